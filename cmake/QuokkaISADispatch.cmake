@@ -0,0 +1,93 @@
+# Runtime instruction-set (ISA) dispatch for CPU builds of Quokka.
+#
+# The default build is compiled for the baseline ISA of the compiler (or whatever is set in CMAKE_CXX_FLAGS).
+# If QUOKKA_ISA_VARIANTS is set to a list of ISA variants, e.g.
+#   -DQUOKKA_ISA_VARIANTS="x86-64-v3;x86-64-v4"    (AVX2 and AVX-512 nodes)
+#   -DQUOKKA_ISA_VARIANTS="sve;sve2"                (ARM nodes with SVE or SVE2)
+# the whole tree is additionally built once for each variant (in <build dir>/isa/<variant>).
+# At startup, each baseline executable checks the features of the CPU it is running on and
+# re-executes itself as the most capable variant that the CPU supports (see src/util/isa_dispatch.hpp).
+# The variants are ranked explicitly (x86-64-v2 < x86-64-v3 < x86-64-v4, sve < sve2), independently of their order in the list.
+# Since Quokka is header-only, each variant is a complete executable, so all of the kernels
+# (reconstruction, Riemann solvers, radiation source terms, cooling, ...) use the selected ISA.
+#
+# The environment variable QUOKKA_ISA can be set to a variant name (or 'baseline') to override the choice at runtime.
+# Dispatch only applies to host code. It is ignored for GPU builds.
+
+set(QUOKKA_ISA_VARIANTS "" CACHE STRING "List of ISA variants to build in addition to the baseline (x86-64-v2, x86-64-v3, x86-64-v4, sve, sve2)")
+set(QUOKKA_ISA_BUILD_TARGETS "all" CACHE STRING "List of targets to build for each ISA variant (default: all)")
+
+# QUOKKA_ISA_NAME is set (by the parent build) when this is the build of one of the variants
+if(DEFINED QUOKKA_ISA_NAME AND NOT QUOKKA_ISA_NAME STREQUAL "")
+  add_compile_definitions(QUOKKA_ISA_NAME="${QUOKKA_ISA_NAME}")
+  return()
+endif()
+
+if(QUOKKA_ISA_VARIANTS STREQUAL "")
+  return()
+endif()
+
+if(AMReX_GPU_BACKEND MATCHES "CUDA" OR AMReX_GPU_BACKEND MATCHES "HIP" OR AMReX_GPU_BACKEND MATCHES "SYCL")
+  message(WARNING "Runtime ISA dispatch is only supported for CPU builds. Ignoring QUOKKA_ISA_VARIANTS=${QUOKKA_ISA_VARIANTS}.")
+  return()
+endif()
+
+if(NOT (CMAKE_CXX_COMPILER_ID STREQUAL "GNU" OR CMAKE_CXX_COMPILER_ID MATCHES "Clang" OR CMAKE_CXX_COMPILER_ID STREQUAL "IntelLLVM"))
+  message(FATAL_ERROR "Runtime ISA dispatch is only supported with GCC or Clang (compiler: ${CMAKE_CXX_COMPILER_ID}).")
+endif()
+
+include(ExternalProject)
+
+# every variant must be configured exactly like the baseline build (apart from the ISA flags), so all of the cache
+# variables of AMReX (e.g., AMReX_MPI, AMReX_OMP, AMReX_PRECISION, AMReX_GPU_BACKEND, AMReX_SPACEDIM) and of Quokka
+# (the QUOKKA_* options, ENABLE_*, ...) are forwarded, as well as the compilers and the search paths.
+# variables that are not in the cache yet (i.e., that were not set on the command line) take the same defaults in each build.
+set(quokka_isa_forwarded_regex
+    "^(AMReX_.*|QUOKKA_.*|ENABLE_.*|DISABLE_FMAD|WARNINGS_AS_ERRORS|CMAKE_BUILD_TYPE|CMAKE_C_COMPILER|CMAKE_CXX_COMPILER|CMAKE_PREFIX_PATH|MPI_.*_COMPILER|Python_ROOT_DIR|openPMD_.*|.*_ROOT)$")
+set(quokka_isa_forwarded_args)
+get_cmake_property(quokka_isa_cache_vars CACHE_VARIABLES)
+foreach(quokka_isa_var IN LISTS quokka_isa_cache_vars)
+  if(NOT quokka_isa_var MATCHES "${quokka_isa_forwarded_regex}" OR quokka_isa_var MATCHES "^QUOKKA_ISA_")
+    continue()
+  endif()
+  get_property(quokka_isa_var_type CACHE ${quokka_isa_var} PROPERTY TYPE)
+  if(quokka_isa_var_type STREQUAL "INTERNAL" OR quokka_isa_var_type STREQUAL "STATIC")
+    continue()
+  elseif(quokka_isa_var_type STREQUAL "UNINITIALIZED")
+    set(quokka_isa_var_type STRING) # set on the command line without a type
+  endif()
+  list(APPEND quokka_isa_forwarded_args "-D${quokka_isa_var}:${quokka_isa_var_type}=${${quokka_isa_var}}")
+endforeach()
+list(APPEND quokka_isa_forwarded_args "-DQUOKKA_ISA_VARIANTS:STRING=")
+
+set(quokka_isa_build_command)
+foreach(quokka_isa_target IN LISTS QUOKKA_ISA_BUILD_TARGETS)
+  list(APPEND quokka_isa_build_command --target ${quokka_isa_target})
+endforeach()
+
+foreach(quokka_isa IN LISTS QUOKKA_ISA_VARIANTS)
+  if(quokka_isa MATCHES "^x86-64-v[234]$")
+    set(quokka_isa_flags "-march=${quokka_isa}")
+  elseif(quokka_isa STREQUAL "sve")
+    set(quokka_isa_flags "-march=armv8.2-a+sve")
+  elseif(quokka_isa STREQUAL "sve2")
+    set(quokka_isa_flags "-march=armv9-a")
+  else()
+    message(FATAL_ERROR "Unknown ISA variant '${quokka_isa}' in QUOKKA_ISA_VARIANTS. Valid variants are x86-64-v2, x86-64-v3, x86-64-v4, sve, and sve2.")
+  endif()
+  message(STATUS "Runtime ISA dispatch: building variant ${quokka_isa} (${quokka_isa_flags}) in ${CMAKE_BINARY_DIR}/isa/${quokka_isa}")
+
+  ExternalProject_Add(quokka-isa-${quokka_isa}
+    SOURCE_DIR ${PROJECT_SOURCE_DIR}
+    BINARY_DIR ${CMAKE_BINARY_DIR}/isa/${quokka_isa}
+    CMAKE_CACHE_ARGS ${quokka_isa_forwarded_args} "-DQUOKKA_ISA_NAME:STRING=${quokka_isa}" "-DCMAKE_CXX_FLAGS:STRING=${CMAKE_CXX_FLAGS} ${quokka_isa_flags}"
+                     "-DCMAKE_C_FLAGS:STRING=${CMAKE_C_FLAGS} ${quokka_isa_flags}"
+    BUILD_COMMAND ${CMAKE_COMMAND} --build <BINARY_DIR> ${quokka_isa_build_command}
+    INSTALL_COMMAND ""
+    TEST_COMMAND ""
+    BUILD_ALWAYS ON)
+endforeach()
+
+# the baseline executables need to know the variants and where to find them
+string(REPLACE ";" "," quokka_isa_variant_string "${QUOKKA_ISA_VARIANTS}")
+add_compile_definitions(QUOKKA_ISA_VARIANTS="${quokka_isa_variant_string}" QUOKKA_BINARY_DIR="${CMAKE_BINARY_DIR}")
@@ -0,0 +1,100 @@
+# Profile-guided optimization (PGO) and link-time optimization (LTO) for Quokka.
+#
+# PGO is a two-pass build:
+#   1. configure with -DQUOKKA_PGO=GENERATE, build, then run `cmake --build . --target pgo-train`
+#      to run the training problems (QUOKKA_PGO_TRAINING_TESTS) with the instrumented executables.
+#   2. reconfigure the *same* build directory with -DQUOKKA_PGO=USE and rebuild.
+#      The optimized executables are compiled using the profiles written in step 1.
+#
+# Both GCC and Clang (including the LLVM-based Intel compilers) are supported.
+# PGO only applies to host code. It is ignored for GPU builds.
+
+set(QUOKKA_PGO "OFF" CACHE STRING "Profile-guided optimization mode (OFF, GENERATE, or USE)")
+set_property(CACHE QUOKKA_PGO PROPERTY STRINGS OFF GENERATE USE)
+set(QUOKKA_PGO_PROFILE_DIR "${CMAKE_BINARY_DIR}/pgo-profiles" CACHE PATH "Directory where PGO profiles are written and read")
+set(QUOKKA_PGO_TRAINING_TESTS "^(HydroBlast3D|HydroHighMach|HydroShocktube|HydroLeblanc|RadhydroShock|MarshakWave|ODEIntegration)$"
+    CACHE STRING "Regular expression (passed to ctest -R) selecting the tests used as the PGO training set")
+
+string(TOUPPER "${QUOKKA_PGO}" QUOKKA_PGO_MODE)
+
+if(QUOKKA_LTO)
+  include(CheckIPOSupported)
+  check_ipo_supported(RESULT quokka_ipo_supported OUTPUT quokka_ipo_output LANGUAGES CXX)
+  if(quokka_ipo_supported)
+    message(STATUS "Link-time optimization (LTO) is *enabled*")
+    set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)
+  else()
+    message(WARNING "Link-time optimization (LTO) is not supported by this compiler: ${quokka_ipo_output}")
+  endif()
+endif(QUOKKA_LTO)
+
+if(QUOKKA_PGO_MODE STREQUAL "OFF" OR QUOKKA_PGO_MODE STREQUAL "")
+  return()
+endif()
+
+if(NOT (QUOKKA_PGO_MODE STREQUAL "GENERATE" OR QUOKKA_PGO_MODE STREQUAL "USE"))
+  message(FATAL_ERROR "Invalid value QUOKKA_PGO=${QUOKKA_PGO}. Valid values are OFF, GENERATE, or USE.")
+endif()
+
+if(AMReX_GPU_BACKEND MATCHES "CUDA" OR AMReX_GPU_BACKEND MATCHES "HIP" OR AMReX_GPU_BACKEND MATCHES "SYCL")
+  message(WARNING "Profile-guided optimization is only supported for CPU builds. Ignoring QUOKKA_PGO=${QUOKKA_PGO}.")
+  return()
+endif()
+
+if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+  set(quokka_pgo_compiler "GNU")
+elseif(CMAKE_CXX_COMPILER_ID MATCHES "Clang" OR CMAKE_CXX_COMPILER_ID STREQUAL "IntelLLVM")
+  set(quokka_pgo_compiler "Clang")
+else()
+  message(FATAL_ERROR "Profile-guided optimization is only supported with GCC or Clang (compiler: ${CMAKE_CXX_COMPILER_ID}).")
+endif()
+
+file(MAKE_DIRECTORY ${QUOKKA_PGO_PROFILE_DIR})
+
+if(QUOKKA_PGO_MODE STREQUAL "GENERATE")
+  message(STATUS "Profile-guided optimization: building *instrumented* executables (profiles: ${QUOKKA_PGO_PROFILE_DIR})")
+  if(quokka_pgo_compiler STREQUAL "GNU")
+    # atomic counter updates are needed for correct profiles from OpenMP-threaded code
+    set(quokka_pgo_flags -fprofile-generate=${QUOKKA_PGO_PROFILE_DIR} -fprofile-update=atomic)
+  else()
+    set(quokka_pgo_flags -fprofile-generate=${QUOKKA_PGO_PROFILE_DIR})
+  endif()
+  add_compile_options(${quokka_pgo_flags})
+  add_link_options(${quokka_pgo_flags})
+
+  # clang writes one raw profile per process, which must be merged before they can be used
+  if(quokka_pgo_compiler STREQUAL "Clang")
+    get_filename_component(quokka_compiler_dir ${CMAKE_CXX_COMPILER} DIRECTORY)
+    find_program(LLVM_PROFDATA NAMES llvm-profdata HINTS ${quokka_compiler_dir})
+    if(NOT LLVM_PROFDATA)
+      message(FATAL_ERROR "llvm-profdata is required for profile-guided optimization with Clang, but it was not found.")
+    endif()
+    set(quokka_pgo_merge_command
+        COMMAND ${CMAKE_COMMAND} -E echo "Merging PGO profiles into ${QUOKKA_PGO_PROFILE_DIR}/default.profdata"
+        COMMAND sh -c "${LLVM_PROFDATA} merge -output=${QUOKKA_PGO_PROFILE_DIR}/default.profdata ${QUOKKA_PGO_PROFILE_DIR}/*.profraw")
+  endif()
+
+  # run the training problems with the instrumented executables (this does not depend on
+  # any build targets, so the executables must be built first)
+  add_custom_target(pgo-train
+    COMMAND ${CMAKE_COMMAND} -E echo "Running PGO training set: ${QUOKKA_PGO_TRAINING_TESTS}"
+    COMMAND ${CMAKE_CTEST_COMMAND} --test-dir ${CMAKE_BINARY_DIR} -R "${QUOKKA_PGO_TRAINING_TESTS}" --output-on-failure
+    ${quokka_pgo_merge_command}
+    COMMAND ${CMAKE_COMMAND} -E echo "Done. Now reconfigure with -DQUOKKA_PGO=USE and rebuild."
+    WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+    VERBATIM)
+
+elseif(QUOKKA_PGO_MODE STREQUAL "USE")
+  message(STATUS "Profile-guided optimization: building *optimized* executables (profiles: ${QUOKKA_PGO_PROFILE_DIR})")
+  if(quokka_pgo_compiler STREQUAL "GNU")
+    # executables that were not part of the training set have no profile; do not warn about them
+    set(quokka_pgo_flags -fprofile-use=${QUOKKA_PGO_PROFILE_DIR} -fprofile-correction -Wno-missing-profile)
+  else()
+    if(NOT EXISTS ${QUOKKA_PGO_PROFILE_DIR}/default.profdata)
+      message(FATAL_ERROR "PGO profile ${QUOKKA_PGO_PROFILE_DIR}/default.profdata not found. Build with -DQUOKKA_PGO=GENERATE and run the 'pgo-train' target first.")
+    endif()
+    set(quokka_pgo_flags -fprofile-use=${QUOKKA_PGO_PROFILE_DIR}/default.profdata -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date)
+  endif()
+  add_compile_options(${quokka_pgo_flags})
+  add_link_options(${quokka_pgo_flags})
+endif()
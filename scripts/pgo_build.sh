@@ -0,0 +1,49 @@
+#!/bin/bash
+# Build profile-guided (and link-time) optimized Quokka executables and report the
+# speedup of the training problems relative to a standard Release build.
+#
+# usage: scripts/pgo_build.sh <source dir> <baseline build dir> <PGO build dir> [extra CMake options...]
+#
+# The training set can be changed by passing -DQUOKKA_PGO_TRAINING_TESTS="<ctest regex>".
+
+set -euo pipefail
+
+if [ $# -lt 3 ]; then
+	echo "usage: $0 <source dir> <baseline build dir> <PGO build dir> [extra CMake options...]"
+	exit 1
+fi
+
+SRC_DIR=$(realpath "$1")
+BASE_DIR=$2
+PGO_DIR=$3
+shift 3
+CMAKE_OPTS=("-DCMAKE_BUILD_TYPE=Release" "$@")
+NPROCS=$(nproc)
+
+# baseline build
+cmake -S "$SRC_DIR" -B "$BASE_DIR" "${CMAKE_OPTS[@]}"
+cmake --build "$BASE_DIR" -j"$NPROCS"
+
+# instrumented build + training run
+cmake -S "$SRC_DIR" -B "$PGO_DIR" "${CMAKE_OPTS[@]}" -DQUOKKA_PGO=GENERATE -DQUOKKA_LTO=ON
+cmake --build "$PGO_DIR" -j"$NPROCS"
+cmake --build "$PGO_DIR" --target pgo-train
+
+# optimized build
+cmake -S "$SRC_DIR" -B "$PGO_DIR" -DQUOKKA_PGO=USE
+cmake --build "$PGO_DIR" -j"$NPROCS"
+
+# compare the wall-clock time of each training problem
+TESTS=$(cmake -L -N "$PGO_DIR" | sed -n 's/^QUOKKA_PGO_TRAINING_TESTS:STRING=//p')
+
+run_tests() {
+	ctest --test-dir "$1" -R "$TESTS" | sed -n 's/^.*Test *#[0-9]*: *\([^ ]*\) [ .]*Passed *\([0-9.]*\) sec.*$/\1 \2/p' | sort
+}
+
+run_tests "$BASE_DIR" >"$PGO_DIR/pgo-baseline-times.txt"
+run_tests "$PGO_DIR" >"$PGO_DIR/pgo-optimized-times.txt"
+
+echo ""
+printf "%-24s %12s %12s %9s\n" "test" "baseline [s]" "PGO+LTO [s]" "speedup"
+join "$PGO_DIR/pgo-baseline-times.txt" "$PGO_DIR/pgo-optimized-times.txt" |
+	awk '{ printf "%-24s %12.2f %12.2f %8.2fx\n", $1, $2, $3, ($3 > 0) ? $2 / $3 : 0 }'
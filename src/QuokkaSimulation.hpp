@@ -12,8 +12,10 @@
 #include <array>
 #include <filesystem>
 #include <limits>
+#include <optional>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 
@@ -28,6 +30,7 @@
 #include "AMReX_FArrayBox.H"
 #include "AMReX_FabArray.H"
 #include "AMReX_FabFactory.H"
+#include "AMReX_FillPatchUtil.H"
 #include "AMReX_Geometry.H"
 #include "AMReX_GpuControl.H"
 #include "AMReX_GpuDevice.H"
@@ -36,10 +39,13 @@
 #include "AMReX_MultiFab.H"
 #include "AMReX_MultiFabUtil.H"
 #include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParallelReduce.H"
 #include "AMReX_ParmParse.H"
+#include "AMReX_PhysBCFunct.H"
 #include "AMReX_PlotFileUtil.H"
 #include "AMReX_Print.H"
 #include "AMReX_REAL.H"
+#include "AMReX_Reduce.H"
 #include "AMReX_YAFluxRegister.H"
 
 #ifdef AMREX_USE_ASCENT
@@ -54,11 +60,13 @@
 #include "cooling/TabulatedCooling.hpp"
 #include "eos.H"
 #include "hydro/hydro_system.hpp"
+#include "hydro/sponge_layer.hpp"
 #include "hyperbolic_system.hpp"
 #include "physics_info.hpp"
 #include "physics_numVars.hpp"
 #include "radiation/radiation_system.hpp"
 #include "simulation.hpp"
+#include "util/CoordGeometry.hpp"
 
 // Simulation class should be initialized only once per program (i.e., is a singleton)
 template <typename problem_t> class QuokkaSimulation : public AMRSimulation<problem_t>
@@ -78,6 +86,12 @@ template <typename problem_t> class QuokkaSimulation : public AMRSimulation<prob
 	using AMRSimulation<problem_t>::componentNames_cc_;
 	using AMRSimulation<problem_t>::componentNames_fc_;
 	using AMRSimulation<problem_t>::cflNumber_;
+	using AMRSimulation<problem_t>::recordHydroRetry;
+	using AMRSimulation<problem_t>::recordFofcCells;
+	using AMRSimulation<problem_t>::hydroRetriesTotal_;
+	using AMRSimulation<problem_t>::fofcCellsTotal_;
+	using AMRSimulation<problem_t>::dtLimiter_;
+	using AMRSimulation<problem_t>::dtLimiters_;
 	using AMRSimulation<problem_t>::fillBoundaryConditions;
 	using AMRSimulation<problem_t>::CustomPlotFileName;
 	using AMRSimulation<problem_t>::geom;
@@ -87,9 +101,18 @@ template <typename problem_t> class QuokkaSimulation : public AMRSimulation<prob
 	using AMRSimulation<problem_t>::flux_reg_;
 	using AMRSimulation<problem_t>::incrementFluxRegisters;
 	using AMRSimulation<problem_t>::finest_level;
+	using AMRSimulation<problem_t>::max_level;
+	using AMRSimulation<problem_t>::tNew_;
+	using AMRSimulation<problem_t>::tOld_;
+	using AMRSimulation<problem_t>::getAmrInterpolaterCellCentered;
 	using AMRSimulation<problem_t>::finestLevel;
 	using AMRSimulation<problem_t>::do_reflux;
+	using AMRSimulation<problem_t>::surfaceFluxes_;
 	using AMRSimulation<problem_t>::do_tracers;
+	using AMRSimulation<problem_t>::do_cic_particles;
+	using AMRSimulation<problem_t>::particleMaxRungReached_;
+	using AMRSimulation<problem_t>::particleSubstepsBlock_;
+	using AMRSimulation<problem_t>::particleSubstepsGlobal_;
 	using AMRSimulation<problem_t>::Verbose;
 	using AMRSimulation<problem_t>::constantDt_;
 	using AMRSimulation<problem_t>::boxArray;
@@ -109,6 +132,7 @@ template <typename problem_t> class QuokkaSimulation : public AMRSimulation<prob
 
 	int enableCooling_ = 0;
 	int enableChemistry_ = 0;
+	int cacheEOSFields_ = 0; // if 1, hydro uses a per-cell cached effective gamma instead of the full EOS
 	Real max_density_allowed = std::numeric_limits<amrex::Real>::max();
 	Real min_density_allowed = std::numeric_limits<amrex::Real>::min();
 
@@ -117,6 +141,8 @@ template <typename problem_t> class QuokkaSimulation : public AMRSimulation<prob
 	std::string coolingTableType_{};
 	std::string coolingTableFilename_{};
 
+	quokka::SpongeLayer<problem_t> sponge_; // absorbing layers at the domain faces
+
 	static constexpr int nvarTotal_cc_ = Physics_Indices<problem_t>::nvarTotal_cc;
 	static constexpr int ncompHydro_ = HydroSystem<problem_t>::nvar_; // hydro
 	static constexpr int ncompHyperbolic_ = RadSystem<problem_t>::nvarHyperbolic_;
@@ -125,6 +151,16 @@ template <typename problem_t> class QuokkaSimulation : public AMRSimulation<prob
 	amrex::Real radiationCflNumber_ = 0.3;
 	int maxSubsteps_ = 10;				// maximum number of radiation subcycles per hydro step
 	amrex::Real dustGasInteractionCoeff_ = 2.5e-34; // erg cm^3 s^−1 K^−3/2
+	int radiationMaxLevel_ = -1;			// radiation is only solved on levels <= radiationMaxLevel_ (-1 == all levels)
+	int radiationCoupleAboveMaxLevel_ = 0;		// 1 == matter-radiation exchange with the interpolated radiation field above radiationMaxLevel_
+	int radiationGreyInitialGuess_ = 0;		// 1 == start the multigroup matter-radiation Newton iteration from the grey solution
+	bool countRadNewtonIterations_ = false;		// true == accumulate radNewtonSolves_ and radNewtonIterations_ (always done if print_rad_counter_)
+	amrex::Long radNewtonSolves_ = 0;		// number of matter-radiation Newton-Raphson solves on this rank (since the start of the run)
+	amrex::Long radNewtonIterations_ = 0;		// number of matter-radiation Newton-Raphson iterations on this rank (since the start of the run)
+
+	// change of the state due to the matter-radiation exchange on each level at or above radiationMaxLevel_
+	// since the last synchronization with the next-coarser level
+	amrex::Vector<amrex::MultiFab> radExchangeDelta_;
 
 	bool computeReferenceSolution_ = false;
 	amrex::Real errorNorm_ = NAN;
@@ -135,11 +171,18 @@ template <typename problem_t> class QuokkaSimulation : public AMRSimulation<prob
 
 	int lowLevelDebuggingOutput_ = 0;	// 0 == do nothing; 1 == output intermediate multifabs used in hydro each timestep (ONLY USE FOR DEBUGGING)
 	int integratorOrder_ = 2;		// 1 == forward Euler; 2 == RK2-SSP (default)
+	int useMusclHancock_ = 0;		// 0 == method-of-lines integrator (default); 1 == single-stage MUSCL-Hancock integrator
 	int reconstructionOrder_ = 3;		// 1 == donor cell; 2 == PLM; 3 == PPM (default)
 	int radiationReconstructionOrder_ = 3;	// 1 == donor cell; 2 == PLM; 3 == PPM (default)
 	int useDualEnergy_ = 1;			// 0 == disabled; 1 == use auxiliary internal energy equation (default)
 	int abortOnFofcFailure_ = 1;		// 0 == keep going, 1 == abort hydro advance if FOFC fails
+	int mixedPrecisionHydro_ = 1;		// 1 == store the hydro temporaries in single precision when it is safe (QUOKKA_MIXED_PRECISION_HYDRO builds only)
+	amrex::Long singlePrecisionFluxCalls_ = 0; // number of hydro flux evaluations with single-precision temporaries
+	amrex::Long doublePrecisionFluxCalls_ = 0; // number of hydro flux evaluations with double-precision temporaries
+	int deepHalo_ = 0;			// 1 == exchange 2 * nghost_cc_ ghost cells once per RK2 step and compute stage 1 redundantly on the ghost cells
 	amrex::Real artificialViscosityK_ = 0.; // artificial viscosity coefficient (default == None)
+	int useHybridRiemannSolver_ = 0;	// 0 == HLLC everywhere (default); 1 == LLF at strong shocks/near-vacuum faces, HLLC elsewhere
+	HybridRiemannParams hybridRiemannParams_{}; // detector thresholds for the hybrid Riemann solver
 
 	amrex::Long radiationCellUpdates_ = 0; // total number of radiation cell-updates
 
@@ -198,6 +241,9 @@ template <typename problem_t> class QuokkaSimulation : public AMRSimulation<prob
 	// fix-up states
 	void FixupState(int level) override;
 
+	// average down, keeping the radiation variables on levels where radiation is solved
+	void AverageDownTo(int crse_lev) override;
+
 	// implement FillPatch function
 	void FillPatch(int lev, amrex::Real time, amrex::MultiFab &mf, int icomp, int ncomp, quokka::centering cen, quokka::direction dir,
 		       FillPatchType fptype) override;
@@ -250,6 +296,13 @@ template <typename problem_t> class QuokkaSimulation : public AMRSimulation<prob
 	void subcycleRadiationAtLevel(int lev, amrex::Real time, amrex::Real dt_lev_hydro, amrex::YAFluxRegister *fr_as_crse,
 				      amrex::YAFluxRegister *fr_as_fine);
 
+	// radiation above radiation.max_level
+	[[nodiscard]] auto radiationSolvedAtLevel(int lev) const -> bool { return (radiationMaxLevel_ < 0) || (lev <= radiationMaxLevel_); }
+	void prepareRadExchangeDelta(int lev);
+	void fillRadiationFromCoarse(int lev, amrex::Real time);
+	void advanceRadiationAboveMaxLevel(int lev, amrex::Real time, amrex::Real dt_lev);
+	void injectRadExchangeDelta();
+
 	void operatorSplitSourceTerms(amrex::Array4<amrex::Real> const &stateNew, const amrex::Box &indexRange, amrex::Real time, double dt, int stage,
 				      amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &dx, amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &prob_lo,
 				      amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &prob_hi, int *p_iteration_counter, int *p_iteration_failure_counter);
@@ -258,24 +311,44 @@ template <typename problem_t> class QuokkaSimulation : public AMRSimulation<prob
 				    amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx)
 	    -> std::tuple<std::array<amrex::FArrayBox, AMREX_SPACEDIM>, std::array<amrex::FArrayBox, AMREX_SPACEDIM>>;
 
-	auto computeHydroFluxes(amrex::MultiFab const &consVar, int nvars, int lev)
+	auto computeEOSCache(amrex::MultiFab const &consVar) -> std::optional<amrex::MultiFab>;
+
+	// deep-halo (communication-avoiding) RK2 helpers
+	auto makeDeepHaloBoxArray(int lev) const -> amrex::BoxArray;
+	template <typename FAB> static void copyLocalOverlap(amrex::FabArray<FAB> &dst, amrex::FabArray<FAB> const &src, int ngrow_dst);
+	auto restrictToGrids(std::array<amrex::MultiFab, AMREX_SPACEDIM> const &src, int lev) const -> std::array<amrex::MultiFab, AMREX_SPACEDIM>;
+	void fillDeepHaloRedoFlags(amrex::iMultiFab &redoFlag, int lev) const;
+
+	auto countRedoCells(amrex::iMultiFab const &redoFlag, int lev) const -> amrex::Long;
+
+	auto computeHydroFluxes(amrex::MultiFab const &consVar, int nvars, int lev, amrex::MultiFab const *eosCache = nullptr, amrex::Real dt_predict = 0.,
+				amrex::iMultiFab *predictorFlag = nullptr)
 	    -> std::pair<std::array<amrex::MultiFab, AMREX_SPACEDIM>, std::array<amrex::MultiFab, AMREX_SPACEDIM>>;
 
-	auto computeFOHydroFluxes(amrex::MultiFab const &consVar, int nvars, int lev)
+	template <typename fab_t>
+	auto computeHydroFluxesWithPrecision(amrex::MultiFab const &consVar, int nvars, int lev, amrex::MultiFab const *eosCache, amrex::Real dt_predict,
+					     amrex::iMultiFab *predictorFlag)
+	    -> std::pair<std::array<amrex::MultiFab, AMREX_SPACEDIM>, std::array<amrex::MultiFab, AMREX_SPACEDIM>>;
+
+	auto computeFOHydroFluxes(amrex::MultiFab const &consVar, int nvars, int lev, amrex::MultiFab const *eosCache = nullptr)
 	    -> std::pair<std::array<amrex::MultiFab, AMREX_SPACEDIM>, std::array<amrex::MultiFab, AMREX_SPACEDIM>>;
 
 	template <FluxDir DIR>
 	void fluxFunction(amrex::Array4<const amrex::Real> const &consState, amrex::FArrayBox &x1Flux, amrex::FArrayBox &x1FluxDiffusive,
 			  const amrex::Box &indexRange, int nvars, amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx);
 
-	template <FluxDir DIR>
-	void hydroFluxFunction(amrex::MultiFab const &primVar, amrex::MultiFab &leftState, amrex::MultiFab &rightState, amrex::MultiFab &x1Flux,
-			       amrex::MultiFab &x1FaceVel, amrex::MultiFab const &x1Flat, amrex::MultiFab const &x2Flat, amrex::MultiFab const &x3Flat,
-			       int ng_reconstruct, int nvars);
+	template <FluxDir DIR, typename fab_t>
+	void hydroReconstructFunction(amrex::FabArray<fab_t> const &primVar, amrex::FabArray<fab_t> &leftState, amrex::FabArray<fab_t> &rightState,
+				      amrex::MultiFab const &x1Flat, amrex::MultiFab const &x2Flat, amrex::MultiFab const &x3Flat, int ng_reconstruct,
+				      int ng_flatten, int nvars);
+
+	template <FluxDir DIR, typename fab_t>
+	void hydroFluxFunction(amrex::FabArray<fab_t> const &primVar, amrex::FabArray<fab_t> &leftState, amrex::FabArray<fab_t> &rightState,
+			       amrex::MultiFab &x1Flux, amrex::MultiFab &x1FaceVel, amrex::MultiFab const *eosCache);
 
 	template <FluxDir DIR>
 	void hydroFOFluxFunction(amrex::MultiFab const &primVar, amrex::MultiFab &leftState, amrex::MultiFab &rightState, amrex::MultiFab &x1Flux,
-				 amrex::MultiFab &x1FaceVel, int ng_reconstruct, int nvars);
+				 amrex::MultiFab &x1FaceVel, int ng_reconstruct, int nvars, amrex::MultiFab const *eosCache);
 
 	void replaceFluxes(std::array<amrex::MultiFab, AMREX_SPACEDIM> &fluxes, std::array<amrex::MultiFab, AMREX_SPACEDIM> &FOfluxes,
 			   amrex::iMultiFab &redoFlag);
@@ -344,10 +417,21 @@ template <typename problem_t> void QuokkaSimulation<problem_t>::readParmParse()
 		amrex::ParmParse hpp("hydro");
 		hpp.query("low_level_debugging_output", lowLevelDebuggingOutput_);
 		hpp.query("rk_integrator_order", integratorOrder_);
+		hpp.query("use_muscl_hancock", useMusclHancock_);
 		hpp.query("reconstruction_order", reconstructionOrder_);
 		hpp.query("use_dual_energy", useDualEnergy_);
 		hpp.query("abort_on_fofc_failure", abortOnFofcFailure_);
+		hpp.query("deep_halo", deepHalo_);
+		hpp.query("mixed_precision", mixedPrecisionHydro_);
 		hpp.query("artificial_viscosity_coefficient", artificialViscosityK_);
+		hpp.query("use_hybrid_riemann_solver", useHybridRiemannSolver_);
+		hpp.query("hybrid_pressure_ratio", hybridRiemannParams_.pressureRatio);
+		hpp.query("hybrid_density_ratio", hybridRiemannParams_.densityRatio);
+		hpp.query("hybrid_compression", hybridRiemannParams_.compression);
+
+		if (useMusclHancock_ == 1 && Physics_Traits<problem_t>::is_mhd_enabled) {
+			amrex::Abort("hydro.use_muscl_hancock is not supported for MHD problems!");
+		}
 	}
 
 	// set cooling runtime parameters
@@ -381,9 +465,13 @@ template <typename problem_t> void QuokkaSimulation<problem_t>::readParmParse()
 		hpp.query("enabled", enableChemistry_);
 		hpp.query("max_density_allowed", max_density_allowed); // chemistry is not accurate for densities > 3e-6
 		hpp.query("min_density_allowed", min_density_allowed); // don't do chemistry in cells with densities below the minimum density specified
+		hpp.query("cache_eos_fields", cacheEOSFields_);	       // use cached effective gamma in the hydro update
 	}
 #endif
 
+	// set sponge layer runtime parameters
+	sponge_.readParameters();
+
 	// set radiation runtime parameters
 	{
 		amrex::ParmParse rpp("radiation");
@@ -391,6 +479,32 @@ template <typename problem_t> void QuokkaSimulation<problem_t>::readParmParse()
 		rpp.query("cfl", radiationCflNumber_);
 		rpp.query("dust_gas_interaction_coeff", dustGasInteractionCoeff_);
 		rpp.query("print_iteration_counts", print_rad_counter_);
+		rpp.query("max_level", radiationMaxLevel_);
+		rpp.query("couple_above_max_level", radiationCoupleAboveMaxLevel_);
+		rpp.query("grey_initial_guess", radiationGreyInitialGuess_);
+		radExchangeDelta_.resize(max_level + 1);
+	}
+	if (Physics_Traits<problem_t>::is_radiation_enabled && !Physics_Traits<problem_t>::is_hydro_enabled && (radiationMaxLevel_ >= 0)) {
+		amrex::Abort("radiation.max_level requires hydro to be enabled!");
+	}
+
+	// check that the physics modules support the coordinate system (geometry.coord_sys)
+	if (!geom[0].IsCartesian()) {
+		if (geom[0].IsRZ() && AMREX_SPACEDIM != 2) {
+			amrex::Abort("RZ coordinates (geometry.coord_sys = 1) are only supported in 2D!");
+		}
+		if (geom[0].IsSPHERICAL() && AMREX_SPACEDIM != 1) {
+			amrex::Abort("spherical coordinates (geometry.coord_sys = 2) are only supported in 1D!");
+		}
+		if (Physics_Traits<problem_t>::is_radiation_enabled || Physics_Traits<problem_t>::is_mhd_enabled) {
+			amrex::Abort("curvilinear coordinates are only supported for hydrodynamics!");
+		}
+#ifdef AMREX_PARTICLES
+		if ((do_tracers != 0) || (do_cic_particles != 0)) {
+			amrex::Abort("curvilinear coordinates are not supported for particles!");
+		}
+#endif
+		// (self-gravity is enabled after the simulation object is constructed, so it is checked in setInitialConditions)
 	}
 }
 
@@ -419,6 +533,11 @@ template <typename problem_t> void QuokkaSimulation<problem_t>::computeMaxSignal
 			// hydro only
 			HydroSystem<problem_t>::ComputeMaxSignalSpeed(stateNew, maxSignal, indexRange);
 		} else if constexpr (Physics_Traits<problem_t>::is_radiation_enabled) {
+			if (!radiationSolvedAtLevel(level)) {
+				// radiation is interpolated from a coarser level, so only hydro limits the timestep
+				HydroSystem<problem_t>::ComputeMaxSignalSpeed(stateNew, maxSignal, indexRange);
+				continue;
+			}
 			// radiation hydro, or radiation only
 			RadSystem<problem_t>::ComputeMaxSignalSpeed(stateNew, maxSignal, indexRange);
 			if constexpr (Physics_Traits<problem_t>::is_hydro_enabled) {
@@ -541,6 +660,9 @@ auto QuokkaSimulation<problem_t>::addStrangSplitSourcesWithBuiltin(amrex::MultiF
 	}
 #endif
 
+	// relax toward the reference state in the sponge layers
+	sponge_.apply(state, geom[lev], dt);
+
 	// compute user-specified sources
 	addStrangSplitSources(state, lev, time, dt);
 
@@ -645,9 +767,11 @@ template <typename problem_t> void QuokkaSimulation<problem_t>::computeAfterEvol
 	amrex::Print() << '\n';
 
 	// compute average number of radiation subcycles per timestep
-	double const avg_rad_subcycles = static_cast<double>(radiationCellUpdates_) / static_cast<double>(cellUpdates_);
-	amrex::Print() << "avg. num. of radiation subcycles = " << avg_rad_subcycles << '\n';
-	amrex::Print() << '\n';
+	if constexpr (Physics_Traits<problem_t>::is_radiation_enabled) {
+		double const avg_rad_subcycles = static_cast<double>(radiationCellUpdates_) / static_cast<double>(cellUpdates_);
+		amrex::Print() << "avg. num. of radiation subcycles = " << avg_rad_subcycles << '\n';
+		amrex::Print() << '\n';
+	}
 }
 
 template <typename problem_t> void QuokkaSimulation<problem_t>::advanceSingleTimestepAtLevel(int lev, amrex::Real time, amrex::Real dt_lev, int ncycle)
@@ -669,7 +793,7 @@ template <typename problem_t> void QuokkaSimulation<problem_t>::advanceSingleTim
 
 	// since we are starting a new timestep, need to swap old and new state vectors
 	std::swap(state_old_cc_[lev], state_new_cc_[lev]);
-	if (Physics_Indices<problem_t>::nvarTotal_fc > 0) {
+	if constexpr (Physics_Indices<problem_t>::nvarTotal_fc > 0) {
 		std::swap(state_old_fc_[lev], state_new_fc_[lev]);
 	}
 
@@ -690,12 +814,24 @@ template <typename problem_t> void QuokkaSimulation<problem_t>::advanceSingleTim
 
 	// subcycle radiation
 	if constexpr (Physics_Traits<problem_t>::is_radiation_enabled) {
-		subcycleRadiationAtLevel(lev, time, dt_lev, fr_as_crse, fr_as_fine);
+		if (radiationSolvedAtLevel(lev)) {
+			// if radiation is not solved on the next-finer level, the radiation fluxes at the coarse-fine boundary
+			// are not corrected (the radiation variables on this level are not overwritten by averaging down)
+			amrex::YAFluxRegister *fr_rad_as_crse = radiationSolvedAtLevel(lev + 1) ? fr_as_crse : nullptr;
+			subcycleRadiationAtLevel(lev, time, dt_lev, fr_rad_as_crse, fr_as_fine);
+		} else {
+			advanceRadiationAboveMaxLevel(lev, time, dt_lev);
+		}
 	}
 
 	// check hydro states after radiation update
 	CHECK_HYDRO_STATES(state_new_cc_[lev]);
 
+	// without hydro, there is no Strang-split source update, so the sponge layers are applied here
+	if constexpr (!Physics_Traits<problem_t>::is_hydro_enabled) {
+		sponge_.apply(state_new_cc_[lev], geom[lev], dt_lev);
+	}
+
 	// compute any operator-split terms here (user-defined)
 	computeAfterLevelAdvance(lev, time, dt_lev, ncycle);
 
@@ -899,6 +1035,9 @@ void QuokkaSimulation<problem_t>::advanceHydroAtLevelWithRetries(int lev, amrex:
 		amrex::Copy(originalFineData, fineData, 0, 0, fineData.nComp(), 0);
 	}
 
+	// save the pre-advance surface flux totals
+	const std::vector<amrex::Real> originalSurfaceFluxes = surfaceFluxes_.localTotals();
+
 #ifdef AMREX_PARTICLES
 	amrex::AmrTracerParticleContainer::ContainerLike<amrex::DefaultAllocator> originalTracerPC;
 	if (do_tracers != 0) {
@@ -908,6 +1047,10 @@ void QuokkaSimulation<problem_t>::advanceHydroAtLevelWithRetries(int lev, amrex:
 	}
 #endif
 
+	// temporary multifab for the old state (allocated once; it is re-copied from state_old_cc_ on every attempt,
+	// since the Strang-split sources are applied to it in place)
+	amrex::MultiFab state_old_cc_tmp(grids[lev], dmap[lev], Physics_Indices<problem_t>::nvarTotal_cc, nghost_cc_);
+
 	for (int retry_count = 0; retry_count <= max_retries; ++retry_count) {
 		// reduce timestep by a factor of 2^retry_count
 		const int nsubsteps = static_cast<int>(std::pow(2, retry_count));
@@ -919,6 +1062,8 @@ void QuokkaSimulation<problem_t>::advanceHydroAtLevelWithRetries(int lev, amrex:
 		}
 
 		if (retry_count > 0) {
+			recordHydroRetry(lev);
+
 			// reset the flux registers to their pre-advance state
 			if (fr_as_crse != nullptr) {
 				fr_as_crse->reset();
@@ -927,6 +1072,9 @@ void QuokkaSimulation<problem_t>::advanceHydroAtLevelWithRetries(int lev, amrex:
 				amrex::Copy(fr_as_fine->getFineData(), originalFineData, 0, 0, originalFineData.nComp(), 0);
 			}
 
+			// reset the surface flux totals to their pre-advance state
+			surfaceFluxes_.setLocalTotals(originalSurfaceFluxes);
+
 #ifdef AMREX_PARTICLES
 			if (do_tracers != 0) {
 				// reset the tracer particles to their pre-advance state
@@ -935,8 +1083,7 @@ void QuokkaSimulation<problem_t>::advanceHydroAtLevelWithRetries(int lev, amrex:
 #endif
 		}
 
-		// create temporary multifab for old state
-		amrex::MultiFab state_old_cc_tmp(grids[lev], dmap[lev], Physics_Indices<problem_t>::nvarTotal_cc, nghost_cc_);
+		// reset the temporary old state
 		amrex::Copy(state_old_cc_tmp, state_old_cc_[lev], 0, 0, Physics_Indices<problem_t>::nvarTotal_cc, nghost_cc_);
 
 		// subcycle advanceHydroAtLevel, checking return value
@@ -1035,14 +1182,19 @@ auto QuokkaSimulation<problem_t>::advanceHydroAtLevel(amrex::MultiFab &state_old
 {
 	BL_PROFILE("QuokkaSimulation::advanceHydroAtLevel()");
 
+	// the MUSCL-Hancock integrator is a single-stage method, so it does not use the second stage of RK2-SSP
+	const int nstages = (useMusclHancock_ == 1) ? 1 : integratorOrder_;
+	const amrex::Real dt_predict = (useMusclHancock_ == 1) ? dt_lev : 0.;
+
 	amrex::Real fluxScaleFactor = NAN;
-	if (integratorOrder_ == 2) {
+	if (nstages == 2) {
 		fluxScaleFactor = 0.5;
-	} else if (integratorOrder_ == 1) {
+	} else if (nstages == 1) {
 		fluxScaleFactor = 1.0;
 	}
 
 	auto dx = geom[lev].CellSizeArray();
+	const auto coordGeom = quokka::CoordGeometry::fromGeometry(geom[lev]);
 
 	// do Strang split source terms (first half-step)
 	auto burn_success_first = addStrangSplitSourcesWithBuiltin(state_old_cc_tmp, lev, time, 0.5 * dt_lev);
@@ -1054,12 +1206,29 @@ auto QuokkaSimulation<problem_t>::advanceHydroAtLevel(amrex::MultiFab &state_old
 
 	// create temporary multifab for intermediate state
 	amrex::MultiFab state_inter_cc_(grids[lev], dmap[lev], Physics_Indices<problem_t>::nvarTotal_cc, nghost_cc_);
-	state_inter_cc_.setVal(0); // prevent assert in fillBoundaryConditions when radiation is enabled
+	if constexpr (nvarTotal_cc_ > ncompHydro_) {
+		// the non-hydro (i.e., radiation) components are not written by the hydro update,
+		// so they must be initialized to prevent an assert in fillBoundaryConditions
+		// (the hydro components are always overwritten, so they do not need to be initialized)
+		state_inter_cc_.setVal(0, ncompHydro_, nvarTotal_cc_ - ncompHydro_, nghost_cc_);
+	}
+#ifdef AMREX_DEBUG
+	// the hydro components of the ghost cells are only written by fillBoundaryConditions (or, in deep-halo mode,
+	// by stage 1 on the grown boxes), which must happen before they are read in stage 2.
+	// in debug builds, fill them with NaN so that the checks before stage 2 fail if any ghost cell is left unfilled
+	// (this holds for every attempt, since each retry of the hydro update allocates a new intermediate state)
+	state_inter_cc_.setVal(std::numeric_limits<amrex::Real>::quiet_NaN(), 0, ncompHydro_, nghost_cc_);
+#endif
 
 	// create temporary multifabs for combined RK2 flux and time-average face velocity
 	std::array<amrex::MultiFab, AMREX_SPACEDIM> flux_rk2;
 	std::array<amrex::MultiFab, AMREX_SPACEDIM> avgFaceVel;
-	const int nghost_vel = 2; // 2 ghost faces are needed for tracer particles
+	int nghost_vel = 0; // the hydro update only uses the face velocities on valid faces
+#ifdef AMREX_PARTICLES
+	if (do_tracers != 0) {
+		nghost_vel = 2; // 2 ghost faces are needed for tracer particles
+	}
+#endif
 	auto ba = grids[lev];
 	auto dm = dmap[lev];
 	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
@@ -1072,8 +1241,34 @@ auto QuokkaSimulation<problem_t>::advanceHydroAtLevel(amrex::MultiFab &state_old
 		avgFaceVel[idim].setVal(0);
 	}
 
-	// update ghost zones [old timestep]
-	fillBoundaryConditions(state_old_cc_tmp, state_old_cc_tmp, lev, time, quokka::centering::cc, quokka::direction::na, PreInterpState, PostInterpState);
+	// in deep-halo mode, the ghost zones of the old state are filled to twice the usual depth, so that stage 1 can be
+	// computed redundantly on the first nghost_cc_ ghost zones of each box, and stage 2 then needs no ghost zone exchange
+	const bool useDeepHalo = (deepHalo_ == 1) && (nstages == 2);
+	std::optional<amrex::MultiFab> state_old_ext;
+	std::optional<amrex::MultiFab> state_inter_ext;
+
+	if (useDeepHalo) {
+		// update ghost zones [old timestep] to depth 2 * nghost_cc_
+		// (the FillPatcher object is built for nghost_cc_ ghost zones, so the FillPatchTwoLevels function is used instead)
+		amrex::MultiFab state_old_deep(grids[lev], dmap[lev], nvarTotal_cc_, 2 * nghost_cc_);
+		amrex::Copy(state_old_deep, state_old_cc_tmp, 0, 0, nvarTotal_cc_, 0);
+		fillBoundaryConditions(state_old_deep, state_old_deep, lev, time, quokka::centering::cc, quokka::direction::na, PreInterpState, PostInterpState,
+				       FillPatchType::fillpatch_function);
+		amrex::Copy(state_old_cc_tmp, state_old_deep, 0, 0, nvarTotal_cc_, nghost_cc_);
+
+		// copy the old state to the grown boxes (this is a local copy)
+		const amrex::BoxArray ba_ext = makeDeepHaloBoxArray(lev);
+		state_old_ext.emplace(ba_ext, dmap[lev], nvarTotal_cc_, nghost_cc_);
+		copyLocalOverlap(*state_old_ext, state_old_deep, nghost_cc_);
+		state_inter_ext.emplace(ba_ext, dmap[lev], nvarTotal_cc_, nghost_cc_);
+		if constexpr (nvarTotal_cc_ > ncompHydro_) {
+			state_inter_ext->setVal(0, ncompHydro_, nvarTotal_cc_ - ncompHydro_, nghost_cc_);
+		}
+	} else {
+		// update ghost zones [old timestep]
+		fillBoundaryConditions(state_old_cc_tmp, state_old_cc_tmp, lev, time, quokka::centering::cc, quokka::direction::na, PreInterpState,
+				       PostInterpState);
+	}
 
 	// LOW LEVEL DEBUGGING: output state_old_cc_tmp (with ghost cells)
 	if (lowLevelDebuggingOutput_ == 1) {
@@ -1093,28 +1288,64 @@ auto QuokkaSimulation<problem_t>::advanceHydroAtLevel(amrex::MultiFab &state_old
 	AMREX_ASSERT(!state_old_cc_tmp.contains_nan(0, state_old_cc_tmp.nComp()));
 	AMREX_ASSERT(!state_old_cc_tmp.contains_nan()); // check ghost cells
 
-	auto [FOfluxArrays, FOfaceVel] = computeFOHydroFluxes(state_old_cc_tmp, ncompHydro_, lev);
+	// (optionally) cache the effective EOS parameters of the old state, after chemistry and after filling ghost cells
+	auto const eosCacheOld = computeEOSCache(state_old_cc_tmp);
+	amrex::MultiFab const *eosCacheOldPtr = eosCacheOld ? &(*eosCacheOld) : nullptr;
+	auto const eosCacheOldExt = useDeepHalo ? computeEOSCache(*state_old_ext) : std::nullopt;
+	amrex::MultiFab const *eosCacheStage1Ptr = useDeepHalo ? (eosCacheOldExt ? &(*eosCacheOldExt) : nullptr) : eosCacheOldPtr;
+
+	auto [FOfluxArrays, FOfaceVel] = computeFOHydroFluxes(useDeepHalo ? *state_old_ext : state_old_cc_tmp, ncompHydro_, lev, eosCacheStage1Ptr);
 
 	// Stage 1 of RK2-SSP
 	{
 		// advance all grids on local processor (Stage 1 of integrator)
-		auto const &stateOld = state_old_cc_tmp;
-		auto &stateNew = state_inter_cc_;
-		auto [fluxArrays, faceVel] = computeHydroFluxes(stateOld, ncompHydro_, lev);
+		auto const &stateOld = useDeepHalo ? *state_old_ext : state_old_cc_tmp;
+		auto &stateNew = useDeepHalo ? *state_inter_ext : state_inter_cc_;
+		std::optional<amrex::iMultiFab> predictorFlag;
+		if (dt_predict > 0.) {
+			predictorFlag.emplace(stateOld.boxArray(), stateOld.DistributionMap(), 1, 1);
+		}
+		auto [fluxArrays, faceVel] =
+		    computeHydroFluxes(stateOld, ncompHydro_, lev, eosCacheStage1Ptr, dt_predict, predictorFlag ? &(*predictorFlag) : nullptr);
 
-		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-			amrex::MultiFab::Saxpy(flux_rk2[idim], 0.5, fluxArrays[idim], 0, 0, ncompHydro_, 0);
-			amrex::MultiFab::Saxpy(avgFaceVel[idim], 0.5, faceVel[idim], 0, 0, 1, 0);
+		if (useDeepHalo) {
+			// only the fluxes on the faces of the valid boxes are accumulated
+			auto fluxValid = restrictToGrids(fluxArrays, lev);
+			auto faceVelValid = restrictToGrids(faceVel, lev);
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				amrex::MultiFab::Saxpy(flux_rk2[idim], fluxScaleFactor, fluxValid[idim], 0, 0, ncompHydro_, 0);
+				amrex::MultiFab::Saxpy(avgFaceVel[idim], fluxScaleFactor, faceVelValid[idim], 0, 0, 1, 0);
+			}
+		} else {
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				amrex::MultiFab::Saxpy(flux_rk2[idim], fluxScaleFactor, fluxArrays[idim], 0, 0, ncompHydro_, 0);
+				amrex::MultiFab::Saxpy(avgFaceVel[idim], fluxScaleFactor, faceVel[idim], 0, 0, 1, 0);
+			}
 		}
 
-		amrex::MultiFab rhs(grids[lev], dmap[lev], ncompHydro_, 0);
-		amrex::iMultiFab redoFlag(grids[lev], dmap[lev], 1, 1);
+		amrex::MultiFab rhs(stateNew.boxArray(), stateNew.DistributionMap(), ncompHydro_, 0);
+		amrex::iMultiFab redoFlag(stateNew.boxArray(), stateNew.DistributionMap(), 1, 1);
 		redoFlag.setVal(quokka::redoFlag::none);
 
-		HydroSystem<problem_t>::ComputeRhsFromFluxes(rhs, fluxArrays, dx, ncompHydro_);
-		HydroSystem<problem_t>::AddInternalEnergyPdV(rhs, stateOld, dx, faceVel, redoFlag);
+		HydroSystem<problem_t>::ComputeRhsFromFluxes(rhs, fluxArrays, dx, ncompHydro_, coordGeom);
+		HydroSystem<problem_t>::AddInternalEnergyPdV(rhs, stateOld, dx, faceVel, redoFlag, eosCacheStage1Ptr, coordGeom);
+		// (with MUSCL-Hancock, the fluxes are time-centred, but the geometric source terms are only evaluated at the old time,
+		// so they are first-order accurate in time)
+		HydroSystem<problem_t>::AddGeometricSources(rhs, stateOld, coordGeom, 1.0, eosCacheStage1Ptr);
 		HydroSystem<problem_t>::PredictStep(stateOld, stateNew, rhs, dt_lev, ncompHydro_, redoFlag);
 
+		if (predictorFlag) {
+			// the cells for which the MUSCL-Hancock prediction was rejected are flux-corrected as well
+			HydroSystem<problem_t>::AddPredictorRedoFlags(redoFlag, *predictorFlag);
+			if (Verbose()) {
+				amrex::Long const ncells_rejected = countRedoCells(*predictorFlag, lev);
+				if (ncells_rejected > 0) {
+					amrex::Print() << "[MUSCL-Hancock] predicted interface states rejected for " << ncells_rejected << " cells on level "
+						       << lev << "\n";
+				}
+			}
+		}
+
 		// LOW LEVEL DEBUGGING: output rhs
 		if (lowLevelDebuggingOutput_ == 1) {
 			// write rhs
@@ -1142,9 +1373,11 @@ auto QuokkaSimulation<problem_t>::advanceHydroAtLevel(amrex::MultiFab &state_old
 		}
 
 		// do first-order flux correction (FOFC)
+		// (in deep-halo mode, the cells in the ghost zones of the grown boxes are corrected as well, but only the cells of
+		// this level are counted)
 		amrex::Gpu::streamSynchronizeAll(); // just in case
-		amrex::Long const ncells_bad = redoFlag.sum(0);
-		if (ncells_bad > 0) {
+		if (redoFlag.max(0) == quokka::redoFlag::redo) {
+			amrex::Long const ncells_bad = countRedoCells(redoFlag, lev);
 			if (Verbose()) {
 				amrex::Print() << "[FOFC-1] flux correcting " << ncells_bad << " cells on level " << lev << "\n";
 				const amrex::IntVect cell_idx = redoFlag.maxIndex(0);
@@ -1152,22 +1385,27 @@ auto QuokkaSimulation<problem_t>::advanceHydroAtLevel(amrex::MultiFab &state_old
 				printCoordinates(lev, cell_idx);
 				amrex::print_state(stateNew, cell_idx);
 			}
+			recordFofcCells(lev, ncells_bad);
 
 			// synchronize redoFlag across ranks
-			redoFlag.FillBoundary(geom[lev].periodicity());
+			if (useDeepHalo) {
+				fillDeepHaloRedoFlags(redoFlag, lev);
+			} else {
+				redoFlag.FillBoundary(geom[lev].periodicity());
+			}
 
 			// replace fluxes around troubled cells with Godunov fluxes
 			replaceFluxes(fluxArrays, FOfluxArrays, redoFlag);
 			replaceFluxes(faceVel, FOfaceVel, redoFlag); // needed for dual energy
 
 			// re-do RK update
-			HydroSystem<problem_t>::ComputeRhsFromFluxes(rhs, fluxArrays, dx, ncompHydro_);
-			HydroSystem<problem_t>::AddInternalEnergyPdV(rhs, stateOld, dx, faceVel, redoFlag);
+			HydroSystem<problem_t>::ComputeRhsFromFluxes(rhs, fluxArrays, dx, ncompHydro_, coordGeom);
+			HydroSystem<problem_t>::AddInternalEnergyPdV(rhs, stateOld, dx, faceVel, redoFlag, eosCacheStage1Ptr, coordGeom);
+			HydroSystem<problem_t>::AddGeometricSources(rhs, stateOld, coordGeom, 1.0, eosCacheStage1Ptr);
 			HydroSystem<problem_t>::PredictStep(stateOld, stateNew, rhs, dt_lev, ncompHydro_, redoFlag);
 
 			amrex::Gpu::streamSynchronizeAll(); // just in case
-			amrex::Long const ncells_bad = static_cast<int>(redoFlag.sum(0));
-			if (ncells_bad > 0) {
+			if (redoFlag.max(0) == quokka::redoFlag::redo) {
 				// FOFC failed
 				if (Verbose()) {
 					const amrex::IntVect cell_idx = redoFlag.maxIndex(0);
@@ -1175,7 +1413,7 @@ auto QuokkaSimulation<problem_t>::advanceHydroAtLevel(amrex::MultiFab &state_old
 					amrex::Print() << "[FOFC-1] Flux correction failed:\n";
 					printCoordinates(lev, cell_idx);
 					amrex::print_state(stateNew, cell_idx);
-					amrex::Print() << "[FOFC-1] failed for " << ncells_bad << " cells on level " << lev << "\n";
+					amrex::Print() << "[FOFC-1] failed for " << countRedoCells(redoFlag, lev) << " cells on level " << lev << "\n";
 				}
 				if (abortOnFofcFailure_ != 0) {
 					return false;
@@ -1191,20 +1429,45 @@ auto QuokkaSimulation<problem_t>::advanceHydroAtLevel(amrex::MultiFab &state_old
 			HydroSystem<problem_t>::SyncDualEnergy(stateNew);
 		}
 
-		if (do_reflux == 1) {
-			// increment flux registers
-			incrementFluxRegisters(fr_as_crse, fr_as_fine, fluxArrays, lev, fluxScaleFactor * dt_lev);
+		if ((do_reflux == 1) || surfaceFluxes_.enabled()) {
+			// increment flux registers (and surface flux totals)
+			if (useDeepHalo) {
+				auto fluxValid = restrictToGrids(fluxArrays, lev);
+				incrementFluxRegisters(fr_as_crse, fr_as_fine, fluxValid, lev, fluxScaleFactor * dt_lev);
+			} else {
+				incrementFluxRegisters(fr_as_crse, fr_as_fine, fluxArrays, lev, fluxScaleFactor * dt_lev);
+			}
 		}
 	}
 	amrex::Gpu::streamSynchronizeAll();
 
+	if (useDeepHalo) {
+		// copy the intermediate state, including the redundantly-computed ghost zones, to state_inter_cc_
+		// (this is a local copy), then fill the ghost zones outside the domain from the physical boundary conditions
+		copyLocalOverlap(state_inter_cc_, *state_inter_ext, nghost_cc_);
+		if (!geom[lev].isAllPeriodic()) {
+			amrex::GpuBndryFuncFab<setBoundaryFunctor<problem_t>> boundaryFunctor(setBoundaryFunctor<problem_t>{});
+			amrex::PhysBCFunct<amrex::GpuBndryFuncFab<setBoundaryFunctor<problem_t>>> physicalBoundaryFunctor(geom[lev], BCs_cc_, boundaryFunctor);
+			physicalBoundaryFunctor(state_inter_cc_, 0, state_inter_cc_.nComp(), state_inter_cc_.nGrowVect(), time + dt_lev, 0);
+		}
+
+		// the first-order fluxes are only needed on the valid boxes for stage 2
+		FOfluxArrays = restrictToGrids(FOfluxArrays, lev);
+		FOfaceVel = restrictToGrids(FOfaceVel, lev);
+		state_old_ext.reset();
+		state_inter_ext.reset();
+	}
+
 	// Stage 2 of RK2-SSP
-	if (integratorOrder_ == 2) {
+	if (nstages == 2) {
 		// update ghost zones [intermediate stage stored in state_inter_cc_]
-		fillBoundaryConditions(state_inter_cc_, state_inter_cc_, lev, time + dt_lev, quokka::centering::cc, quokka::direction::na, PreInterpState,
-				       PostInterpState);
+		// (in deep-halo mode, they have already been computed in stage 1)
+		if (!useDeepHalo) {
+			fillBoundaryConditions(state_inter_cc_, state_inter_cc_, lev, time + dt_lev, quokka::centering::cc, quokka::direction::na,
+					       PreInterpState, PostInterpState);
+		}
 
-		// check intermediate state validity
+		// check intermediate state validity (the ghost zones must have been filled before they are used)
 		AMREX_ASSERT(!state_inter_cc_.contains_nan(0, state_inter_cc_.nComp()));
 		AMREX_ASSERT(!state_inter_cc_.contains_nan()); // check ghost zones
 
@@ -1214,7 +1477,9 @@ auto QuokkaSimulation<problem_t>::advanceHydroAtLevel(amrex::MultiFab &state_old
 		auto const &stateOld = state_old_cc_tmp;
 		auto const &stateInter = state_inter_cc_;
 		auto &stateFinal = state_new_cc_[lev];
-		auto [fluxArrays, faceVel] = computeHydroFluxes(stateInter, ncompHydro_, lev);
+		auto const eosCacheInter = computeEOSCache(stateInter);
+		amrex::MultiFab const *eosCacheInterPtr = eosCacheInter ? &(*eosCacheInter) : nullptr;
+		auto [fluxArrays, faceVel] = computeHydroFluxes(stateInter, ncompHydro_, lev, eosCacheInterPtr);
 
 		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
 			amrex::MultiFab::Saxpy(flux_rk2[idim], 0.5, fluxArrays[idim], 0, 0, ncompHydro_, 0);
@@ -1225,13 +1490,15 @@ auto QuokkaSimulation<problem_t>::advanceHydroAtLevel(amrex::MultiFab &state_old
 		amrex::iMultiFab redoFlag(grids[lev], dmap[lev], 1, 1);
 		redoFlag.setVal(quokka::redoFlag::none);
 
-		HydroSystem<problem_t>::ComputeRhsFromFluxes(rhs, flux_rk2, dx, ncompHydro_);
-		HydroSystem<problem_t>::AddInternalEnergyPdV(rhs, stateOld, dx, avgFaceVel, redoFlag);
+		HydroSystem<problem_t>::ComputeRhsFromFluxes(rhs, flux_rk2, dx, ncompHydro_, coordGeom);
+		HydroSystem<problem_t>::AddInternalEnergyPdV(rhs, stateOld, dx, avgFaceVel, redoFlag, eosCacheOldPtr, coordGeom);
+		HydroSystem<problem_t>::AddGeometricSources(rhs, stateOld, coordGeom, 0.5, eosCacheOldPtr);
+		HydroSystem<problem_t>::AddGeometricSources(rhs, stateInter, coordGeom, 0.5, eosCacheInterPtr);
 		HydroSystem<problem_t>::PredictStep(stateOld, stateFinal, rhs, dt_lev, ncompHydro_, redoFlag);
 
 		// do first-order flux correction (FOFC)
 		amrex::Gpu::streamSynchronizeAll(); // just in case
-		amrex::Long const ncells_bad = redoFlag.sum(0);
+		amrex::Long const ncells_bad = countRedoCells(redoFlag, lev);
 		if (ncells_bad > 0) {
 			if (Verbose()) {
 				amrex::Print() << "[FOFC-2] flux correcting " << ncells_bad << " cells on level " << lev << "\n";
@@ -1239,6 +1506,7 @@ auto QuokkaSimulation<problem_t>::advanceHydroAtLevel(amrex::MultiFab &state_old
 				printCoordinates(lev, cell_idx);
 				amrex::print_state(stateFinal, cell_idx);
 			}
+			recordFofcCells(lev, ncells_bad);
 
 			// synchronize redoFlag across ranks
 			redoFlag.FillBoundary(geom[lev].periodicity());
@@ -1248,12 +1516,14 @@ auto QuokkaSimulation<problem_t>::advanceHydroAtLevel(amrex::MultiFab &state_old
 			replaceFluxes(avgFaceVel, FOfaceVel, redoFlag); // needed for dual energy
 
 			// re-do RK update
-			HydroSystem<problem_t>::ComputeRhsFromFluxes(rhs, flux_rk2, dx, ncompHydro_);
-			HydroSystem<problem_t>::AddInternalEnergyPdV(rhs, stateOld, dx, avgFaceVel, redoFlag);
+			HydroSystem<problem_t>::ComputeRhsFromFluxes(rhs, flux_rk2, dx, ncompHydro_, coordGeom);
+			HydroSystem<problem_t>::AddInternalEnergyPdV(rhs, stateOld, dx, avgFaceVel, redoFlag, eosCacheOldPtr, coordGeom);
+			HydroSystem<problem_t>::AddGeometricSources(rhs, stateOld, coordGeom, 0.5, eosCacheOldPtr);
+			HydroSystem<problem_t>::AddGeometricSources(rhs, stateInter, coordGeom, 0.5, eosCacheInterPtr);
 			HydroSystem<problem_t>::PredictStep(stateOld, stateFinal, rhs, dt_lev, ncompHydro_, redoFlag);
 
 			amrex::Gpu::streamSynchronizeAll(); // just in case
-			amrex::Long ncells_bad = redoFlag.sum(0);
+			amrex::Long ncells_bad = countRedoCells(redoFlag, lev);
 			if (ncells_bad > 0) {
 				// FOFC failed
 				if (Verbose()) {
@@ -1278,8 +1548,8 @@ auto QuokkaSimulation<problem_t>::advanceHydroAtLevel(amrex::MultiFab &state_old
 			HydroSystem<problem_t>::SyncDualEnergy(stateFinal);
 		}
 
-		if (do_reflux == 1) {
-			// increment flux registers
+		if ((do_reflux == 1) || surfaceFluxes_.enabled()) {
+			// increment flux registers (and surface flux totals)
 			incrementFluxRegisters(fr_as_crse, fr_as_fine, fluxArrays, lev, fluxScaleFactor * dt_lev);
 		}
 	} else { // we are only doing forward Euler
@@ -1400,24 +1670,144 @@ auto QuokkaSimulation<problem_t>::expandFluxArrays(std::array<amrex::FArrayBox,
 	return {AMREX_D_DECL(copyFlux(fluxes[0]), copyFlux(fluxes[1]), copyFlux(fluxes[2]))};
 }
 
+template <typename problem_t> auto QuokkaSimulation<problem_t>::makeDeepHaloBoxArray(int lev) const -> amrex::BoxArray
+{
+	// grow each box by nghost_cc_, but not beyond the non-periodic domain boundaries
+	// (the ghost zones outside the domain are filled from the boundary conditions instead)
+	const amrex::Box extDomain = geom[lev].growPeriodicDomain(nghost_cc_);
+	amrex::BoxList bl;
+	for (int i = 0; i < static_cast<int>(grids[lev].size()); ++i) {
+		bl.push_back(amrex::grow(grids[lev][i], nghost_cc_) & extDomain);
+	}
+	return amrex::BoxArray(std::move(bl));
+}
+
+template <typename problem_t>
+template <typename FAB>
+void QuokkaSimulation<problem_t>::copyLocalOverlap(amrex::FabArray<FAB> &dst, amrex::FabArray<FAB> const &src, const int ngrow_dst)
+{
+	// copy the overlap of (box i of dst, grown by ngrow_dst) and (box i of src, including ghost zones) for each i
+	// (dst and src must have the same DistributionMapping, so this does not require any communication)
+	AMREX_ASSERT(dst.DistributionMap() == src.DistributionMap());
+	AMREX_ASSERT(dst.nComp() == src.nComp());
+	const int ncomp = dst.nComp();
+	for (amrex::MFIter mfi(dst); mfi.isValid(); ++mfi) {
+		const amrex::Box bx = amrex::grow(mfi.validbox(), ngrow_dst) & src.fabbox(mfi.index());
+		if (bx.ok()) {
+			auto const &dst_arr = dst.array(mfi);
+			auto const &src_arr = src.const_array(mfi);
+			amrex::ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) { dst_arr(i, j, k, n) = src_arr(i, j, k, n); });
+		}
+	}
+}
+
+template <typename problem_t>
+auto QuokkaSimulation<problem_t>::restrictToGrids(std::array<amrex::MultiFab, AMREX_SPACEDIM> const &src, const int lev) const
+    -> std::array<amrex::MultiFab, AMREX_SPACEDIM>
+{
+	// return the face-centred data on the faces of the boxes of this level (i.e., without the deep-halo faces)
+	std::array<amrex::MultiFab, AMREX_SPACEDIM> dst;
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		dst[idim] = amrex::MultiFab(amrex::convert(grids[lev], amrex::IntVect::TheDimensionVector(idim)), dmap[lev], src[idim].nComp(), 0);
+		copyLocalOverlap(dst[idim], src[idim], 0);
+	}
+	return dst;
+}
+
+template <typename problem_t> void QuokkaSimulation<problem_t>::fillDeepHaloRedoFlags(amrex::iMultiFab &redoFlag, const int lev) const
+{
+	// in deep-halo mode, a cell can be contained in several grown boxes. replace the flag of each cell that belongs to
+	// a box of this level with the flag computed by the box that owns it (so that the flux correction is the same in
+	// every copy of the cell). cells that do not belong to any box of this level keep their own flags.
+	amrex::iMultiFab ownerFlag(grids[lev], dmap[lev], 1, nghost_cc_ + redoFlag.nGrow());
+	ownerFlag.setVal(quokka::redoFlag::none);
+	copyLocalOverlap(ownerFlag, redoFlag, ownerFlag.nGrow());
+	ownerFlag.FillBoundary(geom[lev].periodicity());
+	copyLocalOverlap(redoFlag, ownerFlag, redoFlag.nGrow());
+}
+
+template <typename problem_t> auto QuokkaSimulation<problem_t>::countRedoCells(amrex::iMultiFab const &redoFlag, const int lev) const -> amrex::Long
+{
+	// count the flagged cells on all ranks, only counting the cells of box i of this level in box i of redoFlag
+	// (in deep-halo mode, the grown boxes overlap, so the cells in their ghost zones would otherwise be counted several times)
+	amrex::ReduceOps<amrex::ReduceOpSum> reduce_op;
+	amrex::ReduceData<amrex::Long> reduce_data(reduce_op);
+	for (amrex::MFIter mfi(redoFlag); mfi.isValid(); ++mfi) {
+		const amrex::Box bx = grids[lev][mfi.index()];
+		AMREX_ASSERT(redoFlag.box(mfi.index()).contains(bx));
+		auto const &flag = redoFlag.const_array(mfi);
+		reduce_op.eval(bx, reduce_data, [=] AMREX_GPU_DEVICE(int i, int j, int k) -> amrex::GpuTuple<amrex::Long> {
+			return {(flag(i, j, k) == quokka::redoFlag::redo) ? 1 : 0};
+		});
+	}
+	amrex::Long ncells = amrex::get<0>(reduce_data.value(reduce_op));
+	amrex::ParallelAllReduce::Sum(ncells, amrex::ParallelContext::CommunicatorSub());
+	return ncells;
+}
+
 template <typename problem_t>
-auto QuokkaSimulation<problem_t>::computeHydroFluxes(amrex::MultiFab const &consVar, const int nvars, const int lev)
+auto QuokkaSimulation<problem_t>::computeEOSCache(amrex::MultiFab const &consVar) -> std::optional<amrex::MultiFab>
+{
+	// compute the effective adiabatic index and mean molecular weight in every cell (including ghost cells),
+	// so that the hydro kernels do not need to call the full (chemistry) EOS
+	if (cacheEOSFields_ == 0) {
+		return std::nullopt;
+	}
+	BL_PROFILE("QuokkaSimulation::computeEOSCache()");
+
+	std::optional<amrex::MultiFab> eosCache(std::in_place, consVar.boxArray(), consVar.DistributionMap(), HydroSystem<problem_t>::nEOSCacheVars,
+						 consVar.nGrowVect());
+	HydroSystem<problem_t>::ComputeEOSCache(consVar, *eosCache, consVar.nGrow());
+	return eosCache;
+}
+
+template <typename problem_t>
+auto QuokkaSimulation<problem_t>::computeHydroFluxes(amrex::MultiFab const &consVar, const int nvars, const int lev, amrex::MultiFab const *eosCache,
+						     const amrex::Real dt_predict, amrex::iMultiFab *predictorFlag)
+    -> std::pair<std::array<amrex::MultiFab, AMREX_SPACEDIM>, std::array<amrex::MultiFab, AMREX_SPACEDIM>>
+{
+#ifdef QUOKKA_MIXED_PRECISION_HYDRO
+	// store the primitive variables and interface states in single precision,
+	// unless the state on this level cannot be safely represented in single precision
+	if ((mixedPrecisionHydro_ == 1) && HydroSystem<problem_t>::IsSinglePrecisionSafe(consVar, nghost_cc_)) {
+		++singlePrecisionFluxCalls_;
+		return computeHydroFluxesWithPrecision<amrex::BaseFab<float>>(consVar, nvars, lev, eosCache, dt_predict, predictorFlag);
+	}
+#endif
+	++doublePrecisionFluxCalls_;
+	return computeHydroFluxesWithPrecision<amrex::FArrayBox>(consVar, nvars, lev, eosCache, dt_predict, predictorFlag);
+}
+
+template <typename problem_t>
+template <typename fab_t>
+auto QuokkaSimulation<problem_t>::computeHydroFluxesWithPrecision(amrex::MultiFab const &consVar, const int nvars, const int lev,
+								  amrex::MultiFab const *eosCache, const amrex::Real dt_predict,
+								  amrex::iMultiFab *predictorFlag)
     -> std::pair<std::array<amrex::MultiFab, AMREX_SPACEDIM>, std::array<amrex::MultiFab, AMREX_SPACEDIM>>
 {
 	BL_PROFILE("QuokkaSimulation::computeHydroFluxes()");
 
-	auto ba = grids[lev];
-	auto dm = dmap[lev];
+	// the primitive variables and interface states are stored in fab_t, while the
+	// conserved variables and the fluxes are always stored in double precision
+	constexpr bool isDoublePrecision = std::is_same_v<fab_t, amrex::FArrayBox>;
+	using mf_t = std::conditional_t<isDoublePrecision, amrex::MultiFab, amrex::FabArray<fab_t>>;
+
+	// (in deep-halo mode, consVar is defined on the boxes grown by nghost_cc_)
+	auto ba = consVar.boxArray();
+	auto dm = consVar.DistributionMap();
 	const int flatteningGhost = 2;
-	const int reconstructGhost = 1;
+	const int flattenShocksGhost = 1;
+	// the MUSCL-Hancock predictor needs the interface states on both sides of the cells in the first ghost zone
+	const bool doPredictor = (dt_predict > 0.);
+	const int reconstructGhost = doPredictor ? 2 : 1;
 
 	// allocate temporary MultiFabs
-	amrex::MultiFab primVar(ba, dm, nvars, nghost_cc_);
+	mf_t primVar(ba, dm, nvars, nghost_cc_);
 	std::array<amrex::MultiFab, 3> flatCoefs;
 	std::array<amrex::MultiFab, AMREX_SPACEDIM> flux;
 	std::array<amrex::MultiFab, AMREX_SPACEDIM> facevel;
-	std::array<amrex::MultiFab, AMREX_SPACEDIM> leftState;
-	std::array<amrex::MultiFab, AMREX_SPACEDIM> rightState;
+	std::array<mf_t, AMREX_SPACEDIM> leftState;
+	std::array<mf_t, AMREX_SPACEDIM> rightState;
 
 	for (int idim = 0; idim < 3; ++idim) {
 		flatCoefs[idim] = amrex::MultiFab(ba, dm, 1, flatteningGhost);
@@ -1425,63 +1815,82 @@ auto QuokkaSimulation<problem_t>::computeHydroFluxes(amrex::MultiFab const &cons
 
 	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
 		auto ba_face = amrex::convert(ba, amrex::IntVect::TheDimensionVector(idim));
-		leftState[idim] = amrex::MultiFab(ba_face, dm, nvars, reconstructGhost);
-		rightState[idim] = amrex::MultiFab(ba_face, dm, nvars, reconstructGhost);
+		leftState[idim] = mf_t(ba_face, dm, nvars, reconstructGhost);
+		rightState[idim] = mf_t(ba_face, dm, nvars, reconstructGhost);
 		flux[idim] = amrex::MultiFab(ba_face, dm, nvars, 0);
 		facevel[idim] = amrex::MultiFab(ba_face, dm, 1, 0);
 	}
 
 	// conserved to primitive variables
-	HydroSystem<problem_t>::ConservedToPrimitive(consVar, primVar, nghost_cc_);
+	HydroSystem<problem_t>::ConservedToPrimitive(consVar, primVar, nghost_cc_, eosCache);
 
 	// compute flattening coefficients
-	AMREX_D_TERM(HydroSystem<problem_t>::template ComputeFlatteningCoefficients<FluxDir::X1>(primVar, flatCoefs[0], flatteningGhost);
-		     , HydroSystem<problem_t>::template ComputeFlatteningCoefficients<FluxDir::X2>(primVar, flatCoefs[1], flatteningGhost);
-		     , HydroSystem<problem_t>::template ComputeFlatteningCoefficients<FluxDir::X3>(primVar, flatCoefs[2], flatteningGhost);)
+	AMREX_D_TERM(HydroSystem<problem_t>::template ComputeFlatteningCoefficients<FluxDir::X1>(primVar, flatCoefs[0], flatteningGhost, eosCache);
+		     , HydroSystem<problem_t>::template ComputeFlatteningCoefficients<FluxDir::X2>(primVar, flatCoefs[1], flatteningGhost, eosCache);
+		     , HydroSystem<problem_t>::template ComputeFlatteningCoefficients<FluxDir::X3>(primVar, flatCoefs[2], flatteningGhost, eosCache);)
+
+	// compute interface states
+	AMREX_D_TERM(hydroReconstructFunction<FluxDir::X1>(primVar, leftState[0], rightState[0], flatCoefs[0], flatCoefs[1], flatCoefs[2], reconstructGhost,
+							   flattenShocksGhost, nvars);
+		     , hydroReconstructFunction<FluxDir::X2>(primVar, leftState[1], rightState[1], flatCoefs[0], flatCoefs[1], flatCoefs[2], reconstructGhost,
+							     flattenShocksGhost, nvars);
+		     , hydroReconstructFunction<FluxDir::X3>(primVar, leftState[2], rightState[2], flatCoefs[0], flatCoefs[1], flatCoefs[2], reconstructGhost,
+							     flattenShocksGhost, nvars);)
+
+	// evolve the interface states by dt/2 (MUSCL-Hancock predictor step)
+	// (the cells for which the prediction is rejected are flagged in predictorFlag)
+	if (doPredictor) {
+		AMREX_ALWAYS_ASSERT(predictorFlag != nullptr);
+		HydroSystem<problem_t>::PredictInterfaceStates(consVar, primVar, leftState, rightState, dt_predict, geom[lev].CellSizeArray(),
+							       flattenShocksGhost, *predictorFlag, eosCache);
+	}
 
 	// compute flux functions
-	AMREX_D_TERM(hydroFluxFunction<FluxDir::X1>(primVar, leftState[0], rightState[0], flux[0], facevel[0], flatCoefs[0], flatCoefs[1], flatCoefs[2],
-						    reconstructGhost, nvars);
-		     , hydroFluxFunction<FluxDir::X2>(primVar, leftState[1], rightState[1], flux[1], facevel[1], flatCoefs[0], flatCoefs[1], flatCoefs[2],
-						      reconstructGhost, nvars);
-		     , hydroFluxFunction<FluxDir::X3>(primVar, leftState[2], rightState[2], flux[2], facevel[2], flatCoefs[0], flatCoefs[1], flatCoefs[2],
-						      reconstructGhost, nvars);)
+	AMREX_D_TERM(hydroFluxFunction<FluxDir::X1>(primVar, leftState[0], rightState[0], flux[0], facevel[0], eosCache);
+		     , hydroFluxFunction<FluxDir::X2>(primVar, leftState[1], rightState[1], flux[1], facevel[1], eosCache);
+		     , hydroFluxFunction<FluxDir::X3>(primVar, leftState[2], rightState[2], flux[2], facevel[2], eosCache);)
+
+	// weight the fluxes by the face areas (curvilinear coordinates only)
+	quokka::MultiplyByFaceArea(flux, quokka::CoordGeometry::fromGeometry(geom[lev]), nvars);
 
 	// synchronization point to prevent MultiFabs from going out of scope
 	amrex::Gpu::streamSynchronizeAll();
 
 	// LOW LEVEL DEBUGGING: output all of the temporary MultiFabs
-	if (lowLevelDebuggingOutput_ == 1) {
-		// write primitive cell-centered state
-		std::string plotfile_name = CustomPlotFileName("debug_reconstruction", istep[lev] + 1);
-		WriteSingleLevelPlotfile(plotfile_name, primVar, componentNames_cc_, geom[lev], 0.0, istep[lev] + 1);
-
-		// write flattening coefficients
-		std::string flatx_filename = CustomPlotFileName("debug_flattening_x", istep[lev] + 1);
-		std::string flaty_filename = CustomPlotFileName("debug_flattening_y", istep[lev] + 1);
-		std::string flatz_filename = CustomPlotFileName("debug_flattening_z", istep[lev] + 1);
-		amrex::Vector<std::string> flatCompNames{"chi"};
-		WriteSingleLevelPlotfile(flatx_filename, flatCoefs[0], flatCompNames, geom[lev], 0.0, istep[lev] + 1);
-		WriteSingleLevelPlotfile(flaty_filename, flatCoefs[1], flatCompNames, geom[lev], 0.0, istep[lev] + 1);
-		WriteSingleLevelPlotfile(flatz_filename, flatCoefs[2], flatCompNames, geom[lev], 0.0, istep[lev] + 1);
-
-		// write L interface states
-		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-			if (amrex::ParallelDescriptor::IOProcessor()) {
-				std::filesystem::create_directories(plotfile_name + "/raw_fields/Level_" + std::to_string(lev));
+	// (only supported when they are stored in double precision)
+	if constexpr (isDoublePrecision) {
+		if (lowLevelDebuggingOutput_ == 1) {
+			// write primitive cell-centered state
+			std::string plotfile_name = CustomPlotFileName("debug_reconstruction", istep[lev] + 1);
+			WriteSingleLevelPlotfile(plotfile_name, primVar, componentNames_cc_, geom[lev], 0.0, istep[lev] + 1);
+
+			// write flattening coefficients
+			std::string flatx_filename = CustomPlotFileName("debug_flattening_x", istep[lev] + 1);
+			std::string flaty_filename = CustomPlotFileName("debug_flattening_y", istep[lev] + 1);
+			std::string flatz_filename = CustomPlotFileName("debug_flattening_z", istep[lev] + 1);
+			amrex::Vector<std::string> flatCompNames{"chi"};
+			WriteSingleLevelPlotfile(flatx_filename, flatCoefs[0], flatCompNames, geom[lev], 0.0, istep[lev] + 1);
+			WriteSingleLevelPlotfile(flaty_filename, flatCoefs[1], flatCompNames, geom[lev], 0.0, istep[lev] + 1);
+			WriteSingleLevelPlotfile(flatz_filename, flatCoefs[2], flatCompNames, geom[lev], 0.0, istep[lev] + 1);
+
+			// write L interface states
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				if (amrex::ParallelDescriptor::IOProcessor()) {
+					std::filesystem::create_directories(plotfile_name + "/raw_fields/Level_" + std::to_string(lev));
+				}
+				std::string const fullprefix =
+				    amrex::MultiFabFileFullPrefix(lev, plotfile_name, "raw_fields/Level_", std::string("StateL_") + quokka::face_dir_str[idim]);
+				amrex::VisMF::Write(leftState[idim], fullprefix);
 			}
-			std::string const fullprefix =
-			    amrex::MultiFabFileFullPrefix(lev, plotfile_name, "raw_fields/Level_", std::string("StateL_") + quokka::face_dir_str[idim]);
-			amrex::VisMF::Write(leftState[idim], fullprefix);
-		}
-		// write R interface states
-		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-			if (amrex::ParallelDescriptor::IOProcessor()) {
-				std::filesystem::create_directories(plotfile_name + "/raw_fields/Level_" + std::to_string(lev));
+			// write R interface states
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				if (amrex::ParallelDescriptor::IOProcessor()) {
+					std::filesystem::create_directories(plotfile_name + "/raw_fields/Level_" + std::to_string(lev));
+				}
+				std::string const fullprefix =
+				    amrex::MultiFabFileFullPrefix(lev, plotfile_name, "raw_fields/Level_", std::string("StateR_") + quokka::face_dir_str[idim]);
+				amrex::VisMF::Write(rightState[idim], fullprefix);
 			}
-			std::string const fullprefix =
-			    amrex::MultiFabFileFullPrefix(lev, plotfile_name, "raw_fields/Level_", std::string("StateR_") + quokka::face_dir_str[idim]);
-			amrex::VisMF::Write(rightState[idim], fullprefix);
 		}
 	}
 
@@ -1490,10 +1899,10 @@ auto QuokkaSimulation<problem_t>::computeHydroFluxes(amrex::MultiFab const &cons
 }
 
 template <typename problem_t>
-template <FluxDir DIR>
-void QuokkaSimulation<problem_t>::hydroFluxFunction(amrex::MultiFab const &primVar, amrex::MultiFab &leftState, amrex::MultiFab &rightState,
-						    amrex::MultiFab &flux, amrex::MultiFab &faceVel, amrex::MultiFab const &x1Flat,
-						    amrex::MultiFab const &x2Flat, amrex::MultiFab const &x3Flat, const int ng_reconstruct, const int nvars)
+template <FluxDir DIR, typename fab_t>
+void QuokkaSimulation<problem_t>::hydroReconstructFunction(amrex::FabArray<fab_t> const &primVar, amrex::FabArray<fab_t> &leftState,
+							   amrex::FabArray<fab_t> &rightState, amrex::MultiFab const &x1Flat, amrex::MultiFab const &x2Flat,
+							   amrex::MultiFab const &x3Flat, const int ng_reconstruct, const int ng_flatten, const int nvars)
 {
 	if (reconstructionOrder_ == 3) {
 		HyperbolicSystem<problem_t>::template ReconstructStatesPPM<DIR>(primVar, leftState, rightState, ng_reconstruct, nvars);
@@ -1506,24 +1915,36 @@ void QuokkaSimulation<problem_t>::hydroFluxFunction(amrex::MultiFab const &primV
 	}
 
 	// cell-centered kernel
-	HydroSystem<problem_t>::template FlattenShocks<DIR>(primVar, x1Flat, x2Flat, x3Flat, leftState, rightState, ng_reconstruct, nvars);
+	HydroSystem<problem_t>::template FlattenShocks<DIR>(primVar, x1Flat, x2Flat, x3Flat, leftState, rightState, ng_flatten, nvars);
+}
 
+template <typename problem_t>
+template <FluxDir DIR, typename fab_t>
+void QuokkaSimulation<problem_t>::hydroFluxFunction(amrex::FabArray<fab_t> const &primVar, amrex::FabArray<fab_t> &leftState,
+						    amrex::FabArray<fab_t> &rightState, amrex::MultiFab &flux, amrex::MultiFab &faceVel,
+						    amrex::MultiFab const *eosCache)
+{
 	// interface-centered kernel
 	if constexpr (Physics_Traits<problem_t>::is_mhd_enabled) {
-		HydroSystem<problem_t>::template ComputeFluxes<RiemannSolver::HLLD, DIR>(flux, faceVel, leftState, rightState, primVar, artificialViscosityK_);
+		HydroSystem<problem_t>::template ComputeFluxes<RiemannSolver::HLLD, DIR>(flux, faceVel, leftState, rightState, primVar, artificialViscosityK_,
+											 eosCache);
+	} else if (useHybridRiemannSolver_ == 1) {
+		HydroSystem<problem_t>::template ComputeFluxes<RiemannSolver::HLLC_LLF, DIR>(flux, faceVel, leftState, rightState, primVar,
+											     artificialViscosityK_, eosCache, hybridRiemannParams_);
 	} else {
-		HydroSystem<problem_t>::template ComputeFluxes<RiemannSolver::HLLC, DIR>(flux, faceVel, leftState, rightState, primVar, artificialViscosityK_);
+		HydroSystem<problem_t>::template ComputeFluxes<RiemannSolver::HLLC, DIR>(flux, faceVel, leftState, rightState, primVar, artificialViscosityK_,
+											 eosCache);
 	}
 }
 
 template <typename problem_t>
-auto QuokkaSimulation<problem_t>::computeFOHydroFluxes(amrex::MultiFab const &consVar, const int nvars, const int lev)
+auto QuokkaSimulation<problem_t>::computeFOHydroFluxes(amrex::MultiFab const &consVar, const int nvars, const int lev, amrex::MultiFab const *eosCache)
     -> std::pair<std::array<amrex::MultiFab, AMREX_SPACEDIM>, std::array<amrex::MultiFab, AMREX_SPACEDIM>>
 {
 	BL_PROFILE("QuokkaSimulation::computeFOHydroFluxes()");
 
-	auto ba = grids[lev];
-	auto dm = dmap[lev];
+	auto ba = consVar.boxArray();
+	auto dm = consVar.DistributionMap();
 	const int reconstructRange = 1;
 
 	// allocate temporary MultiFabs
@@ -1542,12 +1963,15 @@ auto QuokkaSimulation<problem_t>::computeFOHydroFluxes(amrex::MultiFab const &co
 	}
 
 	// conserved to primitive variables
-	HydroSystem<problem_t>::ConservedToPrimitive(consVar, primVar, nghost_cc_);
+	HydroSystem<problem_t>::ConservedToPrimitive(consVar, primVar, nghost_cc_, eosCache);
 
 	// compute flux functions
-	AMREX_D_TERM(hydroFOFluxFunction<FluxDir::X1>(primVar, leftState[0], rightState[0], flux[0], facevel[0], reconstructRange, nvars);
-		     , hydroFOFluxFunction<FluxDir::X2>(primVar, leftState[1], rightState[1], flux[1], facevel[1], reconstructRange, nvars);
-		     , hydroFOFluxFunction<FluxDir::X3>(primVar, leftState[2], rightState[2], flux[2], facevel[2], reconstructRange, nvars);)
+	AMREX_D_TERM(hydroFOFluxFunction<FluxDir::X1>(primVar, leftState[0], rightState[0], flux[0], facevel[0], reconstructRange, nvars, eosCache);
+		     , hydroFOFluxFunction<FluxDir::X2>(primVar, leftState[1], rightState[1], flux[1], facevel[1], reconstructRange, nvars, eosCache);
+		     , hydroFOFluxFunction<FluxDir::X3>(primVar, leftState[2], rightState[2], flux[2], facevel[2], reconstructRange, nvars, eosCache);)
+
+	// weight the fluxes by the face areas (curvilinear coordinates only)
+	quokka::MultiplyByFaceArea(flux, quokka::CoordGeometry::fromGeometry(geom[lev]), nvars);
 
 	// synchronization point to prevent MultiFabs from going out of scope
 	amrex::Gpu::streamSynchronizeAll();
@@ -1559,12 +1983,13 @@ auto QuokkaSimulation<problem_t>::computeFOHydroFluxes(amrex::MultiFab const &co
 template <typename problem_t>
 template <FluxDir DIR>
 void QuokkaSimulation<problem_t>::hydroFOFluxFunction(amrex::MultiFab const &primVar, amrex::MultiFab &leftState, amrex::MultiFab &rightState,
-						      amrex::MultiFab &flux, amrex::MultiFab &faceVel, const int ng_reconstruct, const int nvars)
+						      amrex::MultiFab &flux, amrex::MultiFab &faceVel, const int ng_reconstruct, const int nvars,
+						      amrex::MultiFab const *eosCache)
 {
 	// donor-cell reconstruction
 	HydroSystem<problem_t>::template ReconstructStatesConstant<DIR>(primVar, leftState, rightState, ng_reconstruct, nvars);
 	// LLF solver
-	HydroSystem<problem_t>::template ComputeFluxes<RiemannSolver::LLF, DIR>(flux, faceVel, leftState, rightState, primVar, artificialViscosityK_);
+	HydroSystem<problem_t>::template ComputeFluxes<RiemannSolver::LLF, DIR>(flux, faceVel, leftState, rightState, primVar, artificialViscosityK_, eosCache);
 }
 
 template <typename problem_t> void QuokkaSimulation<problem_t>::swapRadiationState(amrex::MultiFab &stateOld, amrex::MultiFab const &stateNew)
@@ -1597,6 +2022,13 @@ void QuokkaSimulation<problem_t>::subcycleRadiationAtLevel(int lev, amrex::Real
 	AMREX_ALWAYS_ASSERT(nsubSteps <= (maxSubsteps_ + 1));
 	AMREX_ALWAYS_ASSERT(dt_radiation > 0.0);
 
+	// if radiation is not solved on the next-finer level, record the change of the state due to the matter-radiation exchange,
+	// so that it can be transferred to (or from) the finer levels when they are synchronized (see AverageDownTo)
+	const bool recordExchange = !radiationSolvedAtLevel(lev + 1) && (lev < finest_level);
+	if (recordExchange) {
+		prepareRadExchangeDelta(lev);
+	}
+
 	// perform subcycle
 	auto const &dx = geom[lev].CellSizeArray();
 	amrex::Real time_subcycle = time;
@@ -1626,6 +2058,9 @@ void QuokkaSimulation<problem_t>::subcycleRadiationAtLevel(int lev, amrex::Real
 
 		if constexpr (IMEX_a22 > 0.0) {
 			// matter-radiation exchange source terms of stage 1
+			if (recordExchange) {
+				amrex::MultiFab::Subtract(radExchangeDelta_[lev], state_new_cc_[lev], 0, 0, nvarTotal_cc_, 0);
+			}
 
 			for (amrex::MFIter iter(state_new_cc_[lev]); iter.isValid(); ++iter) {
 				const amrex::Box &indexRange = iter.validbox();
@@ -1638,6 +2073,10 @@ void QuokkaSimulation<problem_t>::subcycleRadiationAtLevel(int lev, amrex::Real
 				operatorSplitSourceTerms(stateNew, indexRange, time_subcycle, dt_radiation, 1, dx, prob_lo, prob_hi, p_iteration_counter,
 							 p_iteration_failure_counter);
 			}
+
+			if (recordExchange) {
+				amrex::MultiFab::Add(radExchangeDelta_[lev], state_new_cc_[lev], 0, 0, nvarTotal_cc_, 0);
+			}
 		}
 
 		// Stage 2: advance hyperbolic radiation subsystem using midpoint RK2 method, starting from state_old_cc_ to state_new_cc_
@@ -1647,6 +2086,9 @@ void QuokkaSimulation<problem_t>::subcycleRadiationAtLevel(int lev, amrex::Real
 		// new hydro state is stored in state_new_cc_ (always the case during radiation update)
 
 		// Add the matter-radiation exchange source terms to the radiation subsystem and evolve by (1 - IMEX_a32) * dt
+		if (recordExchange) {
+			amrex::MultiFab::Subtract(radExchangeDelta_[lev], state_new_cc_[lev], 0, 0, nvarTotal_cc_, 0);
+		}
 		for (amrex::MFIter iter(state_new_cc_[lev]); iter.isValid(); ++iter) {
 			const amrex::Box &indexRange = iter.validbox();
 			auto const &stateNew = state_new_cc_[lev].array(iter);
@@ -1656,35 +2098,44 @@ void QuokkaSimulation<problem_t>::subcycleRadiationAtLevel(int lev, amrex::Real
 			operatorSplitSourceTerms(stateNew, indexRange, time_subcycle, dt_radiation, 2, dx, prob_lo, prob_hi, p_iteration_counter,
 						 p_iteration_failure_counter);
 		}
+		if (recordExchange) {
+			amrex::MultiFab::Add(radExchangeDelta_[lev], state_new_cc_[lev], 0, 0, nvarTotal_cc_, 0);
+		}
 
-		if (print_rad_counter_) {
+		// the iteration counts are only needed for diagnostics, so avoid the device-to-host copy otherwise
+		if (print_rad_counter_ || countRadNewtonIterations_) {
 			auto h_iteration_counter = iteration_counter.copyToHost();
-			long global_solver_count = h_iteration_counter[0];	      // number of Newton-Raphson solvings
-			long global_iteration_sum = h_iteration_counter[1];	      // sum of Newton-Raphson iterations
-			int global_iteration_max = h_iteration_counter[2];	      // max number of Newton-Raphson iterations
-			long global_decoupled_iteration_sum = h_iteration_counter[3]; // sum of decoupled gas-dust Newton-Raphson iterations
-
-			amrex::ParallelDescriptor::ReduceLongSum(global_solver_count);
-			amrex::ParallelDescriptor::ReduceLongSum(global_iteration_sum);
-			amrex::ParallelDescriptor::ReduceIntMax(global_iteration_max);
-			amrex::ParallelDescriptor::ReduceLongSum(global_decoupled_iteration_sum);
-
-			if (amrex::ParallelDescriptor::IOProcessor()) {
-				const auto n_cells = CountCells(lev);
-				amrex::Print() << "time_subcycle = " << time_subcycle << ", total number of cells updated is " << n_cells << "\n";
-				if (n_cells > 0 && global_solver_count > 0) {
-					const double global_iteration_mean =
-					    static_cast<double>(global_iteration_sum) / static_cast<double>(global_solver_count);
-					const double global_solving_mean =
-					    static_cast<double>(global_solver_count) / static_cast<double>(n_cells) / 2.0; // 2 stages
-					const double global_decoupled_iteration_mean =
-					    static_cast<double>(global_decoupled_iteration_sum) / static_cast<double>(global_solver_count);
-					amrex::Print() << "The average number of Newton-Raphson solvings per IMEX stage is " << global_solving_mean
-						       << ", (mean, max) number of Newton-Raphson iterations are " << global_iteration_mean << ", "
-						       << global_iteration_max << ".\n";
-					if constexpr (ISM_Traits<problem_t>::enable_dust_gas_thermal_coupling_model) {
-						amrex::Print() << "The fraction of gas-dust interactions that are decoupled is "
-							       << global_decoupled_iteration_mean << "\n";
+			radNewtonSolves_ += h_iteration_counter[0];
+			radNewtonIterations_ += h_iteration_counter[1];
+
+			if (print_rad_counter_) {
+				long global_solver_count = h_iteration_counter[0];	      // number of Newton-Raphson solvings
+				long global_iteration_sum = h_iteration_counter[1];	      // sum of Newton-Raphson iterations
+				int global_iteration_max = h_iteration_counter[2];	      // max number of Newton-Raphson iterations
+				long global_decoupled_iteration_sum = h_iteration_counter[3]; // sum of decoupled gas-dust Newton-Raphson iterations
+
+				amrex::ParallelDescriptor::ReduceLongSum(global_solver_count);
+				amrex::ParallelDescriptor::ReduceLongSum(global_iteration_sum);
+				amrex::ParallelDescriptor::ReduceIntMax(global_iteration_max);
+				amrex::ParallelDescriptor::ReduceLongSum(global_decoupled_iteration_sum);
+
+				if (amrex::ParallelDescriptor::IOProcessor()) {
+					const auto n_cells = CountCells(lev);
+					amrex::Print() << "time_subcycle = " << time_subcycle << ", total number of cells updated is " << n_cells << "\n";
+					if (n_cells > 0 && global_solver_count > 0) {
+						const double global_iteration_mean =
+						    static_cast<double>(global_iteration_sum) / static_cast<double>(global_solver_count);
+						const double global_solving_mean =
+						    static_cast<double>(global_solver_count) / static_cast<double>(n_cells) / 2.0; // 2 stages
+						const double global_decoupled_iteration_mean =
+						    static_cast<double>(global_decoupled_iteration_sum) / static_cast<double>(global_solver_count);
+						amrex::Print() << "The average number of Newton-Raphson solvings per IMEX stage is " << global_solving_mean
+							       << ", (mean, max) number of Newton-Raphson iterations are " << global_iteration_mean << ", "
+							       << global_iteration_max << ".\n";
+						if constexpr (ISM_Traits<problem_t>::enable_dust_gas_thermal_coupling_model) {
+							amrex::Print() << "The fraction of gas-dust interactions that are decoupled is "
+								       << global_decoupled_iteration_mean << "\n";
+						}
 					}
 				}
 			}
@@ -1721,6 +2172,174 @@ void QuokkaSimulation<problem_t>::subcycleRadiationAtLevel(int lev, amrex::Real
 	}
 }
 
+template <typename problem_t> void QuokkaSimulation<problem_t>::prepareRadExchangeDelta(int lev)
+{
+	// (re-)define the exchange record if the level has been regridded since it was last used
+	amrex::MultiFab &delta = radExchangeDelta_[lev];
+	if (!delta.ok() || (delta.boxArray() != grids[lev]) || (delta.DistributionMap() != dmap[lev])) {
+		delta.define(grids[lev], dmap[lev], nvarTotal_cc_, 0);
+		delta.setVal(0.);
+	}
+}
+
+template <typename problem_t> void QuokkaSimulation<problem_t>::fillRadiationFromCoarse(int lev, amrex::Real time)
+{
+	BL_PROFILE("QuokkaSimulation::fillRadiationFromCoarse()");
+
+	// interpolate the coarse state linearly in time
+	// (the coarse level has already been advanced to a time >= 'time')
+	const int ncomp = nvarTotal_cc_;
+	amrex::MultiFab crse(grids[lev - 1], dmap[lev - 1], ncomp, 0);
+	const amrex::Real t_old = tOld_[lev - 1];
+	const amrex::Real t_new = tNew_[lev - 1];
+	if ((t_new > t_old) && (time < t_new) && !amrex::almostEqual(time, t_new, 5)) {
+		const amrex::Real w_new = std::max((time - t_old) / (t_new - t_old), 0.0);
+		amrex::MultiFab::LinComb(crse, 1.0 - w_new, state_old_cc_[lev - 1], 0, w_new, state_new_cc_[lev - 1], 0, 0, ncomp, 0);
+	} else {
+		amrex::MultiFab::Copy(crse, state_new_cc_[lev - 1], 0, 0, ncomp, 0);
+	}
+
+	amrex::GpuBndryFuncFab<setBoundaryFunctor<problem_t>> boundaryFunctor(setBoundaryFunctor<problem_t>{});
+	amrex::PhysBCFunct<amrex::GpuBndryFuncFab<setBoundaryFunctor<problem_t>>> finePhysicalBoundaryFunctor(geom[lev], BCs_cc_, boundaryFunctor);
+	amrex::PhysBCFunct<amrex::GpuBndryFuncFab<setBoundaryFunctor<problem_t>>> coarsePhysicalBoundaryFunctor(geom[lev - 1], BCs_cc_, boundaryFunctor);
+
+	// interpolate all variables (the boundary conditions may depend on them), but only copy the radiation variables
+	amrex::MultiFab fine(grids[lev], dmap[lev], ncomp, 0);
+	amrex::InterpFromCoarseLevel(fine, time, crse, 0, 0, ncomp, geom[lev - 1], geom[lev], coarsePhysicalBoundaryFunctor, 0, finePhysicalBoundaryFunctor, 0,
+				     refRatio(lev - 1), getAmrInterpolaterCellCentered(), BCs_cc_, 0);
+	amrex::MultiFab::Copy(state_new_cc_[lev], fine, nstartHyperbolic_, nstartHyperbolic_, ncompHyperbolic_, 0);
+}
+
+template <typename problem_t> void QuokkaSimulation<problem_t>::advanceRadiationAboveMaxLevel(int lev, amrex::Real time, amrex::Real dt_lev)
+{
+	BL_PROFILE("QuokkaSimulation::advanceRadiationAboveMaxLevel()");
+
+	// the radiation variables are interpolated from the next-coarser level
+	fillRadiationFromCoarse(lev, time + dt_lev);
+
+	if (radiationCoupleAboveMaxLevel_ == 0) {
+		// the gas is heated/cooled by the exchange on radiation.max_level when the levels are synchronized
+		return;
+	}
+
+	// matter-radiation exchange with the interpolated radiation field, using a single implicit step
+	// (the stage-2 update advances the gas and radiation by (1 - IMEX_a32) * dt).
+	// The change of the radiation variables is transferred to the coarse level when the levels are synchronized.
+	prepareRadExchangeDelta(lev);
+	amrex::MultiFab::Subtract(radExchangeDelta_[lev], state_new_cc_[lev], 0, 0, nvarTotal_cc_, 0);
+
+	amrex::Gpu::Buffer<int> iteration_failure_counter({0, 0, 0});
+	amrex::Gpu::Buffer<int> iteration_counter({0, 0, 0, 0});
+	int *p_iteration_failure_counter = iteration_failure_counter.data();
+	int *p_iteration_counter = iteration_counter.data();
+
+	auto const &dx = geom[lev].CellSizeArray();
+	auto const &prob_lo = geom[lev].ProbLoArray();
+	auto const &prob_hi = geom[lev].ProbHiArray();
+	const amrex::Real dt_exchange = dt_lev / (1.0 - IMEX_a32);
+	for (amrex::MFIter iter(state_new_cc_[lev]); iter.isValid(); ++iter) {
+		const amrex::Box &indexRange = iter.validbox();
+		auto const &stateNew = state_new_cc_[lev].array(iter);
+		operatorSplitSourceTerms(stateNew, indexRange, time, dt_exchange, 2, dx, prob_lo, prob_hi, p_iteration_counter, p_iteration_failure_counter);
+	}
+
+	amrex::MultiFab::Add(radExchangeDelta_[lev], state_new_cc_[lev], 0, 0, nvarTotal_cc_, 0);
+
+	auto h_iteration_failure_counter = iteration_failure_counter.copyToHost();
+	long nfail = static_cast<long>(h_iteration_failure_counter[0]) + h_iteration_failure_counter[1] + h_iteration_failure_counter[2];
+	amrex::ParallelDescriptor::ReduceLongSum(nfail);
+	if (nfail > 0) {
+		amrex::Abort("Matter-radiation exchange above radiation.max_level failed to converge!");
+	}
+}
+
+template <typename problem_t> void QuokkaSimulation<problem_t>::injectRadExchangeDelta()
+{
+	BL_PROFILE("QuokkaSimulation::injectRadExchangeDelta()");
+
+	// add the change of the gas variables due to the matter-radiation exchange on radiation.max_level to all finer levels
+	// (piecewise-constant in each coarse cell, so that the average over the fine cells equals the coarse change)
+	const int ncomp = nstartHyperbolic_;
+	for (int lev = radiationMaxLevel_ + 1; lev <= finest_level; ++lev) {
+		prepareRadExchangeDelta(lev);
+		amrex::IntVect const rr = refRatio(lev - 1);
+		amrex::MultiFab cdelta(amrex::coarsen(grids[lev], rr), dmap[lev], ncomp, 0);
+		cdelta.ParallelCopy(radExchangeDelta_[lev - 1], 0, 0, ncomp);
+
+		auto const &crse = cdelta.const_arrays();
+		auto const &fine = radExchangeDelta_[lev].arrays();
+		auto const &state = state_new_cc_[lev].arrays();
+		amrex::ParallelFor(state_new_cc_[lev], amrex::IntVect(0), ncomp, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k, int n) noexcept {
+			const amrex::IntVect iv_crse = amrex::coarsen(amrex::IntVect(AMREX_D_DECL(i, j, k)), rr);
+			const amrex::Real d = crse[bx](iv_crse, n);
+			fine[bx](i, j, k, n) = d;
+			state[bx](i, j, k, n) += d;
+		});
+
+		// a fine cell that is colder than the average of its coarse cell can lose more energy than it has,
+		// so the density and temperature floors are enforced, as after the hydro update
+		// (this only breaks the conservation of the total energy in the cells where a floor is applied)
+		HydroSystem<problem_t>::EnforceLimits(densityFloor_, tempFloor_, state_new_cc_[lev]);
+	}
+}
+
+template <typename problem_t> void QuokkaSimulation<problem_t>::AverageDownTo(int crse_lev)
+{
+	if (!Physics_Traits<problem_t>::is_radiation_enabled || radiationSolvedAtLevel(crse_lev + 1)) {
+		AMRSimulation<problem_t>::AverageDownTo(crse_lev);
+		return;
+	}
+
+	BL_PROFILE("QuokkaSimulation::AverageDownTo()");
+
+	// the exchange records are only defined during the time evolution (not when averaging down the initial conditions)
+	auto hasExchangeRecord = [this](int lev) {
+		amrex::MultiFab const &delta = radExchangeDelta_[lev];
+		return delta.ok() && (delta.boxArray() == grids[lev]) && (delta.DistributionMap() == dmap[lev]);
+	};
+	const bool isMaxRadLevel = (crse_lev == radiationMaxLevel_);
+	const bool coupleAbove = (radiationCoupleAboveMaxLevel_ != 0);
+
+	// the gas on the finer levels receives the exchange on radiation.max_level
+	// (this is done before averaging down, so that the covered coarse cells keep the exchange)
+	if (isMaxRadLevel && !coupleAbove && hasExchangeRecord(crse_lev)) {
+		injectRadExchangeDelta();
+	}
+
+	// average down all variables, except the radiation variables of the coarse level
+	amrex::MultiFab radCrse(grids[crse_lev], dmap[crse_lev], ncompHyperbolic_, 0);
+	amrex::MultiFab::Copy(radCrse, state_new_cc_[crse_lev], nstartHyperbolic_, 0, ncompHyperbolic_, 0);
+	AMRSimulation<problem_t>::AverageDownTo(crse_lev);
+	amrex::MultiFab::Copy(state_new_cc_[crse_lev], radCrse, 0, nstartHyperbolic_, ncompHyperbolic_, 0);
+
+	// in the covered coarse cells, the radiation receives the exchange with the fine gas instead of the coarse gas
+	// (which has been overwritten by averaging down)
+	if (coupleAbove && hasExchangeRecord(crse_lev) && hasExchangeRecord(crse_lev + 1)) {
+		if (isMaxRadLevel) {
+			amrex::MultiFab corr(grids[crse_lev], dmap[crse_lev], nvarTotal_cc_, 0);
+			amrex::MultiFab::Copy(corr, radExchangeDelta_[crse_lev], nstartHyperbolic_, nstartHyperbolic_, ncompHyperbolic_, 0);
+			amrex::average_down(radExchangeDelta_[crse_lev + 1], corr, geom[crse_lev + 1], geom[crse_lev], nstartHyperbolic_, ncompHyperbolic_,
+					    refRatio(crse_lev));
+			amrex::MultiFab::Subtract(corr, radExchangeDelta_[crse_lev], nstartHyperbolic_, nstartHyperbolic_, ncompHyperbolic_, 0);
+			amrex::MultiFab::Add(state_new_cc_[crse_lev], corr, nstartHyperbolic_, nstartHyperbolic_, ncompHyperbolic_, 0);
+		} else {
+			amrex::average_down(radExchangeDelta_[crse_lev + 1], radExchangeDelta_[crse_lev], geom[crse_lev + 1], geom[crse_lev],
+					    nstartHyperbolic_, ncompHyperbolic_, refRatio(crse_lev));
+		}
+		radExchangeDelta_[crse_lev + 1].setVal(0.);
+	}
+
+	if (isMaxRadLevel) {
+		if (hasExchangeRecord(crse_lev)) {
+			radExchangeDelta_[crse_lev].setVal(0.);
+		}
+		// update the interpolated radiation variables on the finer levels
+		for (int lev = crse_lev + 1; lev <= finest_level; ++lev) {
+			fillRadiationFromCoarse(lev, tNew_[lev]);
+		}
+	}
+}
+
 template <typename problem_t>
 void QuokkaSimulation<problem_t>::advanceRadiationSubstepAtLevel(int lev, amrex::Real time, amrex::Real dt_radiation, int const iter_count,
 								 int const /*nsubsteps*/, amrex::YAFluxRegister *fr_as_crse, amrex::YAFluxRegister *fr_as_fine)
@@ -1752,8 +2371,8 @@ void QuokkaSimulation<problem_t>::advanceRadiationSubstepAtLevel(int lev, amrex:
 		    {AMREX_D_DECL(fluxDiffusiveArrays[0].const_array(), fluxDiffusiveArrays[1].const_array(), fluxDiffusiveArrays[2].const_array())},
 		    dt_radiation, dx, indexRange, ncompHyperbolic_);
 
-		if (do_reflux) {
-			// increment flux registers
+		if (do_reflux || surfaceFluxes_.enabled()) {
+			// increment flux registers (and surface flux totals)
 			// WARNING: as written, diffusive flux correction is not compatible with reflux!!
 			auto expandedFluxes = expandFluxArrays(fluxArrays, nstartHyperbolic_, state_new_cc_[lev].nComp());
 			incrementFluxRegisters(iter, fr_as_crse, fr_as_fine, expandedFluxes, lev, 0.5 * dt_radiation);
@@ -1778,8 +2397,8 @@ void QuokkaSimulation<problem_t>::advanceRadiationSubstepAtLevel(int lev, amrex:
 		    {AMREX_D_DECL(fluxDiffusiveArrays[0].const_array(), fluxDiffusiveArrays[1].const_array(), fluxDiffusiveArrays[2].const_array())},
 		    dt_radiation, dx, indexRange, ncompHyperbolic_);
 
-		if (do_reflux) {
-			// increment flux registers
+		if (do_reflux || surfaceFluxes_.enabled()) {
+			// increment flux registers (and surface flux totals)
 			// WARNING: as written, diffusive flux correction is not compatible with reflux!!
 			auto expandedFluxes = expandFluxArrays(fluxArrays, nstartHyperbolic_, state_new_cc_[lev].nComp());
 			incrementFluxRegisters(iter, fr_as_crse, fr_as_fine, expandedFluxes, lev, 0.5 * dt_radiation);
@@ -1811,8 +2430,8 @@ void QuokkaSimulation<problem_t>::advanceRadiationForwardEuler(int lev, amrex::R
 		    {AMREX_D_DECL(fluxDiffusiveArrays[0].const_array(), fluxDiffusiveArrays[1].const_array(), fluxDiffusiveArrays[2].const_array())},
 		    dt_radiation, dx, indexRange, ncompHyperbolic_);
 
-		if (do_reflux) {
-			// increment flux registers
+		if (do_reflux || surfaceFluxes_.enabled()) {
+			// increment flux registers (and surface flux totals)
 			// WARNING: as written, diffusive flux correction is not compatible with reflux!!
 			auto expandedFluxes = expandFluxArrays(fluxArrays, nstartHyperbolic_, state_new_cc_[lev].nComp());
 			incrementFluxRegisters(iter, fr_as_crse, fr_as_fine, expandedFluxes, lev, 0.5 * dt_radiation);
@@ -1847,8 +2466,8 @@ void QuokkaSimulation<problem_t>::advanceRadiationMidpointRK2(int lev, amrex::Re
 		    {AMREX_D_DECL(fluxDiffusiveArrays[0].const_array(), fluxDiffusiveArrays[1].const_array(), fluxDiffusiveArrays[2].const_array())},
 		    dt_radiation, dx, indexRange, ncompHyperbolic_);
 
-		if (do_reflux) {
-			// increment flux registers
+		if (do_reflux || surfaceFluxes_.enabled()) {
+			// increment flux registers (and surface flux totals)
 			// WARNING: as written, diffusive flux correction is not compatible with reflux!!
 			auto expandedFluxes = expandFluxArrays(fluxArrays, nstartHyperbolic_, state_new_cc_[lev].nComp());
 			incrementFluxRegisters(iter, fr_as_crse, fr_as_fine, expandedFluxes, lev, 0.5 * dt_radiation);
@@ -1877,7 +2496,7 @@ void QuokkaSimulation<problem_t>::operatorSplitSourceTerms(amrex::Array4<amrex::
 								p_iteration_counter, p_iteration_failure_counter);
 	} else {
 		RadSystem<problem_t>::AddSourceTermsMultiGroup(stateNew, radEnergySource.const_array(), indexRange, dt, stage, dustGasInteractionCoeff_,
-							       p_iteration_counter, p_iteration_failure_counter);
+							       p_iteration_counter, p_iteration_failure_counter, radiationGreyInitialGuess_ == 1);
 	}
 }
 
@@ -65,6 +65,27 @@ template <typename problem_t> class EOS
 	ComputeSoundSpeed(amrex::Real rho, amrex::Real Pressure, std::optional<amrex::GpuArray<amrex::Real, nmscalars_>> const &massScalars = {})
 	    -> amrex::Real;
 
+	[[nodiscard]] AMREX_FORCE_INLINE AMREX_GPU_HOST_DEVICE static auto
+	ComputeEffectiveGamma(amrex::Real rho, amrex::Real Eint, std::optional<amrex::GpuArray<amrex::Real, nmscalars_>> const &massScalars = {})
+	    -> amrex::Real;
+
+	// closed-form EOS evaluations given a (cached) effective adiabatic index
+	[[nodiscard]] AMREX_FORCE_INLINE AMREX_GPU_HOST_DEVICE static auto ComputePressureFromGamma(amrex::Real Eint, amrex::Real gamma_eff) -> amrex::Real
+	{
+		return (gamma_eff - 1.0) * Eint;
+	}
+
+	[[nodiscard]] AMREX_FORCE_INLINE AMREX_GPU_HOST_DEVICE static auto ComputeEintFromPresGamma(amrex::Real Pressure, amrex::Real gamma_eff) -> amrex::Real
+	{
+		return Pressure / (gamma_eff - 1.0);
+	}
+
+	[[nodiscard]] AMREX_FORCE_INLINE AMREX_GPU_HOST_DEVICE static auto ComputeSoundSpeedFromGamma(amrex::Real rho, amrex::Real Pressure,
+												       amrex::Real gamma_eff) -> amrex::Real
+	{
+		return std::sqrt(gamma_eff * Pressure / rho);
+	}
+
       private:
 	static constexpr amrex::Real gamma_ = EOS_Traits<problem_t>::gamma;
 	static constexpr amrex::Real boltzmann_constant_ = EOS_Traits<problem_t>::boltzmann_constant;
@@ -382,6 +403,42 @@ AMREX_FORCE_INLINE AMREX_GPU_HOST_DEVICE auto EOS<problem_t>::ComputeSoundSpeed(
 	return cs;
 }
 
+template <typename problem_t>
+AMREX_FORCE_INLINE AMREX_GPU_HOST_DEVICE auto
+EOS<problem_t>::ComputeEffectiveGamma(amrex::Real rho, amrex::Real Eint, std::optional<amrex::GpuArray<amrex::Real, nmscalars_>> const &massScalars)
+    -> amrex::Real
+{
+	// return the effective adiabatic index (1 + P / Eint),
+	// such that P = (gamma_eff - 1) Eint and cs^2 = gamma_eff P / rho reproduce the full EOS for this composition
+	amrex::Real gamma_eff = gamma_;
+
+#ifdef CHEMISTRY
+	eos_t chemstate;
+	chemstate.rho = rho;
+	chemstate.e = Eint / rho;
+	// initialize array of number densities
+	for (int ii = 0; ii < NumSpec; ++ii) {
+		chemstate.xn[ii] = -1.0;
+	}
+
+	if (massScalars) {
+		const auto &massArray = *massScalars;
+		for (int nn = 0; nn < nmscalars_; ++nn) {
+			chemstate.xn[nn] = massArray[nn] / spmasses[nn]; // massScalars are partial densities (massFractions * rho)
+		}
+	}
+
+	// avoid dividing by zero in vacuum or in (not yet sync'd) ghost cells
+	if (Eint > 0. && rho > 0.) {
+		eos(eos_input_re, chemstate);
+		gamma_eff = 1.0 + chemstate.p / Eint;
+	}
+#else
+	amrex::ignore_unused(rho, Eint, massScalars);
+#endif
+	return gamma_eff;
+}
+
 } // namespace quokka
 
 #endif // EOS_HPP_
@@ -10,12 +10,15 @@
 ///
 
 // c++ headers
+#include <array>
 #include <cmath>
+#include <limits>
 
 // library headers
 #include "AMReX.H"
 #include "AMReX_Array4.H"
 #include "AMReX_BLassert.H"
+#include "AMReX_ParallelReduce.H"
 #include "AMReX_REAL.H"
 #include "AMReX_iMultiFab.H"
 
@@ -28,6 +31,7 @@
 #include "physics_info.hpp"
 #include "radiation/radiation_system.hpp"
 #include "util/ArrayView.hpp"
+#include "util/CoordGeometry.hpp"
 #include "util/valarray.hpp"
 
 // Microphysics headers
@@ -40,7 +44,16 @@ template <typename problem_t> struct HydroSystem_Traits {
 	static constexpr bool reconstruct_eint = true;
 };
 
-enum class RiemannSolver { HLLC, LLF, HLLD };
+// HLLC_LLF selects LLF at faces flagged by a shock/near-vacuum detector, and HLLC elsewhere
+enum class RiemannSolver { HLLC, LLF, HLLD, HLLC_LLF };
+
+// thresholds of the per-face detector used by the hybrid (HLLC_LLF) Riemann solver
+// (these defaults are untuned starting values; the hybrid solver is off unless hydro.use_hybrid_riemann_solver = 1)
+struct HybridRiemannParams {
+	amrex::Real pressureRatio = 5.0;  // max(P_L, P_R) / min(P_L, P_R) above which LLF is used
+	amrex::Real densityRatio = 100.0; // max(rho_L, rho_R) / min(rho_L, rho_R) above which LLF is used
+	amrex::Real compression = 1.0;	  // (u_L - u_R) / min(cs_L, cs_R) above which LLF is used
+};
 
 /// Class for the Euler equations of inviscid hydrodynamics
 ///
@@ -71,7 +84,19 @@ template <typename problem_t> class HydroSystem : public HyperbolicSystem<proble
 		primScalar0_index // first passive scalar (only present if nscalars > 0!)
 	};
 
-	static void ConservedToPrimitive(amrex::MultiFab const &cons_mf, amrex::MultiFab &primVar_mf, int nghost);
+	// components of the (optional) per-cell EOS cache
+	enum eosCacheIndex {
+		gammaEff_index = 0, // effective adiabatic index (1 + P / Eint)
+		nEOSCacheVars
+	};
+
+	template <typename fab_t>
+	static void ConservedToPrimitive(amrex::MultiFab const &cons_mf, amrex::FabArray<fab_t> &primVar_mf, int nghost,
+					 amrex::MultiFab const *eosCache_mf = nullptr);
+
+	static auto IsSinglePrecisionSafe(amrex::MultiFab const &cons_mf, int nghost) -> bool;
+
+	static void ComputeEOSCache(amrex::MultiFab const &cons_mf, amrex::MultiFab &eosCache_mf, int nghost);
 
 	static auto maxSignalSpeedLocal(amrex::MultiFab const &cons) -> amrex::Real;
 
@@ -96,7 +121,7 @@ template <typename problem_t> class HydroSystem : public HyperbolicSystem<proble
 	AMREX_GPU_DEVICE static auto isStateValid(amrex::Array4<const amrex::Real> const &cons, int i, int j, int k) -> bool;
 
 	static void ComputeRhsFromFluxes(amrex::MultiFab &rhs_mf, std::array<amrex::MultiFab, AMREX_SPACEDIM> const &fluxArray,
-					 amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx, int nvars);
+					 amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx, int nvars, quokka::CoordGeometry const &coordGeom = {});
 
 	static void PredictStep(amrex::MultiFab const &consVarOld, amrex::MultiFab &consVarNew, amrex::MultiFab const &rhs, double dt, int nvars,
 				amrex::iMultiFab &redoFlag_mf);
@@ -109,22 +134,42 @@ template <typename problem_t> class HydroSystem : public HyperbolicSystem<proble
 	static void EnforceLimits(amrex::Real densityFloor, amrex::Real tempFloor, amrex::MultiFab &state_mf);
 
 	static void AddInternalEnergyPdV(amrex::MultiFab &rhs_mf, amrex::MultiFab const &consVar_mf, amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx,
-					 std::array<amrex::MultiFab, AMREX_SPACEDIM> const &faceVelArray, amrex::iMultiFab const &redoFlag_mf);
+					 std::array<amrex::MultiFab, AMREX_SPACEDIM> const &faceVelArray, amrex::iMultiFab const &redoFlag_mf,
+					 amrex::MultiFab const *eosCache_mf = nullptr, quokka::CoordGeometry const &coordGeom = {});
+
+	static void AddGeometricSources(amrex::MultiFab &rhs_mf, amrex::MultiFab const &consVar_mf, quokka::CoordGeometry const &coordGeom, amrex::Real weight,
+					amrex::MultiFab const *eosCache_mf = nullptr);
 
 	static void SyncDualEnergy(amrex::MultiFab &consVar_mf);
 
-	template <RiemannSolver RIEMANN, FluxDir DIR>
-	static void ComputeFluxes(amrex::MultiFab &x1Flux_mf, amrex::MultiFab &x1FaceVel_mf, amrex::MultiFab const &x1LeftState_mf,
-				  amrex::MultiFab const &x1RightState_mf, amrex::MultiFab const &primVar_mf, amrex::Real K_visc);
+	template <RiemannSolver RIEMANN, FluxDir DIR, typename fab_t>
+	static void ComputeFluxes(amrex::MultiFab &x1Flux_mf, amrex::MultiFab &x1FaceVel_mf, amrex::FabArray<fab_t> const &x1LeftState_mf,
+				  amrex::FabArray<fab_t> const &x1RightState_mf, amrex::FabArray<fab_t> const &primVar_mf, amrex::Real K_visc,
+				  amrex::MultiFab const *eosCache_mf = nullptr, HybridRiemannParams const &hybridParams = {});
+
+	AMREX_GPU_DEVICE static auto isStrongShockOrVacuum(quokka::HydroState<nscalars_, nmscalars_> const &sL,
+							   quokka::HydroState<nscalars_, nmscalars_> const &sR, HybridRiemannParams const &params) -> bool;
 
 	template <FluxDir DIR>
 	static void ComputeFirstOrderFluxes(amrex::Array4<const amrex::Real> const &consVar, array_t &x1FluxDiffusive, amrex::Box const &indexRange);
 
-	template <FluxDir DIR> static void ComputeFlatteningCoefficients(amrex::MultiFab const &primVar_mf, amrex::MultiFab &x1Chi_mf, int nghost);
+	template <FluxDir DIR, typename fab_t>
+	static void ComputeFlatteningCoefficients(amrex::FabArray<fab_t> const &primVar_mf, amrex::MultiFab &x1Chi_mf, int nghost,
+						  amrex::MultiFab const *eosCache_mf = nullptr);
 
-	template <FluxDir DIR>
-	static void FlattenShocks(amrex::MultiFab const &q_mf, amrex::MultiFab const &x1Chi_mf, amrex::MultiFab const &x2Chi_mf,
-				  amrex::MultiFab const &x3Chi_mf, amrex::MultiFab &x1LeftState_mf, amrex::MultiFab &x1RightState_mf, int nghost, int nvars);
+	template <FluxDir DIR, typename fab_t>
+	static void FlattenShocks(amrex::FabArray<fab_t> const &q_mf, amrex::MultiFab const &x1Chi_mf, amrex::MultiFab const &x2Chi_mf,
+				  amrex::MultiFab const &x3Chi_mf, amrex::FabArray<fab_t> &x1LeftState_mf, amrex::FabArray<fab_t> &x1RightState_mf, int nghost,
+				  int nvars);
+
+	template <typename fab_t>
+	static void PredictInterfaceStates(amrex::MultiFab const &cons_mf, amrex::FabArray<fab_t> const &primVar_mf,
+					   std::array<amrex::FabArray<fab_t>, AMREX_SPACEDIM> &leftState_mf,
+					   std::array<amrex::FabArray<fab_t>, AMREX_SPACEDIM> &rightState_mf, amrex::Real dt,
+					   amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &dx, int nghost, amrex::iMultiFab &predictorFlag_mf,
+					   amrex::MultiFab const *eosCache_mf = nullptr);
+
+	static void AddPredictorRedoFlags(amrex::iMultiFab &redoFlag_mf, amrex::iMultiFab const &predictorFlag_mf);
 
 	// C++ does not allow constexpr to be uninitialized, even in a templated
 	// class!
@@ -135,11 +180,18 @@ template <typename problem_t> class HydroSystem : public HyperbolicSystem<proble
 	static constexpr bool reconstruct_eint = HydroSystem_Traits<problem_t>::reconstruct_eint;
 };
 
-template <typename problem_t> void HydroSystem<problem_t>::ConservedToPrimitive(amrex::MultiFab const &cons_mf, amrex::MultiFab &primVar_mf, const int nghost)
+template <typename problem_t>
+template <typename fab_t>
+void HydroSystem<problem_t>::ConservedToPrimitive(amrex::MultiFab const &cons_mf, amrex::FabArray<fab_t> &primVar_mf, const int nghost,
+						  amrex::MultiFab const *eosCache_mf)
 {
 	// convert conserved to primitive variables
+	// (the primitive variables may be stored in lower precision than the conserved variables)
 	auto const &cons = cons_mf.const_arrays();
 	auto const &primVar = primVar_mf.arrays();
+	// if no EOS cache is given, the cons arrays are captured instead but never read
+	const bool useEOSCache = (eosCache_mf != nullptr);
+	auto const &eosCache = useEOSCache ? eosCache_mf->const_arrays() : cons_mf.const_arrays();
 	amrex::IntVect ng{AMREX_D_DECL(nghost, nghost, nghost)};
 
 	amrex::ParallelFor(cons_mf, ng, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) {
@@ -162,7 +214,12 @@ template <typename problem_t> void HydroSystem<problem_t>::ConservedToPrimitive(
 		const auto kinetic_energy = 0.5 * rho * (vx * vx + vy * vy + vz * vz);
 		const auto Eint_cons = E - kinetic_energy;
 
-		const amrex::Real Pgas = ComputePressure(cons[bx], i, j, k);
+		amrex::Real Pgas = NAN;
+		if (useEOSCache && !is_eos_isothermal()) {
+			Pgas = quokka::EOS<problem_t>::ComputePressureFromGamma(Eint_cons, eosCache[bx](i, j, k, gammaEff_index));
+		} else {
+			Pgas = ComputePressure(cons[bx], i, j, k);
+		}
 		const amrex::Real eint_cons = Eint_cons / rho;
 		const amrex::Real eint_aux = Eint_aux / rho;
 
@@ -195,6 +252,70 @@ template <typename problem_t> void HydroSystem<problem_t>::ConservedToPrimitive(
 	});
 }
 
+template <typename problem_t> auto HydroSystem<problem_t>::IsSinglePrecisionSafe(amrex::MultiFab const &cons_mf, const int nghost) -> bool
+{
+	// check whether the primitive variables can be stored in single precision, including in the ghost cells.
+	// all arithmetic is done in double precision, so only the stored values must be representable:
+	// no value may overflow, and the density and internal energy must not underflow into the
+	// subnormal range (where they would lose their relative precision).
+	// the headroom allows for the interface states to be extrapolated beyond the cell-centered values.
+	// (the result is the same on all ranks, since the precision must be the same for the whole level.)
+	constexpr double headroom = 1.0e4;
+	constexpr double safeMax = static_cast<double>(std::numeric_limits<float>::max()) / headroom;
+	constexpr double safeMin = static_cast<double>(std::numeric_limits<float>::min()) * headroom;
+	auto const &cons = cons_mf.const_arrays();
+
+	bool isSafe = amrex::ParReduce(amrex::TypeList<amrex::ReduceOpLogicalAnd>{}, amrex::TypeList<bool>{}, cons_mf,
+				       amrex::IntVect(AMREX_D_DECL(nghost, nghost, nghost)),
+				       [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) noexcept -> amrex::GpuTuple<bool> {
+					       const auto rho = cons[bx](i, j, k, density_index);
+					       const auto px = cons[bx](i, j, k, x1Momentum_index);
+					       const auto py = cons[bx](i, j, k, x2Momentum_index);
+					       const auto pz = cons[bx](i, j, k, x3Momentum_index);
+					       const auto vmax = std::max({std::abs(px), std::abs(py), std::abs(pz)}) / rho;
+					       const auto Eint = cons[bx](i, j, k, energy_index) - (px * px + py * py + pz * pz) / (2.0 * rho);
+					       const auto Eint_aux = cons[bx](i, j, k, internalEnergy_index);
+
+					       bool safe = (rho > safeMin) && (rho < safeMax) && (vmax < safeMax);
+					       if (!is_eos_isothermal()) {
+						       safe = safe && (std::abs(Eint) > safeMin) && (std::abs(Eint) < safeMax);
+						       safe = safe && (std::abs(Eint_aux) > safeMin) && (std::abs(Eint_aux) < safeMax);
+					       }
+					       for (int nc = 0; nc < nscalars_; ++nc) {
+						       safe = safe && (std::abs(cons[bx](i, j, k, scalar0_index + nc)) < safeMax);
+					       }
+					       return {safe};
+				       });
+
+	amrex::ParallelAllReduce::And(isSafe, amrex::ParallelContext::CommunicatorSub());
+	return isSafe;
+}
+
+template <typename problem_t> void HydroSystem<problem_t>::ComputeEOSCache(amrex::MultiFab const &cons_mf, amrex::MultiFab &eosCache_mf, const int nghost)
+{
+	// evaluate the full EOS once per cell (including ghost cells) and save the effective
+	// adiabatic index, so that the hydro kernels can use a closed-form EOS for this state
+	// instead of re-evaluating the full EOS many times per cell.
+	// (the cache only lives for one hydro stage. the timestep computation and the Strang-split source terms
+	// evaluate the EOS once per cell on a state that has no cache, so building one there would not save any EOS calls.)
+	AMREX_ASSERT(eosCache_mf.nComp() == nEOSCacheVars);
+	auto const &cons = cons_mf.const_arrays();
+	auto const &eosCache = eosCache_mf.arrays();
+	amrex::IntVect ng{AMREX_D_DECL(nghost, nghost, nghost)};
+
+	amrex::ParallelFor(cons_mf, ng, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) {
+		const auto rho = cons[bx](i, j, k, density_index);
+		const auto px = cons[bx](i, j, k, x1Momentum_index);
+		const auto py = cons[bx](i, j, k, x2Momentum_index);
+		const auto pz = cons[bx](i, j, k, x3Momentum_index);
+		const auto E = cons[bx](i, j, k, energy_index);
+		const auto Eint = E - (px * px + py * py + pz * pz) / (2.0 * rho);
+
+		amrex::GpuArray<Real, nmscalars_> massScalars = RadSystem<problem_t>::ComputeMassScalars(cons[bx], i, j, k);
+		eosCache[bx](i, j, k, gammaEff_index) = quokka::EOS<problem_t>::ComputeEffectiveGamma(rho, Eint, massScalars);
+	});
+}
+
 template <typename problem_t> auto HydroSystem<problem_t>::maxSignalSpeedLocal(amrex::MultiFab const &cons_mf) -> amrex::Real
 {
 	// return maximum signal speed on local grids
@@ -447,7 +568,7 @@ AMREX_GPU_DEVICE AMREX_FORCE_INLINE auto HydroSystem<problem_t>::isStateValid(am
 
 template <typename problem_t>
 void HydroSystem<problem_t>::ComputeRhsFromFluxes(amrex::MultiFab &rhs_mf, std::array<amrex::MultiFab, AMREX_SPACEDIM> const &fluxArray,
-						  amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx, const int nvars)
+						  amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx, const int nvars, quokka::CoordGeometry const &coordGeom)
 {
 	// compute the total right-hand-side for the MOL integration
 
@@ -456,6 +577,9 @@ void HydroSystem<problem_t>::ComputeRhsFromFluxes(amrex::MultiFab &rhs_mf, std::
 	// left of zone i, and -1.0*flux(i+1) is the flux *into* zone i through
 	// the interface on the right of zone i.
 
+	// [In curvilinear coordinates, the fluxes have already been multiplied by the face areas,
+	//  so the flux differences are divided by the cell volume.]
+
 	auto const x1Flux = fluxArray[0].const_arrays();
 #if AMREX_SPACEDIM >= 2
 	auto const x2Flux = fluxArray[1].const_arrays();
@@ -469,6 +593,9 @@ void HydroSystem<problem_t>::ComputeRhsFromFluxes(amrex::MultiFab &rhs_mf, std::
 		rhs[bx](i, j, k, n) = AMREX_D_TERM((1.0 / dx[0]) * (x1Flux[bx](i, j, k, n) - x1Flux[bx](i + 1, j, k, n)),
 						   +(1.0 / dx[1]) * (x2Flux[bx](i, j, k, n) - x2Flux[bx](i, j + 1, k, n)),
 						   +(1.0 / dx[2]) * (x3Flux[bx](i, j, k, n) - x3Flux[bx](i, j, k + 1, n)));
+		if (!coordGeom.isCartesian()) {
+			rhs[bx](i, j, k, n) /= coordGeom.cellVolume(i);
+		}
 	});
 }
 
@@ -529,8 +656,9 @@ void HydroSystem<problem_t>::AddFluxesRK2(amrex::MultiFab &Unew_mf, amrex::Multi
 }
 
 template <typename problem_t>
-template <FluxDir DIR>
-void HydroSystem<problem_t>::ComputeFlatteningCoefficients(amrex::MultiFab const &primVar_mf, amrex::MultiFab &x1Chi_mf, const int nghost)
+template <FluxDir DIR, typename fab_t>
+void HydroSystem<problem_t>::ComputeFlatteningCoefficients(amrex::FabArray<fab_t> const &primVar_mf, amrex::MultiFab &x1Chi_mf, const int nghost,
+							   amrex::MultiFab const *eosCache_mf)
 {
 	// compute the PPM shock flattening coefficient following
 	//   Appendix B1 of Mignone+ 2005 [this description has typos].
@@ -545,10 +673,15 @@ void HydroSystem<problem_t>::ComputeFlatteningCoefficients(amrex::MultiFab const
 	auto const &primVar_in = primVar_mf.const_arrays();
 	auto x1Chi_in = x1Chi_mf.arrays();
 	amrex::IntVect ng{AMREX_D_DECL(nghost, nghost, nghost)};
+	// if no EOS cache is given, the x1Chi arrays are captured instead but never read
+	const bool useEOSCache = (eosCache_mf != nullptr);
+	auto const &eosCache_in = useEOSCache ? eosCache_mf->const_arrays() : x1Chi_mf.const_arrays();
+	using value_t = typename fab_t::value_type;
 
 	// cell-centered kernel
 	amrex::ParallelFor(primVar_mf, ng, [=] AMREX_GPU_DEVICE(int bx, int i_in, int j_in, int k_in) {
-		quokka::Array4View<const amrex::Real, DIR> primVar(primVar_in[bx]);
+		quokka::Array4View<const value_t, DIR> primVar(primVar_in[bx]);
+		quokka::Array4View<const amrex::Real, DIR> eosCache(eosCache_in[bx]);
 		quokka::Array4View<amrex::Real, DIR> x1Chi(x1Chi_in[bx]);
 		auto [i, j, k] = quokka::reorderMultiIndex<DIR>(i_in, j_in, k_in);
 
@@ -558,7 +691,18 @@ void HydroSystem<problem_t>::ComputeFlatteningCoefficients(amrex::MultiFab const
 		amrex::Real Pminus1 = primVar(i - 1, j, k, pressure_index);
 		amrex::Real Pminus2 = primVar(i - 2, j, k, pressure_index);
 
-		if constexpr (reconstruct_eint) {
+		if (reconstruct_eint && useEOSCache) {
+			// compute (rho e) (gamma_eff - 1) using the cached effective adiabatic index
+			Pplus2 = quokka::EOS<problem_t>::ComputePressureFromGamma(primVar(i + 2, j, k, primDensity_index) * Pplus2,
+										  eosCache(i + 2, j, k, gammaEff_index));
+			Pplus1 = quokka::EOS<problem_t>::ComputePressureFromGamma(primVar(i + 1, j, k, primDensity_index) * Pplus1,
+										  eosCache(i + 1, j, k, gammaEff_index));
+			P = quokka::EOS<problem_t>::ComputePressureFromGamma(primVar(i, j, k, primDensity_index) * P, eosCache(i, j, k, gammaEff_index));
+			Pminus1 = quokka::EOS<problem_t>::ComputePressureFromGamma(primVar(i - 1, j, k, primDensity_index) * Pminus1,
+										   eosCache(i - 1, j, k, gammaEff_index));
+			Pminus2 = quokka::EOS<problem_t>::ComputePressureFromGamma(primVar(i - 2, j, k, primDensity_index) * Pminus2,
+										   eosCache(i - 2, j, k, gammaEff_index));
+		} else if constexpr (reconstruct_eint) {
 			// compute (rho e) (gamma - 1)
 			amrex::GpuArray<Real, nmscalars_> massScalars_plus2 = RadSystem<problem_t>::ComputeMassScalars(primVar, i + 2, j, k);
 			Pplus2 = quokka::EOS<problem_t>::ComputePressure(primVar(i + 2, j, k, primDensity_index),
@@ -598,9 +742,14 @@ void HydroSystem<problem_t>::ComputeFlatteningCoefficients(amrex::MultiFab const
 		const double chi_min = std::max(0., std::min(1., (beta_max - beta) / (beta_max - beta_min)));
 
 		// Z is a measure of shock strength (Eq. 76 of Miller & Colella 2002)
-		amrex::GpuArray<Real, nmscalars_> massScalars = RadSystem<problem_t>::ComputeMassScalars(primVar, i, j, k);
-		double K_S = std::pow(quokka::EOS<problem_t>::ComputeSoundSpeed(primVar(i, j, k, primDensity_index), P, massScalars), 2) *
-			     primVar(i, j, k, primDensity_index);
+		double K_S = NAN;
+		if (useEOSCache) {
+			K_S = eosCache(i, j, k, gammaEff_index) * P;
+		} else {
+			amrex::GpuArray<Real, nmscalars_> massScalars = RadSystem<problem_t>::ComputeMassScalars(primVar, i, j, k);
+			K_S = std::pow(quokka::EOS<problem_t>::ComputeSoundSpeed(primVar(i, j, k, primDensity_index), P, massScalars), 2) *
+			      primVar(i, j, k, primDensity_index);
+		}
 		if constexpr (is_eos_isothermal()) {
 			K_S = primVar(i, j, k, primDensity_index) * cs_iso_ * cs_iso_;
 		}
@@ -626,10 +775,10 @@ void HydroSystem<problem_t>::ComputeFlatteningCoefficients(amrex::MultiFab const
 }
 
 template <typename problem_t>
-template <FluxDir DIR>
-void HydroSystem<problem_t>::FlattenShocks(amrex::MultiFab const &q_mf, amrex::MultiFab const &x1Chi_mf, amrex::MultiFab const &x2Chi_mf,
-					   amrex::MultiFab const &x3Chi_mf, amrex::MultiFab &x1LeftState_mf, amrex::MultiFab &x1RightState_mf, const int nghost,
-					   const int nvars)
+template <FluxDir DIR, typename fab_t>
+void HydroSystem<problem_t>::FlattenShocks(amrex::FabArray<fab_t> const &q_mf, amrex::MultiFab const &x1Chi_mf, amrex::MultiFab const &x2Chi_mf,
+					   amrex::MultiFab const &x3Chi_mf, amrex::FabArray<fab_t> &x1LeftState_mf, amrex::FabArray<fab_t> &x1RightState_mf,
+					   const int nghost, const int nvars)
 {
 	// Apply shock flattening based on Miller & Colella (2002)
 	// [This is necessary to get a reasonable solution to the slow-moving
@@ -642,12 +791,13 @@ void HydroSystem<problem_t>::FlattenShocks(amrex::MultiFab const &q_mf, amrex::M
 	auto x1LeftState_in = x1LeftState_mf.arrays();
 	auto x1RightState_in = x1RightState_mf.arrays();
 	amrex::IntVect ng{AMREX_D_DECL(nghost, nghost, nghost)};
+	using value_t = typename fab_t::value_type;
 
 	// cell-centered kernel
 	amrex::ParallelFor(q_mf, ng, nvars, [=] AMREX_GPU_DEVICE(int bx, int i_in, int j_in, int k_in, int n) {
-		quokka::Array4View<const amrex::Real, DIR> q(q_in[bx]);
-		quokka::Array4View<amrex::Real, DIR> x1LeftState(x1LeftState_in[bx]);
-		quokka::Array4View<amrex::Real, DIR> x1RightState(x1RightState_in[bx]);
+		quokka::Array4View<const value_t, DIR> q(q_in[bx]);
+		quokka::Array4View<value_t, DIR> x1LeftState(x1LeftState_in[bx]);
+		quokka::Array4View<value_t, DIR> x1RightState(x1RightState_in[bx]);
 
 		// compute coefficient as the minimum from adjacent cells along *each
 		// axis*
@@ -693,6 +843,148 @@ void HydroSystem<problem_t>::FlattenShocks(amrex::MultiFab const &q_mf, amrex::M
 	}
 }
 
+template <typename problem_t>
+template <typename fab_t>
+void HydroSystem<problem_t>::PredictInterfaceStates(amrex::MultiFab const &cons_mf, amrex::FabArray<fab_t> const &primVar_mf,
+						    std::array<amrex::FabArray<fab_t>, AMREX_SPACEDIM> &leftState_mf,
+						    std::array<amrex::FabArray<fab_t>, AMREX_SPACEDIM> &rightState_mf, const amrex::Real dt,
+						    amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &dx, const int nghost,
+						    amrex::iMultiFab &predictorFlag_mf, amrex::MultiFab const *eosCache_mf)
+{
+	// MUSCL-Hancock predictor: advance the reconstructed interface states of each cell by dt/2 using the
+	// primitive form of the Euler equations, with the slopes given by the difference between the interface
+	// states on either side of the cell. [The contributions from all directions are added, so the
+	// predicted states include the transverse terms needed for an unsplit single-stage update.]
+	// (Toro 2009, Sec. 14.4; Stone et al. 2008, Sec. 4.2)
+	//
+	// N.B.: each cell only modifies its own interface states, i.e. rightState(i) and leftState(i+1).
+	//
+	// cells for which the prediction is rejected are flagged in predictorFlag_mf, so that the fluxes on their
+	// faces can be replaced by first-order fluxes (as for cells flagged by PredictStep).
+
+	using value_t = typename fab_t::value_type;
+	auto const &cons = cons_mf.const_arrays();
+	auto const &q = primVar_mf.const_arrays();
+	auto const &predictorFlag = predictorFlag_mf.arrays();
+	// if no EOS cache is given, the cons arrays are captured instead but never read
+	const bool useEOSCache = (eosCache_mf != nullptr);
+	auto const &eosCache = useEOSCache ? eosCache_mf->const_arrays() : cons_mf.const_arrays();
+	amrex::GpuArray<amrex::MultiArray4<value_t>, AMREX_SPACEDIM> leftState{};
+	amrex::GpuArray<amrex::MultiArray4<value_t>, AMREX_SPACEDIM> rightState{};
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		leftState[idim] = leftState_mf[idim].arrays();
+		rightState[idim] = rightState_mf[idim].arrays();
+	}
+	amrex::IntVect ng{AMREX_D_DECL(nghost, nghost, nghost)};
+
+	// cell-centered kernel
+	amrex::ParallelFor(cons_mf, ng, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) noexcept {
+		const amrex::Real rho = q[bx](i, j, k, primDensity_index);
+		const amrex::GpuArray<amrex::Real, 3> vel{q[bx](i, j, k, x1Velocity_index), q[bx](i, j, k, x2Velocity_index),
+							  q[bx](i, j, k, x3Velocity_index)};
+		amrex::Real P = NAN;
+		amrex::Real cs = NAN;
+		if (useEOSCache && !is_eos_isothermal()) {
+			const amrex::Real gamma_eff = eosCache[bx](i, j, k, gammaEff_index);
+			const amrex::Real Eint = cons[bx](i, j, k, energy_index) - 0.5 * rho * (vel[0] * vel[0] + vel[1] * vel[1] + vel[2] * vel[2]);
+			P = quokka::EOS<problem_t>::ComputePressureFromGamma(Eint, gamma_eff);
+			cs = quokka::EOS<problem_t>::ComputeSoundSpeedFromGamma(rho, P, gamma_eff);
+		} else {
+			P = ComputePressure(cons[bx], i, j, k);
+			cs = ComputeSoundSpeed(cons[bx], i, j, k);
+		}
+		const amrex::Real eint = q[bx](i, j, k, pressure_index); // specific internal energy (if reconstruct_eint)
+		const amrex::Real Eint_aux = q[bx](i, j, k, primEint_index);
+
+		// time derivative of the primitive variables
+		amrex::GpuArray<amrex::Real, nvar_> dqdt{};
+
+		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+			const int ip = i + static_cast<int>(idim == 0);
+			const int jp = j + static_cast<int>(idim == 1);
+			const int kp = k + static_cast<int>(idim == 2);
+			auto slope = [&](int n) -> amrex::Real {
+				const amrex::Real qR = rightState[idim][bx](i, j, k, n);
+				const amrex::Real qL = leftState[idim][bx](ip, jp, kp, n);
+				return qL - qR;
+			};
+			const amrex::Real u_n = vel[idim];
+			const amrex::Real inv_dx = 1.0 / dx[idim];
+			const amrex::Real drho = slope(primDensity_index);
+			const amrex::Real du_n = slope(x1Velocity_index + idim);
+			const amrex::Real dp = slope(pressure_index);
+
+			// pressure gradient (if the specific internal energy is reconstructed, assume P ~ rho * e)
+			amrex::Real dP = dp;
+			if constexpr (reconstruct_eint) {
+				dP = (eint > 0.) ? P * (drho / rho + dp / eint) : 0.;
+			}
+
+			dqdt[primDensity_index] -= inv_dx * (u_n * drho + rho * du_n);
+			for (int m = 0; m < 3; ++m) {
+				const amrex::Real gradP = (m == idim) ? dP / rho : 0.;
+				dqdt[x1Velocity_index + m] -= inv_dx * (u_n * slope(x1Velocity_index + m) + gradP);
+			}
+			if constexpr (reconstruct_eint) {
+				dqdt[pressure_index] -= inv_dx * (u_n * dp + (P / rho) * du_n);
+				dqdt[primEint_index] -= inv_dx * (u_n * slope(primEint_index) + (P / rho) * du_n);
+			} else {
+				dqdt[pressure_index] -= inv_dx * (u_n * dp + rho * cs * cs * du_n);
+				dqdt[primEint_index] -= inv_dx * (u_n * slope(primEint_index) + (Eint_aux + P) * du_n);
+			}
+			for (int nc = 0; nc < nscalars_; ++nc) {
+				const int n = primScalar0_index + nc;
+				dqdt[n] -= inv_dx * (u_n * slope(n) + q[bx](i, j, k, n) * du_n);
+			}
+		}
+
+		// do not modify the interface states of this cell if the predicted density or pressure is not positive,
+		// and flag the cell instead (its fluxes are then replaced by first-order fluxes in the flux correction step)
+		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+			const int ip = i + static_cast<int>(idim == 0);
+			const int jp = j + static_cast<int>(idim == 1);
+			const int kp = k + static_cast<int>(idim == 2);
+			const amrex::Real rhoL = rightState[idim][bx](i, j, k, primDensity_index) + 0.5 * dt * dqdt[primDensity_index];
+			const amrex::Real rhoR = leftState[idim][bx](ip, jp, kp, primDensity_index) + 0.5 * dt * dqdt[primDensity_index];
+			bool isValid = (rhoL > 0.) && (rhoR > 0.);
+			if constexpr (!is_eos_isothermal()) {
+				const amrex::Real pL = rightState[idim][bx](i, j, k, pressure_index) + 0.5 * dt * dqdt[pressure_index];
+				const amrex::Real pR = leftState[idim][bx](ip, jp, kp, pressure_index) + 0.5 * dt * dqdt[pressure_index];
+				isValid = isValid && (pL > 0.) && (pR > 0.);
+			}
+			if (!isValid) {
+				predictorFlag[bx](i, j, k) = quokka::redoFlag::redo;
+				return;
+			}
+		}
+		predictorFlag[bx](i, j, k) = quokka::redoFlag::none;
+
+		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+			const int ip = i + static_cast<int>(idim == 0);
+			const int jp = j + static_cast<int>(idim == 1);
+			const int kp = k + static_cast<int>(idim == 2);
+			for (int n = 0; n < nvar_; ++n) {
+				rightState[idim][bx](i, j, k, n) += static_cast<value_t>(0.5 * dt * dqdt[n]);
+				leftState[idim][bx](ip, jp, kp, n) += static_cast<value_t>(0.5 * dt * dqdt[n]);
+			}
+		}
+	});
+}
+
+template <typename problem_t>
+void HydroSystem<problem_t>::AddPredictorRedoFlags(amrex::iMultiFab &redoFlag_mf, amrex::iMultiFab const &predictorFlag_mf)
+{
+	// flag the cells for which the MUSCL-Hancock prediction was rejected for flux correction
+	auto const &redoFlag = redoFlag_mf.arrays();
+	auto const &predictorFlag = predictorFlag_mf.const_arrays();
+
+	amrex::ParallelFor(redoFlag_mf, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) noexcept {
+		if (predictorFlag[bx](i, j, k) == quokka::redoFlag::redo) {
+			redoFlag[bx](i, j, k) = quokka::redoFlag::redo;
+		}
+	});
+}
+
 // to ensure that physical quantities are within reasonable
 // floors and ceilings which can be set in the param file
 template <typename problem_t> void HydroSystem<problem_t>::EnforceLimits(amrex::Real const densityFloor, amrex::Real const tempFloor, amrex::MultiFab &state_mf)
@@ -775,7 +1067,8 @@ template <typename problem_t> void HydroSystem<problem_t>::EnforceLimits(amrex::
 template <typename problem_t>
 void HydroSystem<problem_t>::AddInternalEnergyPdV(amrex::MultiFab &rhs_mf, amrex::MultiFab const &consVar_mf,
 						  amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const dx,
-						  std::array<amrex::MultiFab, AMREX_SPACEDIM> const &faceVelArray, amrex::iMultiFab const &redoFlag_mf)
+						  std::array<amrex::MultiFab, AMREX_SPACEDIM> const &faceVelArray, amrex::iMultiFab const &redoFlag_mf,
+						  amrex::MultiFab const *eosCache_mf, quokka::CoordGeometry const &coordGeom)
 {
 	// compute P dV source term for the internal energy equation,
 	// using the face-centered velocities in faceVelArray and the pressure
@@ -791,21 +1084,39 @@ void HydroSystem<problem_t>::AddInternalEnergyPdV(amrex::MultiFab &rhs_mf, amrex
 	auto const &consVar = consVar_mf.const_arrays();
 	auto const &redoFlag = redoFlag_mf.const_arrays();
 	auto rhs = rhs_mf.arrays();
+	// if no EOS cache is given, the consVar arrays are captured instead but never read
+	const bool useEOSCache = (eosCache_mf != nullptr);
+	auto const &eosCache = useEOSCache ? eosCache_mf->const_arrays() : consVar_mf.const_arrays();
 
 	amrex::ParallelFor(rhs_mf, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) {
 		// get cell-centered pressure
-		const amrex::Real Pgas = ComputePressure(consVar[bx], i, j, k);
+		amrex::Real Pgas = NAN;
+		if (useEOSCache && !is_eos_isothermal()) {
+			const amrex::Real rho = consVar[bx](i, j, k, density_index);
+			const amrex::Real px = consVar[bx](i, j, k, x1Momentum_index);
+			const amrex::Real py = consVar[bx](i, j, k, x2Momentum_index);
+			const amrex::Real pz = consVar[bx](i, j, k, x3Momentum_index);
+			const amrex::Real Eint = consVar[bx](i, j, k, energy_index) - (px * px + py * py + pz * pz) / (2.0 * rho);
+			Pgas = quokka::EOS<problem_t>::ComputePressureFromGamma(Eint, eosCache[bx](i, j, k, gammaEff_index));
+		} else {
+			Pgas = ComputePressure(consVar[bx], i, j, k);
+		}
 
 		// compute div v from face-centered velocities
 		amrex::Real div_v = NAN;
 
 		if (redoFlag[bx](i, j, k) == quokka::redoFlag::none) {
-			div_v = AMREX_D_TERM((vel_x[bx](i + 1, j, k) - vel_x[bx](i, j, k)) / dx[0], +(vel_y[bx](i, j + 1, k) - vel_y[bx](i, j, k)) / dx[1],
+			// (the x1 face velocities are weighted by the face area in curvilinear coordinates)
+			const amrex::Real Avx_p = coordGeom.faceArea(i + 1) * vel_x[bx](i + 1, j, k);
+			const amrex::Real Avx_m = coordGeom.faceArea(i) * vel_x[bx](i, j, k);
+			div_v = AMREX_D_TERM((Avx_p - Avx_m) / (coordGeom.cellVolume(i) * dx[0]), +(vel_y[bx](i, j + 1, k) - vel_y[bx](i, j, k)) / dx[1],
 					     +(vel_z[bx](i, j, k + 1) - vel_z[bx](i, j, k)) / dx[2]);
 		} else {
 			div_v = 0.5 * (AMREX_D_TERM((ComputeVelocityX1(consVar[bx], i + 1, j, k) - ComputeVelocityX1(consVar[bx], i - 1, j, k)) / dx[0],
 						    +(ComputeVelocityX2(consVar[bx], i, j + 1, k) - ComputeVelocityX2(consVar[bx], i, j - 1, k)) / dx[1],
 						    +(ComputeVelocityX3(consVar[bx], i, j, k + 1) - ComputeVelocityX3(consVar[bx], i, j, k - 1)) / dx[2]));
+			// curvilinear part of the divergence (zero in Cartesian coordinates)
+			div_v += coordGeom.areaDivergence(i) * ComputeVelocityX1(consVar[bx], i, j, k);
 		}
 
 		// add P dV term to rhs array
@@ -813,6 +1124,51 @@ void HydroSystem<problem_t>::AddInternalEnergyPdV(amrex::MultiFab &rhs_mf, amrex
 	});
 }
 
+template <typename problem_t>
+void HydroSystem<problem_t>::AddGeometricSources(amrex::MultiFab &rhs_mf, amrex::MultiFab const &consVar_mf, quokka::CoordGeometry const &coordGeom,
+						 const amrex::Real weight, amrex::MultiFab const *eosCache_mf)
+{
+	// add the geometric source terms for the momentum equations in curvilinear coordinates.
+	// the pressure term is computed from the difference in the face areas, so that a
+	// hydrostatic state remains in equilibrium to roundoff error.
+
+	if (coordGeom.isCartesian()) {
+		return;
+	}
+
+	auto const &consVar = consVar_mf.const_arrays();
+	auto rhs = rhs_mf.arrays();
+	// if no EOS cache is given, the cons arrays are captured instead but never read
+	const bool useEOSCache = (eosCache_mf != nullptr);
+	auto const &eosCache = useEOSCache ? eosCache_mf->const_arrays() : consVar_mf.const_arrays();
+
+	amrex::ParallelFor(rhs_mf, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) {
+		const amrex::Real rho = consVar[bx](i, j, k, density_index);
+		const amrex::Real vx = consVar[bx](i, j, k, x1Momentum_index) / rho;
+		const amrex::Real vy = consVar[bx](i, j, k, x2Momentum_index) / rho;
+		const amrex::Real vz = consVar[bx](i, j, k, x3Momentum_index) / rho;
+		amrex::Real P = NAN;
+		if (useEOSCache && !is_eos_isothermal()) {
+			const amrex::Real Eint = consVar[bx](i, j, k, energy_index) - 0.5 * rho * (vx * vx + vy * vy + vz * vz);
+			P = quokka::EOS<problem_t>::ComputePressureFromGamma(Eint, eosCache[bx](i, j, k, gammaEff_index));
+		} else {
+			P = ComputePressure(consVar[bx], i, j, k);
+		}
+		const amrex::Real divA = coordGeom.areaDivergence(i);
+
+		if (coordGeom.coord == amrex::CoordSys::RZ) {
+			// (R, z, phi): pressure and centrifugal force in R; Coriolis term for v_phi
+			rhs[bx](i, j, k, x1Momentum_index) += weight * divA * (P + rho * vz * vz);
+			rhs[bx](i, j, k, x3Momentum_index) -= weight * divA * rho * vx * vz;
+		} else if (coordGeom.coord == amrex::CoordSys::SPHERICAL) {
+			// (r, theta, phi) in 1D: divA ~ 2/r
+			rhs[bx](i, j, k, x1Momentum_index) += weight * divA * (P + 0.5 * rho * (vy * vy + vz * vz));
+			rhs[bx](i, j, k, x2Momentum_index) -= weight * 0.5 * divA * rho * vx * vy;
+			rhs[bx](i, j, k, x3Momentum_index) -= weight * 0.5 * divA * rho * vx * vz;
+		}
+	});
+}
+
 template <typename problem_t> void HydroSystem<problem_t>::SyncDualEnergy(amrex::MultiFab &consVar_mf)
 {
 	// sync internal energy and total energy
@@ -850,9 +1206,24 @@ template <typename problem_t> void HydroSystem<problem_t>::SyncDualEnergy(amrex:
 }
 
 template <typename problem_t>
-template <RiemannSolver RIEMANN, FluxDir DIR>
-void HydroSystem<problem_t>::ComputeFluxes(amrex::MultiFab &x1Flux_mf, amrex::MultiFab &x1FaceVel_mf, amrex::MultiFab const &x1LeftState_mf,
-					   amrex::MultiFab const &x1RightState_mf, amrex::MultiFab const &primVar_mf, const amrex::Real K_visc)
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE auto HydroSystem<problem_t>::isStrongShockOrVacuum(quokka::HydroState<nscalars_, nmscalars_> const &sL,
+										       quokka::HydroState<nscalars_, nmscalars_> const &sR,
+										       HybridRiemannParams const &params) -> bool
+{
+	// cheap detector for interfaces where HLLC may produce unphysical states:
+	// a large pressure jump (strong shock), a large density ratio (near vacuum),
+	// or strong compression along the normal direction (relative to the sound speed)
+	const bool pressureJump = std::max(sL.P, sR.P) > params.pressureRatio * std::min(sL.P, sR.P);
+	const bool densityJump = std::max(sL.rho, sR.rho) > params.densityRatio * std::min(sL.rho, sR.rho);
+	const bool strongCompression = (sL.u - sR.u) > params.compression * std::min(sL.cs, sR.cs);
+	return pressureJump || densityJump || strongCompression;
+}
+
+template <typename problem_t>
+template <RiemannSolver RIEMANN, FluxDir DIR, typename fab_t>
+void HydroSystem<problem_t>::ComputeFluxes(amrex::MultiFab &x1Flux_mf, amrex::MultiFab &x1FaceVel_mf, amrex::FabArray<fab_t> const &x1LeftState_mf,
+					   amrex::FabArray<fab_t> const &x1RightState_mf, amrex::FabArray<fab_t> const &primVar_mf, const amrex::Real K_visc,
+					   amrex::MultiFab const *eosCache_mf, HybridRiemannParams const &hybridParams)
 {
 
 	// By convention, the interfaces are defined on the left edge of each
@@ -866,13 +1237,19 @@ void HydroSystem<problem_t>::ComputeFluxes(amrex::MultiFab &x1Flux_mf, amrex::Mu
 	auto const &primVar_in = primVar_mf.const_arrays();
 	auto x1Flux_in = x1Flux_mf.arrays();
 	auto x1FaceVel_in = x1FaceVel_mf.arrays();
+	// if no EOS cache is given, the x1Flux arrays are captured instead but never read
+	const bool useEOSCache = (eosCache_mf != nullptr);
+	auto const &eosCache_in = useEOSCache ? eosCache_mf->const_arrays() : x1Flux_mf.const_arrays();
+	// the interface states may be stored in lower precision, but the fluxes are always computed in double precision
+	using value_t = typename fab_t::value_type;
 
 	amrex::ParallelFor(x1Flux_mf, [=] AMREX_GPU_DEVICE(int bx, int i_in, int j_in, int k_in) {
-		quokka::Array4View<const amrex::Real, DIR> x1LeftState(x1LeftState_in[bx]);
-		quokka::Array4View<const amrex::Real, DIR> x1RightState(x1RightState_in[bx]);
+		quokka::Array4View<const amrex::Real, DIR> eosCache(eosCache_in[bx]);
+		quokka::Array4View<const value_t, DIR> x1LeftState(x1LeftState_in[bx]);
+		quokka::Array4View<const value_t, DIR> x1RightState(x1RightState_in[bx]);
 		quokka::Array4View<amrex::Real, DIR> x1Flux(x1Flux_in[bx]);
 		quokka::Array4View<amrex::Real, DIR> x1FaceVel(x1FaceVel_in[bx]);
-		quokka::Array4View<const amrex::Real, DIR> q(primVar_in[bx]);
+		quokka::Array4View<const value_t, DIR> q(primVar_in[bx]);
 
 		auto [i, j, k] = quokka::reorderMultiIndex<DIR>(i_in, j_in, k_in);
 
@@ -913,6 +1290,28 @@ void HydroSystem<problem_t>::ComputeFluxes(amrex::MultiFab &x1Flux_mf, amrex::Mu
 
 			cs_L = cs_iso_;
 			cs_R = cs_iso_;
+		} else if (useEOSCache) {
+			// the left (right) interface state is reconstructed from cell i-1 (i),
+			// so use the effective adiabatic index cached for that cell
+			const double gamma_L = eosCache(i - 1, j, k, gammaEff_index);
+			const double gamma_R = eosCache(i, j, k, gammaEff_index);
+
+			if constexpr (reconstruct_eint) {
+				P_L = quokka::EOS<problem_t>::ComputePressureFromGamma(rho_L * x1LeftState(i, j, k, pressure_index), gamma_L);
+				P_R = quokka::EOS<problem_t>::ComputePressureFromGamma(rho_R * x1RightState(i, j, k, pressure_index), gamma_R);
+				Eint_L = rho_L * x1LeftState(i, j, k, primEint_index);
+				Eint_R = rho_R * x1RightState(i, j, k, primEint_index);
+			} else {
+				P_L = x1LeftState(i, j, k, pressure_index);
+				P_R = x1RightState(i, j, k, pressure_index);
+				Eint_L = x1LeftState(i, j, k, primEint_index);
+				Eint_R = x1RightState(i, j, k, primEint_index);
+			}
+
+			cs_L = quokka::EOS<problem_t>::ComputeSoundSpeedFromGamma(rho_L, P_L, gamma_L);
+			E_L = quokka::EOS<problem_t>::ComputeEintFromPresGamma(P_L, gamma_L) + ke_L;
+			cs_R = quokka::EOS<problem_t>::ComputeSoundSpeedFromGamma(rho_R, P_R, gamma_R);
+			E_R = quokka::EOS<problem_t>::ComputeEintFromPresGamma(P_R, gamma_R) + ke_R;
 		} else {
 			if constexpr (reconstruct_eint) {
 				// compute pressure from specific internal energy
@@ -1041,6 +1440,14 @@ void HydroSystem<problem_t>::ComputeFluxes(amrex::MultiFab &x1Flux_mf, amrex::Mu
 			F_canonical = quokka::Riemann::HLLC<problem_t, nscalars_, nmscalars_, nvar_>(sL, sR, gamma_, du, dw);
 		} else if constexpr (RIEMANN == RiemannSolver::LLF) {
 			F_canonical = quokka::Riemann::LLF<problem_t, nscalars_, nmscalars_, nvar_>(sL, sR);
+		} else if constexpr (RIEMANN == RiemannSolver::HLLC_LLF) {
+			static_assert(!Physics_Traits<problem_t>::is_mhd_enabled, "Cannot use HLLC solver for MHD problems!");
+			// use the more dissipative LLF solver only at strong shocks and near-vacuum interfaces
+			if (isStrongShockOrVacuum(sL, sR, hybridParams)) {
+				F_canonical = quokka::Riemann::LLF<problem_t, nscalars_, nmscalars_, nvar_>(sL, sR);
+			} else {
+				F_canonical = quokka::Riemann::HLLC<problem_t, nscalars_, nmscalars_, nvar_>(sL, sR, gamma_, du, dw);
+			}
 		} else if constexpr (RIEMANN == RiemannSolver::HLLD) {
 			// bx = 0 for testing purposes
 			// TODO(Neco): pass correct bx value once magnetic fields are enabled
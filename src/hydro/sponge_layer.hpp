@@ -0,0 +1,257 @@
+#ifndef SPONGE_LAYER_HPP_ // NOLINT
+#define SPONGE_LAYER_HPP_
+//==============================================================================
+// Quokka -- two-moment radiation hydrodynamics on GPUs for astrophysics
+// Copyright 2024 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file sponge_layer.hpp
+/// \brief Implements absorbing (sponge) layers at the domain faces, which relax the
+/// hydro and radiation variables toward a reference state in order to damp outgoing waves.
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "AMReX.H"
+#include "AMReX_Geometry.H"
+#include "AMReX_GpuQualifiers.H"
+#include "AMReX_MultiFab.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_REAL.H"
+#include "hydro/EOS.hpp"
+#include "hydro/hydro_system.hpp"
+#include "physics_info.hpp"
+#include "radiation/radiation_system.hpp"
+
+namespace quokka
+{
+// The relaxation rate in a layer of width L at a domain face is sigma(s) = s^n / timescale,
+// where s = (depth into the layer) / L rises from 0 at the inner edge of the layer to 1 at the face.
+// The state is relaxed exactly over each (sub)step dt, i.e. U <- U_ref + (U - U_ref) * exp(-sigma * dt),
+// so the update is unconditionally stable for any timescale.
+template <typename problem_t> struct SpongeLayer {
+	static constexpr int nGroups_ = Physics_Traits<problem_t>::nGroups;
+	static constexpr int nmscalars_ = Physics_Traits<problem_t>::numMassScalars;
+
+	amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> width_lo{}; // width of the layer at the lower face in each direction (0 == no layer)
+	amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> width_hi{}; // width of the layer at the upper face in each direction (0 == no layer)
+	amrex::Real timescale = 0.;				 // relaxation timescale at the domain face
+	amrex::Real profile_power = 2.;				 // exponent n of the relaxation profile
+
+	// reference state (only the quantities that are specified are relaxed)
+	bool relax_density = false;
+	bool relax_velocity = false;
+	bool relax_pressure = false;
+	bool relax_rad_energy = false;
+	bool damp_rad_flux = false; // relax the radiation flux toward zero
+	amrex::Real density = NAN;
+	amrex::GpuArray<amrex::Real, 3> velocity{};
+	amrex::Real pressure = NAN;
+	amrex::GpuArray<amrex::Real, nGroups_> rad_energy{};
+
+	[[nodiscard]] auto enabled() const -> bool { return timescale > 0.; }
+
+	void readParameters();
+
+	// relax the valid cells of 'state' over a time dt
+	void apply(amrex::MultiFab &state, amrex::Geometry const &geom, amrex::Real dt) const;
+
+	// returns sigma * timescale at position x (zero outside of the layers)
+	[[nodiscard]] AMREX_GPU_HOST_DEVICE auto profile(amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &x,
+							 amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &prob_lo,
+							 amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &prob_hi) const -> amrex::Real;
+};
+
+template <typename problem_t> void SpongeLayer<problem_t>::readParameters()
+{
+	amrex::ParmParse const pp("sponge");
+
+	// (extra values beyond AMREX_SPACEDIM are ignored, so that the same input file can be used in 1D, 2D, and 3D)
+	auto readWidths = [&pp](std::string const &name, amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> &widths) {
+		std::vector<amrex::Real> values;
+		if (pp.queryarr(name.c_str(), values) == 0) {
+			return;
+		}
+		if (values.size() < AMREX_SPACEDIM) {
+			amrex::Abort("sponge." + name + " must have (at least) AMREX_SPACEDIM values!");
+		}
+		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+			if (values[idim] < 0.) {
+				amrex::Abort("sponge." + name + " must be non-negative!");
+			}
+			widths[idim] = values[idim];
+		}
+	};
+	readWidths("width_lo", width_lo);
+	readWidths("width_hi", width_hi);
+
+	bool anyLayer = false;
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		anyLayer = anyLayer || (width_lo[idim] > 0.) || (width_hi[idim] > 0.);
+	}
+	if (!anyLayer) {
+		timescale = 0.;
+		return;
+	}
+
+	pp.get("timescale", timescale);
+	if (!(timescale > 0.)) {
+		amrex::Abort("sponge.timescale must be positive!");
+	}
+	pp.query("profile_power", profile_power);
+	if (profile_power < 0.) {
+		amrex::Abort("sponge.profile_power must be non-negative!");
+	}
+
+	if constexpr (Physics_Traits<problem_t>::is_hydro_enabled) {
+		relax_density = (pp.query("density", density) != 0);
+		if (relax_density && !(density > 0.)) {
+			amrex::Abort("sponge.density must be positive!");
+		}
+		std::vector<amrex::Real> v;
+		relax_velocity = (pp.queryarr("velocity", v) != 0);
+		if (relax_velocity) {
+			if (v.size() != 3) {
+				amrex::Abort("sponge.velocity must have 3 values!");
+			}
+			for (int n = 0; n < 3; ++n) {
+				velocity[n] = v[n];
+			}
+		}
+		relax_pressure = (pp.query("pressure", pressure) != 0);
+		if (relax_pressure && !(pressure > 0.)) {
+			amrex::Abort("sponge.pressure must be positive!");
+		}
+	}
+
+	if constexpr (Physics_Traits<problem_t>::is_radiation_enabled) {
+		std::vector<amrex::Real> Erad;
+		relax_rad_energy = (pp.queryarr("rad_energy", Erad) != 0);
+		if (relax_rad_energy) {
+			if (static_cast<int>(Erad.size()) != nGroups_) {
+				amrex::Abort("sponge.rad_energy must have one value for each photon group!");
+			}
+			for (int g = 0; g < nGroups_; ++g) {
+				rad_energy[g] = Erad[g];
+			}
+		}
+		int damp_flux = 0;
+		pp.query("damp_rad_flux", damp_flux);
+		damp_rad_flux = (damp_flux == 1);
+	}
+
+	if (!(relax_density || relax_velocity || relax_pressure || relax_rad_energy || damp_rad_flux)) {
+		amrex::Abort("sponge layers are enabled, but no reference state is specified!");
+	}
+}
+
+template <typename problem_t>
+AMREX_GPU_HOST_DEVICE auto SpongeLayer<problem_t>::profile(amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &x,
+							  amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &prob_lo,
+							  amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &prob_hi) const -> amrex::Real
+{
+	// where layers overlap (i.e., in the corners of the domain), the strongest relaxation is used
+	amrex::Real s = 0.;
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		if (width_lo[idim] > 0.) {
+			s = std::max(s, (prob_lo[idim] + width_lo[idim] - x[idim]) / width_lo[idim]);
+		}
+		if (width_hi[idim] > 0.) {
+			s = std::max(s, (x[idim] - (prob_hi[idim] - width_hi[idim])) / width_hi[idim]);
+		}
+	}
+	if (s <= 0.) {
+		return 0.;
+	}
+	return std::pow(std::min(s, 1.0), profile_power);
+}
+
+template <typename problem_t> void SpongeLayer<problem_t>::apply(amrex::MultiFab &state_mf, amrex::Geometry const &geom, const amrex::Real dt) const
+{
+	BL_PROFILE("SpongeLayer::apply()");
+
+	if (!enabled()) {
+		return;
+	}
+
+	auto const prob_lo = geom.ProbLoArray();
+	auto const prob_hi = geom.ProbHiArray();
+	auto const dx = geom.CellSizeArray();
+	auto const &state = state_mf.arrays();
+	SpongeLayer<problem_t> const sponge = *this;
+
+	amrex::ParallelFor(state_mf, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) noexcept {
+		amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> x{};
+		amrex::GpuArray<int, 3> const idx{i, j, k};
+		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+			x[idim] = prob_lo[idim] + (idx[idim] + 0.5) * dx[idim];
+		}
+		const amrex::Real sigma_t = sponge.profile(x, prob_lo, prob_hi);
+		if (sigma_t == 0.) {
+			return;
+		}
+		// fraction of the departure from the reference state that remains after this step
+		const amrex::Real decay = std::exp(-sigma_t * dt / sponge.timescale);
+		auto relax = [decay](amrex::Real U, amrex::Real U_ref) { return U_ref + (U - U_ref) * decay; };
+
+		if constexpr (Physics_Traits<problem_t>::is_hydro_enabled) {
+			if (sponge.relax_density || sponge.relax_velocity || sponge.relax_pressure) {
+				const amrex::Real rho = state[bx](i, j, k, HydroSystem<problem_t>::density_index);
+				const amrex::Real px = state[bx](i, j, k, HydroSystem<problem_t>::x1Momentum_index);
+				const amrex::Real py = state[bx](i, j, k, HydroSystem<problem_t>::x2Momentum_index);
+				const amrex::Real pz = state[bx](i, j, k, HydroSystem<problem_t>::x3Momentum_index);
+				const amrex::Real Egas = state[bx](i, j, k, HydroSystem<problem_t>::energy_index);
+				const amrex::Real Eint = RadSystem<problem_t>::ComputeEintFromEgas(rho, px, py, pz, Egas);
+				amrex::GpuArray<amrex::Real, nmscalars_> massScalars = RadSystem<problem_t>::ComputeMassScalars(state[bx], i, j, k);
+				const amrex::Real P = quokka::EOS<problem_t>::ComputePressure(rho, Eint, massScalars);
+
+				const amrex::Real rho_new = sponge.relax_density ? relax(rho, sponge.density) : rho;
+				amrex::GpuArray<amrex::Real, 3> v{px / rho, py / rho, pz / rho};
+				if (sponge.relax_velocity) {
+					for (int n = 0; n < 3; ++n) {
+						v[n] = relax(v[n], sponge.velocity[n]);
+					}
+				}
+				const amrex::Real P_new = sponge.relax_pressure ? relax(P, sponge.pressure) : P;
+
+				// passive scalars keep their mass fractions
+				for (int n = 0; n < HydroSystem<problem_t>::nscalars_; ++n) {
+					state[bx](i, j, k, HydroSystem<problem_t>::scalar0_index + n) *= rho_new / rho;
+				}
+				for (int n = 0; n < nmscalars_; ++n) {
+					massScalars[n] *= rho_new / rho;
+				}
+				const amrex::Real Eint_new = quokka::EOS<problem_t>::ComputeEintFromPres(rho_new, P_new, massScalars);
+				const amrex::Real Ekin_new = 0.5 * rho_new * (v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+
+				state[bx](i, j, k, HydroSystem<problem_t>::density_index) = rho_new;
+				state[bx](i, j, k, HydroSystem<problem_t>::x1Momentum_index) = rho_new * v[0];
+				state[bx](i, j, k, HydroSystem<problem_t>::x2Momentum_index) = rho_new * v[1];
+				state[bx](i, j, k, HydroSystem<problem_t>::x3Momentum_index) = rho_new * v[2];
+				state[bx](i, j, k, HydroSystem<problem_t>::energy_index) = Eint_new + Ekin_new;
+				state[bx](i, j, k, HydroSystem<problem_t>::internalEnergy_index) = Eint_new;
+			}
+		}
+
+		if constexpr (Physics_Traits<problem_t>::is_radiation_enabled) {
+			for (int g = 0; g < nGroups_; ++g) {
+				const int offset = RadSystem<problem_t>::numRadVars_ * g;
+				if (sponge.relax_rad_energy) {
+					amrex::Real &Erad = state[bx](i, j, k, RadSystem<problem_t>::radEnergy_index + offset);
+					Erad = relax(Erad, sponge.rad_energy[g]);
+				}
+				if (sponge.damp_rad_flux) {
+					state[bx](i, j, k, RadSystem<problem_t>::x1RadFlux_index + offset) *= decay;
+					state[bx](i, j, k, RadSystem<problem_t>::x2RadFlux_index + offset) *= decay;
+					state[bx](i, j, k, RadSystem<problem_t>::x3RadFlux_index + offset) *= decay;
+				}
+			}
+		}
+	});
+	amrex::Gpu::streamSynchronizeAll();
+}
+
+} // namespace quokka
+
+#endif // SPONGE_LAYER_HPP_
@@ -68,44 +68,48 @@ template <typename problem_t> class HyperbolicSystem
 	[[nodiscard]] AMREX_GPU_DEVICE AMREX_FORCE_INLINE static auto GetMinmaxSurroundingCell(arrayconst_t &q, int i, int j, int k, int n)
 	    -> std::pair<double, double>;
 
-	template <FluxDir DIR>
-	static void ReconstructStatesConstant(amrex::MultiFab const &q, amrex::MultiFab &leftState, amrex::MultiFab &rightState, int nghost, int nvars);
+	template <FluxDir DIR, typename fab_t>
+	static void ReconstructStatesConstant(amrex::FabArray<fab_t> const &q, amrex::FabArray<fab_t> &leftState, amrex::FabArray<fab_t> &rightState,
+					      int nghost, int nvars);
 
 	template <FluxDir DIR>
 	AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE static void ReconstructStatesConstant(arrayconst_t &q, array_t &leftState, array_t &rightState,
 										       amrex::Box const &indexRange, int nvars);
 
-	template <FluxDir DIR>
-	AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE static void
-	ReconstructStatesConstant(quokka::Array4View<amrex::Real const, DIR> const &q, quokka::Array4View<amrex::Real, DIR> const &leftState,
-				  quokka::Array4View<amrex::Real, DIR> const &rightState, int n, int i_in, int j_in, int k_in);
+	template <FluxDir DIR, typename T>
+	AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE static void ReconstructStatesConstant(quokka::Array4View<T const, DIR> const &q,
+										       quokka::Array4View<T, DIR> const &leftState,
+										       quokka::Array4View<T, DIR> const &rightState, int n, int i_in, int j_in,
+										       int k_in);
 
-	template <FluxDir DIR, SlopeLimiter limiter>
-	static void ReconstructStatesPLM(amrex::MultiFab const &q, amrex::MultiFab &leftState, amrex::MultiFab &rightState, int nghost, int nvars);
+	template <FluxDir DIR, SlopeLimiter limiter, typename fab_t>
+	static void ReconstructStatesPLM(amrex::FabArray<fab_t> const &q, amrex::FabArray<fab_t> &leftState, amrex::FabArray<fab_t> &rightState, int nghost,
+					 int nvars);
 
 	template <FluxDir DIR, SlopeLimiter limiter>
 	AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE static void ReconstructStatesPLM(arrayconst_t &q, array_t &leftState, array_t &rightState,
 										  amrex::Box const &indexRange, int nvars);
 
-	template <FluxDir DIR, SlopeLimiter limiter>
-	AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE static void
-	ReconstructStatesPLM(quokka::Array4View<amrex::Real const, DIR> const &q, quokka::Array4View<amrex::Real, DIR> const &leftState,
-			     quokka::Array4View<amrex::Real, DIR> const &rightState, int n, int i_in, int j_in, int k_in);
+	template <FluxDir DIR, SlopeLimiter limiter, typename T>
+	AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE static void ReconstructStatesPLM(quokka::Array4View<T const, DIR> const &q,
+										  quokka::Array4View<T, DIR> const &leftState,
+										  quokka::Array4View<T, DIR> const &rightState, int n, int i_in, int j_in,
+										  int k_in);
 
-	template <FluxDir DIR>
-	static void ReconstructStatesPPM(amrex::MultiFab const &q_mf, amrex::MultiFab &leftState_mf, amrex::MultiFab &rightState_mf, int nghost, int nvars,
-					 int iReadFrom = 0, int iWriteFrom = 0);
+	template <FluxDir DIR, typename fab_t>
+	static void ReconstructStatesPPM(amrex::FabArray<fab_t> const &q_mf, amrex::FabArray<fab_t> &leftState_mf, amrex::FabArray<fab_t> &rightState_mf,
+					 int nghost, int nvars, int iReadFrom = 0, int iWriteFrom = 0);
 
 	template <FluxDir DIR>
 	AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE static void ReconstructStatesPPM(arrayconst_t &q_in, array_t &leftState_in, array_t &rightState_in,
 										  amrex::Box const &cellRange, amrex::Box const &interfaceRange, int nvars,
 										  int iReadFrom = 0, int iWriteFrom = 0);
 
-	template <FluxDir DIR>
-	AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE static void ReconstructStatesPPM(quokka::Array4View<amrex::Real const, DIR> const &q,
-										  quokka::Array4View<amrex::Real, DIR> const &leftState,
-										  quokka::Array4View<amrex::Real, DIR> const &rightState, int n, int i_in,
-										  int j_in, int k_in, int iReadFrom = 0, int iWriteFrom = 0);
+	template <FluxDir DIR, typename T>
+	AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE static void ReconstructStatesPPM(quokka::Array4View<T const, DIR> const &q,
+										  quokka::Array4View<T, DIR> const &leftState,
+										  quokka::Array4View<T, DIR> const &rightState, int n, int i_in, int j_in,
+										  int k_in, int iReadFrom = 0, int iWriteFrom = 0);
 
 	template <typename F>
 #if defined(__x86_64__)
@@ -127,10 +131,11 @@ template <typename problem_t> class HyperbolicSystem
 };
 
 template <typename problem_t>
-template <FluxDir DIR>
-void HyperbolicSystem<problem_t>::ReconstructStatesConstant(amrex::MultiFab const &q_mf, amrex::MultiFab &leftState_mf, amrex::MultiFab &rightState_mf,
-							    const int nghost, const int nvars)
+template <FluxDir DIR, typename fab_t>
+void HyperbolicSystem<problem_t>::ReconstructStatesConstant(amrex::FabArray<fab_t> const &q_mf, amrex::FabArray<fab_t> &leftState_mf,
+							    amrex::FabArray<fab_t> &rightState_mf, const int nghost, const int nvars)
 {
+	using value_t = typename fab_t::value_type;
 	auto const &q_in = q_mf.const_arrays();
 	auto leftState_in = leftState_mf.arrays();
 	auto rightState_in = rightState_mf.arrays();
@@ -138,9 +143,9 @@ void HyperbolicSystem<problem_t>::ReconstructStatesConstant(amrex::MultiFab cons
 
 	amrex::ParallelFor(q_mf, ng, nvars, [=] AMREX_GPU_DEVICE(int bx, int i_in, int j_in, int k_in, int n) noexcept {
 		// construct ArrayViews for permuted indices
-		quokka::Array4View<amrex::Real const, DIR> q(q_in[bx]);
-		quokka::Array4View<amrex::Real, DIR> leftState(leftState_in[bx]);
-		quokka::Array4View<amrex::Real, DIR> rightState(rightState_in[bx]);
+		quokka::Array4View<value_t const, DIR> q(q_in[bx]);
+		quokka::Array4View<value_t, DIR> leftState(leftState_in[bx]);
+		quokka::Array4View<value_t, DIR> rightState(rightState_in[bx]);
 
 		HyperbolicSystem<problem_t>::template ReconstructStatesConstant<DIR>(q, leftState, rightState, n, i_in, j_in, k_in);
 	});
@@ -162,11 +167,11 @@ AMREX_GPU_HOST_DEVICE void HyperbolicSystem<problem_t>::ReconstructStatesConstan
 }
 
 template <typename problem_t>
-template <FluxDir DIR>
-AMREX_GPU_HOST_DEVICE void HyperbolicSystem<problem_t>::ReconstructStatesConstant(quokka::Array4View<amrex::Real const, DIR> const &q,
-										  quokka::Array4View<amrex::Real, DIR> const &leftState,
-										  quokka::Array4View<amrex::Real, DIR> const &rightState, int n, int i_in,
-										  int j_in, int k_in)
+template <FluxDir DIR, typename T>
+AMREX_GPU_HOST_DEVICE void HyperbolicSystem<problem_t>::ReconstructStatesConstant(quokka::Array4View<T const, DIR> const &q,
+										  quokka::Array4View<T, DIR> const &leftState,
+										  quokka::Array4View<T, DIR> const &rightState, int n, int i_in, int j_in,
+										  int k_in)
 {
 	// permute array indices according to dir
 	auto [i, j, k] = quokka::reorderMultiIndex<DIR>(i_in, j_in, k_in);
@@ -181,10 +186,11 @@ AMREX_GPU_HOST_DEVICE void HyperbolicSystem<problem_t>::ReconstructStatesConstan
 }
 
 template <typename problem_t>
-template <FluxDir DIR, SlopeLimiter limiter>
-void HyperbolicSystem<problem_t>::ReconstructStatesPLM(amrex::MultiFab const &q_mf, amrex::MultiFab &leftState_mf, amrex::MultiFab &rightState_mf,
-						       const int nghost, const int nvars)
+template <FluxDir DIR, SlopeLimiter limiter, typename fab_t>
+void HyperbolicSystem<problem_t>::ReconstructStatesPLM(amrex::FabArray<fab_t> const &q_mf, amrex::FabArray<fab_t> &leftState_mf,
+						       amrex::FabArray<fab_t> &rightState_mf, const int nghost, const int nvars)
 {
+	using value_t = typename fab_t::value_type;
 	auto const &q_in = q_mf.const_arrays();
 	auto leftState_in = leftState_mf.arrays();
 	auto rightState_in = rightState_mf.arrays();
@@ -192,9 +198,9 @@ void HyperbolicSystem<problem_t>::ReconstructStatesPLM(amrex::MultiFab const &q_
 
 	amrex::ParallelFor(q_mf, ng, nvars, [=] AMREX_GPU_DEVICE(int bx, int i_in, int j_in, int k_in, int n) noexcept {
 		// construct ArrayViews for permuted indices
-		quokka::Array4View<amrex::Real const, DIR> q(q_in[bx]);
-		quokka::Array4View<amrex::Real, DIR> leftState(leftState_in[bx]);
-		quokka::Array4View<amrex::Real, DIR> rightState(rightState_in[bx]);
+		quokka::Array4View<value_t const, DIR> q(q_in[bx]);
+		quokka::Array4View<value_t, DIR> leftState(leftState_in[bx]);
+		quokka::Array4View<value_t, DIR> rightState(rightState_in[bx]);
 
 		HyperbolicSystem<problem_t>::template ReconstructStatesPLM<DIR, limiter>(q, leftState, rightState, n, i_in, j_in, k_in);
 	});
@@ -216,10 +222,11 @@ AMREX_GPU_HOST_DEVICE void HyperbolicSystem<problem_t>::ReconstructStatesPLM(arr
 }
 
 template <typename problem_t>
-template <FluxDir DIR, SlopeLimiter limiter>
-AMREX_GPU_HOST_DEVICE void
-HyperbolicSystem<problem_t>::ReconstructStatesPLM(quokka::Array4View<amrex::Real const, DIR> const &q, quokka::Array4View<amrex::Real, DIR> const &leftState,
-						  quokka::Array4View<amrex::Real, DIR> const &rightState, int n, int i_in, int j_in, int k_in)
+template <FluxDir DIR, SlopeLimiter limiter, typename T>
+AMREX_GPU_HOST_DEVICE void HyperbolicSystem<problem_t>::ReconstructStatesPLM(quokka::Array4View<T const, DIR> const &q,
+									     quokka::Array4View<T, DIR> const &leftState,
+									     quokka::Array4View<T, DIR> const &rightState, int n, int i_in, int j_in,
+									     int k_in)
 {
 	// permute array indices according to dir
 	auto [i, j, k] = quokka::reorderMultiIndex<DIR>(i_in, j_in, k_in);
@@ -293,11 +300,13 @@ AMREX_GPU_DEVICE auto HyperbolicSystem<problem_t>::GetMinmaxSurroundingCell(arra
 }
 
 template <typename problem_t>
-template <FluxDir DIR>
-void HyperbolicSystem<problem_t>::ReconstructStatesPPM(amrex::MultiFab const &q_mf, amrex::MultiFab &leftState_mf, amrex::MultiFab &rightState_mf,
-						       const int nghost, const int nvars, const int iReadFrom, const int iWriteFrom)
+template <FluxDir DIR, typename fab_t>
+void HyperbolicSystem<problem_t>::ReconstructStatesPPM(amrex::FabArray<fab_t> const &q_mf, amrex::FabArray<fab_t> &leftState_mf,
+						       amrex::FabArray<fab_t> &rightState_mf, const int nghost, const int nvars, const int iReadFrom,
+						       const int iWriteFrom)
 {
 	const BL_PROFILE("HyperbolicSystem::ReconstructStatesPPM(MultiFabs)");
+	using value_t = typename fab_t::value_type;
 
 	auto const &q_in = q_mf.const_arrays();
 	auto leftState_in = leftState_mf.arrays();
@@ -307,9 +316,9 @@ void HyperbolicSystem<problem_t>::ReconstructStatesPPM(amrex::MultiFab const &q_
 	// cell-centered kernel
 	amrex::ParallelFor(q_mf, ng, nvars, [=] AMREX_GPU_DEVICE(int bx, int i_in, int j_in, int k_in, int n) noexcept {
 		// construct ArrayViews for permuted indices
-		quokka::Array4View<amrex::Real const, DIR> q(q_in[bx]);
-		quokka::Array4View<amrex::Real, DIR> leftState(leftState_in[bx]);
-		quokka::Array4View<amrex::Real, DIR> rightState(rightState_in[bx]);
+		quokka::Array4View<value_t const, DIR> q(q_in[bx]);
+		quokka::Array4View<value_t, DIR> leftState(leftState_in[bx]);
+		quokka::Array4View<value_t, DIR> rightState(rightState_in[bx]);
 
 		HyperbolicSystem<problem_t>::template ReconstructStatesPPM<DIR>(q, leftState, rightState, n, i_in, j_in, k_in, iReadFrom, iWriteFrom);
 	});
@@ -335,10 +344,10 @@ AMREX_GPU_HOST_DEVICE void HyperbolicSystem<problem_t>::ReconstructStatesPPM(arr
 }
 
 template <typename problem_t>
-template <FluxDir DIR>
-AMREX_GPU_HOST_DEVICE void HyperbolicSystem<problem_t>::ReconstructStatesPPM(quokka::Array4View<amrex::Real const, DIR> const &q,
-									     quokka::Array4View<amrex::Real, DIR> const &leftState,
-									     quokka::Array4View<amrex::Real, DIR> const &rightState, int n, int i_in, int j_in,
+template <FluxDir DIR, typename T>
+AMREX_GPU_HOST_DEVICE void HyperbolicSystem<problem_t>::ReconstructStatesPPM(quokka::Array4View<T const, DIR> const &q,
+									     quokka::Array4View<T, DIR> const &leftState,
+									     quokka::Array4View<T, DIR> const &rightState, int n, int i_in, int j_in,
 									     int k_in, int iReadFrom, int iWriteFrom)
 {
 	// permute array indices according to dir
@@ -1,3 +1,5 @@
+#include <cmath>
+
 #include "DiagBase.H"
 #include "AMReX_ParmParse.H"
 
@@ -88,3 +90,12 @@ auto DiagBase::getFieldIndexVec(const std::vector<std::string> &a_field, const a
 	}
 	return indexVec;
 }
+
+auto DiagBase::refRatioBetween(const amrex::Geometry &a_crseGeom, const amrex::Geometry &a_fineGeom) -> amrex::IntVect
+{
+	amrex::IntVect ratio(1);
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		ratio[idim] = static_cast<int>(std::lround(a_crseGeom.CellSize(idim) / a_fineGeom.CellSize(idim)));
+	}
+	return ratio;
+}
@@ -0,0 +1,596 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <ios>
+#include <map>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "AMReX_BLProfiler.H"
+#include "AMReX_BaseFab.H"
+#include "AMReX_FabArray.H"
+#include "AMReX_GpuDevice.H"
+#include "AMReX_Loop.H"
+#include "AMReX_MultiFabUtil.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Print.H"
+#include "AMReX_iMultiFab.H"
+
+#include "DiagClumps.H"
+
+// Finds connected structures (clumps) of cells above (or below) a threshold on the composite (i.e., not covered by a finer level) AMR grid.
+//
+// The structures are found with a two-level union-find:
+//   1. each rank labels the connected components within each of its boxes with a union-find over the cells of the box,
+//      and computes the integrated quantities of each component,
+//   2. the components that touch across box boundaries (including periodic boundaries) and across coarse-fine boundaries
+//      are found by exchanging the labels in the ghost cells,
+//   3. the (small) graph of components and their connections is gathered on the IO processor, where the connected components
+//      of the graph are merged.
+// Only face neighbours are considered connected.
+//
+// Each connection across a periodic boundary records the periodic image of the neighbour, so that the positions of all of the
+// components of a structure are unwrapped relative to its first component before they are summed (the centre of mass is then
+// wrapped back into the domain).
+
+namespace
+{
+using LabelFab = amrex::FabArray<amrex::BaseFab<amrex::Long>>;
+
+template <typename T> auto gatherToIOProc(std::vector<T> const &local) -> std::vector<T>
+{
+	const int nprocs = amrex::ParallelDescriptor::NProcs();
+	const int ioproc = amrex::ParallelDescriptor::IOProcessorNumber();
+	const int nlocal = static_cast<int>(local.size());
+
+	std::vector<int> counts(nprocs, 0);
+	amrex::ParallelDescriptor::Gather(&nlocal, 1, counts.data(), 1, ioproc);
+
+	std::vector<int> displs(nprocs, 0);
+	std::vector<T> global;
+	if (amrex::ParallelDescriptor::IOProcessor()) {
+		std::partial_sum(counts.begin(), counts.end() - 1, displs.begin() + 1);
+		global.resize(displs.back() + counts.back());
+	}
+	amrex::ParallelDescriptor::Gatherv(local.data(), nlocal, global.data(), counts, displs, ioproc);
+	return global;
+}
+
+// union-find with path halving
+template <typename T> auto findRoot(std::vector<T> &parent, T x) -> T
+{
+	while (parent[x] != x) {
+		parent[x] = parent[parent[x]];
+		x = parent[x];
+	}
+	return x;
+}
+
+template <typename T> void unite(std::vector<T> &parent, T a, T b)
+{
+	a = findRoot(parent, a);
+	b = findRoot(parent, b);
+	if (a != b) {
+		// the smaller index becomes the root, so that the result does not depend on the order of the unions
+		parent[std::max(a, b)] = std::min(a, b);
+	}
+}
+
+// a connection is stored as (label, neighbour label, periodic image of the neighbour along each direction)
+constexpr int edgeStride = 2 + AMREX_SPACEDIM;
+
+// the periodic image (-1, 0, or +1 domain lengths along each direction) of the cell iv, which is adjacent to the domain
+auto periodicImage(amrex::Box const &domain, amrex::IntVect const &iv) -> amrex::IntVect
+{
+	amrex::IntVect image(0);
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		if (iv[idim] < domain.smallEnd(idim)) {
+			image[idim] = -1;
+		} else if (iv[idim] > domain.bigEnd(idim)) {
+			image[idim] = 1;
+		}
+	}
+	return image;
+}
+
+void pushEdge(std::vector<amrex::Long> &edges, amrex::Long a, amrex::Long b, amrex::IntVect const &image)
+{
+	edges.push_back(a);
+	edges.push_back(b);
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		edges.push_back(image[idim]);
+	}
+}
+
+// translate the positions of the cells of a component by D
+void translateSums(DiagClumps::sums_t &s, std::array<amrex::Real, 3> const &D)
+{
+	for (int d = 0; d < 3; ++d) {
+		s[DiagClumps::sumMassPos2] += 2.0 * D[d] * s[DiagClumps::sumMassPosX + d] + s[DiagClumps::sumMass] * D[d] * D[d];
+		s[DiagClumps::sumMassPosX + d] += s[DiagClumps::sumMass] * D[d];
+	}
+	for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+		s[DiagClumps::sumLoX + d] += D[d];
+		s[DiagClumps::sumHiX + d] += D[d];
+	}
+}
+} // namespace
+
+auto DiagClumps::emptySums() -> sums_t
+{
+	sums_t s{};
+	s[sumFieldMax] = AMREX_REAL_LOWEST;
+	for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+		s[sumLoX + d] = AMREX_REAL_MAX;
+		s[sumHiX + d] = AMREX_REAL_LOWEST;
+	}
+	return s;
+}
+
+void DiagClumps::mergeSums(sums_t &a, sums_t const &b)
+{
+	for (int n = 0; n < sumFieldMax; ++n) {
+		a[n] += b[n];
+	}
+	a[sumFieldMax] = std::max(a[sumFieldMax], b[sumFieldMax]);
+	for (int d = 0; d < 3; ++d) {
+		a[sumLoX + d] = std::min(a[sumLoX + d], b[sumLoX + d]);
+		a[sumHiX + d] = std::max(a[sumHiX + d], b[sumHiX + d]);
+	}
+}
+
+void DiagClumps::init(const std::string &a_prefix, std::string_view a_diagName)
+{
+	DiagBase::init(a_prefix, a_diagName);
+
+	amrex::ParmParse const pp(a_prefix);
+	pp.query("field_name", m_fieldName);
+	pp.get("threshold", m_threshold);
+	std::string select{"above"};
+	pp.query("select", select);
+	if (select == "above") {
+		m_selectAbove = true;
+	} else if (select == "below") {
+		m_selectAbove = false;
+	} else {
+		amrex::Abort("[DiagClumps] select must be either 'above' or 'below'!");
+	}
+	pp.query("min_cells", m_minCells);
+	pp.query("match_ids", m_matchIds);
+}
+
+void DiagClumps::addVars(amrex::Vector<std::string> &a_varList)
+{
+	DiagBase::addVars(a_varList);
+	a_varList.push_back("gasDensity");
+	a_varList.push_back("x-GasMomentum");
+	a_varList.push_back("y-GasMomentum");
+	a_varList.push_back("z-GasMomentum");
+	a_varList.push_back(m_fieldName);
+}
+
+void DiagClumps::prepare(int a_nlevels, const amrex::Vector<amrex::Geometry> &a_geoms, const amrex::Vector<amrex::BoxArray> &a_grids,
+			 const amrex::Vector<amrex::DistributionMapping> &a_dmap, const amrex::Vector<std::string> &a_varNames)
+{
+	if (first_time) {
+		DiagBase::prepare(a_nlevels, a_geoms, a_grids, a_dmap, a_varNames);
+		first_time = false;
+	}
+
+	m_geoms.resize(a_nlevels);
+	m_refRatio.resize(a_nlevels - 1);
+	for (int lev = 0; lev < a_nlevels; lev++) {
+		m_geoms[lev] = a_geoms[lev];
+		if (lev > 0) {
+			m_refRatio[lev - 1] = refRatioBetween(a_geoms[lev - 1], a_geoms[lev]);
+		}
+	}
+}
+
+void DiagClumps::processDiag(int a_nstep, const amrex::Real &a_time, const amrex::Vector<const amrex::MultiFab *> &a_state,
+			     const amrex::Vector<std::string> &a_stateVar)
+{
+	BL_PROFILE("DiagClumps::processDiag()");
+
+	const int nlevels = static_cast<int>(a_state.size());
+	const int ncomp = a_state[0]->nComp();
+	const int rho_idx = getFieldIndex("gasDensity", a_stateVar);
+	const std::array<int, 3> mom_idx = {getFieldIndex("x-GasMomentum", a_stateVar), getFieldIndex("y-GasMomentum", a_stateVar),
+					    getFieldIndex("z-GasMomentum", a_stateVar)};
+	const int field_idx = getFieldIndex(m_fieldName, a_stateVar);
+	const amrex::MFInfo hostInfo = amrex::MFInfo().SetArena(amrex::The_Pinned_Arena());
+
+	// partial sums of the connected components within each box, indexed by label
+	std::map<amrex::Long, sums_t> localSums;
+	// labels of components that are connected across box or level boundaries (edgeStride entries per connection)
+	std::vector<amrex::Long> localEdges;
+	amrex::Vector<LabelFab> labels(nlevels);
+
+	amrex::Long levelOffset = 0;
+	for (int lev = 0; lev < nlevels; ++lev) {
+		const amrex::BoxArray &ba = a_state[lev]->boxArray();
+		const amrex::DistributionMapping &dm = a_state[lev]->DistributionMap();
+
+		// the label of a cell is the global index of the root cell of its component, so labels are unique across boxes and levels
+		amrex::Vector<amrex::Long> cellOffset(ba.size());
+		for (int b = 0; b < ba.size(); ++b) {
+			cellOffset[b] = levelOffset;
+			levelOffset += ba[b].numPts();
+		}
+
+		// host copies of the state and of the mask of cells that are not covered by the next-finer level
+		amrex::MultiFab hostState(ba, dm, ncomp, 0, hostInfo);
+		amrex::MultiFab::Copy(hostState, *a_state[lev], 0, 0, ncomp, 0);
+		amrex::iMultiFab hostMask(ba, dm, 1, 0, hostInfo);
+		if (lev < nlevels - 1) {
+			const amrex::iMultiFab mask =
+			    amrex::makeFineMask(*a_state[lev], *a_state[lev + 1], amrex::IntVect(0), m_refRatio[lev], amrex::Periodicity::NonPeriodic(), 1, 0);
+			amrex::iMultiFab::Copy(hostMask, mask, 0, 0, 1, 0);
+		} else {
+			hostMask.setVal(1);
+		}
+		amrex::Gpu::streamSynchronize();
+
+		labels[lev].define(ba, dm, 1, 1, hostInfo);
+		labels[lev].setVal(-1);
+		amrex::Gpu::streamSynchronize();
+
+		const auto dx = m_geoms[lev].CellSizeArray();
+		const auto prob_lo = m_geoms[lev].ProbLoArray();
+		const amrex::Real dV = AMREX_D_TERM(dx[0], *dx[1], *dx[2]);
+
+		// 1. union-find over the cells of each box
+		for (amrex::MFIter mfi(labels[lev]); mfi.isValid(); ++mfi) {
+			const amrex::Box &bx = mfi.validbox();
+			auto const &state = hostState.const_array(mfi);
+			auto const &uncovered = hostMask.const_array(mfi);
+			auto const &lab = labels[lev].array(mfi);
+
+			auto isSelected = [&](int i, int j, int k) {
+				if (uncovered(i, j, k) == 0) {
+					return false;
+				}
+				const amrex::Real val = state(i, j, k, field_idx);
+				if (m_selectAbove ? !(val > m_threshold) : !(val < m_threshold)) {
+					return false;
+				}
+				for (auto const &filter : m_filters) {
+					const amrex::Real fval = state(i, j, k, filter.m_fdata.m_filterVarIdx);
+					if (fval < filter.m_fdata.m_low_val || fval > filter.m_fdata.m_high_val) {
+						return false;
+					}
+				}
+				return true;
+			};
+
+			std::vector<amrex::Long> parent(bx.numPts(), -1);
+			amrex::LoopOnCpu(bx, [&](int i, int j, int k) {
+				if (!isSelected(i, j, k)) {
+					return;
+				}
+				const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+				const amrex::Long idx = bx.index(iv);
+				parent[idx] = idx;
+				// connect to the (already visited) lower neighbours
+				for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+					const amrex::IntVect nb = iv - amrex::IntVect::TheDimensionVector(idim);
+					if (bx.contains(nb) && parent[bx.index(nb)] >= 0) {
+						unite(parent, idx, bx.index(nb));
+					}
+				}
+			});
+
+			amrex::LoopOnCpu(bx, [&](int i, int j, int k) {
+				const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+				const amrex::Long idx = bx.index(iv);
+				if (parent[idx] < 0) {
+					return;
+				}
+				const amrex::Long label = cellOffset[mfi.index()] + findRoot(parent, idx);
+				lab(i, j, k) = label;
+
+				// accumulate the integrated quantities of the component
+				sums_t &s = localSums.try_emplace(label, emptySums()).first->second;
+				const amrex::Real rho = state(i, j, k, rho_idx);
+				std::array<amrex::Real, 3> x{};
+				for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+					x[idim] = prob_lo[idim] + (iv[idim] + 0.5) * dx[idim];
+				}
+				amrex::Real vsq = 0.;
+				for (int d = 0; d < 3; ++d) {
+					const amrex::Real mom = state(i, j, k, mom_idx[d]);
+					s[sumMomX + d] += mom * dV;
+					s[sumMassPosX + d] += rho * x[d] * dV;
+					s[sumMassPos2] += rho * x[d] * x[d] * dV;
+					vsq += (mom / rho) * (mom / rho);
+				}
+				s[sumCells] += 1.;
+				s[sumVolume] += dV;
+				s[sumMass] += rho * dV;
+				s[sumMassVel2] += rho * vsq * dV;
+				s[sumFieldMax] = std::max(s[sumFieldMax], state(i, j, k, field_idx));
+				for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+					s[sumLoX + idim] = std::min(s[sumLoX + idim], x[idim] - 0.5 * dx[idim]);
+					s[sumHiX + idim] = std::max(s[sumHiX + idim], x[idim] + 0.5 * dx[idim]);
+				}
+			});
+		}
+
+		// 2. connections across box boundaries on this level
+		const amrex::Box &domain = m_geoms[lev].Domain();
+		labels[lev].FillBoundary(m_geoms[lev].periodicity());
+		amrex::Gpu::streamSynchronize();
+		for (amrex::MFIter mfi(labels[lev]); mfi.isValid(); ++mfi) {
+			const amrex::Box &bx = mfi.validbox();
+			auto const &lab = labels[lev].const_array(mfi);
+			amrex::LoopOnCpu(bx, [&](int i, int j, int k) {
+				const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+				if (lab(iv) < 0) {
+					return;
+				}
+				for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+					for (int side = -1; side <= 1; side += 2) {
+						const amrex::IntVect nb = iv + side * amrex::IntVect::TheDimensionVector(idim);
+						// (each connection is seen from both boxes, so only record it once)
+						if (!bx.contains(nb) && lab(nb) > lab(iv)) {
+							pushEdge(localEdges, lab(iv), lab(nb), periodicImage(domain, nb));
+						}
+					}
+				}
+			});
+		}
+
+		// 3. connections across the coarse-fine boundary with the next-coarser level
+		if (lev > 0) {
+			const amrex::IntVect ratio = m_refRatio[lev - 1];
+			amrex::BoxArray cba = ba;
+			cba.coarsen(ratio);
+			cba.grow(1);
+			LabelFab crseLabels(cba, dm, 1, 0, hostInfo);
+			crseLabels.setVal(-1);
+			crseLabels.ParallelCopy(labels[lev - 1], 0, 0, 1, amrex::IntVect(0), amrex::IntVect(0), m_geoms[lev - 1].periodicity());
+			amrex::Gpu::streamSynchronize();
+
+			for (amrex::MFIter mfi(labels[lev]); mfi.isValid(); ++mfi) {
+				const amrex::Box &bx = mfi.validbox();
+				auto const &lab = labels[lev].const_array(mfi);
+				auto const &crseLab = crseLabels.const_array(mfi);
+				amrex::LoopOnCpu(bx, [&](int i, int j, int k) {
+					const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+					if (lab(iv) < 0) {
+						return;
+					}
+					for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+						for (int side = -1; side <= 1; side += 2) {
+							const amrex::IntVect nb = iv + side * amrex::IntVect::TheDimensionVector(idim);
+							if (bx.contains(nb)) {
+								continue;
+							}
+							// coarse cells covered by this level are not selected, so only uncovered coarse neighbours have a label
+							const amrex::Long crse = crseLab(amrex::coarsen(nb, ratio));
+							if (crse >= 0) {
+								pushEdge(localEdges, lab(iv), crse, periodicImage(domain, nb));
+							}
+						}
+					}
+				});
+			}
+		}
+	}
+
+	// 4. merge the components on the IO processor
+	std::vector<amrex::Long> compLabels;
+	std::vector<amrex::Real> compSums;
+	compLabels.reserve(localSums.size());
+	compSums.reserve(localSums.size() * nSums);
+	for (auto const &[label, s] : localSums) {
+		compLabels.push_back(label);
+		compSums.insert(compSums.end(), s.begin(), s.end());
+	}
+	const std::vector<amrex::Long> allLabels = gatherToIOProc(compLabels);
+	const std::vector<amrex::Real> allSums = gatherToIOProc(compSums);
+	const std::vector<amrex::Long> allEdges = gatherToIOProc(localEdges);
+
+	if (amrex::ParallelDescriptor::IOProcessor()) {
+		const int ncomps = static_cast<int>(allLabels.size());
+		std::unordered_map<amrex::Long, int> compIndex;
+		compIndex.reserve(ncomps);
+		for (int c = 0; c < ncomps; ++c) {
+			compIndex[allLabels[c]] = c;
+		}
+		std::vector<std::vector<std::pair<int, amrex::IntVect>>> neighbours(ncomps);
+		for (size_t e = 0; e + edgeStride <= allEdges.size(); e += edgeStride) {
+			const int a = compIndex.at(allEdges[e]);
+			const int b = compIndex.at(allEdges[e + 1]);
+			amrex::IntVect image(0);
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				image[idim] = static_cast<int>(allEdges[e + 2 + idim]);
+			}
+			neighbours[a].emplace_back(b, image);
+			neighbours[b].emplace_back(a, -image);
+		}
+
+		// find the connected components of the graph, and the periodic image of each component relative to the first
+		// component of its structure (for a structure that wraps around a periodic direction, the first image that is found is used)
+		std::vector<int> root(ncomps, -1);
+		std::vector<amrex::IntVect> image(ncomps, amrex::IntVect(0));
+		for (int c = 0; c < ncomps; ++c) {
+			if (root[c] >= 0) {
+				continue;
+			}
+			root[c] = c;
+			std::vector<int> stack{c};
+			while (!stack.empty()) {
+				const int a = stack.back();
+				stack.pop_back();
+				for (auto const &[b, nbImage] : neighbours[a]) {
+					if (root[b] < 0) {
+						root[b] = c;
+						image[b] = image[a] + nbImage;
+						stack.push_back(b);
+					}
+				}
+			}
+		}
+
+		const amrex::Geometry &geom0 = m_geoms[0];
+		std::map<int, sums_t> merged;
+		for (int c = 0; c < ncomps; ++c) {
+			sums_t s{};
+			std::copy(allSums.begin() + static_cast<std::ptrdiff_t>(c) * nSums, allSums.begin() + static_cast<std::ptrdiff_t>(c + 1) * nSums,
+				  s.begin());
+			if (image[c] != amrex::IntVect(0)) {
+				std::array<amrex::Real, 3> D{};
+				for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+					D[idim] = image[c][idim] * geom0.ProbLength(idim);
+				}
+				translateSums(s, D);
+			}
+			mergeSums(merged.try_emplace(root[c], emptySums()).first->second, s);
+		}
+
+		std::vector<Clump> clumps;
+		for (auto const &[root, s] : merged) {
+			if (s[sumCells] < m_minCells) {
+				continue;
+			}
+			Clump clump;
+			clump.sums = s;
+			const amrex::Real mass = s[sumMass];
+			amrex::Real pos2 = 0.;
+			amrex::Real vel2 = 0.;
+			amrex::Real diag2 = 0.;
+			for (int d = 0; d < 3; ++d) {
+				clump.pos[d] = s[sumMassPosX + d] / mass;
+				clump.vel[d] = s[sumMomX + d] / mass;
+				pos2 += clump.pos[d] * clump.pos[d];
+				vel2 += clump.vel[d] * clump.vel[d];
+				if (d < AMREX_SPACEDIM) {
+					diag2 += (s[sumHiX + d] - s[sumLoX + d]) * (s[sumHiX + d] - s[sumLoX + d]);
+				}
+			}
+			clump.radius = std::sqrt(std::max(s[sumMassPos2] / mass - pos2, 0.));
+			clump.sigma_v = std::sqrt(std::max(s[sumMassVel2] / mass - vel2, 0.));
+			clump.size = 0.5 * std::sqrt(diag2);
+
+			// wrap the centre of mass back into the domain along periodic directions
+			// (the bounding box is moved with it, so it may extend beyond the domain)
+			for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+				if (geom0.isPeriodic(d)) {
+					const amrex::Real L = geom0.ProbLength(d);
+					const amrex::Real shift = -L * std::floor((clump.pos[d] - geom0.ProbLo(d)) / L);
+					clump.pos[d] += shift;
+					clump.sums[sumLoX + d] += shift;
+					clump.sums[sumHiX + d] += shift;
+				}
+			}
+			clumps.push_back(clump);
+		}
+		std::sort(clumps.begin(), clumps.end(), [](Clump const &a, Clump const &b) { return a.sums[sumMass] > b.sums[sumMass]; });
+
+		matchClumps(clumps, a_time);
+		writeCatalogueToFile(a_nstep, a_time, clumps);
+		amrex::Print() << "[DiagClumps] found " << clumps.size() << " structures with " << m_fieldName << (m_selectAbove ? " > " : " < ")
+			       << m_threshold << "\n";
+	}
+}
+
+void DiagClumps::matchClumps(std::vector<Clump> &a_clumps, amrex::Real a_time)
+{
+	// match each structure (in order of decreasing mass) to the nearest unmatched structure of the previous output, whose
+	// position is advanced with its velocity. structures are matched if they are closer than the larger of their sizes
+	// (using the nearest periodic image along periodic directions).
+	std::vector<bool> used(m_prevClumps.size(), false);
+	const amrex::Real dt = a_time - m_prevTime;
+	for (auto &clump : a_clumps) {
+		int best = -1;
+		amrex::Real bestDist = AMREX_REAL_MAX;
+		if (m_matchIds != 0 && m_havePrevious) {
+			for (size_t p = 0; p < m_prevClumps.size(); ++p) {
+				if (used[p]) {
+					continue;
+				}
+				amrex::Real dist2 = 0.;
+				for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+					amrex::Real dx = clump.pos[d] - (m_prevClumps[p].pos[d] + m_prevClumps[p].vel[d] * dt);
+					if (m_geoms[0].isPeriodic(d)) {
+						// nearest periodic image
+						const amrex::Real L = m_geoms[0].ProbLength(d);
+						dx -= L * std::round(dx / L);
+					}
+					dist2 += dx * dx;
+				}
+				const amrex::Real dist = std::sqrt(dist2);
+				if (dist <= std::max(clump.size, m_prevClumps[p].size) && dist < bestDist) {
+					best = static_cast<int>(p);
+					bestDist = dist;
+				}
+			}
+		}
+		if (best >= 0) {
+			used[best] = true;
+			clump.id = m_prevClumps[best].id;
+			clump.matched = true;
+		} else {
+			clump.id = m_nextId++;
+			clump.matched = false;
+		}
+	}
+	m_prevClumps = a_clumps;
+	m_prevTime = a_time;
+	m_havePrevious = true;
+}
+
+void DiagClumps::writeCatalogueToFile(int a_nstep, const amrex::Real &a_time, std::vector<Clump> const &a_clumps)
+{
+	std::string diagfile;
+	if (m_interval > 0) {
+		diagfile = amrex::Concatenate(m_diagfile, a_nstep, 6);
+	}
+	if (m_per > 0.0) {
+		diagfile = m_diagfile + std::to_string(a_time);
+	}
+	diagfile = diagfile + ".dat";
+
+	std::ofstream catFile;
+	catFile.open(diagfile.c_str(), std::ios::out);
+	const int prec = 10;
+	const int width = 18;
+
+	// write cycle and simulation time
+	catFile << "# " << std::setw(width) << "time:" << " " << std::setw(width) << std::setprecision(17) << std::scientific << a_time << "\n";
+	catFile << "# " << std::setw(width) << "cycle:" << " " << std::setw(width) << a_nstep << "\n";
+	catFile << "# " << std::setw(width) << "selection:" << " " << m_fieldName << (m_selectAbove ? " > " : " < ") << m_threshold << "\n";
+	catFile << "# " << std::setw(width) << "structures:" << " " << std::setw(width) << a_clumps.size() << "\n";
+
+	// write column names
+	const std::vector<std::string> columns = {"id",	   "matched", "ncells",	 "volume", "mass",  "x_cm",    "y_cm", "z_cm", "vx_cm", "vy_cm",
+						  "vz_cm", "r_rms",   "sigma_v", m_fieldName + "_max", "x_lo", "y_lo", "z_lo", "x_hi",	"y_hi",	 "z_hi"};
+	for (auto const &col : columns) {
+		catFile << std::setw(width) << col << " ";
+	}
+	catFile << "\n";
+
+	for (auto const &clump : a_clumps) {
+		auto const &s = clump.sums;
+		catFile << std::setw(width) << clump.id << " " << std::setw(width) << static_cast<int>(clump.matched) << " " << std::setw(width)
+			<< static_cast<amrex::Long>(s[sumCells]) << " ";
+		const std::array<amrex::Real, 17> values = {s[sumVolume], s[sumMass],	 clump.pos[0],	 clump.pos[1], clump.pos[2], clump.vel[0],
+							    clump.vel[1], clump.vel[2], clump.radius,	 clump.sigma_v, s[sumFieldMax], s[sumLoX],
+							    s[sumLoY],	  s[sumLoZ],	s[sumHiX],	 s[sumHiY],	s[sumHiZ]};
+		for (amrex::Real const v : values) {
+			catFile << std::setw(width) << std::setprecision(prec) << std::scientific << v << " ";
+		}
+		catFile << "\n";
+	}
+
+	catFile.flush();
+	catFile.close();
+}
@@ -1,5 +1,15 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
 #include "DiagFramePlane.H"
+#include "AMReX_BLProfiler.H"
+#include "AMReX_BoxIterator.H"
 #include "AMReX_FPC.H"
+#include "AMReX_MultiFabUtil.H"
 #include "AMReX_ParmParse.H"
 #include "AMReX_PlotFileUtil.H"
 #include "AMReX_VisMF.H"
@@ -76,6 +86,29 @@ void DiagFramePlane::init(const std::string &a_prefix, std::string_view a_diagNa
 	} else {
 		amrex::Abort("Unknown interpolation type for " + a_prefix);
 	}
+
+	// Output format: AMReX plotfile, PNG images (one per field), or both
+	std::string format = "plotfile";
+	pp.query("format", format);
+	if (format == "plotfile") {
+		m_writePlotfile = true;
+		m_writeImages = false;
+	} else if (format == "png") {
+		m_writePlotfile = false;
+		m_writeImages = true;
+	} else if (format == "both") {
+		m_writePlotfile = true;
+		m_writeImages = true;
+	} else {
+		amrex::Abort("Unknown output format for " + a_prefix);
+	}
+	if (m_writeImages) {
+		pp.query("image_max_level", m_imageMaxLevel);
+		m_renderers.resize(nOutFields);
+		for (int f{0}; f < nOutFields; ++f) {
+			m_renderers[f].init(a_prefix, m_fieldNames[f]);
+		}
+	}
 }
 
 void DiagFramePlane::addVars(amrex::Vector<std::string> &a_varList)
@@ -156,6 +189,21 @@ void DiagFramePlane::prepare(int a_nlevels, const amrex::Vector<amrex::Geometry>
 		}
 	}
 
+	// Refinement ratios in the plane (these may differ between directions, see amr.ref_ratio_vect)
+	m_planeRefRatio.resize(a_nlevels - 1);
+	for (int lev = 1; lev < a_nlevels; lev++) {
+		amrex::IntVect const ratio = refRatioBetween(a_geoms[lev - 1], a_geoms[lev]);
+		amrex::IntVect rref(1);
+		int cdim = 0;
+		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+			if (idim != m_normal) {
+				rref[cdim] = ratio[idim];
+				cdim += 1;
+			}
+		}
+		m_planeRefRatio[lev - 1] = rref;
+	}
+
 	// Assemble the 2D slice boxArray
 	m_sliceBA.resize(a_nlevels);
 	m_sliceDM.resize(a_nlevels);
@@ -243,10 +291,9 @@ void DiagFramePlane::processDiag(int a_nstep, const amrex::Real &a_time, const a
 		amrex::Vector<amrex::Geometry> pltGeoms(nlevs);
 		pltGeoms[0] = m_geomLev0;
 		amrex::Vector<amrex::IntVect> ref_ratio;
-		amrex::IntVect const rref(AMREX_D_DECL(2, 2, 1));
 		for (int lev = 1; lev < nlevs; ++lev) {
-			pltGeoms[lev] = amrex::refine(pltGeoms[lev - 1], rref);
-			ref_ratio.push_back(rref);
+			pltGeoms[lev] = amrex::refine(pltGeoms[lev - 1], m_planeRefRatio[lev - 1]);
+			ref_ratio.push_back(m_planeRefRatio[lev - 1]);
 		}
 
 		// File name based on tep or time
@@ -257,8 +304,78 @@ void DiagFramePlane::processDiag(int a_nstep, const amrex::Real &a_time, const a
 		if (m_per > 0.0) {
 			diagfile = m_diagfile + std::to_string(a_time);
 		}
-		amrex::Vector<int> const step_array(nlevs, a_nstep);
-		Write2DMultiLevelPlotfile(diagfile, nlevs, GetVecOfConstPtrs(planeData), m_fieldNames, pltGeoms, a_time, step_array, ref_ratio);
+		if (m_writePlotfile) {
+			amrex::Vector<int> const step_array(nlevs, a_nstep);
+			Write2DMultiLevelPlotfile(diagfile, nlevs, GetVecOfConstPtrs(planeData), m_fieldNames, pltGeoms, a_time, step_array, ref_ratio);
+		}
+		if (m_writeImages) {
+			WritePNGImages(diagfile, nlevs, planeData, pltGeoms);
+		}
+	}
+}
+
+void DiagFramePlane::WritePNGImages(const std::string &a_prefix, int a_nlevels, const amrex::Vector<amrex::MultiFab> &a_slice,
+				    const amrex::Vector<amrex::Geometry> &a_geoms)
+{
+	BL_PROFILE("DiagFramePlane::WritePNGImages()");
+
+	int const nOutFields = static_cast<int>(m_fieldNames.size());
+	int const ioProc = amrex::ParallelDescriptor::IOProcessorNumber();
+
+	// The image has the resolution of the finest level of the slice, or of level image_max_level if that is coarser
+	int const imageLev = (m_imageMaxLevel >= 0) ? std::min(m_imageMaxLevel, a_nlevels - 1) : a_nlevels - 1;
+
+	// Average the finer levels down onto the image level, one level at a time on the ranks that hold the data,
+	// so that no cell finer than a pixel is sent to the IO rank
+	amrex::MultiFab averaged;
+	for (int lev = a_nlevels - 1; lev > imageLev; --lev) {
+		amrex::MultiFab crse(a_slice[lev - 1].boxArray(), a_slice[lev - 1].DistributionMap(), nOutFields, 0);
+		amrex::MultiFab::Copy(crse, a_slice[lev - 1], 0, 0, nOutFields, 0);
+		amrex::average_down((lev == a_nlevels - 1) ? a_slice[lev] : averaged, crse, 0, nOutFields, m_planeRefRatio[lev - 1]);
+		averaged = std::move(crse);
+	}
+
+	// Gather the boxes of the slice on levels 0 to imageLev onto the IO rank
+	// (only the cells that intersect the slice are sent, not the whole domain of each level)
+	amrex::Vector<amrex::MultiFab> gathered(imageLev + 1);
+	for (int lev = 0; lev <= imageLev; ++lev) {
+		amrex::MultiFab const &src = (lev == imageLev && imageLev < a_nlevels - 1) ? averaged : a_slice[lev];
+		amrex::DistributionMapping const dm(amrex::Vector<int>(src.boxArray().size(), ioProc));
+		gathered[lev].define(src.boxArray(), dm, nOutFields, 0, amrex::MFInfo().SetArena(amrex::The_Pinned_Arena()));
+		gathered[lev].ParallelCopy(src, 0, 0, nOutFields);
+	}
+	amrex::Gpu::streamSynchronize();
+
+	if (!amrex::ParallelDescriptor::IOProcessor()) {
+		return;
+	}
+
+	// Each pixel is a cell of the image level, and takes the value of the finest level that covers it
+	// (pixels that are not covered by the slice on any level are left as NaN)
+	amrex::Box const &imageDomain = a_geoms[imageLev].Domain();
+	int const width = imageDomain.length(0);
+	int const height = imageDomain.length(1);
+	amrex::Vector<amrex::IntVect> ratioToImage(imageLev + 1, amrex::IntVect(1));
+	for (int lev = imageLev - 1; lev >= 0; --lev) {
+		ratioToImage[lev] = ratioToImage[lev + 1] * m_planeRefRatio[lev];
+	}
+
+	std::vector<amrex::Real> values(static_cast<std::size_t>(width) * height);
+	for (int f{0}; f < nOutFields; ++f) {
+		std::fill(values.begin(), values.end(), std::numeric_limits<amrex::Real>::quiet_NaN());
+		for (int lev = 0; lev <= imageLev; ++lev) {
+			for (amrex::MFIter mfi(gathered[lev]); mfi.isValid(); ++mfi) {
+				auto const &data = gathered[lev].const_array(mfi);
+				amrex::Box const pixels = amrex::refine(mfi.validbox(), ratioToImage[lev]) & imageDomain;
+				for (amrex::BoxIterator bit(pixels); bit.ok(); ++bit) {
+					amrex::IntVect const pixel = bit();
+					int const x = pixel[0] - imageDomain.smallEnd(0);
+					int const y = pixel[1] - imageDomain.smallEnd(1);
+					values[x + static_cast<std::size_t>(width) * y] = data(amrex::coarsen(pixel, ratioToImage[lev]), f);
+				}
+			}
+		}
+		m_renderers[f].write(a_prefix + "_" + m_fieldNames[f] + ".png", values, width, height);
 	}
 }
 
@@ -344,8 +461,22 @@ void DiagFramePlane::Write2DPlotfileHeader(std::ostream &HeaderFile, int nlevels
 		HeaderFile << geom[0].ProbHi(idim) << ' ';
 	}
 	HeaderFile << '\n';
+	// the plotfile format stores a single refinement ratio per level, which is only valid if the in-plane ratio is
+	// the same in both directions. Otherwise, the in-plane ratio is written as (rx,ry), which amrex::IntVect can read.
 	for (int i = 0; i < finest_level; ++i) {
-		HeaderFile << ref_ratio[i][0] << ' ';
+		bool isotropic = true;
+		for (int idim = 1; idim < lowerSpaceDim; ++idim) {
+			isotropic = isotropic && (ref_ratio[i][idim] == ref_ratio[i][0]);
+		}
+		if (isotropic) {
+			HeaderFile << ref_ratio[i][0] << ' ';
+		} else {
+			HeaderFile << '(';
+			for (int idim = 0; idim < lowerSpaceDim; ++idim) {
+				HeaderFile << ref_ratio[i][idim] << ((idim < lowerSpaceDim - 1) ? ',' : ')');
+			}
+			HeaderFile << ' ';
+		}
 	}
 	HeaderFile << '\n';
 	for (int i = 0; i <= finest_level; ++i) {
@@ -1,3 +1,4 @@
+#include <cmath>
 #include <ios>
 
 #include "AMReX_BLassert.H"
@@ -78,7 +79,8 @@ void DiagPDF::prepare(int a_nlevels, const amrex::Vector<amrex::Geometry> &a_geo
 	for (int lev = 0; lev < a_nlevels; lev++) {
 		m_geoms[lev] = a_geoms[lev];
 		if (lev > 0) {
-			m_refRatio[lev - 1] = amrex::IntVect(static_cast<int>(a_geoms[lev - 1].CellSize(0) / a_geoms[lev].CellSize(0)));
+			// the refinement ratio may differ between directions (amr.ref_ratio_vect)
+			m_refRatio[lev - 1] = refRatioBetween(a_geoms[lev - 1], a_geoms[lev]);
 		}
 	}
 }
@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <ios>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "AMReX_BLProfiler.H"
+#include "AMReX_GpuContainers.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Print.H"
+#include "AMReX_Utility.H"
+
+#include "DiagProbes.H"
+
+// Samples the state (or derived) variables at a set of points, or along lines of equally-spaced points, and appends the values
+// to one text file per probe. Each point is sampled from the finest level that covers it. The values on each rank are combined
+// with a single reduction onto the IO processor, and the rows are buffered so that the files are written only every few outputs.
+
+namespace
+{
+auto formatPoint(std::array<amrex::Real, AMREX_SPACEDIM> const &pos) -> std::string
+{
+	std::ostringstream os;
+	os << std::setprecision(std::numeric_limits<amrex::Real>::max_digits10) << "(";
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		os << pos[idim] << ((idim < AMREX_SPACEDIM - 1) ? ", " : ")");
+	}
+	return os.str();
+}
+} // namespace
+
+void DiagProbes::init(const std::string &a_prefix, std::string_view a_diagName)
+{
+	DiagBase::init(a_prefix, a_diagName);
+
+	if (!m_filters.empty()) {
+		amrex::Print() << " Filters are not available on DiagProbes and will be discarded \n";
+	}
+
+	amrex::ParmParse const pp(a_prefix);
+
+	// Outputted variables
+	int const nOutFields = pp.countval("field_names");
+	AMREX_ASSERT(nOutFields > 0);
+	m_fieldNames.resize(nOutFields);
+	m_fieldIndices_d.resize(nOutFields);
+	for (int f{0}; f < nOutFields; ++f) {
+		pp.get("field_names", m_fieldNames[f], f);
+	}
+
+	// Interpolation
+	std::string intType = "None";
+	pp.query("interpolation", intType);
+	if (intType == "None") {
+		m_interpType = None;
+	} else if (intType == "Linear") {
+		m_interpType = Linear;
+	} else {
+		amrex::Abort("Unknown interpolation type for " + a_prefix);
+	}
+
+	pp.query("buffer_size", m_bufferSize);
+	m_bufferSize = std::max(m_bufferSize, 1);
+
+	// Probes
+	int const nProbes = pp.countval("probes");
+	AMREX_ASSERT(nProbes > 0);
+	for (int n{0}; n < nProbes; ++n) {
+		Probe probe;
+		pp.get("probes", probe.name, n);
+		std::string const probe_prefix = a_prefix + "." + probe.name;
+		amrex::ParmParse const ppp(probe_prefix);
+
+		std::string type = "point";
+		ppp.query("type", type);
+		amrex::Vector<amrex::Real> start;
+		amrex::Vector<amrex::Real> end;
+		if (type == "point") {
+			ppp.getarr("position", start);
+			end = start;
+		} else if (type == "line") {
+			probe.isLine = true;
+			ppp.getarr("start", start);
+			ppp.getarr("end", end);
+			ppp.get("npoints", probe.npoints);
+			if (probe.npoints < 2) {
+				amrex::Abort("A line probe needs at least 2 points: " + probe_prefix);
+			}
+		} else {
+			amrex::Abort("Unknown probe type for " + probe_prefix);
+		}
+		// (the components beyond AMREX_SPACEDIM are ignored, so that the same inputs can be used in fewer dimensions)
+		if (start.size() < AMREX_SPACEDIM || end.size() < AMREX_SPACEDIM) {
+			amrex::Abort("The probe coordinates must have (at least) AMREX_SPACEDIM components: " + probe_prefix);
+		}
+
+		probe.firstSample = static_cast<int>(m_samplePos.size());
+		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+			probe.start[idim] = start[idim];
+			probe.end[idim] = end[idim];
+		}
+		for (int p{0}; p < probe.npoints; ++p) {
+			const amrex::Real s = probe.isLine ? static_cast<amrex::Real>(p) / static_cast<amrex::Real>(probe.npoints - 1) : 0.0;
+			amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> pos{};
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				pos[idim] = (1.0 - s) * start[idim] + s * end[idim];
+			}
+			m_samplePos.push_back(pos);
+		}
+		m_probes.push_back(probe);
+	}
+
+	m_samplePos_d.resize(m_samplePos.size());
+	amrex::Gpu::copy(amrex::Gpu::hostToDevice, m_samplePos.begin(), m_samplePos.end(), m_samplePos_d.begin());
+}
+
+void DiagProbes::addVars(amrex::Vector<std::string> &a_varList)
+{
+	DiagBase::addVars(a_varList);
+	for (const auto &v : m_fieldNames) {
+		a_varList.push_back(v);
+	}
+}
+
+void DiagProbes::prepare(int a_nlevels, const amrex::Vector<amrex::Geometry> &a_geoms, const amrex::Vector<amrex::BoxArray> &a_grids,
+			 const amrex::Vector<amrex::DistributionMapping> &a_dmap, const amrex::Vector<std::string> &a_varNames)
+{
+	if (first_time) {
+		int const nOutFields = static_cast<int>(m_fieldIndices_d.size());
+		amrex::Vector<int> m_fieldIndices(nOutFields, 0);
+		for (int f{0}; f < nOutFields; ++f) {
+			m_fieldIndices[f] = getFieldIndex(m_fieldNames[f], a_varNames);
+		}
+		amrex::Gpu::copy(amrex::Gpu::hostToDevice, m_fieldIndices.begin(), m_fieldIndices.end(), m_fieldIndices_d.begin());
+
+		// all of the points must be inside the domain
+		amrex::RealBox const &domain = a_geoms[0].ProbDomain();
+		for (auto const &pos : m_samplePos) {
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				if (pos[idim] < domain.lo(idim) || pos[idim] > domain.hi(idim)) {
+					amrex::Abort("A probe point of " + m_diagfile + " is outside of the domain!");
+				}
+			}
+		}
+		first_time = false;
+	}
+
+	// the points only need to be located again when the grids have changed
+	bool gridsChanged = (static_cast<int>(m_grids.size()) != a_nlevels);
+	for (int lev = 0; lev < a_nlevels && !gridsChanged; ++lev) {
+		gridsChanged = !(m_grids[lev] == a_grids[lev]) || (m_dmap[lev] != a_dmap[lev]);
+	}
+	if (!gridsChanged) {
+		return;
+	}
+
+	m_geoms.resize(a_nlevels);
+	m_grids.resize(a_nlevels);
+	m_dmap.resize(a_nlevels);
+	for (int lev = 0; lev < a_nlevels; ++lev) {
+		m_geoms[lev] = a_geoms[lev];
+		m_grids[lev] = a_grids[lev];
+		m_dmap[lev] = a_dmap[lev];
+	}
+
+	// find the finest level that covers each point, and the box that contains it on that level
+	m_localSamples.assign(a_nlevels, {});
+	std::vector<bool> found(m_samplePos.size(), false);
+	for (int lev = a_nlevels - 1; lev >= 0; --lev) {
+		amrex::Box const &domain = a_geoms[lev].Domain();
+		for (int s{0}; s < static_cast<int>(m_samplePos.size()); ++s) {
+			if (found[s]) {
+				continue;
+			}
+			amrex::IntVect iv;
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				const int i = static_cast<int>(std::floor((m_samplePos[s][idim] - a_geoms[lev].ProbLo(idim)) * a_geoms[lev].InvCellSize(idim)));
+				iv[idim] = std::clamp(i, domain.smallEnd(idim), domain.bigEnd(idim));
+			}
+			auto const isects = a_grids[lev].intersections(amrex::Box(iv, iv));
+			if (!isects.empty()) {
+				found[s] = true;
+				const int boxIndex = isects[0].first;
+				if (a_dmap[lev][boxIndex] == amrex::ParallelDescriptor::MyProc()) {
+					m_localSamples[lev][boxIndex].push_back(s);
+				}
+			}
+		}
+	}
+}
+
+void DiagProbes::processDiag(int a_nstep, const amrex::Real &a_time, const amrex::Vector<const amrex::MultiFab *> &a_state,
+			     const amrex::Vector<std::string> & /*a_varNames*/)
+{
+	BL_PROFILE("DiagProbes::processDiag()");
+
+	const int nvars = static_cast<int>(m_fieldNames.size());
+	const int nsamples = static_cast<int>(m_samplePos.size());
+	amrex::Vector<amrex::Real> values(static_cast<size_t>(nsamples) * nvars, 0.0);
+
+	auto const *samplePos = m_samplePos_d.data();
+	auto const *fieldIdx = m_fieldIndices_d.data();
+	const bool linear = (m_interpType == Linear);
+
+	for (int lev = 0; lev < static_cast<int>(m_localSamples.size()); ++lev) {
+		amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const problo = m_geoms[lev].ProbLoArray();
+		amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const dxinv = m_geoms[lev].InvCellSizeArray();
+		amrex::Box const domain = m_geoms[lev].Domain();
+
+		for (amrex::MFIter mfi(*a_state[lev]); mfi.isValid(); ++mfi) {
+			auto it = m_localSamples[lev].find(mfi.index());
+			if (it == m_localSamples[lev].end()) {
+				continue;
+			}
+			std::vector<int> const &ids = it->second;
+			const int npts = static_cast<int>(ids.size());
+			amrex::Gpu::DeviceVector<int> ids_d(npts);
+			amrex::Gpu::copy(amrex::Gpu::hostToDevice, ids.begin(), ids.end(), ids_d.begin());
+			amrex::Gpu::DeviceVector<amrex::Real> out_d(static_cast<size_t>(npts) * nvars);
+			auto const *idsPtr = ids_d.data();
+			auto *outPtr = out_d.data();
+			auto const &state = a_state[lev]->const_array(mfi);
+
+			amrex::ParallelFor(npts, [=] AMREX_GPU_DEVICE(int m) noexcept {
+				auto const &pos = samplePos[idsPtr[m]];
+				// with linear interpolation, the lower corner of the cells that surround the point (this may be a ghost cell),
+				// otherwise the cell that contains the point
+				amrex::IntVect iv;
+				amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> frac{};
+				for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+					const amrex::Real x = (pos[idim] - problo[idim]) * dxinv[idim];
+					if (linear) {
+						iv[idim] = static_cast<int>(std::floor(x - 0.5));
+						frac[idim] = (x - 0.5) - static_cast<amrex::Real>(iv[idim]);
+					} else {
+						iv[idim] = amrex::min(static_cast<int>(std::floor(x)), domain.bigEnd(idim));
+					}
+				}
+				for (int v = 0; v < nvars; ++v) {
+					amrex::Real val = 0.0;
+					for (int corner = 0; corner < (linear ? (1 << AMREX_SPACEDIM) : 1); ++corner) {
+						amrex::IntVect civ = iv;
+						amrex::Real wgt = 1.0;
+						for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+							if (((corner >> idim) & 1) != 0) {
+								civ[idim] += 1;
+								wgt *= frac[idim];
+							} else if (linear) {
+								wgt *= 1.0 - frac[idim];
+							}
+						}
+						val += wgt * state(civ, fieldIdx[v]);
+					}
+					outPtr[m * nvars + v] = val;
+				}
+			});
+
+			amrex::Vector<amrex::Real> out(static_cast<size_t>(npts) * nvars);
+			amrex::Gpu::copy(amrex::Gpu::deviceToHost, out_d.begin(), out_d.end(), out.begin());
+			for (int m{0}; m < npts; ++m) {
+				for (int v{0}; v < nvars; ++v) {
+					values[static_cast<size_t>(ids[m]) * nvars + v] = out[static_cast<size_t>(m) * nvars + v];
+				}
+			}
+		}
+	}
+
+	// each point is sampled on exactly one rank
+	amrex::ParallelDescriptor::ReduceRealSum(values.data(), static_cast<int>(values.size()), amrex::ParallelDescriptor::IOProcessorNumber());
+
+	if (amrex::ParallelDescriptor::IOProcessor()) {
+		for (auto &probe : m_probes) {
+			std::ostringstream os;
+			os << std::setprecision(std::numeric_limits<amrex::Real>::max_digits10);
+			if (!probe.headerWritten) {
+				if (probe.isLine) {
+					os << "# line probe " << probe.name << " from " << formatPoint(probe.start) << " to " << formatPoint(probe.end)
+					   << " with " << probe.npoints << " points\n";
+				} else {
+					os << "# point probe " << probe.name << " at " << formatPoint(probe.start) << "\n";
+				}
+				os << "# step time";
+				for (auto const &field : m_fieldNames) {
+					for (int p{0}; p < probe.npoints; ++p) {
+						os << " " << field;
+						if (probe.isLine) {
+							os << "[" << p << "]";
+						}
+					}
+				}
+				os << "\n";
+				probe.headerWritten = true;
+			}
+			os << a_nstep << " " << a_time;
+			for (int v{0}; v < nvars; ++v) {
+				for (int p{0}; p < probe.npoints; ++p) {
+					os << " " << values[static_cast<size_t>(probe.firstSample + p) * nvars + v];
+				}
+			}
+			os << "\n";
+			probe.buffer += os.str();
+		}
+
+		++m_bufferedRows;
+		if (m_bufferedRows >= m_bufferSize) {
+			close();
+		}
+	}
+}
+
+void DiagProbes::close()
+{
+	if (!amrex::ParallelDescriptor::IOProcessor()) {
+		return;
+	}
+	for (auto &probe : m_probes) {
+		if (probe.buffer.empty()) {
+			continue;
+		}
+		std::string const fileName = m_diagfile + "_" + probe.name + ".txt";
+		std::ofstream file(fileName, std::ofstream::out | std::ofstream::app);
+		if (!file.good()) {
+			amrex::FileOpenFailed(fileName);
+		}
+		file << probe.buffer;
+		probe.buffer.clear();
+	}
+	m_bufferedRows = 0;
+}
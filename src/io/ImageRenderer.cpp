@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "AMReX.H"
+#include "AMReX_BLProfiler.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Utility.H"
+
+#include "ImageRenderer.H"
+#include "util/png_writer.hpp"
+
+namespace
+{
+using Color = std::array<std::uint8_t, 3>;
+
+// colormaps, sampled at 9 equally-spaced points and linearly interpolated in between
+// (viridis, magma, inferno and plasma are the perceptually-uniform colormaps of matplotlib)
+const std::map<std::string, std::array<Color, 9>> colormaps{
+    {"viridis",
+     {{{68, 1, 84}, {71, 44, 122}, {59, 81, 139}, {44, 113, 142}, {33, 144, 141}, {39, 173, 129}, {92, 200, 99}, {170, 220, 50}, {253, 231, 37}}}},
+    {"magma",
+     {{{0, 0, 4}, {28, 16, 68}, {79, 18, 123}, {129, 37, 129}, {181, 54, 122}, {229, 80, 100}, {251, 135, 97}, {254, 194, 135}, {252, 253, 191}}}},
+    {"inferno",
+     {{{0, 0, 4}, {31, 12, 72}, {85, 15, 109}, {136, 34, 106}, {186, 54, 85}, {227, 89, 51}, {249, 140, 10}, {249, 201, 50}, {252, 255, 164}}}},
+    {"plasma",
+     {{{13, 8, 135}, {75, 3, 161}, {125, 3, 168}, {168, 34, 150}, {203, 70, 121}, {229, 107, 93}, {248, 148, 65}, {253, 195, 40}, {240, 249, 33}}}},
+    {"grayscale",
+     {{{0, 0, 0}, {32, 32, 32}, {64, 64, 64}, {96, 96, 96}, {128, 128, 128}, {159, 159, 159}, {191, 191, 191}, {223, 223, 223}, {255, 255, 255}}}},
+};
+
+// colour of the normalized value s in [0, 1]
+auto mapColor(std::array<Color, 9> const &cmap, amrex::Real s) -> Color
+{
+	const amrex::Real x = std::clamp(s, 0.0, 1.0) * static_cast<amrex::Real>(cmap.size() - 1);
+	const int i = std::min(static_cast<int>(x), static_cast<int>(cmap.size()) - 2);
+	const amrex::Real w = x - i;
+	Color c{};
+	for (int n = 0; n < 3; ++n) {
+		c[n] = static_cast<std::uint8_t>(std::lround((1.0 - w) * cmap[i][n] + w * cmap[i + 1][n]));
+	}
+	return c;
+}
+} // namespace
+
+void ImageRenderer::init(std::string const &a_prefix, std::string const &a_varName)
+{
+	for (std::string const &prefix : {a_prefix, a_prefix + "." + a_varName}) {
+		amrex::ParmParse const pp(prefix);
+		pp.query("colormap", m_colormap);
+
+		std::string scale;
+		if (pp.query("scale", scale) != 0) {
+			if (scale == "linear") {
+				m_logScale = false;
+			} else if (scale == "log") {
+				m_logScale = true;
+			} else {
+				amrex::Abort("[ImageRenderer] invalid " + prefix + ".scale: " + scale + " (must be 'linear' or 'log')");
+			}
+		}
+
+		std::vector<amrex::Real> range;
+		if (pp.queryarr("range", range) != 0) {
+			if (range.size() != 2 || !(range[1] > range[0])) {
+				amrex::Abort("[ImageRenderer] " + prefix + ".range must be two increasing values!");
+			}
+			m_fixedRange = true;
+			m_min = range[0];
+			m_max = range[1];
+		}
+	}
+
+	if (colormaps.count(m_colormap) == 0) {
+		std::string names;
+		for (auto const &[name, cmap] : colormaps) {
+			names += " " + name;
+		}
+		amrex::Abort("[ImageRenderer] unknown colormap " + m_colormap + " (available:" + names + ")");
+	}
+	if (m_logScale && m_fixedRange && !(m_min > 0.)) {
+		amrex::Abort("[ImageRenderer] the range of a log scale must be positive!");
+	}
+}
+
+void ImageRenderer::write(std::string const &a_fileName, std::vector<amrex::Real> const &a_values, const int a_width, const int a_height) const
+{
+	BL_PROFILE("ImageRenderer::write()");
+
+	auto transform = [logScale = m_logScale](amrex::Real v) {
+		if (!std::isfinite(v) || (logScale && !(v > 0.))) {
+			return std::numeric_limits<amrex::Real>::quiet_NaN();
+		}
+		return logScale ? std::log10(v) : v;
+	};
+
+	amrex::Real lo = m_fixedRange ? transform(m_min) : std::numeric_limits<amrex::Real>::max();
+	amrex::Real hi = m_fixedRange ? transform(m_max) : std::numeric_limits<amrex::Real>::lowest();
+	if (!m_fixedRange) {
+		for (const amrex::Real v : a_values) {
+			const amrex::Real t = transform(v);
+			if (!std::isnan(t)) {
+				lo = std::min(lo, t);
+				hi = std::max(hi, t);
+			}
+		}
+		if (lo > hi) {
+			// there are no valid values
+			lo = 0.;
+			hi = 1.;
+		}
+	}
+	const amrex::Real width = (hi > lo) ? (hi - lo) : 1.0;
+
+	// pixels with values that cannot be shown (NaN, or non-positive values on a log scale) get the lowest colour
+	auto const &cmap = colormaps.at(m_colormap);
+	std::vector<std::uint8_t> rgb(3 * static_cast<std::size_t>(a_width) * a_height);
+	for (int y = 0; y < a_height; ++y) {
+		const int row = a_height - 1 - y; // the first row of the image is at the top
+		for (int x = 0; x < a_width; ++x) {
+			const amrex::Real t = transform(a_values[x + static_cast<std::size_t>(a_width) * y]);
+			const Color c = mapColor(cmap, std::isnan(t) ? 0. : (t - lo) / width);
+			for (int n = 0; n < 3; ++n) {
+				rgb[3 * (x + static_cast<std::size_t>(a_width) * row) + n] = c[n];
+			}
+		}
+	}
+
+	if (!quokka::writePNG(a_fileName, rgb, a_width, a_height)) {
+		amrex::FileOpenFailed(a_fileName);
+	}
+}
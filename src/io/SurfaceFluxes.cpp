@@ -0,0 +1,415 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <ios>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AMReX_Array.H"
+#include "AMReX_BLProfiler.H"
+#include "AMReX_Box.H"
+#include "AMReX_GpuQualifiers.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Print.H"
+#include "AMReX_Reduce.H"
+#include "AMReX_Utility.H"
+
+#include "SurfaceFluxes.H"
+
+namespace
+{
+constexpr const char *axisNames = "xyz";
+
+auto axisFromName(std::string const &name, std::string const &what) -> int
+{
+	const auto pos = std::string(axisNames).find(name.empty() ? ' ' : name[0]);
+	if (pos == std::string::npos || pos >= AMREX_SPACEDIM) {
+		amrex::Abort("[SurfaceFluxes] invalid " + what + ": " + name);
+	}
+	return static_cast<int>(pos);
+}
+
+// the weighted fluxes through the faces in 'box' of the totals t0 <= t < t0 + N (comps[m] < 0 if total t0 + m is not on this surface)
+template <std::size_t N> struct FaceSum {
+	amrex::Box box;
+	amrex::Array4<const amrex::Real> flux;
+	amrex::GpuArray<int, N> comps{};
+	amrex::GpuArray<amrex::Real, N> weights{};
+};
+
+constexpr std::size_t totalsChunkSize = 16;
+
+template <std::size_t> using TotalSumOp = amrex::ReduceOpSum;
+template <std::size_t> using TotalReal = amrex::Real;
+
+// sum the weighted fluxes of a chunk of totals over a list of face boxes with a single ReduceOps
+template <std::size_t... Is>
+auto sumFaceFluxes(std::vector<FaceSum<sizeof...(Is)>> const &faceSums, std::index_sequence<Is...> /*unused*/) -> std::array<amrex::Real, sizeof...(Is)>
+{
+	amrex::ReduceOps<TotalSumOp<Is>...> reduce_op;
+	amrex::ReduceData<TotalReal<Is>...> reduce_data(reduce_op);
+	using ReduceTuple = typename decltype(reduce_data)::Type;
+	for (auto const &faceSum : faceSums) {
+		auto const &flux = faceSum.flux;
+		auto const &comps = faceSum.comps;
+		auto const &weights = faceSum.weights;
+		reduce_op.eval(faceSum.box, reduce_data, [=] AMREX_GPU_DEVICE(int i, int j, int k) -> ReduceTuple {
+			return {((comps[Is] >= 0) ? weights[Is] * flux(i, j, k, comps[Is]) : amrex::Real(0.))...};
+		});
+	}
+	auto const result = reduce_data.value(reduce_op);
+	return {amrex::get<Is>(result)...};
+}
+
+// index of the faces of the surface at coordinate x along dir (on the level with geometry geom)
+auto faceIndex(amrex::Geometry const &geom, int dir, amrex::Real x) -> int
+{
+	amrex::Box const &domain = geom.Domain();
+	const int i = static_cast<int>(std::lround((x - geom.ProbLo(dir)) / geom.CellSize(dir)));
+	if (geom.isPeriodic(dir) && i == domain.bigEnd(dir) + 1) {
+		// the upper face of a periodic domain is the same as its lower face
+		return domain.smallEnd(dir);
+	}
+	return i;
+}
+} // namespace
+
+void SurfaceFluxes::init(amrex::Geometry const &a_geom, amrex::Vector<std::string> const &a_componentNames)
+{
+	amrex::ParmParse const pp("surface_fluxes");
+	amrex::Vector<std::string> surfaceNames;
+	pp.queryarr("surfaces", surfaceNames);
+	if (surfaceNames.empty()) {
+		return;
+	}
+
+	if (!a_geom.IsCartesian()) {
+		amrex::Abort("[SurfaceFluxes] surface flux accounting is only supported in Cartesian coordinates!");
+	}
+
+	pp.query("interval", m_interval);
+	pp.query("file", m_fileName);
+	if (m_interval < 1) {
+		amrex::Abort("[SurfaceFluxes] surface_fluxes.interval must be at least 1!");
+	}
+
+	m_varNames = {"gasDensity", "x-GasMomentum", "y-GasMomentum", "z-GasMomentum", "gasEnergy"};
+	pp.queryarr("variables", m_varNames);
+	m_varComps.clear();
+	for (auto const &var : m_varNames) {
+		auto it = std::find(a_componentNames.begin(), a_componentNames.end(), var);
+		if (it == a_componentNames.end()) {
+			amrex::Abort("[SurfaceFluxes] " + var + " is not a conserved variable!");
+		}
+		m_varComps.push_back(static_cast<int>(std::distance(a_componentNames.begin(), it)));
+	}
+
+	amrex::Box const &domain = a_geom.Domain();
+	for (auto const &name : surfaceNames) {
+		amrex::ParmParse const pps("surface_fluxes." + name);
+		Surface surface;
+		surface.name = name;
+
+		std::string type = "plane";
+		pps.query("type", type);
+		if (type == "domain_face") {
+			// e.g., face = xhi
+			std::string face;
+			pps.get("face", face);
+			surface.dir = axisFromName(face, "domain face");
+			const std::string side = face.substr(1);
+			if (side != "lo" && side != "hi") {
+				amrex::Abort("[SurfaceFluxes] invalid domain face: " + face);
+			}
+			if (a_geom.isPeriodic(surface.dir)) {
+				amrex::Abort("[SurfaceFluxes] surface " + name + " is on a periodic domain face!");
+			}
+			// outflow through the domain face is counted as positive
+			surface.position = (side == "hi") ? a_geom.ProbHi(surface.dir) : a_geom.ProbLo(surface.dir);
+			surface.sign = (side == "hi") ? 1.0 : -1.0;
+		} else if (type == "plane") {
+			std::string normal;
+			pps.get("normal", normal);
+			surface.dir = axisFromName(normal, "normal direction");
+			pps.get("position", surface.position);
+			// move the plane to the nearest face of the coarsest level, so that it is a face on all levels
+			const int dir = surface.dir;
+			const int i = std::clamp(faceIndex(a_geom, dir, surface.position), domain.smallEnd(dir), domain.bigEnd(dir) + 1);
+			surface.position = a_geom.ProbLo(dir) + i * a_geom.CellSize(dir);
+		} else {
+			amrex::Abort("[SurfaceFluxes] unknown surface type: " + type);
+		}
+
+		// the surface can optionally be restricted to a rectangle (the component along the normal direction is ignored)
+		surface.extent = a_geom.ProbDomain();
+		amrex::Vector<amrex::Real> lo;
+		amrex::Vector<amrex::Real> hi;
+		if (pps.queryarr("lo", lo) != 0) {
+			AMREX_ALWAYS_ASSERT(lo.size() == AMREX_SPACEDIM);
+			surface.extent.setLo(lo.data());
+		}
+		if (pps.queryarr("hi", hi) != 0) {
+			AMREX_ALWAYS_ASSERT(hi.size() == AMREX_SPACEDIM);
+			surface.extent.setHi(hi.data());
+		}
+
+		amrex::Print() << "[SurfaceFluxes] surface " << name << ": " << axisNames[surface.dir] << " = " << surface.position
+			       << (surface.sign > 0. ? " (positive along +" : " (positive along -") << axisNames[surface.dir] << ")\n";
+		m_surfaces.push_back(surface);
+	}
+
+	m_localTotals.assign(m_surfaces.size() * m_varNames.size(), 0.);
+	m_globalTotals.assign(m_surfaces.size() * m_varNames.size(), 0.);
+}
+
+void SurfaceFluxes::updateLevel(int a_lev, amrex::Geometry const &a_geom, amrex::BoxArray const &a_grids, amrex::BoxArray const &a_fineGrids)
+{
+	BL_PROFILE("SurfaceFluxes::updateLevel()");
+
+	LevelFaces &level = m_levels[a_lev];
+	level.grids = a_grids;
+	level.fineGrids = a_fineGrids;
+	level.faces.assign(m_surfaces.size(), {});
+
+	amrex::Box const &domain = a_geom.Domain();
+	for (int s = 0; s < static_cast<int>(m_surfaces.size()); ++s) {
+		Surface const &surface = m_surfaces[s];
+		const int dir = surface.dir;
+
+		// the faces of the surface are the lower faces of the cells in 'bounds'
+		const int i = faceIndex(a_geom, dir, surface.position);
+		amrex::Box bounds = domain;
+		bounds.setRange(dir, i);
+		for (int t = 0; t < AMREX_SPACEDIM; ++t) {
+			if (t != dir) {
+				// include the faces whose centres are within the extent of the surface
+				const amrex::Real dx = a_geom.CellSize(t);
+				const int jlo = static_cast<int>(std::ceil((surface.extent.lo(t) - a_geom.ProbLo(t)) / dx - 0.5));
+				const int jhi = static_cast<int>(std::floor((surface.extent.hi(t) - a_geom.ProbLo(t)) / dx - 0.5));
+				bounds.setSmall(t, std::max(jlo, domain.smallEnd(t)));
+				bounds.setBig(t, std::min(jhi, domain.bigEnd(t)));
+			}
+		}
+		if (!bounds.ok()) {
+			continue;
+		}
+
+		// when the cell below the surface is outside a periodic domain, look for it on the other side of the domain
+		const int periodicShift = (a_geom.isPeriodic(dir) && i == domain.smallEnd(dir)) ? domain.length(dir) : 0;
+
+		for (int ib = 0; ib < static_cast<int>(a_grids.size()); ++ib) {
+			amrex::Box const &vbx = a_grids[ib];
+			if (i < vbx.smallEnd(dir) || i > vbx.bigEnd(dir) + 1) {
+				continue;
+			}
+			amrex::Box slab = vbx;
+			slab.setRange(dir, i);
+			slab &= bounds;
+			if (!slab.ok()) {
+				continue;
+			}
+
+			amrex::BoxList excluded;
+			if (i == vbx.bigEnd(dir) + 1) {
+				// the upper face of this box is counted by the box on the other side (if there is one on this level)
+				for (auto const &isect : a_grids.intersections(slab)) {
+					excluded.push_back(isect.second);
+				}
+			}
+			if (!a_fineGrids.empty()) {
+				// the faces next to a finer level are counted on the finer level
+				for (auto const &isect : a_fineGrids.intersections(slab)) {
+					excluded.push_back(isect.second);
+				}
+				amrex::Box below = slab;
+				below.shift(dir, periodicShift - 1);
+				for (auto const &isect : a_fineGrids.intersections(below)) {
+					excluded.push_back(amrex::Box(isect.second).shift(dir, 1 - periodicShift));
+				}
+			}
+
+			amrex::BoxList faces = excluded.isEmpty() ? amrex::BoxList(slab) : amrex::complementIn(slab, excluded);
+			if (!faces.isEmpty()) {
+				level.faces[s][ib] = faces;
+			}
+		}
+	}
+}
+
+void SurfaceFluxes::accumulate(int a_lev, amrex::Geometry const &a_geom, amrex::BoxArray const &a_grids, amrex::BoxArray const &a_fineGrids,
+			       int a_boxIndex, std::array<amrex::Array4<const amrex::Real>, AMREX_SPACEDIM> const &a_fluxes, amrex::Real a_dt)
+{
+	if (!enabled()) {
+		return;
+	}
+	BL_PROFILE("SurfaceFluxes::accumulate()");
+
+	if (a_lev >= static_cast<int>(m_levels.size())) {
+		m_levels.resize(a_lev + 1);
+	}
+	LevelFaces const &level = m_levels[a_lev];
+	if (level.faces.empty() || !(level.grids == a_grids) || !(level.fineGrids == a_fineGrids)) {
+		updateLevel(a_lev, a_geom, a_grids, a_fineGrids);
+	}
+
+	// the totals of all surfaces and variables are reduced together, in chunks of a fixed number of totals (with a single
+	// ReduceOps each, so that there is usually only one reduction per box)
+	const int nvars = static_cast<int>(m_varComps.size());
+	const int ntotals = static_cast<int>(m_surfaces.size()) * nvars;
+	for (int t0 = 0; t0 < ntotals; t0 += static_cast<int>(totalsChunkSize)) {
+		std::vector<FaceSum<totalsChunkSize>> faceSums;
+		for (int s = 0; s < static_cast<int>(m_surfaces.size()); ++s) {
+			auto it = level.faces[s].find(a_boxIndex);
+			if (it == level.faces[s].end()) {
+				continue;
+			}
+			Surface const &surface = m_surfaces[s];
+
+			amrex::Real area = 1.0;
+			for (int t = 0; t < AMREX_SPACEDIM; ++t) {
+				if (t != surface.dir) {
+					area *= a_geom.CellSize(t);
+				}
+			}
+
+			FaceSum<totalsChunkSize> faceSum;
+			faceSum.flux = a_fluxes[surface.dir];
+			bool hasTotals = false;
+			for (int m = 0; m < static_cast<int>(totalsChunkSize); ++m) {
+				const int t = t0 + m;
+				faceSum.comps[m] = -1;
+				faceSum.weights[m] = 0.;
+				// (skip the variables that are not changed by this update)
+				if (t < ntotals && t / nvars == s && m_varComps[t % nvars] < faceSum.flux.nComp()) {
+					faceSum.comps[m] = m_varComps[t % nvars];
+					faceSum.weights[m] = surface.sign * area;
+					hasTotals = true;
+				}
+			}
+			if (!hasTotals) {
+				continue;
+			}
+			for (amrex::Box const &bx : it->second) {
+				faceSum.box = bx;
+				faceSums.push_back(faceSum);
+			}
+		}
+		if (faceSums.empty()) {
+			continue;
+		}
+
+		const auto sums = sumFaceFluxes(faceSums, std::make_index_sequence<totalsChunkSize>{});
+		for (int m = 0; m < static_cast<int>(totalsChunkSize) && t0 + m < ntotals; ++m) {
+			m_localTotals[t0 + m] += a_dt * sums[m];
+		}
+	}
+}
+
+auto SurfaceFluxes::reducedTotals() const -> std::vector<amrex::Real>
+{
+	std::vector<amrex::Real> totals = m_localTotals;
+	amrex::ParallelDescriptor::ReduceRealSum(totals.data(), static_cast<int>(totals.size()));
+	for (size_t n = 0; n < totals.size(); ++n) {
+		totals[n] += m_globalTotals[n];
+	}
+	return totals;
+}
+
+void SurfaceFluxes::writeToFile(int a_nstep, amrex::Real a_time)
+{
+	if (!enabled()) {
+		return;
+	}
+	BL_PROFILE("SurfaceFluxes::writeToFile()");
+
+	m_globalTotals = reducedTotals();
+	std::fill(m_localTotals.begin(), m_localTotals.end(), 0.);
+
+	if (amrex::ParallelDescriptor::IOProcessor()) {
+		std::ofstream file(m_fileName, std::ofstream::out | std::ofstream::app);
+		if (!file.good()) {
+			amrex::FileOpenFailed(m_fileName);
+		}
+		if (!m_headerWritten) {
+			file << "# cycle time";
+			for (auto const &surface : m_surfaces) {
+				for (auto const &var : m_varNames) {
+					file << " " << surface.name << ":" << var;
+				}
+			}
+			file << "\n";
+			m_headerWritten = true;
+		}
+		file << std::setprecision(std::numeric_limits<amrex::Real>::max_digits10) << a_nstep << " " << a_time;
+		for (amrex::Real const total : m_globalTotals) {
+			file << " " << total;
+		}
+		file << "\n";
+	}
+}
+
+void SurfaceFluxes::writeCheckpoint(std::string const &a_chkfile) const
+{
+	if (!enabled()) {
+		return;
+	}
+
+	const std::vector<amrex::Real> totals = reducedTotals();
+	if (amrex::ParallelDescriptor::IOProcessor()) {
+		const std::string fileName = a_chkfile + "/surface_fluxes.txt";
+		std::ofstream file(fileName, std::ofstream::out | std::ofstream::trunc);
+		if (!file.good()) {
+			amrex::FileOpenFailed(fileName);
+		}
+		file << std::setprecision(std::numeric_limits<amrex::Real>::max_digits10);
+		const int nvars = static_cast<int>(m_varNames.size());
+		for (int s = 0; s < static_cast<int>(m_surfaces.size()); ++s) {
+			for (int v = 0; v < nvars; ++v) {
+				file << m_surfaces[s].name << " " << m_varNames[v] << " " << totals[s * nvars + v] << "\n";
+			}
+		}
+	}
+}
+
+void SurfaceFluxes::readCheckpoint(std::string const &a_chkfile)
+{
+	if (!enabled()) {
+		return;
+	}
+
+	// a restarted run appends to the output file of the previous run, which already has a header
+	m_headerWritten = amrex::FileExists(m_fileName);
+
+	const std::string fileName = a_chkfile + "/surface_fluxes.txt";
+	if (!amrex::FileExists(fileName)) {
+		amrex::Print() << "[SurfaceFluxes] " << fileName << " does not exist, starting the totals from zero.\n";
+		return;
+	}
+
+	amrex::Vector<char> fileCharPtr;
+	amrex::ParallelDescriptor::ReadAndBcastFile(fileName, fileCharPtr);
+	std::istringstream is(fileCharPtr.dataPtr());
+
+	// surfaces and variables that are no longer present are ignored, and new ones start from zero
+	const int nvars = static_cast<int>(m_varNames.size());
+	std::string surfaceName;
+	std::string varName;
+	amrex::Real total = NAN;
+	while (is >> surfaceName >> varName >> total) {
+		for (int s = 0; s < static_cast<int>(m_surfaces.size()); ++s) {
+			for (int v = 0; v < nvars; ++v) {
+				if (m_surfaces[s].name == surfaceName && m_varNames[v] == varName) {
+					m_globalTotals[s * nvars + v] = total;
+				}
+			}
+		}
+	}
+}
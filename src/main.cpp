@@ -14,36 +14,58 @@
 #include "AMReX_REAL.H"
 
 #include "main.hpp"
+#include "util/ensemble.hpp"
+#include "util/isa_dispatch.hpp"
+
+namespace
+{
+void setAmrexDefaults()
+{
+	amrex::ParmParse pp("amrex");
+	// Set GPU memory handling defaults:
+	// since performance is terrible if we have to swap pages between device and
+	// host memory due to exceeding the size of device memory, we crash the code
+	// if this happens, allowing the user to restart with more nodes.
+	if (!pp.contains("abort_on_out_of_gpu_memory")) {
+		pp.add("abort_on_out_of_gpu_memory", 1);
+	}
+
+	// disables managed memory
+	//  for single-GPU runs, the overhead is completely negligible.
+	//  HOWEVER, for multi-GPU runs, using managed memory disables the cuda_ipc
+	//  transport and leads to *extremely poor* GPU-aware MPI performance.
+	if (!pp.contains("the_arena_is_managed")) {
+		pp.add("the_arena_is_managed", 0);
+	}
+
+	// use GPU-aware MPI
+	//   if managed memory is disabled and NVLink/Infinity Fabric is available,
+	//   GPU-aware MPI performance is, in fact, excellent.
+	if (!pp.contains("use_gpu_aware_mpi")) {
+		pp.add("use_gpu_aware_mpi", 1);
+	}
+}
+} // namespace
 
 auto main(int argc, char **argv) -> int
 {
+	// if this executable has been built for several instruction sets, switch to the best one for this CPU
+	quokka::dispatchToBestIsa(argc, argv);
+
+	// if ensemble.num_members > 0, run many independent simulations concurrently,
+	// each on its own sub-communicator of MPI_COMM_WORLD
+	const quokka::EnsembleConfig ensemble = quokka::readEnsembleConfig(argc, argv);
+	if (ensemble.numMembers > 0) {
+		return quokka::runEnsemble(argc, argv, ensemble, setAmrexDefaults, [] {
+			quokka::reportIsaVariant();
+			return problem_main();
+		});
+	}
+
 	// Initialization (copied from ExaWind)
 
-	amrex::Initialize(argc, argv, true, MPI_COMM_WORLD, []() {
-		amrex::ParmParse pp("amrex");
-		// Set GPU memory handling defaults:
-		// since performance is terrible if we have to swap pages between device and
-		// host memory due to exceeding the size of device memory, we crash the code
-		// if this happens, allowing the user to restart with more nodes.
-		if (!pp.contains("abort_on_out_of_gpu_memory")) {
-			pp.add("abort_on_out_of_gpu_memory", 1);
-		}
-
-		// disables managed memory
-		//  for single-GPU runs, the overhead is completely negligible.
-		//  HOWEVER, for multi-GPU runs, using managed memory disables the cuda_ipc
-		//  transport and leads to *extremely poor* GPU-aware MPI performance.
-		if (!pp.contains("the_arena_is_managed")) {
-			pp.add("the_arena_is_managed", 0);
-		}
-
-		// use GPU-aware MPI
-		//   if managed memory is disabled and NVLink/Infinity Fabric is available,
-		//   GPU-aware MPI performance is, in fact, excellent.
-		if (!pp.contains("use_gpu_aware_mpi")) {
-			pp.add("use_gpu_aware_mpi", 1);
-		}
-	});
+	amrex::Initialize(argc, argv, true, MPI_COMM_WORLD, setAmrexDefaults);
+	quokka::reportIsaVariant();
 
 	amrex::Real start_time = amrex::ParallelDescriptor::second();
 
@@ -9,8 +9,14 @@
 /// \brief Implements the particle container for gravitationally-interacting particles
 ///
 
+#include <cmath>
+
 #include "AMReX.H"
+#include "AMReX_Algorithm.H"
 #include "AMReX_AmrParticles.H"
+#include "AMReX_Array.H"
+#include "AMReX_Array4.H"
+#include "AMReX_Math.H"
 #include "AMReX_MultiFab.H"
 #include "AMReX_MultiFabUtil.H"
 #include "AMReX_ParIter.H"
@@ -43,6 +49,91 @@ struct CICDeposition {
 	}
 };
 
+// Interpolate the cell-centred acceleration to the position x with the same trilinear (CIC) weights as
+// amrex::ParticleInterpolator::Linear, and also return the Frobenius norm of the gradient of the interpolant
+// (i.e., of the tidal tensor). Indices are clamped to the extent of 'acc', so particles that have moved
+// beyond the ghost cells of their box use the nearest available acceleration.
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE void interpolateAccel(amrex::Array4<const amrex::Real> const &acc,
+							       amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &x,
+							       amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &plo,
+							       amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &dxi, amrex::Real *a, amrex::Real &gradNorm)
+{
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-avoid-c-arrays)
+	int idx[3] = {0, 0, 0};
+	int nstencil[3] = {1, 1, 1};
+	amrex::Real frac[3] = {0., 0., 0.};
+	const int lo[3] = {acc.begin.x, acc.begin.y, acc.begin.z};
+	const int hi[3] = {acc.end.x - 1, acc.end.y - 1, acc.end.z - 1};
+	for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+		const amrex::Real l = (x[d] - plo[d]) * dxi[d] - 0.5;
+		idx[d] = static_cast<int>(amrex::Math::floor(l));
+		frac[d] = l - idx[d];
+		nstencil[d] = 2;
+	}
+
+	amrex::Real grad[AMREX_SPACEDIM][AMREX_SPACEDIM] = {};
+	for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+		a[n] = 0.;
+	}
+	for (int kk = 0; kk < nstencil[2]; ++kk) {
+		for (int jj = 0; jj < nstencil[1]; ++jj) {
+			for (int ii = 0; ii < nstencil[0]; ++ii) {
+				const int off[3] = {ii, jj, kk};
+				amrex::Real w[3] = {1., 1., 1.};  // weights
+				amrex::Real dw[3] = {0., 0., 0.}; // derivatives of the weights
+				for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+					w[d] = (off[d] == 0) ? (1.0 - frac[d]) : frac[d];
+					dw[d] = (off[d] == 0) ? -dxi[d] : dxi[d];
+				}
+				const int i = amrex::Clamp(idx[0] + ii, lo[0], hi[0]);
+				const int j = amrex::Clamp(idx[1] + jj, lo[1], hi[1]);
+				const int k = amrex::Clamp(idx[2] + kk, lo[2], hi[2]);
+				const amrex::Real wdx[3] = {dw[0] * w[1] * w[2], w[0] * dw[1] * w[2], w[0] * w[1] * dw[2]};
+				for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+					const amrex::Real val = acc(i, j, k, n);
+					a[n] += w[0] * w[1] * w[2] * val;
+					for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+						grad[n][d] += wdx[d] * val;
+					}
+				}
+			}
+		}
+	}
+
+	amrex::Real sum = 0.;
+	for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+		for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+			sum += grad[n][d] * grad[n][d];
+		}
+	}
+	gradNorm = std::sqrt(sum);
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-avoid-c-arrays)
+}
+
+// Compute the power-of-two block timestep level ('rung') of a particle, such that it takes 2^rung substeps of
+// length dt / 2^rung. The particle timestep is eta * min(sqrt(dx / |a|), 1 / sqrt(|grad a|)), i.e., the particle
+// must not accelerate across more than a fraction of a cell, and must resolve the local dynamical (tidal) time.
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE auto blockTimestepRung(amrex::Real const *a, amrex::Real gradNorm, amrex::Real dx, amrex::Real eta, amrex::Real dt,
+								 int maxRung) -> int
+{
+	amrex::Real a2 = 0.;
+	for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+		a2 += a[n] * a[n]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	}
+	amrex::Real dt_p = dt;
+	if (a2 > 0.) {
+		dt_p = amrex::min(dt_p, eta * std::sqrt(dx / std::sqrt(a2)));
+	}
+	if (gradNorm > 0.) {
+		dt_p = amrex::min(dt_p, eta / std::sqrt(gradNorm));
+	}
+	int rung = 0;
+	while ((rung < maxRung) && (dt / static_cast<amrex::Real>(1 << rung) > dt_p)) {
+		++rung;
+	}
+	return rung;
+}
+
 } // namespace quokka
 
 #endif // CICPARTICLES_HPP_
\ No newline at end of file
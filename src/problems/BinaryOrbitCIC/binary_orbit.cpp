@@ -54,6 +54,7 @@ template <> struct Physics_Traits<BinaryOrbit> {
 template <> struct SimulationData<BinaryOrbit> {
 	std::vector<amrex::ParticleReal> time{};
 	std::vector<amrex::ParticleReal> dist{};
+	std::vector<amrex::ParticleReal> energy{};
 };
 
 template <> void QuokkaSimulation<BinaryOrbit>::setInitialConditionsOnGrid(quokka::grid const &grid_elem)
@@ -128,15 +129,83 @@ template <> void QuokkaSimulation<BinaryOrbit>::computeAfterTimestep()
 				const amrex::ParticleReal dist0 = 6.25e12; // cm
 				const amrex::Real cell_dx0 = this->geom[0].CellSize(0);
 
+				// compute the total energy of the binary (the mass of the gas is negligible)
+				auto kinetic = [](quokka::CICParticleContainer::ParticleType const &p) {
+					return 0.5 * p.rdata(quokka::ParticleMassIdx) *
+					       (p.rdata(quokka::ParticleVxIdx) * p.rdata(quokka::ParticleVxIdx) +
+						p.rdata(quokka::ParticleVyIdx) * p.rdata(quokka::ParticleVyIdx) +
+						p.rdata(quokka::ParticleVzIdx) * p.rdata(quokka::ParticleVzIdx));
+				};
+				const amrex::ParticleReal energy =
+				    kinetic(p1) + kinetic(p2) - Gconst_ * p1.rdata(quokka::ParticleMassIdx) * p2.rdata(quokka::ParticleMassIdx) / dist;
+
 				// save statistics
 				userData_.time.push_back(tNew_[0]);
 				userData_.dist.push_back((dist - dist0) / cell_dx0);
+				userData_.energy.push_back(energy);
 			}
 		}
 	}
 	++cycle;
 }
 
+namespace
+{
+struct OrbitErrors {
+	double max_dist_err = NAN;   // maximum change in the particle separation (in cell widths)
+	double max_energy_err = NAN; // maximum relative change in the total energy of the binary
+	int max_block_level = 0;     // the finest particle block level that was used
+	amrex::Long substeps_block = 0;
+	amrex::Long substeps_global = 0;
+};
+
+// evolve the binary (with block timesteps for the particles if blockTimesteps == 1, or as set in the input file if blockTimesteps < 0)
+auto runOrbit(amrex::Vector<amrex::BCRec> const &BCs_cc, int blockTimesteps) -> OrbitErrors
+{
+	// Problem initialization
+	QuokkaSimulation<BinaryOrbit> sim(BCs_cc);
+	sim.doPoissonSolve_ = 1; // enable self-gravity
+	sim.initDt_ = 1.0e3;	 // s
+	if (blockTimesteps >= 0) {
+		sim.particleBlockTimesteps_ = blockTimesteps;
+	}
+
+	// initialize
+	sim.setInitialConditions();
+
+	// evolve
+	sim.evolve();
+
+	OrbitErrors errors;
+	errors.max_block_level = sim.particleMaxRungReached_;
+	errors.substeps_block = sim.particleSubstepsBlock_;
+	errors.substeps_global = sim.particleSubstepsGlobal_;
+
+	// check max abs particle distance
+	if (amrex::ParallelDescriptor::IOProcessor() && (!sim.userData_.dist.empty())) {
+		auto result = std::max_element(sim.userData_.dist.begin(), sim.userData_.dist.end(),
+					       [](amrex::ParticleReal a, amrex::ParticleReal b) { return std::abs(a) < std::abs(b); });
+		errors.max_dist_err = std::abs(*result);
+	}
+	amrex::ParallelDescriptor::Bcast(&errors.max_dist_err, 1, amrex::ParallelDescriptor::Mpi_typemap<double>::type(),
+					 amrex::ParallelDescriptor::ioProcessor, amrex::ParallelDescriptor::Communicator());
+	amrex::Print() << "max particle separation = " << errors.max_dist_err << " cell widths.\n";
+
+	// check the max relative change in the total energy (relative to the first sample)
+	if (amrex::ParallelDescriptor::IOProcessor() && (!sim.userData_.energy.empty())) {
+		const amrex::ParticleReal E0 = sim.userData_.energy.front();
+		errors.max_energy_err = 0.;
+		for (const amrex::ParticleReal E : sim.userData_.energy) {
+			errors.max_energy_err = std::max(errors.max_energy_err, static_cast<double>(std::abs((E - E0) / E0)));
+		}
+	}
+	amrex::ParallelDescriptor::Bcast(&errors.max_energy_err, 1, amrex::ParallelDescriptor::Mpi_typemap<double>::type(),
+					 amrex::ParallelDescriptor::ioProcessor, amrex::ParallelDescriptor::Communicator());
+	amrex::Print() << "max relative energy error = " << errors.max_energy_err << "\n";
+	return errors;
+}
+} // namespace
+
 auto problem_main() -> int
 {
 	auto isNormalComp = [=](int n, int dim) {
@@ -166,32 +235,47 @@ auto problem_main() -> int
 		}
 	}
 
-	// Problem initialization
-	QuokkaSimulation<BinaryOrbit> sim(BCs_cc);
-	sim.doPoissonSolve_ = 1; // enable self-gravity
-	sim.initDt_ = 1.0e3;	 // s
-
-	// initialize
-	sim.setInitialConditions();
-
-	// evolve
-	sim.evolve();
+	// if compare_block_timesteps == 1, the orbit is evolved with a global particle timestep and then with block timesteps.
+	// The block-timestep run must use at least min_block_level particle block levels, and its energy error must not exceed
+	// max_energy_error_ratio times the energy error of the global-timestep run.
+	int compare_block_timesteps = 0;
+	int min_block_level = 1;
+	double max_energy_error_ratio = 1.5;
+	amrex::ParmParse const pp;
+	pp.query("compare_block_timesteps", compare_block_timesteps);
+	pp.query("min_block_level", min_block_level);
+	pp.query("max_energy_error_ratio", max_energy_error_ratio);
 
-	// check max abs particle distance
-	double max_err = NAN;
-	if (amrex::ParallelDescriptor::IOProcessor() && (!sim.userData_.dist.empty())) {
-		auto result = std::max_element(sim.userData_.dist.begin(), sim.userData_.dist.end(),
-					       [](amrex::ParticleReal a, amrex::ParticleReal b) { return std::abs(a) < std::abs(b); });
-		max_err = std::abs(*result);
-	}
-	amrex::ParallelDescriptor::Bcast(&max_err, 1, amrex::ParallelDescriptor::Mpi_typemap<double>::type(), amrex::ParallelDescriptor::ioProcessor,
-					 amrex::ParallelDescriptor::Communicator());
-	amrex::Print() << "max particle separation = " << max_err << " cell widths.\n";
+	const OrbitErrors errors = runOrbit(BCs_cc, (compare_block_timesteps != 0) ? 0 : -1);
 
 	int status = 1;
 	const double max_err_tol = 0.18; // max error tol in cell widths
-	if (max_err < max_err_tol) {
+	if (errors.max_dist_err < max_err_tol) {
 		status = 0;
 	}
+
+	if (compare_block_timesteps != 0) {
+		const OrbitErrors blockErrors = runOrbit(BCs_cc, 1);
+		const double speedup = (blockErrors.substeps_block > 0)
+					   ? static_cast<double>(blockErrors.substeps_global) / static_cast<double>(blockErrors.substeps_block)
+					   : 1.0;
+		amrex::Print() << "block timesteps: finest block level = " << blockErrors.max_block_level << ", " << blockErrors.substeps_block
+			       << " particle substeps (" << speedup << "x fewer than with a global particle timestep)\n";
+		amrex::Print() << "relative energy error: global timestep = " << errors.max_energy_err
+			       << ", block timesteps = " << blockErrors.max_energy_err << "\n";
+
+		if (blockErrors.max_block_level < min_block_level) {
+			amrex::Print() << "The particles did not use block levels >= " << min_block_level << "!\n";
+			status = 1;
+		}
+		if (!(blockErrors.max_dist_err < max_err_tol)) {
+			status = 1;
+		}
+		if (!(blockErrors.max_energy_err <= max_energy_error_ratio * errors.max_energy_err)) {
+			amrex::Print() << "The energy error with block timesteps is larger than " << max_energy_error_ratio
+				       << " times the energy error with a global timestep!\n";
+			status = 1;
+		}
+	}
 	return status;
 }
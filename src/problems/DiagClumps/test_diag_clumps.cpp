@@ -0,0 +1,291 @@
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_diag_clumps.cpp
+/// \brief Defines a test of the clump finder diagnostic (DiagClumps).
+///
+/// Blobs of known size and density are placed on a periodic two-level hierarchy: one inside a single box,
+/// one that crosses box boundaries along every direction, one that crosses the periodic boundary, one that
+/// crosses the coarse-fine boundary, and a single cell that is below the minimum size. The catalogue must
+/// contain exactly the four resolved blobs, with the expected number of cells, volumes, masses, centres of mass,
+/// rms radii and bounding boxes (the blob that crosses the periodic boundary must be unwrapped).
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "AMReX_BoxArray.H"
+#include "AMReX_BoxIterator.H"
+#include "AMReX_DistributionMapping.H"
+#include "AMReX_Geometry.H"
+#include "AMReX_GpuDevice.H"
+#include "AMReX_MultiFab.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Print.H"
+#include "AMReX_RealBox.H"
+#include "AMReX_RealVect.H"
+#include "AMReX_Utility.H"
+
+#include "test_diag_clumps.hpp"
+
+using amrex::Real;
+
+namespace
+{
+constexpr int refRatio = 2;
+constexpr Real rhoBackground = 1.0; // below the threshold (2.0) of tests/diag_clumps.in
+
+struct Blob {
+	amrex::Box box; // base-level cells of the blob (may extend beyond the domain, in which case it is wrapped periodically)
+	Real rho;
+};
+
+// density of the base-level cell iv
+auto density(std::vector<Blob> const &blobs, amrex::Box const &domain, amrex::IntVect const &iv) -> Real
+{
+	for (auto const &blob : blobs) {
+		amrex::IntVect wrapped = iv;
+		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+			const int lo = blob.box.smallEnd(idim);
+			const int n = domain.length(idim);
+			wrapped[idim] = lo + (((iv[idim] - lo) % n) + n) % n;
+		}
+		if (blob.box.contains(wrapped)) {
+			return blob.rho;
+		}
+	}
+	return rhoBackground;
+}
+
+// fill a level with the blobs (the cells of the refined level have the density of the base-level cell that contains them)
+void fillLevel(amrex::MultiFab &mf, std::vector<Blob> const &blobs, amrex::Box const &coarseDomain, int ratio)
+{
+	amrex::MultiFab hostMF(mf.boxArray(), mf.DistributionMap(), mf.nComp(), 0, amrex::MFInfo().SetArena(amrex::The_Pinned_Arena()));
+	for (amrex::MFIter mfi(hostMF); mfi.isValid(); ++mfi) {
+		auto const &arr = hostMF.array(mfi);
+		for (amrex::BoxIterator bit(mfi.validbox()); bit.ok(); ++bit) {
+			const amrex::IntVect iv = bit();
+			arr(iv, 0) = density(blobs, coarseDomain, amrex::coarsen(iv, ratio));
+			for (int n = 1; n < mf.nComp(); ++n) {
+				arr(iv, n) = 0.; // momentum
+			}
+		}
+	}
+	amrex::MultiFab::Copy(mf, hostMF, 0, 0, mf.nComp(), 0);
+	amrex::Gpu::streamSynchronize();
+}
+
+// the catalogue columns that are checked
+enum Column { colCells = 0, colVolume, colMass, colX, colY, colZ, colRadius, colLoX, colLoY, colLoZ, colHiX, colHiY, colHiZ, nColumns };
+using Row = std::array<Real, nColumns>;
+
+// read the checked columns of each structure from the catalogue
+auto readCatalogue(std::string const &fileName) -> std::vector<Row>
+{
+	std::vector<Row> rows;
+	std::ifstream file(fileName);
+	std::string line;
+	bool header = true;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		if (header) {
+			header = false; // column names
+			continue;
+		}
+		// id matched ncells volume mass x_cm y_cm z_cm vx_cm vy_cm vz_cm r_rms sigma_v field_max x_lo y_lo z_lo x_hi y_hi z_hi
+		std::istringstream fields(line);
+		std::array<Real, 20> values{};
+		for (Real &v : values) {
+			fields >> v;
+		}
+		Row row{};
+		row[colCells] = values[2];
+		row[colVolume] = values[3];
+		row[colMass] = values[4];
+		for (int d = 0; d < 3; ++d) {
+			row[colX + d] = values[5 + d];
+			row[colLoX + d] = values[14 + d];
+			row[colHiX + d] = values[17 + d];
+		}
+		row[colRadius] = values[11];
+		rows.push_back(row);
+	}
+	return rows;
+}
+} // namespace
+
+auto problem_main() -> int
+{
+	std::vector<int> n_cell(AMREX_SPACEDIM, 32);
+	int max_grid_size = 8;
+	{
+		amrex::ParmParse const pp("amr");
+		pp.queryarr("n_cell", n_cell, 0, AMREX_SPACEDIM);
+		pp.query("max_grid_size", max_grid_size);
+	}
+	AMREX_ALWAYS_ASSERT(max_grid_size == 8);
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		AMREX_ALWAYS_ASSERT(n_cell[idim] == 32);
+	}
+
+	const amrex::RealBox realBox({AMREX_D_DECL(0., 0., 0.)}, {AMREX_D_DECL(1., 1., 1.)});
+	const amrex::Array<int, AMREX_SPACEDIM> periodic{AMREX_D_DECL(1, 1, 1)};
+	const amrex::Box coarseDomain(amrex::IntVect::TheZeroVector(), amrex::IntVect(AMREX_D_DECL(n_cell[0] - 1, n_cell[1] - 1, n_cell[2] - 1)));
+	const amrex::Box fineDomain = amrex::refine(coarseDomain, refRatio);
+	const amrex::Vector<amrex::Geometry> geom{amrex::Geometry(coarseDomain, realBox, amrex::CoordSys::cartesian, periodic),
+						  amrex::Geometry(fineDomain, realBox, amrex::CoordSys::cartesian, periodic)};
+
+	// the refined region (in base-level cells)
+	const amrex::Box coveredBox(amrex::IntVect(16), amrex::IntVect(23));
+
+	// the blobs (in base-level cells, separated by at least one background cell along every direction)
+	auto cube = [](int lo, int hi) { return amrex::Box(amrex::IntVect(lo), amrex::IntVect(hi)); };
+	amrex::Box periodicBlob = cube(20, 23);
+	periodicBlob.setRange(0, 29, 5); // cells 29, 30, 31, 0, 1 along x
+	amrex::Box cfBlob = cube(18, 21);
+	cfBlob.setRange(0, 14, 6); // cells 14-15 on the base level, 16-19 on the refined level
+	const std::vector<Blob> blobs{
+	    {cube(3, 4), 3.0},	 // inside a single box
+	    {cube(6, 11), 4.0},	 // crosses the box boundaries at 8 along every direction
+	    {periodicBlob, 5.0}, // crosses the periodic boundary
+	    {cfBlob, 6.0},	 // crosses the coarse-fine boundary
+	    {cube(26, 26), 7.0}, // a single cell, below quokka.clumps.min_cells
+	};
+
+	amrex::BoxArray baCoarse(coarseDomain);
+	baCoarse.maxSize(max_grid_size);
+	amrex::BoxArray baFine(amrex::refine(coveredBox, refRatio));
+	baFine.maxSize(max_grid_size);
+
+	const amrex::Vector<std::string> varNames{"gasDensity", "x-GasMomentum", "y-GasMomentum", "z-GasMomentum"};
+	const int ncomp = static_cast<int>(varNames.size());
+	const amrex::Vector<amrex::BoxArray> grids{baCoarse, baFine};
+	const amrex::Vector<amrex::DistributionMapping> dmap{amrex::DistributionMapping(baCoarse), amrex::DistributionMapping(baFine)};
+	amrex::MultiFab coarse(grids[0], dmap[0], ncomp, 0);
+	amrex::MultiFab fine(grids[1], dmap[1], ncomp, 0);
+	fillLevel(coarse, blobs, coarseDomain, 1);
+	fillLevel(fine, blobs, coarseDomain, refRatio);
+
+	// run the clump finder
+	const std::string prefix = "quokka.clumps";
+	auto diag = DiagBase::create("DiagClumps");
+	diag->init(prefix, "clumps");
+	amrex::Vector<std::string> diagVars;
+	diag->addVars(diagVars);
+	for (auto const &v : diagVars) {
+		AMREX_ALWAYS_ASSERT(std::find(varNames.begin(), varNames.end(), v) != varNames.end());
+	}
+	diag->prepare(2, geom, grids, dmap, varNames);
+	diag->processDiag(0, 0., {&coarse, &fine}, varNames);
+
+	int status = 0;
+	if (amrex::ParallelDescriptor::IOProcessor()) {
+		int minCells = 1;
+		std::string fileName = "clumps";
+		amrex::ParmParse const pp(prefix);
+		pp.query("min_cells", minCells);
+		pp.query("file", fileName);
+
+		// expected catalogue entry of each structure on the composite grid, in order of decreasing mass
+		// (the blobs have a uniform density, and the cells of the blob are summed at their unwrapped positions)
+		const auto dx0 = geom[0].CellSizeArray();
+		const auto dx1 = geom[1].CellSizeArray();
+		const Real dV0 = AMREX_D_TERM(dx0[0], *dx0[1], *dx0[2]);
+		const Real dV1 = AMREX_D_TERM(dx1[0], *dx1[1], *dx1[2]);
+		std::vector<Row> expected;
+		for (auto const &blob : blobs) {
+			Row e{};
+			std::array<Real, 3> massPos{};
+			Real massPos2 = 0.;
+			for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+				e[colLoX + d] = blob.box.smallEnd(d) * dx0[d];
+				e[colHiX + d] = (blob.box.bigEnd(d) + 1) * dx0[d];
+			}
+			auto addCell = [&](amrex::RealVect const &x, Real dV) {
+				e[colCells] += 1.;
+				e[colMass] += blob.rho * dV;
+				for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+					massPos[d] += blob.rho * dV * x[d];
+					massPos2 += blob.rho * dV * x[d] * x[d];
+				}
+			};
+			for (amrex::BoxIterator bit(blob.box); bit.ok(); ++bit) {
+				const amrex::IntVect iv = bit();
+				amrex::IntVect wrapped = iv;
+				for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+					wrapped[idim] = (iv[idim] + n_cell[idim]) % n_cell[idim];
+				}
+				e[colVolume] += dV0;
+				if (coveredBox.contains(wrapped)) {
+					for (amrex::BoxIterator fit(amrex::refine(amrex::Box(iv, iv), refRatio)); fit.ok(); ++fit) {
+						addCell(amrex::RealVect(AMREX_D_DECL((fit()[0] + 0.5) * dx1[0], (fit()[1] + 0.5) * dx1[1], (fit()[2] + 0.5) * dx1[2])), dV1);
+					}
+				} else {
+					addCell(amrex::RealVect(AMREX_D_DECL((iv[0] + 0.5) * dx0[0], (iv[1] + 0.5) * dx0[1], (iv[2] + 0.5) * dx0[2])), dV0);
+				}
+			}
+			Real pos2 = 0.;
+			for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+				e[colX + d] = massPos[d] / e[colMass];
+				pos2 += e[colX + d] * e[colX + d];
+			}
+			e[colRadius] = std::sqrt(massPos2 / e[colMass] - pos2);
+			// the centre of mass is wrapped back into the (unit) domain, and the bounding box is moved with it
+			for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+				const Real shift = -std::floor(e[colX + d]);
+				e[colX + d] += shift;
+				e[colLoX + d] += shift;
+				e[colHiX + d] += shift;
+			}
+			if (e[colCells] >= minCells) {
+				expected.push_back(e);
+			}
+		}
+		std::sort(expected.begin(), expected.end(), [](auto const &a, auto const &b) { return a[colMass] > b[colMass]; });
+
+		const auto rows = readCatalogue(amrex::Concatenate(fileName, 0, 6) + ".dat");
+		amrex::Print() << "found " << rows.size() << " structures (expected " << expected.size() << ")\n";
+		if (rows.size() != expected.size()) {
+			status = 1;
+		}
+		// (the catalogue is written with 11 significant digits)
+		const Real rel_tol = 1.0e-9;
+		const Real abs_tol = 1.0e-9; // for positions (the domain is the unit cube)
+		for (size_t c = 0; c < std::min(rows.size(), expected.size()); ++c) {
+			amrex::Print() << "\tstructure " << c << ": " << rows[c][colCells] << " cells, volume " << rows[c][colVolume] << ", mass "
+				       << rows[c][colMass] << ", centre (" << rows[c][colX] << ", " << rows[c][colY] << ", " << rows[c][colZ] << "), r_rms "
+				       << rows[c][colRadius] << " (expected " << expected[c][colCells] << " cells, volume " << expected[c][colVolume]
+				       << ", mass " << expected[c][colMass] << ", centre (" << expected[c][colX] << ", " << expected[c][colY] << ", "
+				       << expected[c][colZ] << "), r_rms " << expected[c][colRadius] << ")\n";
+			if (rows[c][colCells] != expected[c][colCells]) {
+				status = 1;
+			}
+			for (int n : {colVolume, colMass, colRadius}) {
+				if (!(std::abs(rows[c][n] - expected[c][n]) <= rel_tol * expected[c][n])) {
+					status = 1;
+				}
+			}
+			for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+				for (int n : {colX + d, colLoX + d, colHiX + d}) {
+					if (!(std::abs(rows[c][n] - expected[c][n]) <= abs_tol)) {
+						amrex::Print() << "\t\tcolumn " << n << " = " << rows[c][n] << " (expected " << expected[c][n] << ")\n";
+						status = 1;
+					}
+				}
+			}
+		}
+	}
+
+	// Cleanup and exit
+	amrex::ParallelDescriptor::Bcast(&status, 1, amrex::ParallelDescriptor::IOProcessorNumber());
+	return status;
+}
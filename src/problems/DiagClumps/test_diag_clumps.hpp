@@ -0,0 +1,15 @@
+#ifndef TEST_DIAG_CLUMPS_HPP_ // NOLINT
+#define TEST_DIAG_CLUMPS_HPP_
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_diag_clumps.hpp
+/// \brief Defines a test of the clump finder diagnostic (DiagClumps).
+///
+
+// internal headers
+#include "io/DiagClumps.H"
+
+#endif // TEST_DIAG_CLUMPS_HPP_
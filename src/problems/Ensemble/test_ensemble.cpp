@@ -0,0 +1,47 @@
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_ensemble.cpp
+/// \brief Defines a test of the ensemble mode.
+///
+/// Each member of the ensemble finds its index from its output directory (which is set by the ensemble driver), and
+/// checks that it received the overrides of its own line of tests/ensemble_overrides.txt (ensemble_test.value = 100 + index)
+/// rather than the default of tests/ensemble.in. The ensemble fails if any member fails.
+
+#include <fstream>
+#include <string>
+
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Print.H"
+
+#include "test_ensemble.hpp"
+
+auto problem_main() -> int
+{
+	// the ensemble driver sets plotfile_prefix = <member_prefix>NNNN/plt
+	std::string plotfilePrefix;
+	amrex::ParmParse const pp;
+	pp.get("plotfile_prefix", plotfilePrefix);
+	const std::string memberDir = plotfilePrefix.substr(0, plotfilePrefix.rfind('/'));
+	AMREX_ALWAYS_ASSERT(memberDir.size() >= 4);
+	const int member = std::stoi(memberDir.substr(memberDir.size() - 4));
+
+	int value = -1;
+	amrex::ParmParse const ppt("ensemble_test");
+	ppt.get("value", value);
+
+	const int expected = 100 + member;
+	amrex::Print() << "ensemble member " << member << " (" << memberDir << "): ensemble_test.value = " << value << " (expected " << expected
+		       << ")\n";
+
+	// record the value in the output directory of the member
+	if (amrex::ParallelDescriptor::IOProcessor()) {
+		std::ofstream file(memberDir + "/ensemble_test.txt");
+		file << value << "\n";
+	}
+
+	return (value == expected) ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+#ifndef TEST_ENSEMBLE_HPP_ // NOLINT
+#define TEST_ENSEMBLE_HPP_
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_ensemble.hpp
+/// \brief Defines a test of the ensemble mode.
+///
+
+// internal headers
+#include "util/ensemble.hpp"
+
+#endif // TEST_ENSEMBLE_HPP_
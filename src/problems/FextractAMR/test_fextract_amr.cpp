@@ -0,0 +1,247 @@
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_fextract_amr.cpp
+/// \brief Defines a test of the multi-level line and slice extraction (fextract).
+///
+/// A two-level hierarchy (the refined level covers the central half of the domain along
+/// each direction) is extracted with the multi-level fextract and fextract_slice. On the covered
+/// region, the result must be identical to the extraction from a single uniform level at the
+/// fine resolution. Outside of it, the result must be the base-level data.
+
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "AMReX_BoxArray.H"
+#include "AMReX_BoxIterator.H"
+#include "AMReX_DistributionMapping.H"
+#include "AMReX_Geometry.H"
+#include "AMReX_MultiFab.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Print.H"
+#include "AMReX_RealBox.H"
+#include "AMReX_RealVect.H"
+
+#include "test_fextract_amr.hpp"
+
+using amrex::Real;
+
+namespace
+{
+constexpr int refRatio = 2;
+constexpr Real badValue = -1.0e30; // stored in base-level cells that are covered by the refined level
+
+// the test function, which differs between the levels since it is evaluated at the cell centers
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE auto testFunction(Real x, Real y, Real z) -> Real
+{
+	return 1.0 + std::sin(2.0 * M_PI * x) + 2.0 * y * y + 0.5 * z;
+}
+
+// fill component 0 with the test function, and component 1 with -f
+void fillLevel(amrex::MultiFab &mf, amrex::Geometry const &geom, amrex::Box const &coveredBox)
+{
+	const auto problo = geom.ProbLoArray();
+	const auto dx = geom.CellSizeArray();
+	auto const &arr = mf.arrays();
+	amrex::ParallelFor(mf, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) {
+		const Real x = problo[0] + (i + 0.5) * dx[0];
+		const Real y = (AMREX_SPACEDIM >= 2) ? problo[1] + (j + 0.5) * dx[1] : 0.;
+		const Real z = (AMREX_SPACEDIM >= 3) ? problo[2] + (k + 0.5) * dx[2] : 0.;
+		const bool covered = coveredBox.ok() && coveredBox.contains(amrex::IntVect(AMREX_D_DECL(i, j, k)));
+		const Real f = covered ? badValue : testFunction(x, y, z);
+		arr[bx](i, j, k, 0) = f;
+		arr[bx](i, j, k, 1) = -f;
+	});
+	amrex::Gpu::streamSynchronize();
+}
+
+// returns the number of records of a multi-level extraction that disagree with the expected values
+auto countMismatches(std::vector<std::pair<std::vector<Real>, std::vector<Real>>> const &records,
+		     std::map<std::vector<Real>, std::vector<Real>> const &expected) -> int
+{
+	int nbad = 0;
+	for (auto const &[pos, values] : records) {
+		auto it = expected.find(pos);
+		if (it == expected.end()) {
+			amrex::Print() << "\tunexpected record at position";
+			for (const Real x : pos) {
+				amrex::Print() << " " << x;
+			}
+			amrex::Print() << "\n";
+			++nbad;
+			continue;
+		}
+		for (size_t c = 0; c < values.size(); ++c) {
+			if (std::abs(values[c] - it->second[c]) > 1.0e-12 * std::abs(it->second[c])) {
+				amrex::Print() << "\tcomponent " << c << " = " << values[c] << " (expected " << it->second[c] << ")\n";
+				++nbad;
+			}
+		}
+	}
+	return nbad;
+}
+} // namespace
+
+auto problem_main() -> int
+{
+	std::vector<int> n_cell(AMREX_SPACEDIM, 32);
+	int max_grid_size = 8;
+	{
+		amrex::ParmParse const pp("amr");
+		pp.queryarr("n_cell", n_cell, 0, AMREX_SPACEDIM);
+		pp.query("max_grid_size", max_grid_size);
+	}
+
+	const amrex::RealBox realBox({AMREX_D_DECL(0., 0., 0.)}, {AMREX_D_DECL(1., 1., 1.)});
+	const amrex::Array<int, AMREX_SPACEDIM> notPeriodic{AMREX_D_DECL(0, 0, 0)};
+	const amrex::Box coarseDomain(amrex::IntVect::TheZeroVector(), amrex::IntVect(AMREX_D_DECL(n_cell[0] - 1, n_cell[1] - 1, n_cell[2] - 1)));
+	const amrex::Box fineDomain = amrex::refine(coarseDomain, refRatio);
+	amrex::Vector<amrex::Geometry> geom{amrex::Geometry(coarseDomain, realBox, amrex::CoordSys::cartesian, notPeriodic),
+					    amrex::Geometry(fineDomain, realBox, amrex::CoordSys::cartesian, notPeriodic)};
+	const amrex::Vector<amrex::IntVect> ratios{amrex::IntVect(refRatio)};
+
+	// the refined region covers the central half of the domain along each direction
+	amrex::Box coveredBox = coarseDomain;
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		const int len = coarseDomain.length(idim);
+		coveredBox.setRange(idim, len / 4, len / 2); // len/2 cells, starting at len/4
+	}
+
+	amrex::BoxArray baCoarse(coarseDomain);
+	baCoarse.maxSize(max_grid_size);
+	amrex::BoxArray baFine(amrex::refine(coveredBox, refRatio));
+	baFine.maxSize(max_grid_size);
+	amrex::BoxArray baUniform(fineDomain);
+	baUniform.maxSize(max_grid_size);
+
+	const int ncomp = 2;
+	amrex::MultiFab coarse(baCoarse, amrex::DistributionMapping(baCoarse), ncomp, 0);
+	amrex::MultiFab fine(baFine, amrex::DistributionMapping(baFine), ncomp, 0);
+	amrex::MultiFab uniform(baUniform, amrex::DistributionMapping(baUniform), ncomp, 0);
+	fillLevel(coarse, geom[0], coveredBox);
+	fillLevel(fine, geom[1], amrex::Box());
+	fillLevel(uniform, geom[1], amrex::Box());
+
+	const amrex::Vector<const amrex::MultiFab *> levels{&coarse, &fine};
+	const amrex::Vector<const amrex::MultiFab *> uniformLevel{&uniform};
+	const auto problo = geom[0].ProbLoArray();
+	const auto dx0 = geom[0].CellSizeArray();
+
+	// expected values outside of the refined region (the base-level cells)
+	auto coarseValue = [&](amrex::IntVect const &iv) {
+		const Real x = problo[0] + (iv[0] + 0.5) * dx0[0];
+		const Real y = (AMREX_SPACEDIM >= 2) ? problo[1] + (iv[1] + 0.5) * dx0[1] : 0.;
+		const Real z = (AMREX_SPACEDIM >= 3) ? problo[2] + (iv[2] + 0.5) * dx0[2] : 0.;
+		const Real f = testFunction(x, y, z);
+		return std::vector<Real>{f, -f};
+	};
+
+	int nbad = 0;
+
+	// lines along each direction through the center cell of the uniform fine level (which lies inside the refined region)
+	for (int idir = 0; idir < AMREX_SPACEDIM; ++idir) {
+		auto [posUniform, dataUniform] = fextract(uniform, geom[1], idir, 0., true);
+
+		amrex::RealVect point;
+		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+			point[idim] = geom[1].ProbLo(idim) + (fineDomain.length(idim) / 2 + 0.5) * geom[1].CellSize(idim);
+		}
+		auto [pos, data] = fextract(2, levels, geom, ratios, idir, point);
+
+		if (amrex::ParallelDescriptor::IOProcessor()) {
+			std::map<std::vector<Real>, std::vector<Real>> expected;
+			for (size_t r = 0; r < posUniform.size(); ++r) {
+				const int ifine = static_cast<int>(std::floor((posUniform[r] - problo[idir]) / geom[1].CellSize(idir)));
+				if (ifine / refRatio >= coveredBox.smallEnd(idir) && ifine / refRatio <= coveredBox.bigEnd(idir)) {
+					expected[{posUniform[r]}] = {dataUniform[0][r], dataUniform[1][r]};
+				}
+			}
+			amrex::IntVect iv;
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				iv[idim] = static_cast<int>(std::floor((point[idim] - problo[idim]) / dx0[idim]));
+			}
+			for (int i = coarseDomain.smallEnd(idir); i <= coarseDomain.bigEnd(idir); ++i) {
+				if (i < coveredBox.smallEnd(idir) || i > coveredBox.bigEnd(idir)) {
+					iv[idir] = i;
+					expected[{problo[idir] + (i + 0.5) * dx0[idir]}] = coarseValue(iv);
+				}
+			}
+
+			std::vector<std::pair<std::vector<Real>, std::vector<Real>>> records;
+			for (size_t r = 0; r < pos.size(); ++r) {
+				records.push_back({{pos[r]}, {data[0][r], data[1][r]}});
+			}
+			const int nbadLine = countMismatches(records, expected) + ((records.size() != expected.size()) ? 1 : 0);
+			amrex::Print() << "line along direction " << idir << ": " << records.size() << " cells (expected " << expected.size() << "), " << nbadLine
+				       << " mismatches\n";
+			nbad += nbadLine;
+		}
+	}
+
+	// slice normal to the last direction through the center of the uniform fine level
+	if constexpr (AMREX_SPACEDIM >= 2) {
+		const int normal = AMREX_SPACEDIM - 1;
+		const int dir0 = 0;
+		const int dir1 = (AMREX_SPACEDIM == 3) ? 1 : -1;
+		const Real sliceCoord = geom[1].ProbLo(normal) + (fineDomain.length(normal) / 2 + 0.5) * geom[1].CellSize(normal);
+		auto [pos0Uniform, pos1Uniform, dataUniform] = fextract_slice(1, uniformLevel, {geom[1]}, {}, normal, sliceCoord);
+		auto [pos0, pos1, data] = fextract_slice(2, levels, geom, ratios, normal, sliceCoord);
+
+		if (amrex::ParallelDescriptor::IOProcessor()) {
+			auto insideCovered = [&](int idir, Real x, Real dx, int ratio) {
+				const int i = static_cast<int>(std::floor((x - problo[idir]) / dx)) / ratio;
+				return i >= coveredBox.smallEnd(idir) && i <= coveredBox.bigEnd(idir);
+			};
+			auto position = [&](std::vector<Real> const &p0, std::vector<Real> const &p1, size_t r) {
+				return (dir1 >= 0) ? std::vector<Real>{p0[r], p1[r]} : std::vector<Real>{p0[r]};
+			};
+
+			std::map<std::vector<Real>, std::vector<Real>> expected;
+			for (size_t r = 0; r < pos0Uniform.size(); ++r) {
+				bool covered = insideCovered(dir0, pos0Uniform[r], geom[1].CellSize(dir0), refRatio);
+				if (dir1 >= 0) {
+					covered = covered && insideCovered(dir1, pos1Uniform[r], geom[1].CellSize(dir1), refRatio);
+				}
+				if (covered) {
+					expected[position(pos0Uniform, pos1Uniform, r)] = {dataUniform[0][r], dataUniform[1][r]};
+				}
+			}
+			amrex::Box plane = coarseDomain;
+			plane.setRange(normal, static_cast<int>(std::floor((sliceCoord - problo[normal]) / dx0[normal])));
+			for (amrex::BoxIterator bit(plane); bit.ok(); ++bit) {
+				const amrex::IntVect iv = bit();
+				bool covered = iv[dir0] >= coveredBox.smallEnd(dir0) && iv[dir0] <= coveredBox.bigEnd(dir0);
+				if (dir1 >= 0) {
+					covered = covered && iv[dir1] >= coveredBox.smallEnd(dir1) && iv[dir1] <= coveredBox.bigEnd(dir1);
+				}
+				if (!covered) {
+					std::vector<Real> p{problo[dir0] + (iv[dir0] + 0.5) * dx0[dir0]};
+					if (dir1 >= 0) {
+						p.push_back(problo[dir1] + (iv[dir1] + 0.5) * dx0[dir1]);
+					}
+					expected[p] = coarseValue(iv);
+				}
+			}
+
+			std::vector<std::pair<std::vector<Real>, std::vector<Real>>> records;
+			for (size_t r = 0; r < pos0.size(); ++r) {
+				records.push_back({position(pos0, pos1, r), {data[0][r], data[1][r]}});
+			}
+			const int nbadSlice = countMismatches(records, expected) + ((records.size() != expected.size()) ? 1 : 0);
+			amrex::Print() << "slice normal to direction " << normal << ": " << records.size() << " cells (expected " << expected.size() << "), "
+				       << nbadSlice << " mismatches\n";
+			nbad += nbadSlice;
+		}
+	}
+
+	// Cleanup and exit
+	int status = (nbad > 0) ? 1 : 0;
+	amrex::ParallelDescriptor::Bcast(&status, 1, amrex::ParallelDescriptor::IOProcessorNumber());
+	return status;
+}
@@ -0,0 +1,15 @@
+#ifndef TEST_FEXTRACT_AMR_HPP_ // NOLINT
+#define TEST_FEXTRACT_AMR_HPP_
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_fextract_amr.hpp
+/// \brief Defines a test of the multi-level line and slice extraction (fextract).
+///
+
+// internal headers
+#include "util/fextract.hpp"
+
+#endif // TEST_FEXTRACT_AMR_HPP_
@@ -171,13 +171,52 @@ auto problem_main() -> int
 	sim.maxTimesteps_ = 20000;
 	sim.plotfileInterval_ = 2000;
 
+	// check that the locality-preserving distribution map (dmap_locality = 1) does not increase
+	// the fraction of fine cells whose coarse data is owned by another rank, compared to the default map?
+	int check_dmap_locality = 0;
+	int check_dmap_timesteps = 10;
+	{
+		amrex::ParmParse const pp;
+		pp.query("check_dmap_locality", check_dmap_locality);
+		pp.query("check_dmap_timesteps", check_dmap_timesteps);
+	}
+	if (check_dmap_locality == 1) {
+		sim.maxTimesteps_ = check_dmap_timesteps; // enough to regrid
+		sim.plotfileInterval_ = -1;
+	}
+
+	int status = 0;
+	auto checkDistributionMaps = [&sim, &status]() {
+		for (int lev = 1; lev <= sim.finestLevel(); ++lev) {
+			amrex::BoxArray const &ba = sim.boxArray(lev);
+			const amrex::DistributionMapping dm_default(ba, amrex::ParallelDescriptor::NProcs());
+			const amrex::Real offRank = sim.offRankCoarseFraction(lev, ba, sim.DistributionMap(lev));
+			const amrex::Real offRank_default = sim.offRankCoarseFraction(lev, ba, dm_default);
+			amrex::Print() << "level " << lev << ": coarse data is off-rank for " << offRank << " of the fine cells (default map: " << offRank_default
+				       << ")\n";
+			if (!(offRank <= offRank_default)) {
+				status = 1;
+			}
+		}
+	};
+
 	// initialize
 	sim.setInitialConditions();
+	if (check_dmap_locality == 1) {
+		if (sim.finestLevel() < 1) {
+			amrex::Print() << "The blast was not refined!\n";
+			status = 1;
+		}
+		checkDistributionMaps();
+	}
 
 	// evolve
 	sim.evolve();
+	if (check_dmap_locality == 1) {
+		checkDistributionMaps(); // after regridding
+	}
 
 	// Cleanup and exit
 	amrex::Print() << "Finished." << std::endl;
-	return 0;
+	return status;
 }
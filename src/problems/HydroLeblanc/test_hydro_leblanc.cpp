@@ -14,6 +14,8 @@
 
 #include "AMReX_BC_TYPES.H"
 #include "AMReX_BLassert.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
 
 #include "QuokkaSimulation.hpp"
 #include "hydro/hydro_system.hpp"
@@ -329,30 +331,24 @@ void QuokkaSimulation<ShocktubeProblem>::computeReferenceSolution(amrex::MultiFa
 #endif
 }
 
-auto problem_main() -> int
+namespace
 {
-	// Problem parameters
+struct LeblancRun {
+	amrex::Real errorNorm = NAN;
+	int hydroRetries = 0;
+	amrex::Long fofcCells = 0;
+	amrex::Real wallTime = NAN;
+};
 
-	// const int nx = 2000;
-	// const double Lx = 9.0;
+auto runLeblanc(amrex::Vector<amrex::BCRec> const &BCs_cc, int useHybridRiemannSolver) -> LeblancRun
+{
+	// Problem parameters
 	const double CFL_number = 0.1;
 	const double max_time = 6.0;
 	const double max_dt = 1e-3;
 	const double initial_dt = 1e-5;
 	const int max_timesteps = 50000;
 
-	// Problem initialization
-	const int ncomp_cc = Physics_Indices<ShocktubeProblem>::nvarTotal_cc;
-	amrex::Vector<amrex::BCRec> BCs_cc(ncomp_cc);
-	for (int n = 0; n < ncomp_cc; ++n) {
-		BCs_cc[0].setLo(0, amrex::BCType::foextrap); // Dirichlet
-		BCs_cc[0].setHi(0, amrex::BCType::foextrap);
-		for (int i = 1; i < AMREX_SPACEDIM; ++i) {
-			BCs_cc[n].setLo(i, amrex::BCType::int_dir); // periodic
-			BCs_cc[n].setHi(i, amrex::BCType::int_dir);
-		}
-	}
-
 	QuokkaSimulation<ShocktubeProblem> sim(BCs_cc);
 
 	sim.cflNumber_ = CFL_number;
@@ -362,17 +358,61 @@ auto problem_main() -> int
 	sim.initDt_ = initial_dt;
 	sim.computeReferenceSolution_ = true;
 	sim.plotfileInterval_ = -1;
+	sim.useHybridRiemannSolver_ = useHybridRiemannSolver;
 
 	// Main time loop
+	const amrex::Real start_time = amrex::ParallelDescriptor::second();
 	sim.setInitialConditions();
 	sim.evolve();
 
-	// Compute test success condition
-	int status = 0;
+	LeblancRun run;
+	run.errorNorm = sim.errorNorm_;
+	run.hydroRetries = sim.hydroRetriesTotal_;
+	run.fofcCells = sim.fofcCellsTotal_;
+	run.wallTime = amrex::ParallelDescriptor::second() - start_time;
+	return run;
+}
+} // namespace
+
+auto problem_main() -> int
+{
+	// Problem initialization
+	const int ncomp_cc = Physics_Indices<ShocktubeProblem>::nvarTotal_cc;
+	amrex::Vector<amrex::BCRec> BCs_cc(ncomp_cc);
+	for (int n = 0; n < ncomp_cc; ++n) {
+		BCs_cc[0].setLo(0, amrex::BCType::foextrap); // Dirichlet
+		BCs_cc[0].setHi(0, amrex::BCType::foextrap);
+		for (int i = 1; i < AMREX_SPACEDIM; ++i) {
+			BCs_cc[n].setLo(i, amrex::BCType::int_dir); // periodic
+			BCs_cc[n].setHi(i, amrex::BCType::int_dir);
+		}
+	}
+
+	// if compare_hybrid == 1, run the problem with HLLC everywhere, then with the hybrid HLLC/LLF Riemann solver,
+	// and require that both solutions meet the error tolerance
+	int compare_hybrid = 0;
+	amrex::ParmParse const pp;
+	pp.query("compare_hybrid", compare_hybrid);
+
 	const double error_tol = 0.002;
-	if (sim.errorNorm_ > error_tol) {
+	int status = 0;
+
+	const LeblancRun hllc = runLeblanc(BCs_cc, 0);
+	if (!(hllc.errorNorm <= error_tol)) {
 		status = 1;
 	}
 
+	if (compare_hybrid == 1) {
+		const LeblancRun hybrid = runLeblanc(BCs_cc, 1);
+		if (!(hybrid.errorNorm <= error_tol)) {
+			status = 1;
+		}
+		amrex::Print() << "\nRiemann solver comparison (error tolerance " << error_tol << "):\n"
+			       << "\tHLLC:      L1 error = " << hllc.errorNorm << ", hydro retries = " << hllc.hydroRetries
+			       << ", FOFC cells = " << hllc.fofcCells << ", wall time = " << hllc.wallTime << " s\n"
+			       << "\tHLLC/LLF:  L1 error = " << hybrid.errorNorm << ", hydro retries = " << hybrid.hydroRetries
+			       << ", FOFC cells = " << hybrid.fofcCells << ", wall time = " << hybrid.wallTime << " s\n\n";
+	}
+
 	return status;
 }
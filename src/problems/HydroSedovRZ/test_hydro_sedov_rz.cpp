@@ -0,0 +1,219 @@
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_hydro_sedov_rz.cpp
+/// \brief Defines a test problem for a spherical explosion in 2D axisymmetric (RZ) coordinates.
+///
+
+#include <cmath>
+
+#include "AMReX.H"
+#include "AMReX_BC_TYPES.H"
+#include "AMReX_BLassert.H"
+#include "AMReX_MultiFab.H"
+#include "AMReX_ParReduce.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_Print.H"
+
+#include "QuokkaSimulation.hpp"
+#include "hydro/hydro_system.hpp"
+#include "test_hydro_sedov_rz.hpp"
+#include "util/CoordGeometry.hpp"
+
+struct SedovProblem {
+};
+
+template <> struct quokka::EOS_Traits<SedovProblem> {
+	static constexpr double gamma = 1.4;
+	static constexpr double mean_molecular_weight = C::m_u;
+	static constexpr double boltzmann_constant = C::k_B;
+};
+
+template <> struct HydroSystem_Traits<SedovProblem> {
+	static constexpr bool reconstruct_eint = false;
+};
+
+template <> struct Physics_Traits<SedovProblem> {
+	// cell-centred
+	static constexpr bool is_hydro_enabled = true;
+	static constexpr int numMassScalars = 0;		     // number of mass scalars
+	static constexpr int numPassiveScalars = numMassScalars + 0; // number of passive scalars
+	static constexpr bool is_radiation_enabled = false;
+	// face-centred
+	static constexpr bool is_mhd_enabled = false;
+	static constexpr int nGroups = 1; // number of radiation groups
+};
+
+// same parameters as the 3D test (HydroBlast3D), for which the shock is at r = 1 at t = 1
+const double rho = 1.0;		 // g cm^-3
+const double E_blast = 0.851072; // ergs
+
+template <> void QuokkaSimulation<SedovProblem>::setInitialConditionsOnGrid(quokka::grid const &grid_elem)
+{
+	// the blast energy is deposited in the two cells on the axis (R = 0) that are adjacent to the midplane (z = 0),
+	// i.e., in a cylinder of radius dR and height 2 dz centred on the origin
+
+	amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx = grid_elem.dx_;
+	amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> prob_lo = grid_elem.prob_lo_;
+	const amrex::Box &indexRange = grid_elem.indexRange_;
+	const amrex::Array4<double> &state_cc = grid_elem.array_;
+	// volume of the two innermost cells
+	const amrex::Real blast_vol = 2.0 * M_PI * dx[0] * dx[0] * dx[1];
+	const double rho_copy = rho;
+	const double E_blast_copy = E_blast;
+
+	// loop over the grid and set the initial condition
+	amrex::ParallelFor(indexRange, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+		const amrex::Real z = prob_lo[1] + (j + 0.5) * dx[1];
+		double rho_e = NAN;
+		if ((i == 0) && (std::abs(z) < dx[1])) {
+			rho_e = E_blast_copy / blast_vol;
+		} else {
+			rho_e = 1.0e-10 * (E_blast_copy / blast_vol);
+		}
+
+		for (int n = 0; n < state_cc.nComp(); ++n) {
+			state_cc(i, j, k, n) = 0.; // zero fill all components
+		}
+
+		state_cc(i, j, k, HydroSystem<SedovProblem>::density_index) = rho_copy;
+		state_cc(i, j, k, HydroSystem<SedovProblem>::x1Momentum_index) = 0;
+		state_cc(i, j, k, HydroSystem<SedovProblem>::x2Momentum_index) = 0;
+		state_cc(i, j, k, HydroSystem<SedovProblem>::x3Momentum_index) = 0;
+		state_cc(i, j, k, HydroSystem<SedovProblem>::energy_index) = rho_e;
+		state_cc(i, j, k, HydroSystem<SedovProblem>::internalEnergy_index) = rho_e;
+	});
+}
+
+// compute the total energy (or the total kinetic energy) on level 0, using the volumes of the annular cells
+auto integrateEnergy(amrex::MultiFab const &state_mf, amrex::Geometry const &geom, bool kineticOnly) -> amrex::Real
+{
+	const auto coordGeom = quokka::CoordGeometry::fromGeometry(geom);
+	const amrex::Real dR = geom.CellSize(0);
+	const amrex::Real dz = geom.CellSize(1);
+	amrex::MultiFab E_mf(state_mf.boxArray(), state_mf.DistributionMap(), 1, 0);
+	auto const &state = state_mf.const_arrays();
+	auto const &E = E_mf.arrays();
+
+	amrex::ParallelFor(E_mf, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) {
+		const amrex::Real vol = 2.0 * M_PI * coordGeom.cellVolume(i) * dR * dz;
+		const amrex::Real rho = state[bx](i, j, k, HydroSystem<SedovProblem>::density_index);
+		const amrex::Real pR = state[bx](i, j, k, HydroSystem<SedovProblem>::x1Momentum_index);
+		const amrex::Real pz = state[bx](i, j, k, HydroSystem<SedovProblem>::x2Momentum_index);
+		const amrex::Real Ekin = (pR * pR + pz * pz) / (2.0 * rho);
+		E[bx](i, j, k) = (kineticOnly ? Ekin : state[bx](i, j, k, HydroSystem<SedovProblem>::energy_index)) * vol;
+	});
+	return E_mf.sum(0);
+}
+
+// compute the position of the density peak on level 0 along the midplane (dir == 0, the cells just above z = 0)
+// or along the axis (dir == 1, the cells with R < dR and z > 0)
+auto shockRadius(amrex::MultiFab const &state_mf, amrex::Geometry const &geom, int dir) -> amrex::Real
+{
+	const auto dx = geom.CellSizeArray();
+	const auto prob_lo = geom.ProbLoArray();
+	auto const &state = state_mf.const_arrays();
+
+	// the distance from the origin of cell (i, j) if it is on the line, otherwise a negative value
+	auto distance = [=] AMREX_GPU_DEVICE(int i, int j) noexcept -> amrex::Real {
+		const amrex::Real R = prob_lo[0] + (i + 0.5) * dx[0];
+		const amrex::Real z = prob_lo[1] + (j + 0.5) * dx[1];
+		if ((dir == 0) && (z > 0.) && (z < dx[1])) {
+			return R;
+		}
+		if ((dir == 1) && (R < dx[0]) && (z > 0.)) {
+			return z;
+		}
+		return -1.0;
+	};
+
+	amrex::Real rho_max = amrex::ParReduce(amrex::TypeList<amrex::ReduceOpMax>{}, amrex::TypeList<amrex::Real>{}, state_mf, amrex::IntVect(0),
+					       [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) noexcept -> amrex::GpuTuple<amrex::Real> {
+						       if (distance(i, j) < 0.) {
+							       return {0.};
+						       }
+						       return {state[bx](i, j, k, HydroSystem<SedovProblem>::density_index)};
+					       });
+	amrex::ParallelDescriptor::ReduceRealMax(rho_max);
+
+	amrex::Real r_peak = amrex::ParReduce(amrex::TypeList<amrex::ReduceOpMax>{}, amrex::TypeList<amrex::Real>{}, state_mf, amrex::IntVect(0),
+					      [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) noexcept -> amrex::GpuTuple<amrex::Real> {
+						      const amrex::Real r = distance(i, j);
+						      if ((r < 0.) || (state[bx](i, j, k, HydroSystem<SedovProblem>::density_index) < rho_max)) {
+							      return {-1.0};
+						      }
+						      return {r};
+					      });
+	amrex::ParallelDescriptor::ReduceRealMax(r_peak);
+	return r_peak;
+}
+
+auto problem_main() -> int
+{
+	const int ncomp_cc = Physics_Indices<SedovProblem>::nvarTotal_cc;
+	amrex::Vector<amrex::BCRec> BCs_cc(ncomp_cc);
+	for (int n = 0; n < ncomp_cc; ++n) {
+		// reflecting at R = 0 and at the outer boundaries (which the shock does not reach)
+		// (the radial and azimuthal momenta are odd across the axis, the vertical momentum is odd across the z boundaries)
+		const bool oddInR = (n == HydroSystem<SedovProblem>::x1Momentum_index) || (n == HydroSystem<SedovProblem>::x3Momentum_index);
+		const bool oddInZ = (n == HydroSystem<SedovProblem>::x2Momentum_index);
+		BCs_cc[n].setLo(0, oddInR ? amrex::BCType::reflect_odd : amrex::BCType::reflect_even);
+		BCs_cc[n].setHi(0, oddInR ? amrex::BCType::reflect_odd : amrex::BCType::reflect_even);
+		BCs_cc[n].setLo(1, oddInZ ? amrex::BCType::reflect_odd : amrex::BCType::reflect_even);
+		BCs_cc[n].setHi(1, oddInZ ? amrex::BCType::reflect_odd : amrex::BCType::reflect_even);
+	}
+
+	// Problem initialization
+	QuokkaSimulation<SedovProblem> sim(BCs_cc);
+
+	sim.reconstructionOrder_ = 3; // 2=PLM, 3=PPM
+	sim.stopTime_ = 1.0;	      // seconds
+	sim.cflNumber_ = 0.3;
+
+	// initialize
+	sim.setInitialConditions();
+	const amrex::Real Egas0 = integrateEnergy(sim.state_new_cc_[0], sim.Geom(0), false);
+
+	// evolve
+	sim.evolve();
+
+	// check conservation of total energy
+	const amrex::Real Egas = integrateEnergy(sim.state_new_cc_[0], sim.Geom(0), false);
+	const amrex::Real Ekin = integrateEnergy(sim.state_new_cc_[0], sim.Geom(0), true);
+	const amrex::Real rel_err = (Egas - Egas0) / Egas0;
+
+	// the kinetic energy fraction and shock radius should agree with the 3D Cartesian result
+	const amrex::Real frac_Ekin = Ekin / Egas;
+	const amrex::Real frac_Ekin_exact = 0.218729;
+	const amrex::Real rel_err_Ekin = frac_Ekin - frac_Ekin_exact;
+
+	// the blast wave must be spherical, i.e., the shock radius must be the same along the midplane and along the axis
+	const amrex::Real r_shock_midplane = shockRadius(sim.state_new_cc_[0], sim.Geom(0), 0);
+	const amrex::Real r_shock_axis = shockRadius(sim.state_new_cc_[0], sim.Geom(0), 1);
+	const amrex::Real r_shock_exact = 1.0;
+
+	amrex::Print() << "\nInitial energy = " << Egas0 << '\n';
+	amrex::Print() << "Final energy = " << Egas << '\n';
+	amrex::Print() << "\trelative conservation error = " << rel_err << '\n';
+	amrex::Print() << "\trelative K.E. error = " << rel_err_Ekin << '\n';
+	amrex::Print() << "\tshock radius = " << r_shock_midplane << " (midplane), " << r_shock_axis << " (axis), exact: " << r_shock_exact << '\n';
+	amrex::Print() << '\n';
+
+	int status = 0;
+	if ((std::abs(rel_err) > 1.0e-12) || std::isnan(rel_err)) {
+		amrex::Print() << "Energy not conserved to machine precision!\n";
+		status = 1;
+	}
+	if ((std::abs(rel_err_Ekin) > 0.01) || std::isnan(rel_err_Ekin)) {
+		amrex::Print() << "Kinetic energy production is incorrect by more than 1 percent!\n";
+		status = 1;
+	}
+	if ((std::abs(r_shock_midplane - r_shock_exact) > 0.02) || (std::abs(r_shock_axis - r_shock_exact) > 0.02)) {
+		amrex::Print() << "Shock radius is incorrect by more than 2 percent!\n";
+		status = 1;
+	}
+
+	return status;
+}
@@ -0,0 +1,17 @@
+#ifndef TEST_HYDRO_SEDOV_RZ_HPP_ // NOLINT
+#define TEST_HYDRO_SEDOV_RZ_HPP_
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_hydro_sedov_rz.hpp
+/// \brief Defines a test problem for a spherical explosion in 2D axisymmetric (RZ) coordinates.
+///
+
+// internal headers
+#include "hydro/hydro_system.hpp"
+
+// function definitions
+
+#endif // TEST_HYDRO_SEDOV_RZ_HPP_
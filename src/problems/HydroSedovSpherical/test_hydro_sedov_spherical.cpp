@@ -0,0 +1,211 @@
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_hydro_sedov_spherical.cpp
+/// \brief Defines a test problem for a spherical explosion in 1D spherical coordinates.
+///
+
+#include <cmath>
+
+#include "AMReX.H"
+#include "AMReX_BC_TYPES.H"
+#include "AMReX_BLassert.H"
+#include "AMReX_MultiFab.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Print.H"
+
+#include "QuokkaSimulation.hpp"
+#include "hydro/hydro_system.hpp"
+#include "test_hydro_sedov_spherical.hpp"
+#include "util/CoordGeometry.hpp"
+
+struct SedovProblem {
+};
+
+template <> struct quokka::EOS_Traits<SedovProblem> {
+	static constexpr double gamma = 1.4;
+	static constexpr double mean_molecular_weight = C::m_u;
+	static constexpr double boltzmann_constant = C::k_B;
+};
+
+template <> struct HydroSystem_Traits<SedovProblem> {
+	static constexpr bool reconstruct_eint = false;
+};
+
+template <> struct Physics_Traits<SedovProblem> {
+	// cell-centred
+	static constexpr bool is_hydro_enabled = true;
+	static constexpr int numMassScalars = 0;		     // number of mass scalars
+	static constexpr int numPassiveScalars = numMassScalars + 0; // number of passive scalars
+	static constexpr bool is_radiation_enabled = false;
+	// face-centred
+	static constexpr bool is_mhd_enabled = false;
+	static constexpr int nGroups = 1; // number of radiation groups
+};
+
+// same parameters as the 3D test (HydroBlast3D), for which the shock is at r = 1 at t = 1
+const double rho = 1.0;		 // g cm^-3
+const double E_blast = 0.851072; // ergs
+
+template <> void QuokkaSimulation<SedovProblem>::setInitialConditionsOnGrid(quokka::grid const &grid_elem)
+{
+	// initialize a Sedov test problem using parameters from
+	// Richard Klein and J. Bolstad
+	// [Reference: J.R. Kamm and F.X. Timmes, On Efficient Generation of
+	//   Numerically Robust Sedov Solutions, LA-UR-07-2849.]
+
+	amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx = grid_elem.dx_;
+	const amrex::Box &indexRange = grid_elem.indexRange_;
+	const amrex::Array4<double> &state_cc = grid_elem.array_;
+	// volume of the innermost cell
+	const amrex::Real cell_vol = (4.0 / 3.0) * M_PI * dx[0] * dx[0] * dx[0];
+	const double rho_copy = rho;
+	const double E_blast_copy = E_blast;
+
+	// loop over the grid and set the initial condition
+	amrex::ParallelFor(indexRange, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+		double rho_e = NAN;
+		if (i == 0) {
+			rho_e = E_blast_copy / cell_vol;
+		} else {
+			rho_e = 1.0e-10 * (E_blast_copy / cell_vol);
+		}
+
+		for (int n = 0; n < state_cc.nComp(); ++n) {
+			state_cc(i, j, k, n) = 0.; // zero fill all components
+		}
+
+		state_cc(i, j, k, HydroSystem<SedovProblem>::density_index) = rho_copy;
+		state_cc(i, j, k, HydroSystem<SedovProblem>::x1Momentum_index) = 0;
+		state_cc(i, j, k, HydroSystem<SedovProblem>::x2Momentum_index) = 0;
+		state_cc(i, j, k, HydroSystem<SedovProblem>::x3Momentum_index) = 0;
+		state_cc(i, j, k, HydroSystem<SedovProblem>::energy_index) = rho_e;
+		state_cc(i, j, k, HydroSystem<SedovProblem>::internalEnergy_index) = rho_e;
+	});
+}
+
+template <> void QuokkaSimulation<SedovProblem>::ErrorEst(int lev, amrex::TagBoxArray &tags, amrex::Real /*time*/, int /*ngrow*/)
+{
+	// tag cells for refinement (same criterion as the 3D test, HydroBlast3D)
+
+	const amrex::Real eta_threshold = 0.1; // gradient refinement threshold
+	const amrex::Real P_min = 1.0e-3;      // minimum pressure for refinement
+
+	for (amrex::MFIter mfi(state_new_cc_[lev]); mfi.isValid(); ++mfi) {
+		const amrex::Box &box = mfi.validbox();
+		const auto state = state_new_cc_[lev].const_array(mfi);
+		const auto tag = tags.array(mfi);
+
+		amrex::ParallelFor(box, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+			amrex::Real const P = HydroSystem<SedovProblem>::ComputePressure(state, i, j, k);
+			amrex::Real const P_xplus = HydroSystem<SedovProblem>::ComputePressure(state, i + 1, j, k);
+			amrex::Real const P_xminus = HydroSystem<SedovProblem>::ComputePressure(state, i - 1, j, k);
+			amrex::Real const gradient_indicator = std::max(std::abs(P_xplus - P), std::abs(P - P_xminus)) / P;
+
+			if ((gradient_indicator > eta_threshold) && (P > P_min)) {
+				tag(i, j, k) = amrex::TagBox::SET;
+			}
+		});
+	}
+}
+
+// compute the total energy (or the total kinetic energy) on level 0, using the volumes of the spherical shells
+// (with AMR, level 0 holds the volume-weighted average of the finer levels, so this is the composite total)
+auto integrateEnergy(amrex::MultiFab const &state_mf, amrex::Geometry const &geom, bool kineticOnly) -> amrex::Real
+{
+	const auto coordGeom = quokka::CoordGeometry::fromGeometry(geom);
+	const amrex::Real dr = geom.CellSize(0);
+	amrex::MultiFab E_mf(state_mf.boxArray(), state_mf.DistributionMap(), 1, 0);
+	auto const &state = state_mf.const_arrays();
+	auto const &E = E_mf.arrays();
+
+	amrex::ParallelFor(E_mf, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) {
+		const amrex::Real vol = 4.0 * M_PI * coordGeom.cellVolume(i) * dr;
+		const amrex::Real rho = state[bx](i, j, k, HydroSystem<SedovProblem>::density_index);
+		const amrex::Real px = state[bx](i, j, k, HydroSystem<SedovProblem>::x1Momentum_index);
+		const amrex::Real Ekin = px * px / (2.0 * rho);
+		E[bx](i, j, k) = (kineticOnly ? Ekin : state[bx](i, j, k, HydroSystem<SedovProblem>::energy_index)) * vol;
+	});
+	return E_mf.sum(0);
+}
+
+auto problem_main() -> int
+{
+	const int ncomp_cc = Physics_Indices<SedovProblem>::nvarTotal_cc;
+	amrex::Vector<amrex::BCRec> BCs_cc(ncomp_cc);
+	for (int n = 0; n < ncomp_cc; ++n) {
+		// reflecting at r = 0 and at the outer boundary (which the shock does not reach)
+		if (n == HydroSystem<SedovProblem>::x1Momentum_index) {
+			BCs_cc[n].setLo(0, amrex::BCType::reflect_odd);
+			BCs_cc[n].setHi(0, amrex::BCType::reflect_odd);
+		} else {
+			BCs_cc[n].setLo(0, amrex::BCType::reflect_even);
+			BCs_cc[n].setHi(0, amrex::BCType::reflect_even);
+		}
+	}
+
+	// Problem initialization
+	QuokkaSimulation<SedovProblem> sim(BCs_cc);
+
+	sim.reconstructionOrder_ = 3; // 2=PLM, 3=PPM
+	sim.stopTime_ = 1.0;	      // seconds
+	sim.cflNumber_ = 0.3;
+
+	// initialize
+	sim.setInitialConditions();
+	const amrex::Real Egas0 = integrateEnergy(sim.state_new_cc_[0], sim.Geom(0), false);
+
+	// evolve
+	sim.evolve();
+
+	// check conservation of total energy
+	const amrex::Real Egas = integrateEnergy(sim.state_new_cc_[0], sim.Geom(0), false);
+	const amrex::Real Ekin = integrateEnergy(sim.state_new_cc_[0], sim.Geom(0), true);
+	const amrex::Real rel_err = (Egas - Egas0) / Egas0;
+
+	// the kinetic energy fraction and shock radius should agree with the 3D Cartesian result
+	const amrex::Real frac_Ekin = Ekin / Egas;
+	const amrex::Real frac_Ekin_exact = 0.218729;
+	const amrex::Real rel_err_Ekin = frac_Ekin - frac_Ekin_exact;
+
+	const amrex::IntVect idx_max = sim.state_new_cc_[0].maxIndex(HydroSystem<SedovProblem>::density_index);
+	const amrex::Real r_shock = sim.Geom(0).ProbLo(0) + (idx_max[0] + 0.5) * sim.Geom(0).CellSize(0);
+	const amrex::Real r_shock_exact = 1.0;
+
+	amrex::Print() << "\nInitial energy = " << Egas0 << '\n';
+	amrex::Print() << "Final energy = " << Egas << '\n';
+	amrex::Print() << "\trelative conservation error = " << rel_err << '\n';
+	amrex::Print() << "\trelative K.E. error = " << rel_err_Ekin << '\n';
+	amrex::Print() << "\tshock radius = " << r_shock << " (exact: " << r_shock_exact << ")\n";
+	amrex::Print() << '\n';
+
+	int status = 0;
+
+	// with check_amr = 1, the blast wave must have been refined (amr.max_level >= 1), so that conservation is checked
+	// across the coarse-fine boundaries (refluxing with area-weighted fluxes and volume-weighted averaging)
+	int check_amr = 0;
+	amrex::ParmParse const pp;
+	pp.query("check_amr", check_amr);
+	amrex::Print() << "finest level = " << sim.finestLevel() << '\n';
+	if ((check_amr == 1) && (sim.finestLevel() == 0)) {
+		amrex::Print() << "The blast wave was not refined!\n";
+		status = 1;
+	}
+
+	if ((std::abs(rel_err) > 1.0e-12) || std::isnan(rel_err)) {
+		amrex::Print() << "Energy not conserved to machine precision!\n";
+		status = 1;
+	}
+	if ((std::abs(rel_err_Ekin) > 0.01) || std::isnan(rel_err_Ekin)) {
+		amrex::Print() << "Kinetic energy production is incorrect by more than 1 percent!\n";
+		status = 1;
+	}
+	if (std::abs(r_shock - r_shock_exact) > 0.02) {
+		amrex::Print() << "Shock radius is incorrect by more than 2 percent!\n";
+		status = 1;
+	}
+
+	return status;
+}
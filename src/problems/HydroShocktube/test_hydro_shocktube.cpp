@@ -12,6 +12,8 @@
 #include <unordered_map>
 
 #include "AMReX_BC_TYPES.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Utility.H"
 
 #include "QuokkaSimulation.hpp"
 #include "hydro/hydro_system.hpp"
@@ -379,5 +381,182 @@ auto problem_main() -> int
 	if (sim.errorNorm_ > error_tol) {
 		status = 1;
 	}
+
+	// with a refinement ratio that refines only along the shock normal (e.g., amr.ref_ratio_vect = 2 1 1), check the
+	// per-direction extents of the fine level: it must have the fine cell width along x, the coarse cell widths along
+	// y and z, and (since the solution does not depend on y or z) span the full y and z extents of the domain
+	int checkAnisotropic = 0;
+	amrex::ParmParse const pp;
+	pp.query("check_anisotropic", checkAnisotropic);
+	if (checkAnisotropic == 1) {
+		if (sim.finestLevel() == 0) {
+			amrex::Print() << "The shock tube was not refined!\n";
+			status = 1;
+		}
+		for (int lev = 1; lev <= sim.finestLevel(); ++lev) {
+			amrex::IntVect const ratio = sim.refRatio(lev - 1);
+			if ((ratio[0] < 2) || (ratio.product() != ratio[0])) {
+				amrex::Print() << "The refinement ratio " << ratio << " of level " << lev << " does not refine only along x!\n";
+				status = 1;
+			}
+			amrex::Box const &fineDomain = sim.Geom(lev).Domain();
+			amrex::Box const &crseDomain = sim.Geom(lev - 1).Domain();
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				if (fineDomain.length(idim) != ratio[idim] * crseDomain.length(idim)) {
+					amrex::Print() << "The domain of level " << lev << " has the wrong number of cells along direction " << idim << "!\n";
+					status = 1;
+				}
+			}
+
+			// the fine level must cover whole columns along y and z
+			amrex::Long const columnCells = fineDomain.numPts() / fineDomain.length(0);
+			amrex::Long const fineCells = sim.boxArray(lev).numPts();
+			if ((fineCells == 0) || (fineCells % columnCells != 0)) {
+				amrex::Print() << "The fine level " << lev << " does not cover whole columns along y and z!\n";
+				status = 1;
+			}
+			amrex::Print() << "level " << lev << ": refinement ratio " << ratio << ", " << fineCells << " cells (isotropic refinement: "
+				       << fineCells * AMREX_D_TERM(ratio[0], *ratio[0], *ratio[0]) / ratio.product() << " cells)\n";
+		}
+	}
+
+	// restart from a checkpoint written in the middle of the run (restart_step) and require that the restarted run
+	// reproduces the original run exactly. with the adaptive CFL controller enabled, this is only the case if the
+	// controller state (CFL number and streak/cooldown counters) is restored from the checkpoint.
+	int restartStep = 0;
+	pp.query("restart_step", restartStep);
+	if (restartStep > 0) {
+		std::string chkPrefix{"chk"};
+		pp.query("checkpoint_prefix", chkPrefix);
+
+		QuokkaSimulation<ShocktubeProblem> simRestart(BCs_cc);
+		simRestart.stopTime_ = max_time;
+		simRestart.maxTimesteps_ = max_timesteps;
+		simRestart.setChkFile(amrex::Concatenate(chkPrefix, restartStep));
+		simRestart.setInitialConditions();
+		amrex::Print() << "CFL number after restart at step " << restartStep << ": " << simRestart.cflNumber_ << "\n";
+		simRestart.evolve();
+
+		amrex::Print() << "Final CFL number: " << sim.cflNumber_ << " (original run), " << simRestart.cflNumber_ << " (restarted run)\n";
+		if ((sim.istep[0] != simRestart.istep[0]) || (sim.tNew_[0] != simRestart.tNew_[0]) || (sim.cflNumber_ != simRestart.cflNumber_) ||
+		    (sim.finestLevel() != simRestart.finestLevel())) {
+			amrex::Print() << "The restarted run did not reproduce the number of steps, final time, CFL number or levels of the original run!\n";
+			status = 1;
+		} else {
+			for (int lev = 0; lev <= sim.finestLevel(); ++lev) {
+				amrex::MultiFab const &state = sim.state_new_cc_[lev];
+				amrex::MultiFab diff(state.boxArray(), state.DistributionMap(), state.nComp(), 0);
+				amrex::MultiFab::Copy(diff, state, 0, 0, state.nComp(), 0);
+				amrex::MultiFab::Subtract(diff, simRestart.state_new_cc_[lev], 0, 0, state.nComp(), 0);
+				for (int n = 0; n < state.nComp(); ++n) {
+					if (diff.norm0(n) != 0.) {
+						amrex::Print() << "The restarted run differs from the original run on level " << lev << " in component " << n << "!\n";
+						status = 1;
+					}
+				}
+			}
+		}
+	}
+
+	// compare the solution computed in deep-halo mode to a run without it
+	// (this requires amr.max_level = 0: on a single level, the results must agree to roundoff)
+	int compareDeepHalo = 0;
+	pp.query("compare_deep_halo", compareDeepHalo);
+	if (compareDeepHalo == 1) {
+		using hydro = HydroSystem<ShocktubeProblem>;
+		AMREX_ALWAYS_ASSERT(sim.finestLevel() == 0);
+		AMREX_ALWAYS_ASSERT(sim.deepHalo_ == 1);
+		AMREX_ALWAYS_ASSERT(sim.state_new_cc_[0].boxArray().size() > 1);
+		amrex::MultiFab const &state = sim.state_new_cc_[0];
+
+		QuokkaSimulation<ShocktubeProblem> simRef(BCs_cc);
+		simRef.stopTime_ = max_time;
+		simRef.maxTimesteps_ = max_timesteps;
+		simRef.deepHalo_ = 0;
+		simRef.setInitialConditions();
+		simRef.evolve();
+		amrex::MultiFab const &stateRef = simRef.state_new_cc_[0];
+
+		if (sim.tNew_[0] != simRef.tNew_[0]) {
+			amrex::Print() << "The deep-halo run and the reference run ended at different times!\n";
+			status = 1;
+		}
+
+		// relative L1 difference of the conserved variables
+		const double halo_tol = 1.0e-13;
+		for (const int n : {hydro::density_index, hydro::x1Momentum_index, hydro::energy_index}) {
+			amrex::MultiFab diff(state.boxArray(), state.DistributionMap(), 1, 0);
+			amrex::MultiFab::Copy(diff, state, n, 0, 1, 0);
+			amrex::MultiFab::Subtract(diff, stateRef, n, 0, 1, 0);
+			const double rel_diff = diff.norm1(0) / stateRef.norm1(n);
+			amrex::Print() << "Relative L1 difference (deep halo vs. default) of component " << n << ": " << rel_diff << "\n";
+			if (!(rel_diff <= halo_tol)) {
+				status = 1;
+			}
+		}
+	}
+
+#ifdef QUOKKA_MIXED_PRECISION_HYDRO
+	// compare the solution computed with single-precision hydro temporaries to a double-precision run
+	// (this requires amr.max_level = 0, so that both runs have the same grids)
+	int compareMixedPrecision = 0;
+	pp.query("compare_mixed_precision", compareMixedPrecision);
+	if (compareMixedPrecision == 1) {
+		using hydro = HydroSystem<ShocktubeProblem>;
+		AMREX_ALWAYS_ASSERT(sim.finestLevel() == 0);
+		amrex::MultiFab const &state = sim.state_new_cc_[0];
+
+		QuokkaSimulation<ShocktubeProblem> simDouble(BCs_cc);
+		simDouble.stopTime_ = max_time;
+		simDouble.maxTimesteps_ = max_timesteps;
+		simDouble.computeReferenceSolution_ = true;
+		simDouble.mixedPrecisionHydro_ = 0;
+		simDouble.setInitialConditions();
+		simDouble.evolve();
+		amrex::MultiFab const &stateDouble = simDouble.state_new_cc_[0];
+
+		// every flux evaluation of the first run must have used single-precision temporaries, and none of the second
+		amrex::Print() << "Hydro flux evaluations in single/double precision: " << sim.singlePrecisionFluxCalls_ << "/"
+			       << sim.doublePrecisionFluxCalls_ << " (mixed-precision run), " << simDouble.singlePrecisionFluxCalls_ << "/"
+			       << simDouble.doublePrecisionFluxCalls_ << " (double-precision run)\n";
+		if ((sim.singlePrecisionFluxCalls_ == 0) || (sim.doublePrecisionFluxCalls_ != 0) || (simDouble.singlePrecisionFluxCalls_ != 0)) {
+			amrex::Print() << "The single-precision hydro path was not used for every flux evaluation of the mixed-precision run!\n";
+			status = 1;
+		}
+
+		// the L1 errors with respect to the exact solution must agree to within precision_error_tol (relative).
+		// the discretization error of the shock tube is ~1e-3, while the rounding error of single precision is ~1e-7
+		// per operation, so the errors should agree to far better than this tolerance.
+		const double precision_error_tol = 1.0e-3;
+		const double rel_error_diff = std::abs(sim.errorNorm_ - simDouble.errorNorm_) / simDouble.errorNorm_;
+		amrex::Print() << "L1 error norm: " << sim.errorNorm_ << " (mixed precision), " << simDouble.errorNorm_
+			       << " (double precision), relative difference " << rel_error_diff << " (tolerance " << precision_error_tol << ")\n";
+		if (!(rel_error_diff < precision_error_tol)) {
+			status = 1;
+		}
+
+		// relative L1 difference of the conserved variables
+		const double precision_tol = 1.0e-4;
+		for (const int n : {hydro::density_index, hydro::x1Momentum_index, hydro::energy_index}) {
+			amrex::MultiFab diff(state.boxArray(), state.DistributionMap(), 1, 0);
+			amrex::MultiFab::Copy(diff, state, n, 0, 1, 0);
+			amrex::MultiFab::Subtract(diff, stateDouble, n, 0, 1, 0);
+			const double rel_diff = diff.norm1(0) / stateDouble.norm1(n);
+			amrex::Print() << "Relative L1 difference (single vs. double precision) of component " << n << ": " << rel_diff << " (tolerance "
+				       << precision_tol << ")\n";
+			if (!(rel_diff < precision_tol)) {
+				status = 1;
+			}
+		}
+	}
+#else
+	// without QUOKKA_MIXED_PRECISION_HYDRO, the single-precision path does not exist, so the comparison cannot be made
+	int compareMixedPrecision = 0;
+	pp.query("compare_mixed_precision", compareMixedPrecision);
+	if (compareMixedPrecision == 1) {
+		amrex::Print() << "compare_mixed_precision requires a build with -DQUOKKA_MIXED_PRECISION_HYDRO=ON!\n";
+		status = 1;
+	}
+#endif
 	return status;
 }
@@ -0,0 +1,172 @@
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_hydro_surface_fluxes.cpp
+/// \brief Defines a test of the surface flux accounting (mass conservation through the domain faces).
+///
+/// An overdense blob (in pressure equilibrium) is advected diagonally by a uniform flow with outflow boundaries,
+/// and leaves the domain through the upper x face on the refined level. The change in the total mass in the
+/// domain plus the time-integrated mass fluxes through all of the domain faces must vanish to roundoff.
+
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "AMReX_BC_TYPES.H"
+#include "AMReX_BLassert.H"
+#include "AMReX_MultiFab.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Print.H"
+
+#include "QuokkaSimulation.hpp"
+#include "test_hydro_surface_fluxes.hpp"
+
+struct SurfaceFluxProblem {
+};
+
+template <> struct quokka::EOS_Traits<SurfaceFluxProblem> {
+	static constexpr double gamma = 1.4;
+	static constexpr double mean_molecular_weight = C::m_u;
+	static constexpr double boltzmann_constant = C::k_B;
+};
+
+template <> struct Physics_Traits<SurfaceFluxProblem> {
+	// cell-centred
+	static constexpr bool is_hydro_enabled = true;
+	static constexpr int numMassScalars = 0;		     // number of mass scalars
+	static constexpr int numPassiveScalars = numMassScalars + 0; // number of passive scalars
+	static constexpr bool is_radiation_enabled = false;
+	// face-centred
+	static constexpr bool is_mhd_enabled = false;
+	static constexpr int nGroups = 1; // number of radiation groups
+};
+
+constexpr double rho0 = 1.0;	 // background density
+constexpr double rho_blob = 10.; // peak density of the blob
+constexpr double P0 = 1.0;	 // pressure
+constexpr double v0 = 1.0;	 // flow velocity along x (the flow along y and z is v0/2 and v0/4)
+constexpr double sigma = 0.05;	 // width of the blob
+constexpr double x_blob = 0.75;	 // initial position of the blob (y = z = 0.5)
+
+template <> void QuokkaSimulation<SurfaceFluxProblem>::setInitialConditionsOnGrid(quokka::grid const &grid_elem)
+{
+	// extract variables required from the geom object
+	amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx = grid_elem.dx_;
+	amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> prob_lo = grid_elem.prob_lo_;
+	const amrex::Box &indexRange = grid_elem.indexRange_;
+	const amrex::Array4<double> &state_cc = grid_elem.array_;
+
+	const int ncomp_cc = Physics_Indices<SurfaceFluxProblem>::nvarTotal_cc;
+	// loop over the grid and set the initial condition
+	amrex::ParallelFor(indexRange, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+		amrex::Real const x = prob_lo[0] + (i + amrex::Real(0.5)) * dx[0];
+		amrex::Real const y = prob_lo[1] + (j + amrex::Real(0.5)) * dx[1];
+		amrex::Real const z = prob_lo[2] + (k + amrex::Real(0.5)) * dx[2];
+		amrex::Real const r2 = (x - x_blob) * (x - x_blob) + (y - 0.5) * (y - 0.5) + (z - 0.5) * (z - 0.5);
+
+		const double rho = rho0 + (rho_blob - rho0) * std::exp(-r2 / (2.0 * sigma * sigma));
+		const double vx = v0;
+		const double vy = 0.5 * v0;
+		const double vz = 0.25 * v0;
+		const double Eint = quokka::EOS<SurfaceFluxProblem>::ComputeEintFromPres(rho, P0);
+
+		for (int n = 0; n < ncomp_cc; ++n) {
+			state_cc(i, j, k, n) = 0.;
+		}
+		state_cc(i, j, k, HydroSystem<SurfaceFluxProblem>::density_index) = rho;
+		state_cc(i, j, k, HydroSystem<SurfaceFluxProblem>::x1Momentum_index) = rho * vx;
+		state_cc(i, j, k, HydroSystem<SurfaceFluxProblem>::x2Momentum_index) = rho * vy;
+		state_cc(i, j, k, HydroSystem<SurfaceFluxProblem>::x3Momentum_index) = rho * vz;
+		state_cc(i, j, k, HydroSystem<SurfaceFluxProblem>::energy_index) = Eint + 0.5 * rho * (vx * vx + vy * vy + vz * vz);
+		state_cc(i, j, k, HydroSystem<SurfaceFluxProblem>::internalEnergy_index) = Eint;
+	});
+}
+
+template <> void QuokkaSimulation<SurfaceFluxProblem>::ErrorEst(int lev, amrex::TagBoxArray &tags, amrex::Real /*time*/, int /*ngrow*/)
+{
+	// refine the blob
+	const amrex::Real rho_threshold = 2.0 * rho0;
+
+	for (amrex::MFIter mfi(state_new_cc_[lev]); mfi.isValid(); ++mfi) {
+		const amrex::Box &box = mfi.validbox();
+		const auto state = state_new_cc_[lev].const_array(mfi);
+		const auto tag = tags.array(mfi);
+
+		amrex::ParallelFor(box, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+			if (state(i, j, k, HydroSystem<SurfaceFluxProblem>::density_index) > rho_threshold) {
+				tag(i, j, k) = amrex::TagBox::SET;
+			}
+		});
+	}
+}
+
+namespace
+{
+// total mass in the domain, computed from the base level (which holds the average of the finer levels)
+auto totalMass(QuokkaSimulation<SurfaceFluxProblem> const &sim) -> amrex::Real
+{
+	const amrex::Real cellVolume = AMREX_D_TERM(sim.geom[0].CellSize(0), *sim.geom[0].CellSize(1), *sim.geom[0].CellSize(2));
+	return sim.state_new_cc_[0].sum(HydroSystem<SurfaceFluxProblem>::density_index) * cellVolume;
+}
+} // namespace
+
+auto problem_main() -> int
+{
+	// Boundary conditions
+	const int ncomp_cc = Physics_Indices<SurfaceFluxProblem>::nvarTotal_cc;
+	amrex::Vector<amrex::BCRec> BCs_cc(ncomp_cc);
+	for (int n = 0; n < ncomp_cc; ++n) {
+		for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+			BCs_cc[n].setLo(i, amrex::BCType::foextrap); // outflow
+			BCs_cc[n].setHi(i, amrex::BCType::foextrap);
+		}
+	}
+
+	// Problem initialization
+	QuokkaSimulation<SurfaceFluxProblem> sim(BCs_cc);
+
+	double max_time = 0.3; // the peak of the blob leaves the domain at t = 0.25, but its tail is still refined
+	amrex::ParmParse const pp;
+	pp.query("max_time", max_time);
+
+	sim.reconstructionOrder_ = 3; // PPM
+	sim.stopTime_ = max_time;
+	sim.cflNumber_ = 0.3;
+	sim.plotfileInterval_ = -1;
+	sim.checkpointInterval_ = -1;
+
+	// initialize
+	sim.setInitialConditions();
+	const amrex::Real M_initial = totalMass(sim);
+
+	// evolve
+	sim.evolve();
+	const amrex::Real M_final = totalMass(sim);
+
+	// the mass that left the domain (surface_fluxes.variables = gasDensity, and outflow is counted as positive on all faces)
+	const std::vector<amrex::Real> totals = sim.surfaceFluxes_.totals();
+	AMREX_ALWAYS_ASSERT(totals.size() == 2 * AMREX_SPACEDIM);
+	const amrex::Real M_out = std::accumulate(totals.begin(), totals.end(), amrex::Real(0.));
+
+	// the change in mass plus the outflow must vanish to roundoff
+	const amrex::Real rel_err = std::abs(M_final - M_initial + M_out) / M_initial;
+	const amrex::Real rel_tol = 1.0e-12;
+	amrex::Print() << "Total mass: initial = " << M_initial << ", final = " << M_final << ", outflow through the domain faces = " << M_out
+		       << ", relative error = " << rel_err << "\n";
+
+	int status = 0;
+	if (sim.finestLevel() < 1) {
+		amrex::Print() << "The blob was not refined!\n";
+		status = 1;
+	}
+	if (!(M_initial - M_final > 5.0e-3 * M_initial)) {
+		amrex::Print() << "The blob did not leave the domain!\n";
+		status = 1;
+	}
+	if (!(rel_err < rel_tol)) {
+		status = 1;
+	}
+	return status;
+}
@@ -0,0 +1,15 @@
+#ifndef TEST_HYDRO_SURFACE_FLUXES_HPP_ // NOLINT
+#define TEST_HYDRO_SURFACE_FLUXES_HPP_
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_hydro_surface_fluxes.hpp
+/// \brief Defines a test of the surface flux accounting (mass conservation through the domain faces).
+///
+
+// internal headers
+#include "hydro/hydro_system.hpp"
+
+#endif // TEST_HYDRO_SURFACE_FLUXES_HPP_
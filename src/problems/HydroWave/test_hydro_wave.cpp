@@ -7,10 +7,21 @@
 /// \brief Defines a test problem for a linear hydro wave.
 ///
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
 #include <valarray>
+#include <vector>
 
 #include "AMReX_Array.H"
 #include "AMReX_Array4.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
 #include "AMReX_REAL.H"
 
 #include "QuokkaSimulation.hpp"
@@ -84,6 +95,89 @@ template <> void QuokkaSimulation<WaveProblem>::setInitialConditionsOnGrid(quokk
 	});
 }
 
+namespace
+{
+// a probe of the DiagProbes diagnostic 'quokka.probes' (a point, or a line of equally-spaced points along x)
+struct WaveProbe {
+	std::string fileName;
+	std::vector<double> xs; // x-coordinates of the points
+};
+
+auto readWaveProbes() -> std::vector<WaveProbe>
+{
+	const std::string prefix = "quokka.probes";
+	amrex::ParmParse const pp(prefix);
+	std::string diagFile = "probes";
+	pp.query("file", diagFile);
+	std::vector<std::string> fields;
+	pp.queryarr("field_names", fields);
+	AMREX_ALWAYS_ASSERT_WITH_MESSAGE(fields == std::vector<std::string>({"gasDensity", "x-GasMomentum"}),
+					 "the probes must sample gasDensity and x-GasMomentum (in this order)!");
+
+	std::vector<WaveProbe> probes;
+	std::vector<std::string> names;
+	pp.queryarr("probes", names);
+	for (auto const &name : names) {
+		amrex::ParmParse const ppp(prefix + "." + name);
+		std::string type = "point";
+		ppp.query("type", type);
+		WaveProbe probe;
+		probe.fileName = diagFile + "_" + name + ".txt";
+		if (type == "line") {
+			std::vector<double> start;
+			std::vector<double> end;
+			int npoints = 0;
+			ppp.getarr("start", start);
+			ppp.getarr("end", end);
+			ppp.get("npoints", npoints);
+			for (int p = 0; p < npoints; ++p) {
+				const double s = static_cast<double>(p) / static_cast<double>(npoints - 1);
+				probe.xs.push_back((1.0 - s) * start[0] + s * end[0]);
+			}
+		} else {
+			std::vector<double> position;
+			ppp.getarr("position", position);
+			probe.xs.push_back(position[0]);
+		}
+		probes.push_back(probe);
+	}
+	return probes;
+}
+
+// the maximum deviation (in units of the amplitude) of the sampled density and x-momentum from the analytic linear wave,
+// which travels in the -x direction at the sound speed. returns -1 if the probe file has fewer than two samples.
+auto probeError(WaveProbe const &probe) -> double
+{
+	const double c_s = std::sqrt(quokka::EOS_Traits<WaveProblem>::gamma * P0 / rho0);
+	const size_t npoints = probe.xs.size();
+	std::ifstream file(probe.fileName);
+	std::string line;
+	int nsamples = 0;
+	double maxErr = 0.;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		std::istringstream row(line);
+		double step = NAN;
+		double t = NAN;
+		std::vector<double> values(2 * npoints);
+		row >> step >> t;
+		for (auto &v : values) {
+			row >> v;
+		}
+		for (size_t p = 0; p < npoints; ++p) {
+			const double dU = amp * std::sin(2.0 * M_PI * (probe.xs[p] + c_s * t));
+			const double rho_exact = rho0 + dU;	   // R[0] = 1
+			const double xmom_exact = rho0 * v0 - dU; // R[1] = -1
+			maxErr = std::max({maxErr, std::abs(values[p] - rho_exact) / amp, std::abs(values[npoints + p] - xmom_exact) / amp});
+		}
+		++nsamples;
+	}
+	return (nsamples < 2) ? -1.0 : maxErr;
+}
+} // namespace
+
 auto problem_main() -> int
 {
 	// Based on the ATHENA test page:
@@ -106,6 +200,21 @@ auto problem_main() -> int
 		}
 	}
 
+	// the probe outputs are appended to, so remove those of previous runs
+	int checkProbes = 0;
+	amrex::ParmParse const pp;
+	pp.query("check_probes", checkProbes);
+	std::vector<WaveProbe> probes;
+	if (checkProbes == 1) {
+		probes = readWaveProbes();
+		if (amrex::ParallelDescriptor::IOProcessor()) {
+			for (auto const &probe : probes) {
+				std::remove(probe.fileName.c_str());
+			}
+		}
+		amrex::ParallelDescriptor::Barrier();
+	}
+
 	QuokkaSimulation<WaveProblem> sim(BCs_cc);
 
 	sim.cflNumber_ = CFL_number;
@@ -233,5 +342,60 @@ auto problem_main() -> int
 		status = 1;
 	}
 
+	// the error and resolution are written to the file 'write_error', or the order of convergence is computed
+	// with respect to the (coarser) run whose error is stored in the file 'compare_error'
+	// (used to check that the MUSCL-Hancock integrator is second-order accurate, as is RK2-SSP)
+	std::string write_error;
+	std::string compare_error;
+	double min_order = 1.8;
+	pp.query("write_error", write_error);
+	pp.query("compare_error", compare_error);
+	pp.query("min_order", min_order);
+	if (amrex::ParallelDescriptor::IOProcessor()) {
+		if (!write_error.empty()) {
+			std::ofstream file(write_error, std::ofstream::out | std::ofstream::trunc);
+			if (!file.good()) {
+				amrex::FileOpenFailed(write_error);
+			}
+			file << std::setprecision(std::numeric_limits<double>::max_digits10) << nx << " " << epsilon << "\n";
+		}
+		if (!compare_error.empty()) {
+			std::ifstream file(compare_error);
+			int nx_coarse = 0;
+			double epsilon_coarse = NAN;
+			file >> nx_coarse >> epsilon_coarse;
+			const double order = std::log(epsilon_coarse / epsilon) / std::log(static_cast<double>(nx) / nx_coarse);
+			amrex::Print() << "order of convergence between Nx = " << nx_coarse << " and Nx = " << nx << ": " << order
+				       << " (minimum = " << min_order << ")\n";
+			if (!(order >= min_order)) {
+				status = 1;
+			}
+		}
+	}
+	amrex::ParallelDescriptor::Bcast(&status, 1, amrex::ParallelDescriptor::IOProcessorNumber());
+
+	// compare the probe time series with the analytic solution
+	// (the spatial interpolation of the cell averages contributes less than 1e-3 of the amplitude for Nx = 100)
+	if (checkProbes == 1) {
+		const double probe_tol = 3.0e-2; // in units of the amplitude
+		int probe_status = 0;
+		if (amrex::ParallelDescriptor::IOProcessor()) {
+			for (auto const &probe : probes) {
+				const double probe_err = probeError(probe);
+				amrex::Print() << "probe " << probe.fileName << ": max. relative deviation from the linear wave = " << probe_err << "\n";
+				if (!(probe_err >= 0. && probe_err < probe_tol)) {
+					probe_status = 1;
+				}
+			}
+			if (probes.empty()) {
+				probe_status = 1;
+			}
+		}
+		amrex::ParallelDescriptor::Bcast(&probe_status, 1, amrex::ParallelDescriptor::IOProcessorNumber());
+		if (probe_status != 0) {
+			status = 1;
+		}
+	}
+
 	return status;
 }
@@ -7,7 +7,12 @@
 /// \brief Implements a subsonic channel flow problem with Navier-Stokes
 ///        Characteristic Boundary Conditions (NSCBC).
 ///
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
 #include <random>
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -163,6 +168,16 @@ auto problem_main() -> int
 	::P_outflow = quokka::EOS<Channel>::ComputePressure(rho0, Eint0);
 	amrex::Print() << "Derived outflow pressure is " << ::P_outflow << " erg/cc.\n";
 
+	// the sponge layer (if any) must only relax the pressure toward the far-field pressure imposed by the NSCBC outflow boundary,
+	// so that it does not relax toward the exact solution that the error norm is measured against
+	if (sim.sponge_.enabled()) {
+		AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!sim.sponge_.relax_density && !sim.sponge_.relax_velocity && sim.sponge_.relax_pressure,
+						 "the channel flow sponge layer must only relax toward the far-field pressure!");
+		AMREX_ALWAYS_ASSERT_WITH_MESSAGE(std::abs(sim.sponge_.pressure - ::P_outflow) < 1.0e-6 * ::P_outflow,
+						 "sponge.pressure must be the outflow pressure!");
+		sim.sponge_.pressure = ::P_outflow;
+	}
+
 	// Set initial conditions
 	sim.setInitialConditions();
 
@@ -208,25 +223,79 @@ auto problem_main() -> int
 	std::vector<std::vector<double>> const sol{d, vx, P, s};
 	std::vector<std::vector<double>> const sol_exact{density_exact, velocity_exact, Pexact, sexact};
 
-	// compute error norm
-	amrex::Real err_sq = 0.;
-	for (size_t n = 0; n < sol.size(); ++n) {
-		amrex::Real dU_k = 0.;
-		amrex::Real U_k = 0;
+	// compute error norm (over the cells with x < x_max)
+	auto errorNorm = [&](amrex::Real x_max) {
+		int ncells = 0;
 		for (int i = 0; i < nx; ++i) {
-			// Δ Uk = ∑i |Uk,in - Uk,i0| / Nx
-			const amrex::Real U_k0 = sol_exact.at(n)[i];
-			const amrex::Real U_k1 = sol.at(n)[i];
-			dU_k += std::abs(U_k1 - U_k0) / static_cast<double>(nx);
-			U_k += std::abs(U_k0) / static_cast<double>(nx);
+			if (xs[i] < x_max) {
+				++ncells;
+			}
 		}
-		amrex::Print() << "dU_" << n << " = " << dU_k << " U_k = " << U_k << "\n";
-		// ε = || Δ U / U || = [&sum_k (ΔU_k/U_k)^2]^{1/2}
-		err_sq += std::pow(dU_k / U_k, 2);
-	}
-	const amrex::Real epsilon = std::sqrt(err_sq);
+		amrex::Real err_sq = 0.;
+		for (size_t n = 0; n < sol.size(); ++n) {
+			amrex::Real dU_k = 0.;
+			amrex::Real U_k = 0;
+			for (int i = 0; i < nx; ++i) {
+				if (!(xs[i] < x_max)) {
+					continue;
+				}
+				// Δ Uk = ∑i |Uk,in - Uk,i0| / Nx
+				const amrex::Real U_k0 = sol_exact.at(n)[i];
+				const amrex::Real U_k1 = sol.at(n)[i];
+				dU_k += std::abs(U_k1 - U_k0) / static_cast<double>(ncells);
+				U_k += std::abs(U_k0) / static_cast<double>(ncells);
+			}
+			amrex::Print() << "dU_" << n << " = " << dU_k << " U_k = " << U_k << "\n";
+			// ε = || Δ U / U || = [&sum_k (ΔU_k/U_k)^2]^{1/2}
+			err_sq += std::pow(dU_k / U_k, 2);
+		}
+		return std::sqrt(err_sq);
+	};
+	const amrex::Real epsilon = errorNorm(std::numeric_limits<amrex::Real>::max());
 	amrex::Print() << "rms of component-wise relative L1 error norms = " << epsilon << "\n\n";
 
+	// the error in the region x < compare_x_max is written to the file 'write_baseline' (by the full-domain run without a sponge layer),
+	// or compared to the error in the file 'compare_baseline' (by the run on a truncated domain with a sponge layer).
+	// The truncated run passes if its error exceeds the baseline by at most the relative tolerance 'baseline_rel_tol'
+	// (the residual reflections from the sponge layer change the error slightly, even when they are much weaker than
+	// the reflections from the outflow boundary that the full domain is large enough to avoid).
+	amrex::Real compare_x_max = -1.;
+	amrex::Real baseline_rel_tol = 0.05;
+	std::string write_baseline;
+	std::string compare_baseline;
+	{
+		amrex::ParmParse const ppt;
+		ppt.query("compare_x_max", compare_x_max);
+		ppt.query("baseline_rel_tol", baseline_rel_tol);
+		ppt.query("write_baseline", write_baseline);
+		ppt.query("compare_baseline", compare_baseline);
+	}
+	int baseline_status = 0;
+	if (compare_x_max > 0.) {
+		const amrex::Real epsilon_cmp = errorNorm(compare_x_max);
+		amrex::Print() << "rms of component-wise relative L1 error norms for x < " << compare_x_max << " = " << epsilon_cmp << "\n\n";
+		if (amrex::ParallelDescriptor::IOProcessor()) {
+			if (!write_baseline.empty()) {
+				std::ofstream file(write_baseline, std::ofstream::out | std::ofstream::trunc);
+				if (!file.good()) {
+					amrex::FileOpenFailed(write_baseline);
+				}
+				file << std::setprecision(std::numeric_limits<amrex::Real>::max_digits10) << epsilon_cmp << "\n";
+			}
+			if (!compare_baseline.empty()) {
+				std::ifstream file(compare_baseline);
+				amrex::Real epsilon_baseline = NAN;
+				file >> epsilon_baseline;
+				amrex::Print() << "baseline (full domain without a sponge layer) = " << epsilon_baseline << " (relative tolerance " << baseline_rel_tol
+					       << ")\n\n";
+				if (!(epsilon_cmp <= (1.0 + baseline_rel_tol) * epsilon_baseline)) {
+					baseline_status = 1;
+				}
+			}
+		}
+		amrex::ParallelDescriptor::Bcast(&baseline_status, 1, amrex::ParallelDescriptor::IOProcessorNumber());
+	}
+
 #ifdef HAVE_PYTHON
 	if (amrex::ParallelDescriptor::IOProcessor()) {
 		// Plot results
@@ -299,5 +368,8 @@ auto problem_main() -> int
 	if (epsilon > error_tol) {
 		status = 1;
 	}
+	if (baseline_status != 0) {
+		status = 1;
+	}
 	return status;
 }
@@ -0,0 +1,107 @@
+"""Decode the PNG files written by test_png_writer (with zlib, independently of the encoder)
+and compare their pixels with the raw RGB data written next to them.
+
+usage: python3 check_png.py <prefix>
+"""
+import glob
+import struct
+import sys
+import zlib
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    if pb <= pc:
+        return b
+    return c
+
+
+def decode_png(data):
+    """return (width, height, rgb bytes) of an 8-bit RGB PNG image"""
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("invalid PNG signature")
+
+    pos = 8
+    chunks = []
+    while pos < len(data):
+        (length,) = struct.unpack(">I", data[pos : pos + 4])
+        kind = data[pos + 4 : pos + 8]
+        body = data[pos + 8 : pos + 8 + length]
+        (crc,) = struct.unpack(">I", data[pos + 8 + length : pos + 12 + length])
+        if zlib.crc32(kind + body) != crc:
+            raise ValueError("invalid CRC of chunk %s" % kind)
+        chunks.append((kind, body))
+        pos += 12 + length
+
+    if chunks[0][0] != b"IHDR" or chunks[-1][0] != b"IEND":
+        raise ValueError("the first chunk must be IHDR and the last chunk must be IEND")
+    width, height, depth, color, compression, filtering, interlace = struct.unpack(">IIBBBBB", chunks[0][1])
+    if (depth, color, compression, filtering, interlace) != (8, 2, 0, 0, 0):
+        raise ValueError("not an 8-bit, non-interlaced RGB image")
+
+    # zlib.decompress also checks the Adler-32 checksum of the stream
+    raw = zlib.decompress(b"".join(body for kind, body in chunks if kind == b"IDAT"))
+    stride = 3 * width
+    if len(raw) != height * (stride + 1):
+        raise ValueError("wrong size of the image data")
+
+    rgb = bytearray()
+    prev = bytearray(stride)
+    for y in range(height):
+        ftype = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1 : (y + 1) * (stride + 1)])
+        for i in range(stride):
+            a = line[i - 3] if i >= 3 else 0
+            b = prev[i]
+            c = prev[i - 3] if i >= 3 else 0
+            if ftype == 0:
+                pred = 0
+            elif ftype == 1:
+                pred = a
+            elif ftype == 2:
+                pred = b
+            elif ftype == 3:
+                pred = (a + b) // 2
+            elif ftype == 4:
+                pred = paeth(a, b, c)
+            else:
+                raise ValueError("invalid filter type %d in row %d" % (ftype, y))
+            line[i] = (line[i] + pred) % 256
+        rgb += line
+        prev = line
+    return width, height, bytes(rgb)
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__)
+        return 1
+    prefix = sys.argv[1]
+
+    files = sorted(glob.glob(prefix + "_*.png"))
+    if not files:
+        print("no images found with prefix %s!" % prefix)
+        return 1
+
+    status = 0
+    for filename in files:
+        name = filename[: -len(".png")]
+        expected_width, expected_height = (int(n) for n in name.split("_")[-1].split("x"))
+        with open(filename, "rb") as f:
+            width, height, rgb = decode_png(f.read())
+        with open(name + ".rgb", "rb") as f:
+            expected = f.read()
+
+        mismatches = sum(1 for p, q in zip(rgb, expected) if p != q)
+        ok = (width, height) == (expected_width, expected_height) and len(rgb) == len(expected) and mismatches == 0
+        print("%s: %d x %d pixels, %d differing bytes: %s" % (filename, width, height, mismatches, "ok" if ok else "FAILED"))
+        if not ok:
+            status = 1
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
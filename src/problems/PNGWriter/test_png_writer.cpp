@@ -0,0 +1,86 @@
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_png_writer.cpp
+/// \brief Defines a test of the built-in PNG encoder.
+///
+/// Images of several sizes (a smooth gradient with a uniform region, which compresses well, and a band of
+/// noise, which does not) are encoded with quokka::writePNG. The raw RGB data of each image is written
+/// next to it, and check_png.py decodes the PNG files independently (with zlib) and compares the pixels.
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Print.H"
+#include "AMReX_Utility.H"
+
+#include "test_png_writer.hpp"
+
+namespace
+{
+// a deterministic test image of the given size
+auto testImage(int width, int height) -> std::vector<std::uint8_t>
+{
+	std::mt19937 gen(width * 1000 + height); // NOLINT(cert-msc32-c,cert-msc51-cpp)
+	std::vector<std::uint8_t> rgb(3 * static_cast<std::size_t>(width) * height);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			for (int n = 0; n < 3; ++n) {
+				std::uint8_t value = 0;
+				if (y < height / 3) {
+					value = static_cast<std::uint8_t>((x * (n + 1) + 7 * y) % 256); // gradient
+				} else if (y < 2 * height / 3) {
+					value = static_cast<std::uint8_t>(40 * n + 17); // uniform
+				} else {
+					value = static_cast<std::uint8_t>(gen() % 256); // noise
+				}
+				rgb[3 * (x + static_cast<std::size_t>(width) * y) + n] = value;
+			}
+		}
+	}
+	return rgb;
+}
+} // namespace
+
+auto problem_main() -> int
+{
+	std::string prefix = "png_writer_test";
+	std::vector<int> widths{1, 37, 300};
+	std::vector<int> heights{1, 23, 7};
+	amrex::ParmParse const pp("png_writer");
+	pp.query("file", prefix);
+	pp.queryarr("widths", widths);
+	pp.queryarr("heights", heights);
+	AMREX_ALWAYS_ASSERT(widths.size() == heights.size());
+
+	int status = 0;
+	if (amrex::ParallelDescriptor::IOProcessor()) {
+		for (std::size_t i = 0; i < widths.size(); ++i) {
+			const std::string fileName = prefix + "_" + std::to_string(widths[i]) + "x" + std::to_string(heights[i]);
+			const std::vector<std::uint8_t> rgb = testImage(widths[i], heights[i]);
+			if (!quokka::writePNG(fileName + ".png", rgb, widths[i], heights[i])) {
+				amrex::Print() << "Could not write " << fileName << ".png!\n";
+				status = 1;
+			}
+
+			std::ofstream raw(fileName + ".rgb", std::ios::binary | std::ios::trunc);
+			if (!raw.good()) {
+				amrex::FileOpenFailed(fileName + ".rgb");
+			}
+			raw.write(reinterpret_cast<const char *>(rgb.data()), static_cast<std::streamsize>(rgb.size())); // NOLINT
+			amrex::Print() << "wrote " << fileName << ".png (" << widths[i] << " x " << heights[i] << " pixels)\n";
+		}
+	}
+
+	// Cleanup and exit
+	amrex::ParallelDescriptor::Bcast(&status, 1, amrex::ParallelDescriptor::IOProcessorNumber());
+	return status;
+}
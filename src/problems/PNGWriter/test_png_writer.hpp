@@ -0,0 +1,15 @@
+#ifndef TEST_PNG_WRITER_HPP_ // NOLINT
+#define TEST_PNG_WRITER_HPP_
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_png_writer.hpp
+/// \brief Defines a test of the built-in PNG encoder.
+///
+
+// internal headers
+#include "util/png_writer.hpp"
+
+#endif // TEST_PNG_WRITER_HPP_
@@ -13,6 +13,8 @@
 #include "AMReX_BC_TYPES.H"
 #include "AMReX_FabArray.H"
 #include "AMReX_MultiFab.H"
+#include "AMReX_ParReduce.H"
+#include "AMReX_ParallelDescriptor.H"
 #include "AMReX_ParmParse.H"
 #include "AMReX_Print.H"
 #include "AMReX_REAL.H"
@@ -445,25 +447,97 @@ auto problem_main() -> int
 		}
 	}
 
-	// Problem initialization
-	QuokkaSimulation<PopIII> sim(BCs_cc);
-	sim.doPoissonSolve_ = 1; // enable self-gravity
+	// set up and run the problem, optionally copying the final state on level 0 into 'state_out'; returns the wall time of the evolution
+	auto runPopIII = [&](int cacheEOSFields, amrex::MultiFab *state_out) -> amrex::Real {
+		// Problem initialization
+		QuokkaSimulation<PopIII> sim(BCs_cc);
+		sim.doPoissonSolve_ = 1; // enable self-gravity
+		if (cacheEOSFields >= 0) {
+			sim.cacheEOSFields_ = cacheEOSFields;
+		}
+
+		sim.tempFloor_ = 2.73 * (30.0 + 1.0);
+		// sim.speedCeiling_ = 3e6;
 
-	sim.tempFloor_ = 2.73 * (30.0 + 1.0);
-	// sim.speedCeiling_ = 3e6;
+		sim.userData_.R_sphere = R_sphere;
+		sim.userData_.numdens_init = numdens_init;
+		sim.userData_.omega_sphere = omega_sphere;
 
-	sim.userData_.R_sphere = R_sphere;
-	sim.userData_.numdens_init = numdens_init;
-	sim.userData_.omega_sphere = omega_sphere;
+		sim.initDt_ = 1e6;
 
-	sim.initDt_ = 1e6;
+		// initialize
+		sim.setInitialConditions();
 
-	// initialize
-	sim.setInitialConditions();
+		// evolve
+		amrex::Real const start_time = amrex::ParallelDescriptor::second();
+		sim.evolve();
+		amrex::Real elapsed = amrex::ParallelDescriptor::second() - start_time;
+		amrex::ParallelDescriptor::ReduceRealMax(elapsed);
 
-	// evolve
-	sim.evolve();
+		if (state_out != nullptr) {
+			amrex::MultiFab const &state = sim.state_new_cc_[0];
+			state_out->define(state.boxArray(), state.DistributionMap(), state.nComp(), 0);
+			amrex::MultiFab::Copy(*state_out, state, 0, 0, state.nComp(), 0);
+		}
+		return elapsed;
+	};
+
+	// compare the hydro update with the cached effective adiabatic index (chemistry.cache_eos_fields = 1) to the full EOS?
+	int compare_eos_cache = 0;
+	amrex::Real eos_cache_rel_tol = 1.0e-10;
+	{
+		amrex::ParmParse const ppt;
+		ppt.query("compare_eos_cache", compare_eos_cache);
+		ppt.query("eos_cache_rel_tol", eos_cache_rel_tol);
+	}
 
-	int const status = 0;
+	if (compare_eos_cache == 0) {
+		runPopIII(-1, nullptr);
+		int const status = 0;
+		return status;
+	}
+
+	// For a cloud that fills the domain (uniform density, temperature, and composition) and a single forward-Euler stage
+	// (hydro.rk_integrator_order = 1) without chemistry, every EOS call in the hydro update is made for the same state,
+	// so the cached and full EOS must give the same temperature and pressure to round-off (the default tolerance also allows for
+	// the convergence tolerance of the temperature iteration in the primordial EOS, which may be hit for states that differ by round-off).
+	amrex::MultiFab state_full;
+	amrex::MultiFab state_cached;
+	amrex::Real const time_full = runPopIII(0, &state_full);
+	amrex::Real const time_cached = runPopIII(1, &state_cached);
+	AMREX_ALWAYS_ASSERT(state_full.boxArray() == state_cached.boxArray());
+	AMREX_ALWAYS_ASSERT(state_full.DistributionMap() == state_cached.DistributionMap());
+
+	auto const &full = state_full.const_arrays();
+	auto const &cached = state_cached.const_arrays();
+	auto [dT_max, dP_max] =
+	    amrex::ParReduce(amrex::TypeList<amrex::ReduceOpMax, amrex::ReduceOpMax>{}, amrex::TypeList<Real, Real>{}, state_full, amrex::IntVect(0),
+			     [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) noexcept -> amrex::GpuTuple<Real, Real> {
+				     auto temperature = [=](amrex::Array4<const Real> const &state) {
+					     Real const rho = state(i, j, k, HydroSystem<PopIII>::density_index);
+					     Real const Eint = state(i, j, k, HydroSystem<PopIII>::internalEnergy_index);
+					     amrex::GpuArray<Real, Physics_Traits<PopIII>::numMassScalars> massScalars =
+						 RadSystem<PopIII>::ComputeMassScalars(state, i, j, k);
+					     return quokka::EOS<PopIII>::ComputeTgasFromEint(rho, Eint, massScalars);
+				     };
+				     Real const T_full = temperature(full[bx]);
+				     Real const T_cached = temperature(cached[bx]);
+				     Real const P_full = HydroSystem<PopIII>::ComputePressure(full[bx], i, j, k);
+				     Real const P_cached = HydroSystem<PopIII>::ComputePressure(cached[bx], i, j, k);
+				     return {std::abs(T_cached - T_full) / T_full, std::abs(P_cached - P_full) / P_full};
+			     });
+	amrex::ParallelDescriptor::ReduceRealMax(dT_max);
+	amrex::ParallelDescriptor::ReduceRealMax(dP_max);
+
+	amrex::Print() << "\nmax. relative difference (cached vs. full EOS): temperature = " << dT_max << ", pressure = " << dP_max
+		       << " (tolerance = " << eos_cache_rel_tol << ")\n";
+	amrex::Print() << "wall time of the evolution: full EOS = " << time_full << " s, cached EOS = " << time_cached
+		       << " s (speedup = " << time_full / time_cached << ")\n\n";
+
+	int status = 0;
+	if (!(dT_max <= eos_cache_rel_tol) || !(dP_max <= eos_cache_rel_tol)) {
+		amrex::Print() << "The temperature or pressure with the cached EOS differs from the full EOS by more than the tolerance!\n";
+		status = 1;
+	}
 	return status;
 }
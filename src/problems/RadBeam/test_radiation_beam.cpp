@@ -7,9 +7,17 @@
 /// \brief Defines a test problem for radiation in the streaming regime.
 ///
 
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <string>
+
 #include "AMReX_Array.H"
 #include "AMReX_BC_TYPES.H"
 #include "AMReX_IntVect.H"
+#include "AMReX_ParReduce.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
 #include "AMReX_REAL.H"
 
 #include "QuokkaSimulation.hpp"
@@ -263,6 +271,34 @@ template <> void QuokkaSimulation<BeamProblem>::ErrorEst(int lev, amrex::TagBoxA
 	}
 }
 
+// compute the relative L1 error of the radiation energy density on level 0 (over the cells with x < x_max and y < x_max)
+// with respect to the beam in the streaming limit, which fills the stripe |x - y| <= 0.0625 (the width of the inflow
+// region on each lower face) once it has crossed the domain
+auto beamErrorNorm(amrex::MultiFab const &state_mf, amrex::Geometry const &geom, amrex::Real x_max) -> amrex::Real
+{
+	const auto dx = geom.CellSizeArray();
+	const auto prob_lo = geom.ProbLoArray();
+	auto const &state = state_mf.const_arrays();
+	const double E_beam = a_rad * std::pow(T_hohlraum, 4);
+	const double E_ambient = a_rad * std::pow(T_initial, 4);
+	const double width = 0.0625;
+
+	auto [dE, E] = amrex::ParReduce(amrex::TypeList<amrex::ReduceOpSum, amrex::ReduceOpSum>{}, amrex::TypeList<amrex::Real, amrex::Real>{}, state_mf,
+					amrex::IntVect(0), [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) noexcept -> amrex::GpuTuple<amrex::Real, amrex::Real> {
+						const amrex::Real x = prob_lo[0] + (i + 0.5) * dx[0];
+						const amrex::Real y = prob_lo[1] + (j + 0.5) * dx[1];
+						if (!((x < x_max) && (y < x_max))) {
+							return {0., 0.};
+						}
+						const amrex::Real E_exact = (std::abs(x - y) <= width) ? E_beam : E_ambient;
+						const amrex::Real Erad = state[bx](i, j, k, RadSystem<BeamProblem>::radEnergy_index);
+						return {std::abs(Erad - E_exact), E_exact};
+					});
+	amrex::ParallelDescriptor::ReduceRealSum(dE);
+	amrex::ParallelDescriptor::ReduceRealSum(E);
+	return dE / E;
+}
+
 auto problem_main() -> int
 {
 	// Problem parameters
@@ -292,7 +328,6 @@ auto problem_main() -> int
 	sim.radiationCflNumber_ = CFL_number;
 	sim.radiationReconstructionOrder_ = 2; // PLM
 	sim.maxTimesteps_ = max_timesteps;
-	sim.plotfileInterval_ = 20; // for debugging
 
 	// initialize
 	sim.setInitialConditions();
@@ -300,7 +335,49 @@ auto problem_main() -> int
 	// evolve
 	sim.evolve();
 
+	// the error in the region x, y < compare_max is written to the file 'write_baseline' (by the run on the full domain),
+	// or compared to the error in the file 'compare_baseline' (by the run on a truncated domain with a sponge layer).
+	// The truncated run passes if its error exceeds the baseline by at most the relative tolerance 'baseline_rel_tol'
+	// (the relaxation in the layer slightly changes the radiation field that streams back out of it).
+	amrex::Real compare_max = -1.;
+	amrex::Real baseline_rel_tol = 0.05;
+	std::string write_baseline;
+	std::string compare_baseline;
+	{
+		amrex::ParmParse const pp;
+		pp.query("compare_max", compare_max);
+		pp.query("baseline_rel_tol", baseline_rel_tol);
+		pp.query("write_baseline", write_baseline);
+		pp.query("compare_baseline", compare_baseline);
+	}
+
+	int status = 0;
+	if (compare_max > 0.) {
+		const amrex::Real err = beamErrorNorm(sim.state_new_cc_[0], sim.Geom(0), compare_max);
+		amrex::Print() << "relative L1 error of the radiation energy density for x, y < " << compare_max << " = " << err << "\n\n";
+		if (amrex::ParallelDescriptor::IOProcessor()) {
+			if (!write_baseline.empty()) {
+				std::ofstream file(write_baseline, std::ofstream::out | std::ofstream::trunc);
+				if (!file.good()) {
+					amrex::FileOpenFailed(write_baseline);
+				}
+				file << std::setprecision(std::numeric_limits<amrex::Real>::max_digits10) << err << "\n";
+			}
+			if (!compare_baseline.empty()) {
+				std::ifstream file(compare_baseline);
+				amrex::Real err_baseline = NAN;
+				file >> err_baseline;
+				amrex::Print() << "baseline (full domain without a sponge layer) = " << err_baseline << " (relative tolerance " << baseline_rel_tol
+					       << ")\n\n";
+				if (!(err <= (1.0 + baseline_rel_tol) * err_baseline)) {
+					status = 1;
+				}
+			}
+		}
+		amrex::ParallelDescriptor::Bcast(&status, 1, amrex::ParallelDescriptor::IOProcessorNumber());
+	}
+
 	// Cleanup and exit
 	amrex::Print() << "Finished." << '\n';
-	return 0;
+	return status;
 }
@@ -3,6 +3,9 @@
 ///
 
 #include "AMReX_BLassert.H"
+#include "AMReX_MultiFab.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
 
 #include "QuokkaSimulation.hpp"
 #include "radiation/radiation_system.hpp"
@@ -282,18 +285,69 @@ auto problem_main() -> int
 	sim.maxTimesteps_ = max_timesteps;
 	sim.plotfileInterval_ = -1;
 
+	// compare to a run with the grey initial guess for the matter-radiation exchange, which must give the same solution
+	// (within the tolerance of the Newton-Raphson iteration) with fewer iterations
+	int compareGreyGuess = 0;
+	amrex::ParmParse const pp;
+	pp.query("compare_grey_guess", compareGreyGuess);
+	sim.countRadNewtonIterations_ = (compareGreyGuess == 1);
+
 	// initialize
 	sim.setInitialConditions();
 
 	// evolve
 	sim.evolve();
 
+	int status = 0;
+	if (compareGreyGuess == 1) {
+		AMREX_ALWAYS_ASSERT(sim.radiationGreyInitialGuess_ == 0);
+		QuokkaSimulation<SuOlsonProblemCgs> simGrey(BCs_cc);
+		simGrey.radiationReconstructionOrder_ = 3; // PPM
+		simGrey.stopTime_ = max_time;
+		simGrey.maxDt_ = max_dt;
+		simGrey.radiationCflNumber_ = CFL_number;
+		simGrey.maxTimesteps_ = max_timesteps;
+		simGrey.plotfileInterval_ = -1;
+		simGrey.radiationGreyInitialGuess_ = 1;
+		simGrey.countRadNewtonIterations_ = true;
+		simGrey.setInitialConditions();
+		simGrey.evolve();
+
+		amrex::Long iterations = sim.radNewtonIterations_;
+		amrex::Long iterations_grey = simGrey.radNewtonIterations_;
+		amrex::ParallelDescriptor::ReduceLongSum(iterations);
+		amrex::ParallelDescriptor::ReduceLongSum(iterations_grey);
+		amrex::Print() << "Newton-Raphson iterations: " << iterations << " (default), " << iterations_grey << " (grey initial guess)\n";
+		if (!(iterations_grey < iterations)) {
+			amrex::Print() << "The grey initial guess does not reduce the number of Newton-Raphson iterations!\n";
+			status = 1;
+		}
+
+		// relative L1 difference of the gas energy and the radiation energy of each group
+		const double guess_tol = 1.0e-6;
+		amrex::MultiFab const &state = sim.state_new_cc_[0];
+		amrex::MultiFab const &stateGrey = simGrey.state_new_cc_[0];
+		std::vector<int> comps{RadSystem<SuOlsonProblemCgs>::gasEnergy_index};
+		for (int g = 0; g < Physics_Traits<SuOlsonProblemCgs>::nGroups; ++g) {
+			comps.push_back(RadSystem<SuOlsonProblemCgs>::radEnergy_index + Physics_NumVars::numRadVars * g);
+		}
+		for (const int n : comps) {
+			amrex::MultiFab diff(state.boxArray(), state.DistributionMap(), 1, 0);
+			amrex::MultiFab::Copy(diff, stateGrey, n, 0, 1, 0);
+			amrex::MultiFab::Subtract(diff, state, n, 0, 1, 0);
+			const double rel_diff = diff.norm1(0) / state.norm1(n);
+			amrex::Print() << "Relative L1 difference (grey initial guess vs. default) of component " << n << ": " << rel_diff << "\n";
+			if (!(rel_diff < guess_tol)) {
+				status = 1;
+			}
+		}
+	}
+
 	// read output variables
 	auto [position, values] = fextract(sim.state_new_cc_[0], sim.Geom(0), 0, 0.0);
 	const int nx = static_cast<int>(position.size());
 
 	// compare against diffusion solution
-	const int status = 0;
 	if (amrex::ParallelDescriptor::IOProcessor()) {
 		std::vector<double> xs(nx);
 		std::vector<double> Trad(nx);
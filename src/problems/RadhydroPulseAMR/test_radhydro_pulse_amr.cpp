@@ -0,0 +1,232 @@
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_radhydro_pulse_amr.cpp
+/// \brief Defines a test of energy conservation for radiation diffusion on an AMR hierarchy (including radiation.max_level).
+///
+/// A static radiation pulse (the same setup as RadhydroPulse) diffuses through the gas, with a refined level
+/// that covers the pulse. The total (gas + radiation) energy must be conserved to roundoff, whether radiation
+/// is solved on all levels or only up to radiation.max_level.
+
+#include <algorithm>
+
+#include "test_radhydro_pulse_amr.hpp"
+#include "AMReX_BC_TYPES.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Print.H"
+#include "QuokkaSimulation.hpp"
+#include "physics_info.hpp"
+
+struct PulseAMRProblem {
+}; // dummy type to allow compile-type polymorphism via template specialization
+
+constexpr double T0 = 1.0e7; // K (temperature)
+constexpr double T1 = 2.0e7; // K (temperature)
+constexpr double rho0 = 1.2; // g cm^-3 (matter density)
+constexpr double a_rad = C::a_rad;
+constexpr double c = C::c_light; // speed of light (cgs)
+constexpr double width = 24.0;	 // cm, width of the pulse
+constexpr double erad_floor = a_rad * T0 * T0 * T0 * T0 * 1.0e-10;
+constexpr double mu = 2.33 * C::m_u;
+constexpr double k_B = C::k_B;
+constexpr double kappa0 = 100.; // cm^2 g^-1
+
+template <> struct quokka::EOS_Traits<PulseAMRProblem> {
+	static constexpr double mean_molecular_weight = mu;
+	static constexpr double boltzmann_constant = k_B;
+	static constexpr double gamma = 5. / 3.;
+};
+
+template <> struct RadSystem_Traits<PulseAMRProblem> {
+	static constexpr double c_light = c;
+	static constexpr double c_hat = c;
+	static constexpr double radiation_constant = a_rad;
+	static constexpr double Erad_floor = erad_floor;
+	static constexpr int beta_order = 1;
+};
+
+template <> struct Physics_Traits<PulseAMRProblem> {
+	// cell-centred
+	static constexpr bool is_hydro_enabled = true;
+	static constexpr int numMassScalars = 0;		     // number of mass scalars
+	static constexpr int numPassiveScalars = numMassScalars + 0; // number of passive scalars
+	static constexpr bool is_radiation_enabled = true;
+	// face-centred
+	static constexpr bool is_mhd_enabled = false;
+	static constexpr int nGroups = 1;
+};
+
+AMREX_GPU_HOST_DEVICE
+auto compute_initial_Tgas(const double x) -> double
+{
+	// compute temperature profile for Gaussian radiation pulse
+	const double sigma = width;
+	return T0 + (T1 - T0) * std::exp(-x * x / (2.0 * sigma * sigma));
+}
+
+AMREX_GPU_HOST_DEVICE
+auto compute_exact_rho(const double x) -> double
+{
+	// compute density profile for Gaussian radiation pulse (in pressure equilibrium)
+	auto T = compute_initial_Tgas(x);
+	return rho0 * T0 / T + (a_rad * mu / 3. / k_B) * (std::pow(T0, 4) / T - std::pow(T, 3));
+}
+
+template <> AMREX_GPU_HOST_DEVICE auto RadSystem<PulseAMRProblem>::ComputePlanckOpacity(const double /*rho*/, const double /*Tgas*/) -> amrex::Real
+{
+	return kappa0;
+}
+
+template <> AMREX_GPU_HOST_DEVICE auto RadSystem<PulseAMRProblem>::ComputeFluxMeanOpacity(const double rho, const double Tgas) -> amrex::Real
+{
+	return ComputePlanckOpacity(rho, Tgas);
+}
+
+template <> void QuokkaSimulation<PulseAMRProblem>::setInitialConditionsOnGrid(quokka::grid const &grid_elem)
+{
+	// extract variables required from the geom object
+	amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const dx = grid_elem.dx_;
+	amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> prob_lo = grid_elem.prob_lo_;
+	amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> prob_hi = grid_elem.prob_hi_;
+	const amrex::Box &indexRange = grid_elem.indexRange_;
+	const amrex::Array4<double> &state_cc = grid_elem.array_;
+
+	amrex::Real const x0 = prob_lo[0] + 0.5 * (prob_hi[0] - prob_lo[0]);
+
+	// loop over the grid and set the initial condition
+	amrex::ParallelFor(indexRange, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+		amrex::Real const x = prob_lo[0] + (i + static_cast<amrex::Real>(0.5)) * dx[0];
+		const double Trad = compute_initial_Tgas(x - x0);
+		const double Erad = a_rad * std::pow(Trad, 4);
+		const double rho = compute_exact_rho(x - x0);
+		const double Egas = quokka::EOS<PulseAMRProblem>::ComputeEintFromTgas(rho, Trad);
+
+		state_cc(i, j, k, RadSystem<PulseAMRProblem>::radEnergy_index) = Erad;
+		state_cc(i, j, k, RadSystem<PulseAMRProblem>::x1RadFlux_index) = 0.;
+		state_cc(i, j, k, RadSystem<PulseAMRProblem>::x2RadFlux_index) = 0.;
+		state_cc(i, j, k, RadSystem<PulseAMRProblem>::x3RadFlux_index) = 0.;
+		state_cc(i, j, k, RadSystem<PulseAMRProblem>::gasEnergy_index) = Egas;
+		state_cc(i, j, k, RadSystem<PulseAMRProblem>::gasDensity_index) = rho;
+		state_cc(i, j, k, RadSystem<PulseAMRProblem>::gasInternalEnergy_index) = Egas;
+		state_cc(i, j, k, RadSystem<PulseAMRProblem>::x1GasMomentum_index) = 0.;
+		state_cc(i, j, k, RadSystem<PulseAMRProblem>::x2GasMomentum_index) = 0.;
+		state_cc(i, j, k, RadSystem<PulseAMRProblem>::x3GasMomentum_index) = 0.;
+	});
+}
+
+template <> void QuokkaSimulation<PulseAMRProblem>::ErrorEst(int lev, amrex::TagBoxArray &tags, amrex::Real /*time*/, int /*ngrow*/)
+{
+	// refine the pulse (where the radiation energy density exceeds the background by more than 10 per cent)
+	const amrex::Real Erad_threshold = 1.1 * a_rad * std::pow(T0, 4);
+
+	for (amrex::MFIter mfi(state_new_cc_[lev]); mfi.isValid(); ++mfi) {
+		const amrex::Box &box = mfi.validbox();
+		const auto state = state_new_cc_[lev].const_array(mfi);
+		const auto tag = tags.array(mfi);
+
+		amrex::ParallelFor(box, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+			if (state(i, j, k, RadSystem<PulseAMRProblem>::radEnergy_index) > Erad_threshold) {
+				tag(i, j, k) = amrex::TagBox::SET;
+			}
+		});
+	}
+}
+
+namespace
+{
+// total (gas + radiation) energy, computed from the base level (which holds the average of the finer levels)
+auto totalEnergy(QuokkaSimulation<PulseAMRProblem> const &sim) -> amrex::Real
+{
+	amrex::MultiFab const &state = sim.state_new_cc_[0];
+	const amrex::Real cellVolume = AMREX_D_TERM(sim.geom[0].CellSize(0), *sim.geom[0].CellSize(1), *sim.geom[0].CellSize(2));
+	return (state.sum(RadSystem<PulseAMRProblem>::gasEnergy_index) + state.sum(RadSystem<PulseAMRProblem>::radEnergy_index)) * cellVolume;
+}
+} // namespace
+
+auto problem_main() -> int
+{
+	// Problem parameters
+	const int64_t max_timesteps = 1e8;
+	const double CFL_number = 0.8;
+	const double max_dt = 1e-3;
+
+	// Boundary conditions
+	// (the pulse does not reach the boundaries, so the energy flux through them vanishes)
+	constexpr int nvars = RadSystem<PulseAMRProblem>::nvar_;
+	amrex::Vector<amrex::BCRec> BCs_cc(nvars);
+	for (int n = 0; n < nvars; ++n) {
+		BCs_cc[n].setLo(0, amrex::BCType::foextrap); // extrapolate
+		BCs_cc[n].setHi(0, amrex::BCType::foextrap);
+		for (int i = 1; i < AMREX_SPACEDIM; ++i) {
+			BCs_cc[n].setLo(i, amrex::BCType::int_dir); // periodic
+			BCs_cc[n].setHi(i, amrex::BCType::int_dir);
+		}
+	}
+
+	double max_time = 2.4e-5;
+	int compare_rad_max_level = 0;
+	amrex::ParmParse const pp;
+	pp.query("max_time", max_time);
+	pp.query("compare_rad_max_level", compare_rad_max_level);
+
+	// run the problem (with radiation.max_level = radMaxLevel, unless radMaxLevel < -1) and check energy conservation,
+	// returning the wall time of the evolution in 'elapsed'
+	auto runPulse = [&](int radMaxLevel, amrex::Real &elapsed) -> int {
+		// Problem initialization
+		QuokkaSimulation<PulseAMRProblem> sim(BCs_cc);
+
+		sim.radiationReconstructionOrder_ = 3; // PPM
+		sim.stopTime_ = max_time;
+		sim.radiationCflNumber_ = CFL_number;
+		sim.cflNumber_ = CFL_number;
+		sim.maxDt_ = max_dt;
+		sim.maxTimesteps_ = max_timesteps;
+		sim.plotfileInterval_ = -1;
+		if (radMaxLevel >= -1) {
+			sim.radiationMaxLevel_ = radMaxLevel;
+		}
+
+		// initialize
+		sim.setInitialConditions();
+		const amrex::Real E_initial = totalEnergy(sim);
+
+		// evolve
+		amrex::Real const start_time = amrex::ParallelDescriptor::second();
+		sim.evolve();
+		elapsed = amrex::ParallelDescriptor::second() - start_time;
+		amrex::ParallelDescriptor::ReduceRealMax(elapsed);
+		const amrex::Real E_final = totalEnergy(sim);
+
+		// the total energy must be conserved to roundoff
+		// (the refined level holds most of the energy exchanged between the gas and the radiation)
+		const amrex::Real rel_err = std::abs(E_final - E_initial) / E_initial;
+		const amrex::Real rel_tol = 1.0e-10;
+		amrex::Print() << "Total energy: initial = " << E_initial << ", final = " << E_final << ", relative change = " << rel_err << "\n";
+
+		int status = 0;
+		if (sim.finestLevel() < 1) {
+			amrex::Print() << "The pulse was not refined!\n";
+			status = 1;
+		}
+		if (!(rel_err < rel_tol)) {
+			status = 1;
+		}
+		return status;
+	};
+
+	amrex::Real elapsed = NAN;
+	if (compare_rad_max_level == 0) {
+		return runPulse(-2, elapsed);
+	}
+
+	// measure the time saved by solving the radiation only on the base level (radiation.max_level = 0)
+	amrex::Real elapsed_capped = NAN;
+	int status = runPulse(-1, elapsed);
+	status = std::max(status, runPulse(0, elapsed_capped));
+	amrex::Print() << "\nwall time of the evolution: radiation on all levels = " << elapsed << " s, radiation.max_level = 0: " << elapsed_capped
+		       << " s (speedup = " << elapsed / elapsed_capped << ")\n";
+	return status;
+}
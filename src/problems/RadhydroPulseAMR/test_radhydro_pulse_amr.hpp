@@ -0,0 +1,11 @@
+#ifndef TEST_RADHYDRO_PULSE_AMR_HPP_ // NOLINT
+#define TEST_RADHYDRO_PULSE_AMR_HPP_
+/// \file test_radhydro_pulse_amr.hpp
+/// \brief Defines a test of energy conservation for radiation diffusion on an AMR hierarchy (including radiation.max_level).
+///
+
+// internal headers
+
+#include "radiation/radiation_system.hpp"
+
+#endif // TEST_RADHYDRO_PULSE_AMR_HPP_
@@ -11,6 +11,7 @@
 
 #include "AMReX_BLassert.H"
 #include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
 #include "QuokkaSimulation.hpp"
 #include "hydro/hydro_system.hpp"
 #include "test_radhydro_shock.hpp"
@@ -210,6 +211,36 @@ template <> void QuokkaSimulation<ShockProblem>::setInitialConditionsOnGrid(quok
 	});
 }
 
+template <> void QuokkaSimulation<ShockProblem>::ErrorEst(int lev, amrex::TagBoxArray &tags, amrex::Real /*time*/, int /*ngrow*/)
+{
+	// tag cells across which the density jumps by more than eta_threshold (relative to the local density).
+	// the jump is measured between neighbouring cells in each direction separately, so the criterion does not
+	// depend on the cell aspect ratio, and it remains valid for anisotropic refinement ratios (amr.ref_ratio_vect).
+	const amrex::Real eta_threshold = 0.05;
+
+	for (amrex::MFIter mfi(state_new_cc_[lev]); mfi.isValid(); ++mfi) {
+		const amrex::Box &box = mfi.validbox();
+		const auto state = state_new_cc_[lev].const_array(mfi);
+		const auto tag = tags.array(mfi);
+		const int nidx = RadSystem<ShockProblem>::gasDensity_index;
+
+		amrex::ParallelFor(box, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+			amrex::Real const rho = state(i, j, k, nidx);
+			amrex::Real jump = 0.;
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				amrex::IntVect const e = amrex::IntVect::TheDimensionVector(idim);
+				amrex::Real const rho_p = state(i + e[0], j + e[1], k + e[2], nidx);
+				amrex::Real const rho_m = state(i - e[0], j - e[1], k - e[2], nidx);
+				jump = std::max(jump, 0.5 * std::abs(rho_p - rho_m));
+			}
+
+			if (jump > eta_threshold * rho) {
+				tag(i, j, k) = amrex::TagBox::SET;
+			}
+		});
+	}
+}
+
 auto problem_main() -> int
 {
 	// Problem parameters
@@ -258,6 +289,40 @@ auto problem_main() -> int
 	int nx = static_cast<int>(position.size());
 	int status = 0;
 
+	// with a refinement ratio that differs between directions (amr.ref_ratio_vect), check that the shock was refined
+	// with that ratio, and compare the number of cells on the refined levels to an isotropic refinement
+	// with the largest ratio in each direction
+	int check_anisotropic = 0;
+	amrex::ParmParse const pp;
+	pp.query("check_anisotropic", check_anisotropic);
+	if ((check_anisotropic == 1) && (sim.finestLevel() == 0)) {
+		amrex::Print() << "The shock was not refined!\n";
+		status = 1;
+	}
+	if (sim.finestLevel() > 0) {
+		amrex::Long cells = sim.boxArray(0).numPts();
+		amrex::Long cells_isotropic = cells;
+		for (int lev = 1; lev <= sim.finestLevel(); ++lev) {
+			amrex::IntVect const ratio = sim.refRatio(lev - 1);
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				if (sim.Geom(lev).Domain().length(idim) != ratio[idim] * sim.Geom(lev - 1).Domain().length(idim)) {
+					amrex::Print() << "The domain of level " << lev << " is not refined by the ratio " << ratio << "!\n";
+					status = 1;
+				}
+			}
+			const amrex::Long fine_cells = sim.boxArray(lev).numPts();
+			cells += fine_cells;
+			cells_isotropic += fine_cells * AMREX_D_TERM(ratio.max(), *ratio.max(), *ratio.max()) / ratio.product();
+			amrex::Print() << "level " << lev << ": refinement ratio " << ratio << ", " << fine_cells << " cells\n";
+		}
+		amrex::Print() << "Total cells: " << cells << " (isotropic refinement: " << cells_isotropic << ", ratio "
+			       << static_cast<double>(cells_isotropic) / static_cast<double>(cells) << ")\n";
+		if ((check_anisotropic == 1) && !(cells < cells_isotropic)) {
+			amrex::Print() << "Anisotropic refinement did not save cells!\n";
+			status = 1;
+		}
+	}
+
 	if (amrex::ParallelDescriptor::IOProcessor()) {
 		std::vector<double> xs(nx);
 		std::vector<double> Trad(nx);
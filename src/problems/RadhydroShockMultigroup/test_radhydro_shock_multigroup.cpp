@@ -6,6 +6,8 @@
 
 #include "AMReX_Array.H"
 #include "AMReX_BC_TYPES.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_ParmParse.H"
 
 #include "radiation/radiation_system.hpp"
 #include "test_radhydro_shock_multigroup.hpp"
@@ -250,10 +252,62 @@ auto problem_main() -> int
 	sim.stopTime_ = max_time;
 	sim.plotfileInterval_ = -1;
 
+	// compare to a run with the grey initial guess for the matter-radiation exchange, which must give the same solution
+	// (within the tolerance of the Newton-Raphson iteration) with fewer iterations
+	int compareGreyGuess = 0;
+	amrex::ParmParse const pp;
+	pp.query("compare_grey_guess", compareGreyGuess);
+	sim.countRadNewtonIterations_ = (compareGreyGuess == 1);
+
 	// run
 	sim.setInitialConditions();
 	sim.evolve();
 
+	int status_grey = 0;
+	if (compareGreyGuess == 1) {
+		AMREX_ALWAYS_ASSERT(sim.radiationGreyInitialGuess_ == 0);
+		QuokkaSimulation<ShockProblem> simGrey(BCs_cc);
+		simGrey.radiationReconstructionOrder_ = 3; // PPM
+		simGrey.reconstructionOrder_ = 3;	   // PPM
+		simGrey.cflNumber_ = CFL_number;
+		simGrey.radiationCflNumber_ = CFL_number;
+		simGrey.maxTimesteps_ = max_timesteps;
+		simGrey.stopTime_ = max_time;
+		simGrey.plotfileInterval_ = -1;
+		simGrey.radiationGreyInitialGuess_ = 1;
+		simGrey.countRadNewtonIterations_ = true;
+		simGrey.setInitialConditions();
+		simGrey.evolve();
+
+		amrex::Long iterations = sim.radNewtonIterations_;
+		amrex::Long iterations_grey = simGrey.radNewtonIterations_;
+		amrex::ParallelDescriptor::ReduceLongSum(iterations);
+		amrex::ParallelDescriptor::ReduceLongSum(iterations_grey);
+		amrex::Print() << "Newton-Raphson iterations: " << iterations << " (default), " << iterations_grey << " (grey initial guess)\n";
+		if (!(iterations_grey < iterations)) {
+			status_grey = 1;
+		}
+
+		// relative L1 difference of the gas energy and the radiation energy of each group
+		const double guess_tol = 1.0e-6;
+		amrex::MultiFab const &state = sim.state_new_cc_[0];
+		amrex::MultiFab const &stateGrey = simGrey.state_new_cc_[0];
+		std::vector<int> comps{RadSystem<ShockProblem>::gasEnergy_index};
+		for (int g = 0; g < Physics_Traits<ShockProblem>::nGroups; ++g) {
+			comps.push_back(RadSystem<ShockProblem>::radEnergy_index + Physics_NumVars::numRadVars * g);
+		}
+		for (const int n : comps) {
+			amrex::MultiFab diff(state.boxArray(), state.DistributionMap(), 1, 0);
+			amrex::MultiFab::Copy(diff, stateGrey, n, 0, 1, 0);
+			amrex::MultiFab::Subtract(diff, state, n, 0, 1, 0);
+			const double rel_diff = diff.norm1(0) / state.norm1(n);
+			amrex::Print() << "Relative L1 difference (grey initial guess vs. default) of component " << n << ": " << rel_diff << "\n";
+			if (!(rel_diff < guess_tol)) {
+				status_grey = 1;
+			}
+		}
+	}
+
 	// read output variables
 	auto [position, values] = fextract(sim.state_new_cc_[0], sim.Geom(0), 0, 0.0);
 	int const nx = static_cast<int>(position.size());
@@ -395,5 +449,8 @@ auto problem_main() -> int
 #endif
 	}
 
+	if (status_grey != 0) {
+		status = 1;
+	}
 	return status;
 }
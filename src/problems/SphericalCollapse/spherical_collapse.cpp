@@ -6,14 +6,18 @@
 /// \file spherical_collapse.cpp
 /// \brief Defines a test problem for pressureless spherical collapse.
 ///
+#include <cmath>
 #include <limits>
+#include <vector>
 
 #include "AMReX.H"
 #include "AMReX_BC_TYPES.H"
 #include "AMReX_BLassert.H"
 #include "AMReX_Config.H"
 #include "AMReX_FabArrayUtility.H"
+#include "AMReX_GpuContainers.H"
 #include "AMReX_MultiFab.H"
+#include "AMReX_ParReduce.H"
 #include "AMReX_ParallelDescriptor.H"
 #include "AMReX_ParmParse.H"
 #include "AMReX_Print.H"
@@ -47,6 +51,16 @@ template <> struct Physics_Traits<CollapseProblem> {
 	static constexpr int nGroups = 1; // number of radiation groups
 };
 
+constexpr double rho_min = 1.0e-5;
+constexpr double rho_max = 10.0;
+constexpr double R_sphere = 0.5;
+constexpr double R_smooth = 0.025;
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE auto initialDensity(amrex::Real r) -> amrex::Real
+{
+	return std::max(rho_min, rho_max * ((std::tanh((R_sphere - r) / R_smooth) + 1.0) / 2.0));
+}
+
 template <> void QuokkaSimulation<CollapseProblem>::setInitialConditionsOnGrid(quokka::grid const &grid_elem)
 {
 	// set initial conditions
@@ -66,11 +80,7 @@ template <> void QuokkaSimulation<CollapseProblem>::setInitialConditionsOnGrid(q
 		amrex::Real const z = prob_lo[2] + (k + static_cast<amrex::Real>(0.5)) * dx[2];
 		amrex::Real const r = std::sqrt(std::pow(x - x0, 2) + std::pow(y - y0, 2) + std::pow(z - z0, 2));
 
-		double rho_min = 1.0e-5;
-		double rho_max = 10.0;
-		double R_sphere = 0.5;
-		double R_smooth = 0.025;
-		double rho = std::max(rho_min, rho_max * ((std::tanh((R_sphere - r) / R_smooth) + 1.0) / 2.0));
+		double rho = initialDensity(r);
 		double P = 1.0e-1;
 
 		AMREX_ASSERT(!std::isnan(rho));
@@ -129,6 +139,64 @@ template <> void QuokkaSimulation<CollapseProblem>::ComputeDerivedVar(int lev, s
 	}
 }
 
+// returns the maximum error of the initial potential (on all levels), relative to the maximum of the analytic potential
+// of the spherical density profile (ignoring the density floor outside of the inscribed sphere of the domain, which
+// contributes a relative error of ~1e-5)
+auto computePotentialError(QuokkaSimulation<CollapseProblem> const &sim) -> amrex::Real
+{
+	// tabulate phi(r) = -G M(<r) / r - 4 pi G int_r^{r_out} rho(r') r' dr' with the trapezoidal rule
+	const amrex::Real G = sim.Gconst_;
+	const amrex::Real r_in = 0.5 * (sim.geom[0].ProbHi(0) - sim.geom[0].ProbLo(0));
+	const amrex::Real r_max = 1.01 * std::sqrt(3.0) * r_in;
+	const int nr = 20000;
+	const amrex::Real dr = r_max / nr;
+	auto rho_r = [=](amrex::Real r) { return (r <= r_in) ? initialDensity(r) : amrex::Real(0.); };
+
+	std::vector<amrex::Real> mass(nr + 1, 0.);
+	std::vector<amrex::Real> outer(nr + 1, 0.);
+	for (int n = 1; n <= nr; ++n) {
+		const amrex::Real r0 = (n - 1) * dr;
+		const amrex::Real r1 = n * dr;
+		mass[n] = mass[n - 1] + 2.0 * M_PI * (rho_r(r0) * r0 * r0 + rho_r(r1) * r1 * r1) * dr;
+	}
+	for (int n = nr - 1; n >= 0; --n) {
+		const amrex::Real r0 = n * dr;
+		const amrex::Real r1 = (n + 1) * dr;
+		outer[n] = outer[n + 1] + 0.5 * (rho_r(r0) * r0 + rho_r(r1) * r1) * dr;
+	}
+	amrex::Gpu::DeviceVector<amrex::Real> phi_exact_d(nr + 1);
+	std::vector<amrex::Real> phi_exact(nr + 1);
+	for (int n = 0; n <= nr; ++n) {
+		const amrex::Real r = n * dr;
+		phi_exact[n] = -4.0 * M_PI * G * outer[n] - ((n > 0) ? G * mass[n] / r : 0.);
+	}
+	amrex::Gpu::copy(amrex::Gpu::hostToDevice, phi_exact.begin(), phi_exact.end(), phi_exact_d.begin());
+	amrex::Real const *phi_exact_p = phi_exact_d.data();
+	const amrex::Real phi_scale = std::abs(phi_exact[0]);
+
+	amrex::Real max_err = 0.;
+	for (int lev = 0; lev <= sim.finestLevel(); ++lev) {
+		auto const &phi_arr = sim.phi[lev].const_arrays();
+		const auto dx = sim.geom[lev].CellSizeArray();
+		const auto prob_lo = sim.geom[lev].ProbLoArray();
+		const auto prob_hi = sim.geom[lev].ProbHiArray();
+		const amrex::Real lev_err = amrex::ParReduce(amrex::TypeList<amrex::ReduceOpMax>{}, amrex::TypeList<amrex::Real>{}, sim.phi[lev], amrex::IntVect(0),
+						       [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) noexcept -> amrex::GpuTuple<amrex::Real> {
+							       amrex::Real const x = prob_lo[0] + (i + 0.5) * dx[0] - 0.5 * (prob_lo[0] + prob_hi[0]);
+							       amrex::Real const y = prob_lo[1] + (j + 0.5) * dx[1] - 0.5 * (prob_lo[1] + prob_hi[1]);
+							       amrex::Real const z = prob_lo[2] + (k + 0.5) * dx[2] - 0.5 * (prob_lo[2] + prob_hi[2]);
+							       amrex::Real const s = std::sqrt(x * x + y * y + z * z) / dr;
+							       const int n = amrex::min(static_cast<int>(s), nr - 1);
+							       amrex::Real const w = s - n;
+							       amrex::Real const phi_a = (1.0 - w) * phi_exact_p[n] + w * phi_exact_p[n + 1]; // NOLINT
+							       return {std::abs(phi_arr[bx](i, j, k) - phi_a)};
+						       });
+		max_err = std::max(max_err, lev_err);
+	}
+	amrex::ParallelDescriptor::ReduceRealMax(max_err);
+	return max_err / phi_scale;
+}
+
 auto problem_main() -> int
 {
 	auto isNormalComp = [=](int n, int dim) {
@@ -162,12 +230,44 @@ auto problem_main() -> int
 	QuokkaSimulation<CollapseProblem> sim(BCs_cc);
 	sim.doPoissonSolve_ = 1; // enable self-gravity
 
+	// if positive, the initial potential must agree with the analytic potential to this relative tolerance
+	// (this requires do_cic_particles = 0, since the particles are placed at random positions)
+	amrex::Real max_potential_error = -1.0;
+	amrex::ParmParse const pp;
+	pp.query("max_potential_error", max_potential_error);
+
+	// if non-negative, the CIC particles (with particles.block_timesteps = 1) must use at least this many block levels
+	int min_block_level = -1;
+	pp.query("min_block_level", min_block_level);
+
 	// initialize
 	sim.setInitialConditions();
 
+	int status = 0;
+	if (max_potential_error > 0.) {
+		AMREX_ALWAYS_ASSERT_WITH_MESSAGE(sim.do_cic_particles == 0, "The analytic potential does not include the particles!");
+		const amrex::Real err = computePotentialError(sim);
+		amrex::Print() << "Relative error of the initial potential: " << err << " (tolerance " << max_potential_error << ")\n";
+		if (!(err < max_potential_error)) {
+			status = 1;
+		}
+	}
+
 	// evolve
 	sim.evolve();
 
-	int status = 0;
+	if (min_block_level >= 0) {
+		AMREX_ALWAYS_ASSERT_WITH_MESSAGE(sim.particleBlockTimesteps_ != 0, "min_block_level requires particles.block_timesteps = 1!");
+		const double speedup = (sim.particleSubstepsBlock_ > 0)
+					   ? static_cast<double>(sim.particleSubstepsGlobal_) / static_cast<double>(sim.particleSubstepsBlock_)
+					   : 1.0;
+		amrex::Print() << "Particle block timesteps: finest block level = " << sim.particleMaxRungReached_ << ", " << sim.particleSubstepsBlock_
+			       << " particle substeps (" << speedup << "x fewer than with a global particle timestep)\n";
+		if (sim.particleMaxRungReached_ < min_block_level) {
+			amrex::Print() << "The particles did not use block levels >= " << min_block_level << "!\n";
+			status = 1;
+		}
+	}
+
 	return status;
 }
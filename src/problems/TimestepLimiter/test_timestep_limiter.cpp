@@ -0,0 +1,155 @@
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_timestep_limiter.cpp
+/// \brief Defines a test of the reported timestep constraint (timestep_diagnostics).
+///
+/// A static uniform gas contains a single hot cell, which has the maximum signal speed (its sound speed).
+/// The problem is run for one or two steps with each of the timestep constraints (signal speed, max_dt,
+/// init_dt, and stop_time) made the tightest one in turn, and the reported constraint, the timestep,
+/// and (for the signal speed) the location of the limiting cell must match.
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+
+#include "AMReX_BC_TYPES.H"
+#include "AMReX_IntVect.H"
+#include "AMReX_Print.H"
+#include "AMReX_REAL.H"
+
+#include "QuokkaSimulation.hpp"
+#include "test_timestep_limiter.hpp"
+
+struct LimiterProblem {
+};
+
+template <> struct quokka::EOS_Traits<LimiterProblem> {
+	static constexpr double gamma = 5. / 3.;
+	static constexpr double mean_molecular_weight = C::m_u;
+	static constexpr double boltzmann_constant = C::k_B;
+};
+
+template <> struct Physics_Traits<LimiterProblem> {
+	// cell-centred
+	static constexpr bool is_hydro_enabled = true;
+	static constexpr int numMassScalars = 0;		     // number of mass scalars
+	static constexpr int numPassiveScalars = numMassScalars + 0; // number of passive scalars
+	static constexpr bool is_radiation_enabled = false;
+	// face-centred
+	static constexpr bool is_mhd_enabled = false;
+	static constexpr int nGroups = 1; // number of radiation groups
+};
+
+constexpr double rho0 = 1.0;	// background density
+constexpr double P0 = 1.0;	// background pressure
+constexpr double P_hot = 100.0; // pressure of the hot cell
+
+// the hot cell (inside the domain of tests/timestep_limiter.in)
+const amrex::IntVect hotCell(AMREX_D_DECL(20, 4, 4));
+
+template <> void QuokkaSimulation<LimiterProblem>::setInitialConditionsOnGrid(quokka::grid const &grid_elem)
+{
+	const amrex::Box &indexRange = grid_elem.indexRange_;
+	const amrex::Array4<double> &state_cc = grid_elem.array_;
+	const amrex::IntVect hot = hotCell;
+	const double gamma = quokka::EOS_Traits<LimiterProblem>::gamma;
+
+	amrex::ParallelFor(indexRange, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+		const double P = (amrex::IntVect(AMREX_D_DECL(i, j, k)) == hot) ? P_hot : P0;
+		for (int n = 0; n < state_cc.nComp(); ++n) {
+			state_cc(i, j, k, n) = 0.;
+		}
+		state_cc(i, j, k, HydroSystem<LimiterProblem>::density_index) = rho0;
+		state_cc(i, j, k, HydroSystem<LimiterProblem>::energy_index) = P / (gamma - 1.0);
+		state_cc(i, j, k, HydroSystem<LimiterProblem>::internalEnergy_index) = P / (gamma - 1.0);
+	});
+}
+
+auto problem_main() -> int
+{
+	const int ncomp_cc = Physics_Indices<LimiterProblem>::nvarTotal_cc;
+	amrex::Vector<amrex::BCRec> BCs_cc(ncomp_cc);
+	for (int n = 0; n < ncomp_cc; ++n) {
+		for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+			BCs_cc[n].setLo(i, amrex::BCType::int_dir); // periodic
+			BCs_cc[n].setHi(i, amrex::BCType::int_dir);
+		}
+	}
+
+	const double cflNumber = 0.3;
+	const double gamma = quokka::EOS_Traits<LimiterProblem>::gamma;
+	const double cs_hot = std::sqrt(gamma * P_hot / rho0);
+
+	// run the problem with the constraints set by 'configure', and check the reported constraint and timestep
+	// (after 'nsteps' steps, the reported values are those of the last step)
+	auto runCase = [&](std::string const &name, int nsteps, std::function<void(QuokkaSimulation<LimiterProblem> &, double)> const &configure,
+			   TimestepLimiter expectedLimiter, std::function<double(QuokkaSimulation<LimiterProblem> const &, double)> const &expectedDt) -> int {
+		QuokkaSimulation<LimiterProblem> sim(BCs_cc);
+		sim.cflNumber_ = cflNumber;
+		sim.stopTime_ = 1.0;
+		sim.maxTimesteps_ = nsteps;
+		sim.plotfileInterval_ = -1;
+		sim.checkpointInterval_ = -1;
+		sim.timestepDiagnostics_ = 1;
+
+		// the CFL timestep of the initial state
+		const amrex::Real dx_min = std::min({AMREX_D_DECL(sim.Geom(0).CellSize(0), sim.Geom(0).CellSize(1), sim.Geom(0).CellSize(2))});
+		const double dt_cfl = cflNumber * dx_min / cs_hot;
+		configure(sim, dt_cfl);
+
+		sim.setInitialConditions();
+		sim.evolve();
+
+		const double dt_expected = expectedDt(sim, dt_cfl);
+		const double dt_err = std::abs(sim.dt_[0] - dt_expected) / dt_expected;
+		amrex::Print() << "[" << name << "] dt = " << sim.dt_[0] << " (expected " << dt_expected << "), limited by "
+			       << timestepLimiterName(sim.dtLimiter_) << " (expected " << timestepLimiterName(expectedLimiter) << ")\n";
+
+		int status = 0;
+		if (sim.dtLimiter_ != expectedLimiter) {
+			status = 1;
+		}
+		if (!(dt_err < 1.0e-12)) {
+			status = 1;
+		}
+		if (expectedLimiter == TimestepLimiter::signal_speed) {
+			// the limiting cell is the hot cell, with the sound speed of the hot gas
+			auto const &info = sim.dtLimiters_[0];
+			const double speed_err = std::abs(info.maxSignalSpeed - cs_hot) / cs_hot;
+			amrex::Print() << "[" << name << "] max signal speed = " << info.maxSignalSpeed << " (expected " << cs_hot << ") in cell " << info.cell
+				       << " (expected " << hotCell << ")\n";
+			if ((info.cell != hotCell) || !(speed_err < 1.0e-12)) {
+				status = 1;
+			}
+		}
+		return status;
+	};
+
+	int status = 0;
+
+	// the signal speed of the hot cell limits the first step
+	status |= runCase(
+	    "signal_speed", 1, [](QuokkaSimulation<LimiterProblem> & /*sim*/, double /*dt_cfl*/) {}, TimestepLimiter::signal_speed,
+	    [](QuokkaSimulation<LimiterProblem> const & /*sim*/, double dt_cfl) { return dt_cfl; });
+
+	// max_dt limits every step
+	status |= runCase(
+	    "max_dt", 2, [](QuokkaSimulation<LimiterProblem> &sim, double dt_cfl) { sim.maxDt_ = 0.1 * dt_cfl; }, TimestepLimiter::max_dt,
+	    [](QuokkaSimulation<LimiterProblem> const & /*sim*/, double dt_cfl) { return 0.1 * dt_cfl; });
+
+	// init_dt limits the first step
+	status |= runCase(
+	    "init_dt", 1, [](QuokkaSimulation<LimiterProblem> &sim, double dt_cfl) { sim.initDt_ = 0.1 * dt_cfl; }, TimestepLimiter::init_dt,
+	    [](QuokkaSimulation<LimiterProblem> const & /*sim*/, double dt_cfl) { return 0.1 * dt_cfl; });
+
+	// the stop time limits the first step, which ends exactly at the stop time
+	status |= runCase(
+	    "stop_time", 2, [](QuokkaSimulation<LimiterProblem> &sim, double dt_cfl) { sim.stopTime_ = 0.5 * dt_cfl; }, TimestepLimiter::stop_time,
+	    [](QuokkaSimulation<LimiterProblem> const &sim, double /*dt_cfl*/) { return sim.stopTime_; });
+
+	return status;
+}
@@ -0,0 +1,15 @@
+#ifndef TEST_TIMESTEP_LIMITER_HPP_ // NOLINT
+#define TEST_TIMESTEP_LIMITER_HPP_
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file test_timestep_limiter.hpp
+/// \brief Defines a test of the reported timestep constraint (timestep_diagnostics).
+///
+
+// internal headers
+#include "hydro/hydro_system.hpp"
+
+#endif // TEST_TIMESTEP_LIMITER_HPP_
@@ -256,7 +256,7 @@ template <typename problem_t> class RadSystem : public HyperbolicSystem<problem_
 						double gas_update_factor, double Ekin0) -> FluxUpdateResult<problem_t>;
 
 	static void AddSourceTermsMultiGroup(array_t &consVar, arrayconst_t &radEnergySource, amrex::Box const &indexRange, amrex::Real dt, int stage,
-					     double dustGasCoeff, int *p_iteration_counter, int *p_iteration_failure_counter);
+					     double dustGasCoeff, int *p_iteration_counter, int *p_iteration_failure_counter, bool greyInitialGuess = false);
 
 	static void AddSourceTermsSingleGroup(array_t &consVar, arrayconst_t &radEnergySource, amrex::Box const &indexRange, amrex::Real dt, int stage,
 					      double dustGasCoeff, int *p_iteration_counter, int *p_iteration_failure_counter);
@@ -377,12 +377,20 @@ template <typename problem_t> class RadSystem : public HyperbolicSystem<problem_
 	    quokka::valarray<double, nGroups_> const &Src, double coeff_n, quokka::valarray<double, nGroups_> const &tau, double c_v, double lambda_gd_time_dt,
 	    quokka::valarray<double, nGroups_> const &kappaPoverE, quokka::valarray<double, nGroups_> const &d_fourpiboverc_d_t) -> JacobianResult<problem_t>;
 
+	AMREX_GPU_DEVICE static void ComputeGreyInitialGuess(double Egas0, quokka::valarray<double, nGroups_> const &Erad0Vec, double rho,
+							     amrex::GpuArray<Real, nmscalars_> const &massScalars,
+							     quokka::valarray<double, nGroups_> const &tauP,
+							     quokka::valarray<double, nGroups_> const &kappaPoverE,
+							     quokka::valarray<double, nGroups_> const &work, quokka::valarray<double, nGroups_> const &Src,
+							     amrex::GpuArray<double, nGroups_ + 1> const &rad_boundaries, double &Egas_guess,
+							     quokka::valarray<double, nGroups_> &EradVec_guess);
+
 	AMREX_GPU_DEVICE static auto
 	SolveGasRadiationEnergyExchange(double Egas0, quokka::valarray<double, nGroups_> const &Erad0Vec, double rho, double dt,
 					amrex::GpuArray<Real, nmscalars_> const &massScalars, int n_outer_iter, quokka::valarray<double, nGroups_> const &work,
 					quokka::valarray<double, nGroups_> const &vel_times_F, quokka::valarray<double, nGroups_> const &Src,
-					amrex::GpuArray<double, nGroups_ + 1> const &rad_boundaries, int *p_iteration_counter, int *p_iteration_failure_counter)
-	    -> NewtonIterationResult<problem_t>;
+					amrex::GpuArray<double, nGroups_ + 1> const &rad_boundaries, int *p_iteration_counter, int *p_iteration_failure_counter,
+					bool greyInitialGuess = false) -> NewtonIterationResult<problem_t>;
 
 	AMREX_GPU_DEVICE static auto SolveGasDustRadiationEnergyExchange(double Egas0, quokka::valarray<double, nGroups_> const &Erad0Vec, double rho,
 									 double coeff_n, double dt, amrex::GpuArray<Real, nmscalars_> const &massScalars,
@@ -143,12 +143,112 @@ AMREX_GPU_DEVICE auto RadSystem<problem_t>::ComputeJacobianForGas(double /*T_d*/
 	return result;
 }
 
+// Grey acceleration of the multigroup energy exchange: compute an initial guess for the Newton-Raphson iteration by first solving the
+// frequency-integrated (grey) energy exchange for the gas temperature, then distributing the radiation energy across the groups
+// according to the Planck fractions at that temperature. With group opacities fixed at the old temperature, the grey equations are
+//
+//   Egas - Egas0 + c / chat * (Erad - Erad0 - Src) = 0,
+//   Erad (1 + tau_E) = Erad0 + Src + work + sum_g tau_{P,g} 4 pi B_g(T) / c,
+//
+// where tau_{P,g} = dt chat rho kappa_{P,g} and tau_E is the energy-mean (weighted by Erad0) of tau_{P,g} kappa_{E,g} / kappa_{P,g}.
+// (The emission term is the Planck-mean opacity times a_r T^4.) This is a scalar equation for Egas, which is solved with Newton's
+// method. Only the groups with tau_{P,g} > 0 exchange energy with the gas. This does not affect the converged solution.
+template <typename problem_t>
+AMREX_GPU_DEVICE void RadSystem<problem_t>::ComputeGreyInitialGuess(double const Egas0, quokka::valarray<double, nGroups_> const &Erad0Vec, double const rho,
+								    amrex::GpuArray<Real, nmscalars_> const &massScalars,
+								    quokka::valarray<double, nGroups_> const &tauP,
+								    quokka::valarray<double, nGroups_> const &kappaPoverE,
+								    quokka::valarray<double, nGroups_> const &work,
+								    quokka::valarray<double, nGroups_> const &Src,
+								    amrex::GpuArray<double, nGroups_ + 1> const &rad_boundaries, double &Egas_guess,
+								    quokka::valarray<double, nGroups_> &EradVec_guess)
+{
+	const double cscale = c_light_ / c_hat_;
+
+	// frequency-integrated quantities of the groups that exchange energy with the gas
+	double Erad0_sum = 0.;	 // Erad0
+	double Erad_src = 0.;	 // Erad0 + Src
+	double Erad_rhs = 0.;	 // Erad0 + Src + work
+	double tauE_weight = 0.; // sum_g tau_{E,g} Erad0_g
+	for (int g = 0; g < nGroups_; ++g) {
+		if (tauP[g] > 0.0) {
+			Erad0_sum += Erad0Vec[g];
+			Erad_src += Erad0Vec[g] + Src[g];
+			Erad_rhs += Erad0Vec[g] + Src[g] + work[g];
+			tauE_weight += tauP[g] / kappaPoverE[g] * Erad0Vec[g];
+		}
+	}
+	if (!(Erad0_sum > 0.)) {
+		return;
+	}
+	const double tauE = tauE_weight / Erad0_sum;
+
+	const double grey_tol = 1.0e-10;
+	const int maxGreyIter = 30;
+	double Egas = Egas0;
+	double Erad = NAN;
+	quokka::valarray<double, nGroups_> fourPiBoverC{};
+	bool converged = false;
+	for (int m = 0; m < maxGreyIter; ++m) {
+		const double T = quokka::EOS<problem_t>::ComputeTgasFromEint(rho, Egas, massScalars);
+		fourPiBoverC = ComputeThermalRadiationMultiGroup(T, rad_boundaries);
+		const auto d_fourpiboverc_d_t = ComputeThermalRadiationTempDerivativeMultiGroup(T, rad_boundaries);
+		const double c_v = quokka::EOS<problem_t>::ComputeEintTempDerivative(rho, T, massScalars);
+
+		double emission = 0.;
+		double d_emission_d_T = 0.;
+		for (int g = 0; g < nGroups_; ++g) {
+			if (tauP[g] > 0.0) {
+				emission += tauP[g] * fourPiBoverC[g];
+				d_emission_d_T += tauP[g] * d_fourpiboverc_d_t[g];
+			}
+		}
+		Erad = (Erad_rhs + emission) / (1.0 + tauE);
+
+		const double F = Egas - Egas0 + cscale * (Erad - Erad_src);
+		const double dF_dEgas = 1.0 + cscale * d_emission_d_T / (c_v * (1.0 + tauE));
+		const double delta = -F / dF_dEgas;
+		if (std::isnan(delta)) {
+			break;
+		}
+		// the residual is monotonic in Egas, so it is sufficient to prevent Egas from becoming negative
+		Egas = std::max(Egas + delta, 0.5 * Egas);
+		if (std::abs(delta) < grey_tol * Egas) {
+			converged = true;
+			break;
+		}
+	}
+	if (!converged) {
+		return; // use the old state as the initial guess
+	}
+
+	// distribute the grey radiation energy across the groups according to the Planck fractions
+	const double T = quokka::EOS<problem_t>::ComputeTgasFromEint(rho, Egas, massScalars);
+	fourPiBoverC = ComputeThermalRadiationMultiGroup(T, rad_boundaries);
+	double fourPiBoverC_sum = 0.;
+	for (int g = 0; g < nGroups_; ++g) {
+		if (tauP[g] > 0.0) {
+			fourPiBoverC_sum += fourPiBoverC[g];
+		}
+	}
+	if (!(fourPiBoverC_sum > 0.)) {
+		return;
+	}
+	Egas_guess = Egas;
+	for (int g = 0; g < nGroups_; ++g) {
+		if (tauP[g] > 0.0) {
+			EradVec_guess[g] = std::max(Erad * fourPiBoverC[g] / fourPiBoverC_sum, Erad_floor_);
+		}
+	}
+}
+
 template <typename problem_t>
 AMREX_GPU_DEVICE auto RadSystem<problem_t>::SolveGasRadiationEnergyExchange(
     double const Egas0, quokka::valarray<double, nGroups_> const &Erad0Vec, double const rho, double const dt,
     amrex::GpuArray<Real, nmscalars_> const &massScalars, int const n_outer_iter, quokka::valarray<double, nGroups_> const &work,
     quokka::valarray<double, nGroups_> const &vel_times_F, quokka::valarray<double, nGroups_> const &Src,
-    amrex::GpuArray<double, nGroups_ + 1> const &rad_boundaries, int *p_iteration_counter, int *p_iteration_failure_counter) -> NewtonIterationResult<problem_t>
+    amrex::GpuArray<double, nGroups_ + 1> const &rad_boundaries, int *p_iteration_counter, int *p_iteration_failure_counter, bool const greyInitialGuess)
+    -> NewtonIterationResult<problem_t>
 {
 	// 1. Compute energy exchange
 
@@ -220,9 +320,51 @@ AMREX_GPU_DEVICE auto RadSystem<problem_t>::SolveGasRadiationEnergyExchange(
 		}
 	}
 
+	// compute the work term at the old state (this is done in the first Newton-Raphson iteration, or before the grey solve)
+	auto computeWorkTerm = [&](double T_old, OpacityTerms<problem_t> const &opacity_terms_old) {
+		amrex::ignore_unused(T_old);
+		quokka::valarray<double, nGroups_> work_old{};
+		if constexpr ((beta_order_ == 1) && (include_work_term_in_source)) {
+			// const double gamma = 1.0 / sqrt(1.0 - vsqr / (c * c));
+			if (n_outer_iter == 0) {
+				for (int g = 0; g < nGroups_; ++g) {
+					if constexpr (opacity_model_ == OpacityModel::piecewise_constant_opacity) {
+						work_old[g] = vel_times_F[g] * opacity_terms_old.kappaF[g] * chat / (c * c) * dt;
+					} else {
+						kappa_expo_and_lower_value = DefineOpacityExponentsAndLowerValues(rad_boundaries, rho, T_old);
+						work_old[g] = vel_times_F[g] * opacity_terms_old.kappaF[g] * chat / (c * c) * dt *
+							      (1.0 + kappa_expo_and_lower_value[0][g]);
+					}
+				}
+			} else {
+				// If n_outer_iter > 0, use the work term from the previous outer iteration, which is passed as the parameter 'work'
+				work_old = work;
+			}
+		} else {
+			work_old.fillin(0.0);
+		}
+		return work_old;
+	};
+
 	double Egas_guess = Egas0;
 	auto EradVec_guess = Erad0Vec;
 
+	// optionally, start the Newton-Raphson iteration from the solution of the grey energy exchange
+	bool work_is_computed = false;
+	if (greyInitialGuess) {
+		const double T_old = quokka::EOS<problem_t>::ComputeTgasFromEint(rho, Egas0, massScalars);
+		const auto fourPiBoverC_old = ComputeThermalRadiationMultiGroup(T_old, rad_boundaries);
+		auto opacity_terms_old = ComputeModelDependentKappaEAndKappaP(T_old, rho, rad_boundaries, rad_boundary_ratios, fourPiBoverC_old, Erad0Vec, 0,
+									      opacity_terms.alpha_E, opacity_terms.alpha_P);
+		ComputeModelDependentKappaFAndDeltaTerms(T_old, rho, rad_boundaries, fourPiBoverC_old, opacity_terms_old);
+		work_local = computeWorkTerm(T_old, opacity_terms_old);
+		work_is_computed = true;
+
+		const auto tauP = dt * rho * opacity_terms_old.kappaP * chat;
+		ComputeGreyInitialGuess(Egas0, Erad0Vec, rho, massScalars, tauP, opacity_terms_old.kappaPoverE, work_local, Src, rad_boundaries, Egas_guess,
+					EradVec_guess);
+	}
+
 	const double resid_tol = 1.0e-11; // 1.0e-15;
 	const int maxIter = 100;
 	int n = 0;
@@ -251,25 +393,8 @@ AMREX_GPU_DEVICE auto RadSystem<problem_t>::SolveGasRadiationEnergyExchange(
 
 		if (n == 0) {
 
-			if constexpr ((beta_order_ == 1) && (include_work_term_in_source)) {
-				// compute the work term at the old state
-				// const double gamma = 1.0 / sqrt(1.0 - vsqr / (c * c));
-				if (n_outer_iter == 0) {
-					for (int g = 0; g < nGroups_; ++g) {
-						if constexpr (opacity_model_ == OpacityModel::piecewise_constant_opacity) {
-							work_local[g] = vel_times_F[g] * opacity_terms.kappaF[g] * chat / (c * c) * dt;
-						} else {
-							kappa_expo_and_lower_value = DefineOpacityExponentsAndLowerValues(rad_boundaries, rho, T_d);
-							work_local[g] = vel_times_F[g] * opacity_terms.kappaF[g] * chat / (c * c) * dt *
-									(1.0 + kappa_expo_and_lower_value[0][g]);
-						}
-					}
-				} else {
-					// If n_outer_iter > 0, use the work term from the previous outer iteration, which is passed as the parameter 'work'
-					work_local = work;
-				}
-			} else {
-				work_local.fillin(0.0);
+			if (!work_is_computed) {
+				work_local = computeWorkTerm(T_d, opacity_terms);
 			}
 
 			tau0 = dt * rho * opacity_terms.kappaP * chat;
@@ -565,7 +690,8 @@ AMREX_GPU_DEVICE auto RadSystem<problem_t>::UpdateFlux(int const i, int const j,
 
 template <typename problem_t>
 void RadSystem<problem_t>::AddSourceTermsMultiGroup(array_t &consVar, arrayconst_t &radEnergySource, amrex::Box const &indexRange, amrex::Real dt_radiation,
-						    const int stage, double dustGasCoeff, int *p_iteration_counter, int *p_iteration_failure_counter)
+						    const int stage, double dustGasCoeff, int *p_iteration_counter, int *p_iteration_failure_counter,
+						    bool greyInitialGuess)
 {
 	static_assert(beta_order_ == 0 || beta_order_ == 1);
 
@@ -702,7 +828,8 @@ void RadSystem<problem_t>::AddSourceTermsMultiGroup(array_t &consVar, arrayconst
 					// gas + radiation
 					updated_energy =
 					    SolveGasRadiationEnergyExchange(Egas0, Erad0Vec, rho, dt, massScalars, iter, work, vel_times_F, Src,
-									    radBoundaries_g_copy, p_iteration_counter_local, p_iteration_failure_counter_local);
+									    radBoundaries_g_copy, p_iteration_counter_local, p_iteration_failure_counter_local,
+									    greyInitialGuess);
 				} else {
 					if constexpr (!enable_photoelectric_heating_) {
 						// gas + radiation + dust
@@ -10,6 +10,7 @@
 /// timestepping, solving, and I/O of a simulation.
 
 // c++ headers
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
@@ -25,11 +26,16 @@ namespace filesystem = experimental::filesystem;
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <map>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <ostream>
 #include <stdexcept>
+#include <string>
+#include <utility>
 #include <variant>
 
 // library headers
@@ -73,7 +79,10 @@ namespace filesystem = experimental::filesystem;
 #endif
 
 #if AMREX_SPACEDIM == 3
+#include "AMReX_MLMG.H"
+#include "AMReX_MLPoisson.H"
 #include "AMReX_OpenBC.H"
+#include "util/MultipoleExpansion.hpp"
 #endif
 
 #ifdef AMREX_USE_ASCENT
@@ -85,7 +94,11 @@ namespace filesystem = experimental::filesystem;
 #include "fundamental_constants.H"
 #include "grid.hpp"
 #include "io/DiagBase.H"
+#include "io/ImageRenderer.H"
+#include "io/SurfaceFluxes.H"
 #include "physics_info.hpp"
+#include "util/CoordGeometry.hpp"
+#include "util/MFCellConsQuarticInterp.hpp"
 
 #ifdef QUOKKA_USE_OPENPMD
 #include "io/openPMD.hpp"
@@ -137,6 +150,38 @@ template <> struct as_if<std::string, std::optional<std::string>> {
 
 enum class FillPatchType { fillpatch_class, fillpatch_function };
 
+// the constraint that determined the timestep
+enum class TimestepLimiter { signal_speed = 0, extra_physics, growth_limit, max_dt, init_dt, constant_dt, stop_time };
+
+inline auto timestepLimiterName(TimestepLimiter limiter) -> std::string
+{
+	switch (limiter) {
+		case TimestepLimiter::signal_speed:
+			return "signal_speed";
+		case TimestepLimiter::extra_physics:
+			return "extra_physics";
+		case TimestepLimiter::growth_limit:
+			return "growth_limit";
+		case TimestepLimiter::max_dt:
+			return "max_dt";
+		case TimestepLimiter::init_dt:
+			return "init_dt";
+		case TimestepLimiter::constant_dt:
+			return "constant_dt";
+		case TimestepLimiter::stop_time:
+			return "stop_time";
+	}
+	return "unknown";
+}
+
+// records which constraint determined the candidate timestep on a level
+struct TimestepLimiterInfo {
+	TimestepLimiter limiter = TimestepLimiter::signal_speed;
+	amrex::Real dt = 0.;			    // candidate timestep on this level
+	amrex::Real maxSignalSpeed = 0.;	    // maximum signal speed on this level
+	amrex::IntVect cell{AMREX_D_DECL(0, 0, 0)}; // cell with the maximum signal speed (only computed if timestep_diagnostics == 1)
+};
+
 // Main simulation class; solvers should inherit from this
 template <typename problem_t> class AMRSimulation : public amrex::AmrCore
 {
@@ -163,10 +208,26 @@ template <typename problem_t> class AMRSimulation : public amrex::AmrCore
 	amrex::Real plotTimeInterval_ = -1.0;	    // time interval for plt file
 	amrex::Real checkpointTimeInterval_ = -1.0; // time interval for checkpoints
 	int checkpointInterval_ = -1;		    // -1 == no output
-	int amrInterpMethod_ = 1;		    // 0 == piecewise constant, 1 == lincc_interp
+	int amrInterpMethod_ = 1;		    // 0 == piecewise constant, 1 == lincc_interp, 2 == limited quartic
+	int timestepDiagnostics_ = 0;		    // 1 == report the location and state of the dt-limiting cells
+	int dmapLocality_ = 0;			    // 1 == assign fine boxes to the ranks that own the underlying coarse boxes
+	amrex::Real dmapMaxImbalance_ = 0.1;	    // maximum fractional load imbalance allowed by the locality-preserving distribution map
+
+	// adaptive CFL controller parameters
+	int adaptiveCfl_ = 0;			       // 1 == adapt the CFL number based on the retry history
+	amrex::Real adaptiveCflMin_ = -1.0;	       // minimum CFL number (default: 0.5 * cfl)
+	amrex::Real adaptiveCflMax_ = -1.0;	       // maximum CFL number (default: cfl)
+	amrex::Real adaptiveCflIncrease_ = 1.05;       // factor by which the CFL number is raised after a streak without retries
+	amrex::Real adaptiveCflDecrease_ = 0.7;	       // factor by which the CFL number is lowered after retries or an FOFC surge
+	int adaptiveCflStreak_ = 100;		       // number of coarse steps without retries before the CFL number is raised
+	int adaptiveCflCooldown_ = 200;		       // number of coarse steps after a retry during which the CFL number is not raised
+	amrex::Real adaptiveCflFofcFraction_ = 1.0e-3; // fraction of first-order flux corrected cells (per coarse step) that counts as a surge
 	amrex::Real reltolPoisson_ = 1.0e-5;	    // default
 	amrex::Real abstolPoisson_ = 1.0e-5;	    // default (scaled by minimum RHS value)
 	int doPoissonSolve_ = 0;		    // 1 == self-gravity enabled, 0 == disabled
+	std::string poissonSolver_ = "openbc";	    // open boundary conditions: "openbc" (James 1977) or "multipole"
+	int multipoleOrder_ = 8;		    // maximum multipole order l used for the boundary values
+	int comparePoissonSolvers_ = 0;		    // 1 == also run the other solver and print the difference and timings
 	amrex::Vector<amrex::MultiFab> phi;
 
 	amrex::Real densityFloor_ = 0.0; // default
@@ -213,6 +274,12 @@ template <typename problem_t> class AMRSimulation : public amrex::AmrCore
 	void evolve();
 	void computeTimestep();
 	auto computeTimestepAtLevel(int lev) -> amrex::Real;
+	void reportTimestepLimiter();
+	auto getCellState(int lev, amrex::IntVect const &cell) const -> amrex::Vector<amrex::Real>;
+	void updateCflController();
+	void restoreCflController();
+	void recordHydroRetry(int lev);
+	void recordFofcCells(int lev, amrex::Long ncells);
 
 	void AverageFCToCC(amrex::MultiFab &mf_cc, const amrex::MultiFab &mf_fc, int idim, int dstcomp_start, int srccomp_start, int srccomp_total,
 			   int nGrow) const;
@@ -259,6 +326,10 @@ template <typename problem_t> class AMRSimulation : public amrex::AmrCore
 	// DistributionMapping
 	void MakeNewLevelFromScratch(int lev, amrex::Real time, const amrex::BoxArray &ba, const amrex::DistributionMapping &dm) override;
 
+	// Make the DistributionMapping for a new BoxArray (used by the functions above)
+	auto MakeDistributionMap(int lev, amrex::BoxArray const &ba) -> amrex::DistributionMapping override;
+	[[nodiscard]] auto offRankCoarseFraction(int lev, amrex::BoxArray const &ba, amrex::DistributionMapping const &dm) const -> amrex::Real;
+
 	// AMR utility functions
 	template <typename PreInterpHook, typename PostInterpHook>
 	void fillBoundaryConditions(amrex::MultiFab &S_filled, amrex::MultiFab &state, int lev, amrex::Real time, quokka::centering cen, quokka::direction dir,
@@ -281,9 +352,11 @@ template <typename problem_t> class AMRSimulation : public amrex::AmrCore
 	void GetData(int lev, amrex::Real time, amrex::Vector<amrex::MultiFab *> &data, amrex::Vector<amrex::Real> &datatime, quokka::centering cen,
 		     quokka::direction dir);
 	void AverageDown();
-	void AverageDownTo(int crse_lev);
+	virtual void AverageDownTo(int crse_lev);
 	void timeStepWithSubcycling(int lev, amrex::Real time, int iteration);
 	void calculateGpotAllLevels();
+	void solvePoissonOpenBC(amrex::Vector<amrex::MultiFab> &phi_mf, amrex::Vector<amrex::MultiFab> const &rhs, amrex::Real abstol);
+	void solvePoissonMultipole(amrex::Vector<amrex::MultiFab> &phi_mf, amrex::Vector<amrex::MultiFab> const &rhs, amrex::Real abstol);
 	void gravAccelAllLevels(amrex::Real dt);
 	void ellipticSolveAllLevels(amrex::Real dt);
 
@@ -293,6 +366,11 @@ template <typename problem_t> class AMRSimulation : public amrex::AmrCore
 	void incrementFluxRegisters(amrex::YAFluxRegister *fr_as_crse, amrex::YAFluxRegister *fr_as_fine,
 				    std::array<amrex::MultiFab, AMREX_SPACEDIM> &fluxArrays, int lev, amrex::Real dt_lev);
 
+	auto fluxRegisterGeom(int lev) const -> amrex::Geometry;
+	auto surfaceFluxFineGrids(int lev) const -> amrex::BoxArray;
+	auto subcycleRatio(int lev) const -> int;
+	void refluxLevel(int lev);
+
 	// boundary condition
 	AMREX_GPU_DEVICE static void setCustomBoundaryConditions(const amrex::IntVect &iv, amrex::Array4<amrex::Real> const &dest, int dcomp, int numcomp,
 								 amrex::GeometryData const &geom, amrex::Real time, const amrex::BCRec *bcr, int bcomp,
@@ -321,8 +399,10 @@ template <typename problem_t> class AMRSimulation : public amrex::AmrCore
 	void WriteMetadataFile(std::string const &MetadataFileName) const;
 	void ReadMetadataFile(std::string const &chkfilename);
 	void WriteStatisticsFile();
+	void WriteTimestepLimiterFile(std::string const &filename) const;
 	void WritePlotFile();
 	void WriteProjectionPlotfile() const;
+	void WriteProjectionImages(std::unordered_map<std::string, amrex::BaseFab<amrex::Real>> const &proj, int dir, std::string const &dir_str) const;
 	void WriteCheckpointFile() const;
 	void SetLastCheckpointSymlink(std::string const &checkpointname) const;
 	void ReadCheckpointFile();
@@ -332,8 +412,11 @@ template <typename problem_t> class AMRSimulation : public amrex::AmrCore
 	[[nodiscard]] auto getNewMF_fc() const -> amrex::Vector<amrex::Array<amrex::MultiFab, AMREX_SPACEDIM>> const &;
 
 	// particle functions
+	void computeParticleAccelAllLevels(amrex::Vector<amrex::MultiFab> &accel);
 	void kickParticlesAllLevels(amrex::Real dt);
+	void kickParticlesAllLevels(amrex::Vector<amrex::MultiFab> const &accel, amrex::Real dt);
 	void driftParticlesAllLevels(amrex::Real dt);
+	void blockStepParticlesAllLevels(amrex::Vector<amrex::MultiFab> &accelOld, amrex::Real dt);
 
 #ifdef AMREX_USE_ASCENT
 	void AscentCustomActions(conduit::Node const &blueprintMesh);
@@ -348,6 +431,21 @@ template <typename problem_t> class AMRSimulation : public amrex::AmrCore
 	amrex::Vector<amrex::Array<amrex::MultiFab, AMREX_SPACEDIM>> state_new_fc_;
 	amrex::Vector<amrex::MultiFab> max_signal_speed_; // needed to compute CFL timestep
 
+	// constraints that determined the most recent timestep
+	amrex::Vector<TimestepLimiterInfo> dtLimiters_;		     // on each level
+	TimestepLimiter dtLimiter_ = TimestepLimiter::signal_speed; // for the coarse timestep
+	int dtLimitingLevel_ = 0;				     // level that determined the coarse timestep
+
+	// adaptive CFL controller state (saved in simulationMetadata_)
+	int cflStepsWithoutRetry_ = 0;	   // coarse steps since the last retry or FOFC surge
+	int cflCooldownRemaining_ = 0;	   // coarse steps until the CFL number may be raised again
+	int cflRetriesThisStep_ = 0;	   // number of hydro retries during the current coarse step
+	amrex::Long cflFofcCellsThisStep_ = 0; // number of first-order flux corrected cells during the current coarse step
+
+	// hydro robustness statistics (for comparing solver options)
+	int hydroRetriesTotal_ = 0;	 // number of hydro retries since the start of the run
+	amrex::Long fofcCellsTotal_ = 0; // number of first-order flux corrected cells since the start of the run
+
 	// flux registers: store fluxes at coarse-fine interface for synchronization
 	// this will be sized "nlevs_max+1"
 	// NOTE: the flux register associated with flux_reg[lev] is associated with
@@ -378,6 +476,9 @@ template <typename problem_t> class AMRSimulation : public amrex::AmrCore
 	amrex::Vector<std::unique_ptr<DiagBase>> m_diagnostics;
 	amrex::Vector<std::string> m_diagVars;
 
+	// time-integrated fluxes through surfaces
+	SurfaceFluxes surfaceFluxes_;
+
 	/// AMR-specific parameters
 	int regrid_int = 2;	 // regrid interval (number of coarse steps)
 	int do_reflux = 1;	 // 1 == reflux, 0 == no reflux
@@ -397,6 +498,12 @@ template <typename problem_t> class AMRSimulation : public amrex::AmrCore
 	void InitCICParticles(); // create CIC particles
 	int do_tracers = 0;
 	int do_cic_particles = 0;
+	int particleBlockTimesteps_ = 0;     // 1 == power-of-two individual (block) timesteps for CIC particles
+	amrex::Real particleBlockEta_ = 0.2; // accuracy parameter of the particle timestep criterion
+	int particleMaxRung_ = 6;	     // maximum block level (i.e., at most 2^particleMaxRung_ substeps per coarse step)
+	int particleMaxRungReached_ = 0;     // the finest block level used by any particle so far
+	amrex::Long particleSubstepsBlock_ = 0;	 // the number of particle substeps taken so far with block timesteps
+	amrex::Long particleSubstepsGlobal_ = 0; // the same, if all particles had taken the smallest block timestep of each step
 	std::unique_ptr<amrex::AmrTracerParticleContainer> TracerPC;
 	std::unique_ptr<quokka::CICParticleContainer> CICParticles;
 #endif
@@ -439,7 +546,7 @@ template <typename problem_t> void AMRSimulation<problem_t>::initialize()
 	nsubsteps.resize(nlevs_max, 1);
 	if (do_subcycle == 1) {
 		for (int lev = 1; lev <= max_level; ++lev) {
-			nsubsteps[lev] = MaxRefRatio(lev - 1);
+			nsubsteps[lev] = subcycleRatio(lev);
 		}
 	}
 
@@ -454,6 +561,7 @@ template <typename problem_t> void AMRSimulation<problem_t>::initialize()
 		state_old_fc_.resize(nlevs_max);
 	}
 	max_signal_speed_.resize(nlevs_max);
+	dtLimiters_.resize(nlevs_max);
 	flux_reg_.resize(nlevs_max + 1);
 	fillpatcher_.resize(nlevs_max + 1);
 	cellUpdatesEachLevel_.resize(nlevs_max, 0);
@@ -462,7 +570,8 @@ template <typename problem_t> void AMRSimulation<problem_t>::initialize()
 	// (this is necessary since FillPatch only fills from non-ghost cells on
 	// lev-1)
 	auto checkIsProperlyNested = [this](int const lev, amrex::IntVect const &blockingFactor) {
-		return amrex::ProperlyNested(refRatio(lev - 1), blockingFactor, nghost_cc_, amrex::IndexType::TheCellType(), &amrex::cell_cons_interp);
+		return amrex::ProperlyNested(refRatio(lev - 1), blockingFactor, nghost_cc_, amrex::IndexType::TheCellType(),
+					     getAmrInterpolaterCellCentered());
 	};
 
 	for (int lev = 1; lev <= max_level; ++lev) {
@@ -554,6 +663,47 @@ template <typename problem_t> void AMRSimulation<problem_t>::readParameters()
 	// Default AMR interpolation method == lincc_interp
 	pp.query("amr_interpolation_method", amrInterpMethod_);
 
+	// Default timestep_diagnostics = 0 (report the location and state of the dt-limiting cells)
+	pp.query("timestep_diagnostics", timestepDiagnostics_);
+
+	// Default dmap_locality = 0 (use the default distribution map on each level)
+	pp.query("dmap_locality", dmapLocality_);
+	pp.query("dmap_max_imbalance", dmapMaxImbalance_);
+	if (dmapMaxImbalance_ < 0.) {
+		amrex::Abort("dmap_max_imbalance must be non-negative!");
+	}
+
+	// set adaptive CFL controller parameters
+	{
+		const amrex::ParmParse cpp("cfl_controller");
+		cpp.query("enabled", adaptiveCfl_);
+		cpp.query("min_cfl", adaptiveCflMin_);
+		cpp.query("max_cfl", adaptiveCflMax_);
+		cpp.query("increase_factor", adaptiveCflIncrease_);
+		cpp.query("decrease_factor", adaptiveCflDecrease_);
+		cpp.query("streak_length", adaptiveCflStreak_);
+		cpp.query("cooldown_steps", adaptiveCflCooldown_);
+		cpp.query("fofc_surge_fraction", adaptiveCflFofcFraction_);
+
+		if (adaptiveCflMin_ <= 0.) {
+			adaptiveCflMin_ = 0.5 * cflNumber_;
+		}
+		if (adaptiveCflMax_ <= 0.) {
+			adaptiveCflMax_ = cflNumber_;
+		}
+		if (adaptiveCfl_ == 1) {
+			if (adaptiveCflMin_ > adaptiveCflMax_) {
+				amrex::Abort("cfl_controller.min_cfl must not be larger than cfl_controller.max_cfl!");
+			}
+			if ((adaptiveCflIncrease_ < 1.) || (adaptiveCflDecrease_ <= 0.) || (adaptiveCflDecrease_ > 1.)) {
+				amrex::Abort("cfl_controller.increase_factor must be >= 1 and cfl_controller.decrease_factor must be in (0, 1]!");
+			}
+			cflNumber_ = std::clamp(cflNumber_, adaptiveCflMin_, adaptiveCflMax_);
+			amrex::Print() << fmt::format("Adaptive CFL controller enabled (initial cfl = {}, min_cfl = {}, max_cfl = {}).\n", cflNumber_,
+						      adaptiveCflMin_, adaptiveCflMax_);
+		}
+	}
+
 	// Default stopping time
 	pp.query("stop_time", stopTime_);
 
@@ -584,6 +734,9 @@ template <typename problem_t> void AMRSimulation<problem_t>::readParameters()
 	// Default checkpoint prefix
 	pp.query("checkpoint_prefix", chk_file);
 
+	// Default statistics filename
+	pp.query("statistics_file", stats_file);
+
 	// Default do_reflux = 1
 	pp.query("do_reflux", do_reflux);
 
@@ -632,13 +785,39 @@ template <typename problem_t> void AMRSimulation<problem_t>::readParameters()
 	{
 		const amrex::ParmParse hpp("gravity");
 		hpp.query("Gconst", Gconst_);
+		hpp.query("poisson_solver", poissonSolver_);
+		hpp.query("multipole_order", multipoleOrder_);
+		hpp.query("compare_solvers", comparePoissonSolvers_);
+		if ((poissonSolver_ != "openbc") && (poissonSolver_ != "multipole")) {
+			amrex::Abort("gravity.poisson_solver must be either 'openbc' or 'multipole'!");
+		}
+	}
+
+#ifdef AMREX_PARTICLES
+	// set CIC particle runtime parameters
+	{
+		const amrex::ParmParse ppp("particles");
+		ppp.query("block_timesteps", particleBlockTimesteps_);
+		ppp.query("block_timestep_eta", particleBlockEta_);
+		ppp.query("max_block_level", particleMaxRung_);
+		if ((particleMaxRung_ < 0) || (particleMaxRung_ > 20)) {
+			amrex::Abort("particles.max_block_level must be between 0 and 20!");
+		}
 	}
+#endif
 }
 
 template <typename problem_t> void AMRSimulation<problem_t>::setInitialConditions()
 {
 	BL_PROFILE("AMRSimulation::setInitialConditions()");
 
+	// the Poisson solvers assume Cartesian coordinates
+	if (!geom[0].IsCartesian() && (doPoissonSolve_ != 0)) {
+		amrex::Abort("curvilinear coordinates are not supported for self-gravity!");
+	}
+
+	surfaceFluxes_.init(geom[0], componentNames_cc_);
+
 	if (restart_chkfile.empty()) {
 		// start simulation from the beginning
 		const amrex::Real time = 0.0;
@@ -691,6 +870,8 @@ template <typename problem_t> void AMRSimulation<problem_t>::setInitialCondition
 		WriteStatisticsFile();
 	}
 
+	surfaceFluxes_.writeToFile(istep[0], tNew_[0]);
+
 	// initialize diagnostics
 	createDiagnostics();
 	// output diagnostics
@@ -715,8 +896,18 @@ template <typename problem_t> auto AMRSimulation<problem_t>::computeTimestepAtLe
 	// compute timestep due to extra physics on level 'lev'
 	const amrex::Real extra_physics_dt = computeExtraPhysicsTimestep(lev);
 
+	// record which constraint determined the timestep on this level
+	TimestepLimiterInfo &info = dtLimiters_[lev];
+	info.limiter = (hydro_dt <= extra_physics_dt) ? TimestepLimiter::signal_speed : TimestepLimiter::extra_physics;
+	info.dt = std::min(hydro_dt, extra_physics_dt);
+	info.maxSignalSpeed = domain_signal_max;
+	if (timestepDiagnostics_ == 1) {
+		// find the cell with the maximum signal speed (this requires an additional reduction)
+		info.cell = max_signal_speed_[lev].maxIndex(0);
+	}
+
 	// return minimum timestep
-	return std::min(hydro_dt, extra_physics_dt);
+	return info.dt;
 }
 
 template <typename problem_t> void AMRSimulation<problem_t>::computeTimestep()
@@ -733,49 +924,70 @@ template <typename problem_t> void AMRSimulation<problem_t>::computeTimestep()
 	constexpr amrex::Real change_max = 1.1;
 
 	for (int level = 0; level <= finest_level; ++level) {
-		dt_tmp[level] = std::min(dt_tmp[level], change_max * dt_[level]);
+		if (change_max * dt_[level] < dt_tmp[level]) {
+			dt_tmp[level] = change_max * dt_[level];
+			dtLimiters_[level].limiter = TimestepLimiter::growth_limit;
+			dtLimiters_[level].dt = dt_tmp[level];
+		}
 	}
 
 	// set default subcycling pattern
 	if (do_subcycle == 1) {
 		for (int lev = 1; lev <= max_level; ++lev) {
-			nsubsteps[lev] = MaxRefRatio(lev - 1);
+			nsubsteps[lev] = subcycleRatio(lev);
 			reductionFactor_[lev] = 1; // reset additional subcycling
 		}
 	}
 
+	// apply the global timestep limits to the candidate timestep dt, keeping track of which constraint wins
+	auto applyGlobalLimits = [this](amrex::Real &dt, TimestepLimiter &limiter, int level) {
+		if (maxDt_ < dt) { // limit to maxDt_
+			dt = maxDt_;
+			limiter = TimestepLimiter::max_dt;
+		}
+		if ((tNew_[level] == 0.0) && (initDt_ < dt)) { // first timestep
+			dt = initDt_;
+			limiter = TimestepLimiter::init_dt;
+		}
+		if (constantDt_ > 0.0) { // use constant timestep if set
+			dt = constantDt_;
+			limiter = TimestepLimiter::constant_dt;
+		}
+	};
+
 	// compute root level timestep given nsubsteps
 	amrex::Real dt_0 = dt_tmp[0];
+	TimestepLimiter dt_0_limiter = dtLimiters_[0].limiter;
+	int dt_0_level = 0;
 	amrex::Long n_factor = 1;
 
 	for (int level = 0; level <= finest_level; ++level) {
 		n_factor *= nsubsteps[level];
-		dt_0 = std::min(dt_0, static_cast<amrex::Real>(n_factor) * dt_tmp[level]);
-		dt_0 = std::min(dt_0, maxDt_); // limit to maxDt_
-
-		if (tNew_[level] == 0.0) { // first timestep
-			dt_0 = std::min(dt_0, initDt_);
-		}
-		if (constantDt_ > 0.0) { // use constant timestep if set
-			dt_0 = constantDt_;
+		if (static_cast<amrex::Real>(n_factor) * dt_tmp[level] < dt_0) {
+			dt_0 = static_cast<amrex::Real>(n_factor) * dt_tmp[level];
+			dt_0_limiter = dtLimiters_[level].limiter;
+			dt_0_level = level;
 		}
+		applyGlobalLimits(dt_0, dt_0_limiter, level);
 	}
 
 	// compute global timestep assuming no subcycling
 	amrex::Real dt_global = dt_tmp[0];
+	TimestepLimiter dt_global_limiter = dtLimiters_[0].limiter;
+	int dt_global_level = 0;
 
 	for (int level = 0; level <= finest_level; ++level) {
-		dt_global = std::min(dt_global, dt_tmp[level]);
-		dt_global = std::min(dt_global, maxDt_); // limit to maxDt_
-
-		if (tNew_[level] == 0.0) { // special case: first timestep
-			dt_global = std::min(dt_global, initDt_);
-		}
-		if (constantDt_ > 0.0) { // special case: constant timestep
-			dt_global = constantDt_;
+		if (dt_tmp[level] < dt_global) {
+			dt_global = dt_tmp[level];
+			dt_global_limiter = dtLimiters_[level].limiter;
+			dt_global_level = level;
 		}
+		applyGlobalLimits(dt_global, dt_global_limiter, level);
 	}
 
+	dtLimiter_ = dt_0_limiter;
+	dtLimitingLevel_ = dt_0_level;
+
 	// compute work estimate for subcycling
 	amrex::Long n_factor_work = 1;
 	amrex::Long work_subcycling = 0;
@@ -800,6 +1012,8 @@ template <typename problem_t> void AMRSimulation<problem_t>::computeTimestep()
 		for (int lev = 1; lev <= max_level; ++lev) {
 			nsubsteps[lev] = 1;
 		}
+		dtLimiter_ = dt_global_limiter;
+		dtLimitingLevel_ = dt_global_level;
 	}
 
 	// Limit dt to avoid overshooting stop_time
@@ -807,6 +1021,7 @@ template <typename problem_t> void AMRSimulation<problem_t>::computeTimestep()
 
 	if (tNew_[0] + dt_0 > stopTime_ - eps) {
 		dt_0 = stopTime_ - tNew_[0];
+		dtLimiter_ = TimestepLimiter::stop_time;
 	}
 
 	// assign timesteps on each level
@@ -815,6 +1030,165 @@ template <typename problem_t> void AMRSimulation<problem_t>::computeTimestep()
 	for (int level = 1; level <= finest_level; ++level) {
 		dt_[level] = dt_[level - 1] / nsubsteps[level];
 	}
+
+	reportTimestepLimiter();
+}
+
+template <typename problem_t> auto AMRSimulation<problem_t>::getCellState(int lev, amrex::IntVect const &cell) const -> amrex::Vector<amrex::Real>
+{
+	// return the state of a single cell on the IO processor (this must be called on all ranks)
+	const int ncomp = state_new_cc_[lev].nComp();
+	amrex::Vector<amrex::Real> values = amrex::get_cell_data(state_new_cc_[lev], cell); // only non-empty on the owning rank
+	values.resize(ncomp, 0.0);
+	amrex::ParallelDescriptor::ReduceRealSum(values.data(), ncomp, amrex::ParallelDescriptor::IOProcessorNumber());
+	return values;
+}
+
+template <typename problem_t> void AMRSimulation<problem_t>::recordHydroRetry(int /*lev*/)
+{
+	// called whenever a hydro update on any level has to be re-tried with a smaller timestep
+	++cflRetriesThisStep_;
+	++hydroRetriesTotal_;
+}
+
+template <typename problem_t> void AMRSimulation<problem_t>::recordFofcCells(int /*lev*/, amrex::Long ncells)
+{
+	// called whenever first-order flux correction is applied to cells on any level
+	cflFofcCellsThisStep_ += ncells;
+	fofcCellsTotal_ += ncells;
+}
+
+template <typename problem_t> void AMRSimulation<problem_t>::updateCflController()
+{
+	// adjust the CFL number at the end of each coarse step based on the retry history:
+	//   - after retries (or a surge of first-order flux corrected cells), lower the CFL number and
+	//     do not raise it again for adaptiveCflCooldown_ steps,
+	//   - after adaptiveCflStreak_ steps without retries, raise the CFL number.
+
+	if (adaptiveCfl_ == 0) {
+		return;
+	}
+
+	// the FOFC cell counts are accumulated over all substeps of each level, so the cells of each level are counted
+	// once per substep (i.e., the number of cell updates during this coarse step, excluding retries)
+	amrex::Long ncells = 0;
+	amrex::Long substeps = 1;
+	for (int lev = 0; lev <= finest_level; ++lev) {
+		substeps *= nsubsteps[lev];
+		ncells += boxArray(lev).numPts() * substeps;
+	}
+	const bool fofcSurge = static_cast<amrex::Real>(cflFofcCellsThisStep_) > adaptiveCflFofcFraction_ * static_cast<amrex::Real>(ncells);
+	const amrex::Real cflOld = cflNumber_;
+
+	if ((cflRetriesThisStep_ > 0) || fofcSurge) {
+		cflNumber_ = std::max(adaptiveCflMin_, adaptiveCflDecrease_ * cflNumber_);
+		cflStepsWithoutRetry_ = 0;
+		cflCooldownRemaining_ = adaptiveCflCooldown_;
+		amrex::Print() << fmt::format("[CFL controller] step {}: {} retries, {} FOFC cells. Lowering cfl from {} to {}.\n", istep[0],
+					      cflRetriesThisStep_, cflFofcCellsThisStep_, cflOld, cflNumber_);
+	} else {
+		++cflStepsWithoutRetry_;
+		cflCooldownRemaining_ = std::max(0, cflCooldownRemaining_ - 1);
+
+		if ((cflCooldownRemaining_ == 0) && (cflStepsWithoutRetry_ >= adaptiveCflStreak_) && (cflNumber_ < adaptiveCflMax_)) {
+			cflNumber_ = std::min(adaptiveCflMax_, adaptiveCflIncrease_ * cflNumber_);
+			cflStepsWithoutRetry_ = 0;
+			amrex::Print() << fmt::format("[CFL controller] step {}: no retries for {} steps. Raising cfl from {} to {}.\n", istep[0],
+						      adaptiveCflStreak_, cflOld, cflNumber_);
+		}
+	}
+
+	cflRetriesThisStep_ = 0;
+	cflFofcCellsThisStep_ = 0;
+
+	// save the controller state so that restarts behave identically
+	simulationMetadata_["cfl_controller_cfl"] = cflNumber_;
+	simulationMetadata_["cfl_controller_steps_without_retry"] = static_cast<amrex::Real>(cflStepsWithoutRetry_);
+	simulationMetadata_["cfl_controller_cooldown_remaining"] = static_cast<amrex::Real>(cflCooldownRemaining_);
+}
+
+template <typename problem_t> void AMRSimulation<problem_t>::restoreCflController()
+{
+	// restore the adaptive CFL controller state from the checkpoint metadata (if present)
+	if ((adaptiveCfl_ == 0) || (simulationMetadata_.count("cfl_controller_cfl") == 0)) {
+		return;
+	}
+
+	cflNumber_ = std::get<amrex::Real>(simulationMetadata_["cfl_controller_cfl"]);
+	cflStepsWithoutRetry_ = static_cast<int>(std::get<amrex::Real>(simulationMetadata_["cfl_controller_steps_without_retry"]));
+	cflCooldownRemaining_ = static_cast<int>(std::get<amrex::Real>(simulationMetadata_["cfl_controller_cooldown_remaining"]));
+	amrex::Print() << fmt::format("[CFL controller] restored cfl = {} from checkpoint.\n", cflNumber_);
+}
+
+template <typename problem_t> void AMRSimulation<problem_t>::reportTimestepLimiter()
+{
+	if ((verbose == 0) || (suppress_output == 1)) {
+		return;
+	}
+
+	const int lev = dtLimitingLevel_;
+	amrex::Print() << "\t>> dt = " << dt_[0] << " is limited by " << timestepLimiterName(dtLimiter_);
+	if ((dtLimiter_ == TimestepLimiter::signal_speed) || (dtLimiter_ == TimestepLimiter::extra_physics) ||
+	    (dtLimiter_ == TimestepLimiter::growth_limit)) {
+		amrex::Print() << " on level " << lev;
+	}
+	amrex::Print() << "\n";
+
+	// print the location and state of the cell with the maximum signal speed on the limiting level
+	if ((timestepDiagnostics_ == 1) && (dtLimiter_ == TimestepLimiter::signal_speed)) {
+		auto const &info = dtLimiters_[lev];
+		const auto problo = geom[lev].ProbLoArray();
+		const auto dx = geom[lev].CellSizeArray();
+		const amrex::Vector<amrex::Real> state = getCellState(lev, info.cell);
+
+		amrex::Print() << "\t   max signal speed = " << info.maxSignalSpeed << " in cell " << info.cell << " at x = ("
+			       << AMREX_D_TERM(problo[0] + (info.cell[0] + 0.5) * dx[0], << ", " << problo[1] + (info.cell[1] + 0.5) * dx[1],
+					       << ", " << problo[2] + (info.cell[2] + 0.5) * dx[2])
+			       << ")\n";
+		for (int n = 0; n < static_cast<int>(state.size()); ++n) {
+			amrex::Print() << "\t   " << componentNames_cc_[n] << " = " << state[n] << "\n";
+		}
+	}
+}
+
+template <typename problem_t> void AMRSimulation<problem_t>::WriteTimestepLimiterFile(std::string const &filename) const
+{
+	// write the constraint that determined the most recent timestep on each level,
+	// and the location and state of the cell with the maximum signal speed on each level
+
+	amrex::Vector<amrex::Vector<amrex::Real>> states(finest_level + 1);
+	for (int lev = 0; lev <= finest_level; ++lev) {
+		states[lev] = getCellState(lev, dtLimiters_[lev].cell);
+	}
+
+	if (amrex::ParallelDescriptor::IOProcessor()) {
+		std::ofstream file(filename);
+		if (!file.good()) {
+			amrex::FileOpenFailed(filename);
+		}
+		file << std::setprecision(std::numeric_limits<amrex::Real>::max_digits10);
+		file << "# coarse dt = " << dt_[0] << " limited by " << timestepLimiterName(dtLimiter_) << " on level " << dtLimitingLevel_ << "\n";
+		file << "# level limiter dt_level max_signal_speed " << AMREX_D_TERM("i ", "j ", "k ") << AMREX_D_TERM("x ", "y ", "z ");
+		for (auto const &name : componentNames_cc_) {
+			file << name << " ";
+		}
+		file << "\n";
+
+		for (int lev = 0; lev <= finest_level; ++lev) {
+			auto const &info = dtLimiters_[lev];
+			file << lev << " " << timestepLimiterName(info.limiter) << " " << info.dt << " " << info.maxSignalSpeed << " ";
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				file << info.cell[idim] << " ";
+			}
+			for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+				file << geom[lev].ProbLo(idim) + (info.cell[idim] + 0.5) * geom[lev].CellSize(idim) << " ";
+			}
+			for (auto const &value : states[lev]) {
+				file << value << " ";
+			}
+			file << "\n";
+		}
+	}
 }
 
 template <typename problem_t> auto AMRSimulation<problem_t>::getWalltime() -> amrex::Real
@@ -836,6 +1210,7 @@ template <typename problem_t> void AMRSimulation<problem_t>::evolve()
 #endif
 	int last_projection_step = 0;
 	int last_statistics_step = 0;
+	int last_surface_flux_step = 0;
 	int last_plot_file_step = 0;
 	double next_plot_file_time = plotTimeInterval_;
 	double next_chk_file_time = checkpointTimeInterval_;
@@ -867,7 +1242,16 @@ template <typename problem_t> void AMRSimulation<problem_t>::evolve()
 		computeBeforeTimestep();
 
 		// do particle leapfrog (first kick at time t)
-		kickParticlesAllLevels(dt_[0]);
+		// (with block timesteps, the particles are instead sub-stepped after the Poisson solve at t + dt,
+		// so we save the accelerations at time t for the time interpolation. The first kick is still applied here,
+		// so that the predictor drift below deposits the particle mass at the leapfrog positions at t + dt.)
+		amrex::Vector<amrex::MultiFab> particleAccelOld;
+		if ((do_cic_particles != 0) && (particleBlockTimesteps_ != 0)) {
+			computeParticleAccelAllLevels(particleAccelOld);
+			kickParticlesAllLevels(particleAccelOld, dt_[0]);
+		} else {
+			kickParticlesAllLevels(dt_[0]);
+		}
 
 		// hyperbolic advance over all levels
 		// (N.B. when AMR is enabled, regridding may happen during this function!)
@@ -877,16 +1261,23 @@ template <typename problem_t> void AMRSimulation<problem_t>::evolve()
 
 		// drift particles from t to (t + dt)
 		// N.B.: MUST be done *before* Poisson solve at new time!
+		// (with block timesteps, this is a predictor that is only used to deposit the particle mass)
 		driftParticlesAllLevels(dt_[0]);
 
 		// elliptic solve over entire AMR grid (post-timestep)
 		ellipticSolveAllLevels(dt_[0]);
 
-		// do particle leapfrog (second kick at t + dt)
-		kickParticlesAllLevels(dt_[0]);
+		if ((do_cic_particles != 0) && (particleBlockTimesteps_ != 0)) {
+			// sub-step particles from t to (t + dt) with individual timesteps
+			blockStepParticlesAllLevels(particleAccelOld, dt_[0]);
+		} else {
+			// do particle leapfrog (second kick at t + dt)
+			kickParticlesAllLevels(dt_[0]);
+		}
 
 		cur_time += dt_[0];
 		++cycleCount_;
+		updateCflController();
 		computeAfterTimestep();
 
 		// sync up time (to avoid roundoff error)
@@ -907,6 +1298,11 @@ template <typename problem_t> void AMRSimulation<problem_t>::evolve()
 			WriteStatisticsFile();
 		}
 
+		if (surfaceFluxes_.enabled() && (step + 1) % surfaceFluxes_.interval() == 0) {
+			last_surface_flux_step = step + 1;
+			surfaceFluxes_.writeToFile(istep[0], tNew_[0]);
+		}
+
 		if (plotfileInterval_ > 0 && (step + 1) % plotfileInterval_ == 0) {
 			last_plot_file_step = step + 1;
 			WritePlotFile();
@@ -995,6 +1391,16 @@ template <typename problem_t> void AMRSimulation<problem_t>::evolve()
 		WriteStatisticsFile();
 	}
 
+	// write final surface fluxes
+	if (surfaceFluxes_.enabled() && istep[0] > last_surface_flux_step) {
+		surfaceFluxes_.writeToFile(istep[0], tNew_[0]);
+	}
+
+	// flush the diagnostics that buffer their output (e.g., probes)
+	for (const auto &diag : m_diagnostics) {
+		diag->close();
+	}
+
 	// write final checkpoint
 	// IMPORTANT: this MUST be written *after* the plotfile to avoid corruption:
 	// 	https://github.com/quokka-astro/quokka/issues/554
@@ -1018,16 +1424,11 @@ template <typename problem_t> void AMRSimulation<problem_t>::calculateGpotAllLev
 
 		BL_PROFILE_REGION("GravitySolver");
 
-		// set up elliptic solve object
-		amrex::OpenBCSolver poissonSolver(Geom(0, finest_level), boxArray(0, finest_level), DistributionMap(0, finest_level));
 		if (verbose) {
-			poissonSolver.setVerbose(true);
-			poissonSolver.setBottomVerbose(false);
 			amrex::Print() << "Doing Poisson solve...\n\n";
 		}
 
 		phi.resize(finest_level + 1);
-		// solve Poisson equation with open b.c. using the method of James (1977)
 		amrex::Vector<amrex::MultiFab> rhs(finest_level + 1);
 		const int nghost = 1;
 		const int ncomp = 1;
@@ -1055,11 +1456,49 @@ template <typename problem_t> void AMRSimulation<problem_t>::calculateGpotAllLev
 		}
 
 		amrex::Real abstol = abstolPoisson_ * rhs_min;
-		poissonSolver.solve(amrex::GetVecOfPtrs(phi), amrex::GetVecOfConstPtrs(rhs), reltolPoisson_, abstol);
+		const bool useMultipole = (poissonSolver_ == "multipole");
+		const double solve_start = amrex::second();
+		if (useMultipole) {
+			solvePoissonMultipole(phi, rhs, abstol);
+		} else {
+			solvePoissonOpenBC(phi, rhs, abstol);
+		}
+		const double solve_time = amrex::second() - solve_start;
 		if (verbose) {
 			amrex::Print() << "\n";
 		}
 
+		if (comparePoissonSolvers_ != 0) {
+			// solve again with the other method, and print the difference of the potentials and the wall time of each solve
+			amrex::Vector<amrex::MultiFab> phi_ref(finest_level + 1);
+			for (int lev = 0; lev <= finest_level; ++lev) {
+				phi_ref[lev].define(grids[lev], dmap[lev], ncomp, nghost);
+				phi_ref[lev].setVal(0);
+			}
+			const double ref_start = amrex::second();
+			if (useMultipole) {
+				solvePoissonOpenBC(phi_ref, rhs, abstol);
+			} else {
+				solvePoissonMultipole(phi_ref, rhs, abstol);
+			}
+			const double ref_time = amrex::second() - ref_start;
+
+			amrex::Real max_diff = 0.;
+			amrex::Real max_phi = 0.;
+			for (int lev = 0; lev <= finest_level; ++lev) {
+				amrex::MultiFab diff(grids[lev], dmap[lev], ncomp, 0);
+				amrex::MultiFab::LinComb(diff, 1.0, phi[lev], 0, -1.0, phi_ref[lev], 0, 0, ncomp, 0);
+				max_diff = std::max(max_diff, diff.norm0(0, 0, true));
+				max_phi = std::max(max_phi, phi_ref[lev].norm0(0, 0, true));
+			}
+			amrex::ParallelDescriptor::ReduceRealMax(max_diff);
+			amrex::ParallelDescriptor::ReduceRealMax(max_phi);
+			const std::string other = useMultipole ? "openbc" : "multipole";
+			amrex::Print() << fmt::format("Poisson solver comparison: max|phi_{} - phi_{}| / max|phi_{}| = {:.3e}\n", poissonSolver_, other, other,
+						      max_diff / max_phi);
+			amrex::Print() << fmt::format("\twall time: {} = {:.4f} s, {} = {:.4f} s\n", poissonSolver_, solve_time, other, ref_time);
+		}
+
 		// check for NaN
 		for (int lev = 0; lev <= finest_level; ++lev) {
 			AMREX_ALWAYS_ASSERT(!phi[lev].contains_nan()); // this fails when max_level=2 for SphericalCollapse
@@ -1068,6 +1507,60 @@ template <typename problem_t> void AMRSimulation<problem_t>::calculateGpotAllLev
 #endif
 }
 
+template <typename problem_t>
+void AMRSimulation<problem_t>::solvePoissonOpenBC(amrex::Vector<amrex::MultiFab> &phi_mf, amrex::Vector<amrex::MultiFab> const &rhs, amrex::Real abstol)
+{
+#if AMREX_SPACEDIM == 3
+	BL_PROFILE("AMRSimulation::solvePoissonOpenBC()");
+
+	// solve Poisson equation with open b.c. using the method of James (1977)
+	amrex::OpenBCSolver poissonSolver(Geom(0, finest_level), boxArray(0, finest_level), DistributionMap(0, finest_level));
+	if (verbose) {
+		poissonSolver.setVerbose(true);
+		poissonSolver.setBottomVerbose(false);
+	}
+	poissonSolver.solve(amrex::GetVecOfPtrs(phi_mf), amrex::GetVecOfConstPtrs(rhs), reltolPoisson_, abstol);
+#else
+	amrex::ignore_unused(phi_mf, rhs, abstol);
+#endif
+}
+
+template <typename problem_t>
+void AMRSimulation<problem_t>::solvePoissonMultipole(amrex::Vector<amrex::MultiFab> &phi_mf, amrex::Vector<amrex::MultiFab> const &rhs,
+						     amrex::Real abstol)
+{
+#if AMREX_SPACEDIM == 3
+	BL_PROFILE("AMRSimulation::solvePoissonMultipole()");
+
+	// compute the Dirichlet boundary values from a multipole expansion about the centre of the domain,
+	// then solve the Poisson equation on the (composite) AMR hierarchy with these boundary values
+	amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> center{};
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		center[idim] = 0.5 * (geom[0].ProbLo(idim) + geom[0].ProbHi(idim));
+	}
+	amrex::Vector<amrex::IntVect> ref_ratio(finest_level);
+	for (int lev = 0; lev < finest_level; ++lev) {
+		ref_ratio[lev] = refRatio(lev);
+	}
+	const auto moments = quokka::MultipoleExpansion::computeMoments(rhs, geom, ref_ratio, multipoleOrder_, center);
+
+	amrex::MLPoisson poissonOp(Geom(0, finest_level), boxArray(0, finest_level), DistributionMap(0, finest_level));
+	poissonOp.setDomainBC({AMREX_D_DECL(amrex::LinOpBCType::Dirichlet, amrex::LinOpBCType::Dirichlet, amrex::LinOpBCType::Dirichlet)},
+			      {AMREX_D_DECL(amrex::LinOpBCType::Dirichlet, amrex::LinOpBCType::Dirichlet, amrex::LinOpBCType::Dirichlet)});
+	for (int lev = 0; lev <= finest_level; ++lev) {
+		quokka::MultipoleExpansion::fillBoundaryValues(phi_mf[lev], geom[lev], moments, multipoleOrder_, center);
+		poissonOp.setLevelBC(lev, &phi_mf[lev]);
+	}
+
+	amrex::MLMG mlmg(poissonOp);
+	mlmg.setVerbose(verbose ? 1 : 0);
+	mlmg.setBottomVerbose(0);
+	mlmg.solve(amrex::GetVecOfPtrs(phi_mf), amrex::GetVecOfConstPtrs(rhs), reltolPoisson_, abstol);
+#else
+	amrex::ignore_unused(phi_mf, rhs, abstol);
+#endif
+}
+
 template <typename problem_t> void AMRSimulation<problem_t>::gravAccelAllLevels(const amrex::Real dt)
 {
 #if AMREX_SPACEDIM == 3
@@ -1104,66 +1597,85 @@ struct setFunctorParticleAccel {
 	}
 };
 
-template <typename problem_t> void AMRSimulation<problem_t>::kickParticlesAllLevels(const amrex::Real dt)
+template <typename problem_t> void AMRSimulation<problem_t>::computeParticleAccelAllLevels(amrex::Vector<amrex::MultiFab> &accel)
 {
-	// kick particles (do: vel[i] += 0.5 * dt * accel[i])
+	// compute the gravitational acceleration -grad(phi) on all levels, including one ghost cell
+	accel.resize(finest_level + 1);
 
-	if (do_cic_particles != 0) {
-		// gravitational acceleration multifabs
-		amrex::Vector<amrex::MultiFab> accel(finest_level + 1);
+	// self-gravity in Quokka requires open boundary conditions,
+	// so we extrapolate the gravitational accelerations at physical boundaries
+	amrex::Vector<amrex::BCRec> accelBC(AMREX_SPACEDIM);
+	for (int j = 0; j < AMREX_SPACEDIM; ++j) {
+		for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+			accelBC[j].setLo(i, amrex::BCType::foextrap);
+			accelBC[j].setHi(i, amrex::BCType::foextrap);
+		}
+	}
 
-		// self-gravity in Quokka requires open boundary conditions,
-		// so we extrapolate the gravitational accelerations at physical boundaries
-		amrex::Vector<amrex::BCRec> accelBC(AMREX_SPACEDIM);
-		for (int j = 0; j < AMREX_SPACEDIM; ++j) {
-			for (int i = 0; i < AMREX_SPACEDIM; ++i) {
-				accelBC[j].setLo(i, amrex::BCType::foextrap);
-				accelBC[j].setHi(i, amrex::BCType::foextrap);
+	for (int lev = 0; lev <= finest_level; ++lev) {
+		// compute accelerations
+		accel[lev].define(boxArray(lev), DistributionMap(lev), AMREX_SPACEDIM, 1);
+		accel[lev].setVal(0.);
+		auto accel_arr = accel[lev].arrays();
+		const auto &phi_arr = phi[lev].const_arrays();
+		const auto dx_inv = geom[lev].InvCellSizeArray();
+		const amrex::IntVect ng(0);
+
+		// check for NaN
+		AMREX_ALWAYS_ASSERT(!phi[lev].contains_nan());
+
+		amrex::ParallelFor(accel[lev], ng, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k, int n) {
+			// compute cell-centered acceleration -grad(phi)
+			if (n == 0) {
+				accel_arr[bx](i, j, k, n) = -0.5 * dx_inv[0] * (phi_arr[bx](i + 1, j, k) - phi_arr[bx](i - 1, j, k));
 			}
-		}
+			if (n == 1) {
+				accel_arr[bx](i, j, k, n) = -0.5 * dx_inv[1] * (phi_arr[bx](i, j + 1, k) - phi_arr[bx](i, j - 1, k));
+			}
+			if (n == 2) {
+				accel_arr[bx](i, j, k, n) = -0.5 * dx_inv[2] * (phi_arr[bx](i, j, k + 1) - phi_arr[bx](i, j, k - 1));
+			}
+		});
+		amrex::Gpu::streamSynchronizeAll();
 
-		for (int lev = 0; lev <= finest_level; ++lev) {
-			// compute accelerations
-			accel[lev].define(boxArray(lev), DistributionMap(lev), AMREX_SPACEDIM, 1);
-			accel[lev].setVal(0.);
-			auto accel_arr = accel[lev].arrays();
-			const auto &phi_arr = phi[lev].const_arrays();
-			const auto dx_inv = geom[lev].InvCellSizeArray();
-			const amrex::IntVect ng(0);
+		// fill ghost cells for accel[lev]
+		amrex::GpuBndryFuncFab<setFunctorParticleAccel> boundaryFunctor(setFunctorParticleAccel{});
+		amrex::PhysBCFunct<amrex::GpuBndryFuncFab<setFunctorParticleAccel>> fineBdryFunct(geom[lev], accelBC, boundaryFunctor);
 
-			// check for NaN
-			AMREX_ALWAYS_ASSERT(!phi[lev].contains_nan());
+		if (lev == 0) {
+			accel[lev].FillBoundary(geom[lev].periodicity());
+			fineBdryFunct(accel[lev], 0, accel[lev].nComp(), accel[lev].nGrowVect(), 0., 0);
+		} else {
+			amrex::PhysBCFunct<amrex::GpuBndryFuncFab<setFunctorParticleAccel>> coarseBdryFunct(geom[lev - 1], accelBC, boundaryFunctor);
+			amrex::InterpFromCoarseLevel(accel[lev], 0., accel[lev - 1], 0, 0, AMREX_SPACEDIM, geom[lev - 1], geom[lev], coarseBdryFunct, 0,
+						     fineBdryFunct, 0, refRatio(lev - 1), getAmrInterpolaterCellCentered(), accelBC, 0);
+		}
 
-			amrex::ParallelFor(accel[lev], ng, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k, int n) {
-				// compute cell-centered acceleration -grad(phi)
-				if (n == 0) {
-					accel_arr[bx](i, j, k, n) = -0.5 * dx_inv[0] * (phi_arr[bx](i + 1, j, k) - phi_arr[bx](i - 1, j, k));
-				}
-				if (n == 1) {
-					accel_arr[bx](i, j, k, n) = -0.5 * dx_inv[1] * (phi_arr[bx](i, j + 1, k) - phi_arr[bx](i, j - 1, k));
-				}
-				if (n == 2) {
-					accel_arr[bx](i, j, k, n) = -0.5 * dx_inv[2] * (phi_arr[bx](i, j, k + 1) - phi_arr[bx](i, j, k - 1));
-				}
-			});
-			amrex::Gpu::streamSynchronizeAll();
+		// check for NaN
+		AMREX_ALWAYS_ASSERT(!accel[lev].contains_nan(0, AMREX_SPACEDIM));
+		AMREX_ALWAYS_ASSERT(!accel[lev].contains_nan());
+	}
+}
 
-			// fill ghost cells for accel[lev]
-			amrex::GpuBndryFuncFab<setFunctorParticleAccel> boundaryFunctor(setFunctorParticleAccel{});
-			amrex::PhysBCFunct<amrex::GpuBndryFuncFab<setFunctorParticleAccel>> fineBdryFunct(geom[lev], accelBC, boundaryFunctor);
+template <typename problem_t> void AMRSimulation<problem_t>::kickParticlesAllLevels(const amrex::Real dt)
+{
+	// kick particles (do: vel[i] += 0.5 * dt * accel[i])
 
-			if (lev == 0) {
-				accel[lev].FillBoundary(geom[lev].periodicity());
-				fineBdryFunct(accel[lev], 0, accel[lev].nComp(), accel[lev].nGrowVect(), 0., 0);
-			} else {
-				amrex::PhysBCFunct<amrex::GpuBndryFuncFab<setFunctorParticleAccel>> coarseBdryFunct(geom[lev - 1], accelBC, boundaryFunctor);
-				amrex::InterpFromCoarseLevel(accel[lev], 0., accel[lev - 1], 0, 0, AMREX_SPACEDIM, geom[lev - 1], geom[lev], coarseBdryFunct, 0,
-							     fineBdryFunct, 0, refRatio(lev - 1), getAmrInterpolaterCellCentered(), accelBC, 0);
-			}
+	if (do_cic_particles != 0) {
+		// gravitational acceleration multifabs
+		amrex::Vector<amrex::MultiFab> accel;
+		computeParticleAccelAllLevels(accel);
+		kickParticlesAllLevels(accel, dt);
+	}
+}
 
-			// check for NaN
-			AMREX_ALWAYS_ASSERT(!accel[lev].contains_nan(0, AMREX_SPACEDIM));
-			AMREX_ALWAYS_ASSERT(!accel[lev].contains_nan());
+template <typename problem_t> void AMRSimulation<problem_t>::kickParticlesAllLevels(amrex::Vector<amrex::MultiFab> const &accel, const amrex::Real dt)
+{
+	// kick particles with the given accelerations (do: vel[i] += 0.5 * dt * accel[i])
+
+	if (do_cic_particles != 0) {
+		for (int lev = 0; lev <= finest_level; ++lev) {
+			const auto dx_inv = geom[lev].InvCellSizeArray();
 
 			// loop over boxes of particles on this level
 			for (quokka::CICParticleIterator pIter(*CICParticles, lev); pIter.isValid(); ++pIter) {
@@ -1171,7 +1683,7 @@ template <typename problem_t> void AMRSimulation<problem_t>::kickParticlesAllLev
 				quokka::CICParticleContainer::ParticleType *pData = particles().data();
 				const amrex::Long np = pIter.numParticles();
 
-				amrex::Array4<const amrex::Real> const &accel_arr = accel[lev].array(pIter);
+				amrex::Array4<const amrex::Real> const &accel_arr = accel[lev].const_array(pIter);
 				const auto plo = geom[lev].ProbLoArray();
 
 				amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE(int64_t idx) {
@@ -1215,6 +1727,140 @@ template <typename problem_t> void AMRSimulation<problem_t>::driftParticlesAllLe
 	}
 }
 
+template <typename problem_t> void AMRSimulation<problem_t>::blockStepParticlesAllLevels(amrex::Vector<amrex::MultiFab> &accelOld, const amrex::Real dt)
+{
+	// advance particles from t to (t + dt) with power-of-two individual timesteps (kick-drift-kick for each substep),
+	// using the acceleration interpolated linearly in time between the potentials at t (accelOld) and t + dt (phi).
+	// N.B.: the hydro timestep is not changed, since the particles only feel the mesh potential.
+	BL_PROFILE("AMRSimulation::blockStepParticlesAllLevels()");
+
+	if (do_cic_particles != 0) {
+		// undo the predictor drift, which was only used to deposit the particle mass for the Poisson solve
+		// (the particles have not been redistributed since then, so they are still in the boxes they occupied at time t)
+		driftParticlesAllLevels(-dt);
+
+		amrex::Vector<amrex::MultiFab> accelNew;
+		computeParticleAccelAllLevels(accelNew);
+
+		// if the grids have changed since time t, copy the old accelerations to the new grids
+		// (where there is no old data, e.g., on a newly-created level, the new acceleration is used)
+		const int nlevOld = static_cast<int>(accelOld.size());
+		accelOld.resize(finest_level + 1);
+		for (int lev = 0; lev <= finest_level; ++lev) {
+			if ((lev < nlevOld) && (accelOld[lev].boxArray() == boxArray(lev)) && (accelOld[lev].DistributionMap() == DistributionMap(lev))) {
+				continue;
+			}
+			const int ncomp = accelNew[lev].nComp();
+			const amrex::IntVect ng = accelNew[lev].nGrowVect();
+			amrex::MultiFab remapped(boxArray(lev), DistributionMap(lev), ncomp, ng);
+			amrex::MultiFab::Copy(remapped, accelNew[lev], 0, 0, ncomp, ng);
+			if (lev < nlevOld) {
+				remapped.ParallelCopy(accelOld[lev], 0, 0, ncomp, ng, ng);
+			}
+			accelOld[lev] = std::move(remapped);
+		}
+
+		// undo the first kick of the predictor (with the same acceleration and interpolation, at the same positions)
+		kickParticlesAllLevels(accelOld, -dt);
+
+		// number of particles on each block level
+		amrex::Gpu::DeviceVector<amrex::Long> rungCount_d(particleMaxRung_ + 1, 0);
+		amrex::Long *p_rungCount = rungCount_d.data();
+		const amrex::Real eta = particleBlockEta_;
+		const int maxRung = particleMaxRung_;
+
+		for (int lev = 0; lev <= finest_level; ++lev) {
+			const auto dx_inv = geom[lev].InvCellSizeArray();
+			const auto plo = geom[lev].ProbLoArray();
+			const amrex::Real dx_min = AMREX_D_PICK(geom[lev].CellSize(0), std::min(geom[lev].CellSize(0), geom[lev].CellSize(1)),
+								std::min({geom[lev].CellSize(0), geom[lev].CellSize(1), geom[lev].CellSize(2)}));
+
+			for (quokka::CICParticleIterator pIter(*CICParticles, lev); pIter.isValid(); ++pIter) {
+				auto &particles = pIter.GetArrayOfStructs();
+				quokka::CICParticleContainer::ParticleType *pData = particles().data();
+				const amrex::Long np = pIter.numParticles();
+
+				amrex::Array4<const amrex::Real> const &accelOld_arr = accelOld[lev].const_array(pIter);
+				amrex::Array4<const amrex::Real> const &accelNew_arr = accelNew[lev].const_array(pIter);
+
+				amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE(int64_t idx) {
+					quokka::CICParticleContainer::ParticleType &p = pData[idx]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+					amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> x{};
+					amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> v{};
+					for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+						x[n] = p.pos(n);
+						v[n] = p.rdata(quokka::ParticleVxIdx + n);
+					}
+
+					// choose the block level from the acceleration and its gradient at time t
+					amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> a{};
+					amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> a0{};
+					amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> a1{};
+					amrex::Real gradNorm0 = 0.;
+					amrex::Real gradNorm1 = 0.;
+					quokka::interpolateAccel(accelOld_arr, x, plo, dx_inv, a.data(), gradNorm0);
+					const int rung = quokka::blockTimestepRung(a.data(), gradNorm0, dx_min, eta, dt, maxRung);
+					const int nsub = 1 << rung;
+					const amrex::Real h = dt / static_cast<amrex::Real>(nsub);
+
+					for (int s = 0; s < nsub; ++s) {
+						// kick-drift
+						for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+							v[n] += 0.5 * h * a[n];
+							x[n] += h * v[n];
+						}
+						// acceleration at the end of the substep (re-used for the first kick of the next substep)
+						const amrex::Real w = static_cast<amrex::Real>(s + 1) / static_cast<amrex::Real>(nsub);
+						quokka::interpolateAccel(accelOld_arr, x, plo, dx_inv, a0.data(), gradNorm0);
+						quokka::interpolateAccel(accelNew_arr, x, plo, dx_inv, a1.data(), gradNorm1);
+						for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+							a[n] = (1.0 - w) * a0[n] + w * a1[n];
+							v[n] += 0.5 * h * a[n];
+						}
+					}
+
+					for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+						p.pos(n) = static_cast<amrex::ParticleReal>(x[n]);
+						p.rdata(quokka::ParticleVxIdx + n) = static_cast<amrex::ParticleReal>(v[n]);
+					}
+					amrex::HostDevice::Atomic::Add(&p_rungCount[rung], amrex::Long(1)); // NOLINT
+				});
+			}
+		}
+
+		// count the particles on each block level (once per coarse step)
+		amrex::Vector<amrex::Long> rungCount(particleMaxRung_ + 1, 0);
+		amrex::Gpu::copy(amrex::Gpu::deviceToHost, rungCount_d.begin(), rungCount_d.end(), rungCount.begin());
+		amrex::ParallelDescriptor::ReduceLongSum(rungCount.data(), static_cast<int>(rungCount.size()));
+
+		// compare the number of particle substeps with a global particle timestep equal to the smallest block timestep
+		amrex::Long nparticles = 0;
+		amrex::Long nsubsteps_block = 0;
+		int finest_rung = 0;
+		for (int r = 0; r <= particleMaxRung_; ++r) {
+			nparticles += rungCount[r];
+			nsubsteps_block += rungCount[r] * (amrex::Long(1) << r);
+			if (rungCount[r] > 0) {
+				finest_rung = r;
+			}
+		}
+		const amrex::Long nsubsteps_global = nparticles * (amrex::Long(1) << finest_rung);
+		particleMaxRungReached_ = std::max(particleMaxRungReached_, finest_rung);
+		particleSubstepsBlock_ += nsubsteps_block;
+		particleSubstepsGlobal_ += nsubsteps_global;
+
+		if (verbose) {
+			amrex::Print() << "Particle block timesteps (number of particles on each level):";
+			for (int r = 0; r <= finest_rung; ++r) {
+				amrex::Print() << " " << rungCount[r];
+			}
+			const double speedup = (nsubsteps_block > 0) ? static_cast<double>(nsubsteps_global) / static_cast<double>(nsubsteps_block) : 1.0;
+			amrex::Print() << fmt::format("\n\t{} particle substeps ({:.2f}x fewer than with a global particle timestep)\n", nsubsteps_block,
+						      speedup);
+		}
+	}
+}
+
 // N.B.: This function actually works for subcycled or not subcycled, as long as
 // nsubsteps[lev] is set correctly.
 template <typename problem_t> void AMRSimulation<problem_t>::timeStepWithSubcycling(int lev, amrex::Real time, int iteration)
@@ -1305,7 +1951,7 @@ template <typename problem_t> void AMRSimulation<problem_t>::timeStepWithSubcycl
 
 		if (do_reflux != 0) {
 			// update lev based on coarse-fine flux mismatch
-			flux_reg_[lev + 1]->Reflux(state_new_cc_[lev]);
+			refluxLevel(lev);
 		}
 
 		AverageDownTo(lev); // average lev+1 down to lev
@@ -1361,6 +2007,11 @@ void AMRSimulation<problem_t>::incrementFluxRegisters(amrex::MFIter &mfi, amrex:
 		fr_as_fine->FineAdd(mfi, {AMREX_D_DECL(&fluxArrays[0], &fluxArrays[1], &fluxArrays[2])}, // NOLINT(readability-container-data-pointer)
 				    geom[lev].CellSize(), dt_lev, amrex::RunOn::Gpu);
 	}
+
+	if (surfaceFluxes_.enabled()) {
+		surfaceFluxes_.accumulate(lev, geom[lev], grids[lev], surfaceFluxFineGrids(lev), mfi.index(),
+					  {AMREX_D_DECL(fluxArrays[0].const_array(), fluxArrays[1].const_array(), fluxArrays[2].const_array())}, dt_lev);
+	}
 }
 
 template <typename problem_t>
@@ -1369,6 +2020,7 @@ void AMRSimulation<problem_t>::incrementFluxRegisters(amrex::YAFluxRegister *fr_
 {
 	BL_PROFILE("AMRSimulation::incrementFluxRegisters()");
 
+	amrex::BoxArray const fineGrids = surfaceFluxFineGrids(lev);
 	for (amrex::MFIter mfi(state_new_cc_[lev]); mfi.isValid(); ++mfi) {
 		if (fr_as_crse != nullptr) {
 			AMREX_ASSERT(lev < finestLevel());
@@ -1383,7 +2035,63 @@ void AMRSimulation<problem_t>::incrementFluxRegisters(amrex::YAFluxRegister *fr_
 			fr_as_fine->FineAdd(mfi, {AMREX_D_DECL(fluxArrays[0].fabPtr(mfi), fluxArrays[1].fabPtr(mfi), fluxArrays[2].fabPtr(mfi))},
 					    geom[lev].CellSize(), dt_lev, amrex::RunOn::Gpu);
 		}
+
+		if (surfaceFluxes_.enabled()) {
+			surfaceFluxes_.accumulate(
+			    lev, geom[lev], grids[lev], fineGrids, mfi.index(),
+			    {AMREX_D_DECL(fluxArrays[0].const_array(mfi), fluxArrays[1].const_array(mfi), fluxArrays[2].const_array(mfi))}, dt_lev);
+		}
+	}
+}
+
+template <typename problem_t> auto AMRSimulation<problem_t>::surfaceFluxFineGrids(int lev) const -> amrex::BoxArray
+{
+	// the grids of the next finer level, coarsened to level lev (the surface fluxes on faces next to them are counted on the finer level)
+	if (lev >= finest_level) {
+		return {};
+	}
+	return amrex::coarsen(boxArray(lev + 1), refRatio(lev));
+}
+
+template <typename problem_t> auto AMRSimulation<problem_t>::fluxRegisterGeom(int lev) const -> amrex::Geometry
+{
+	// in curvilinear coordinates, the fluxes are multiplied by the face areas before they are added to the
+	// flux registers (see quokka::MultiplyByFaceArea), so the flux registers always use Cartesian geometry
+	amrex::Geometry const &g = Geom(lev);
+	if (g.IsCartesian()) {
+		return g;
+	}
+	return amrex::Geometry(g.Domain(), g.ProbDomain(), amrex::CoordSys::cartesian, g.isPeriodic());
+}
+
+template <typename problem_t> auto AMRSimulation<problem_t>::subcycleRatio(int lev) const -> int
+{
+	// the CFL timestep is proportional to the smallest cell width, so with anisotropic refinement ratios
+	// (amr.ref_ratio_vect) the number of substeps is the ratio of the smallest cell widths on levels lev-1 and lev,
+	// rounded up (this is equal to the refinement ratio when the ratio is isotropic)
+	amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &dx_crse = Geom(lev - 1).CellSizeArray();
+	amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &dx_fine = Geom(lev).CellSizeArray();
+	const amrex::Real dx_min_crse = std::min({AMREX_D_DECL(dx_crse[0], dx_crse[1], dx_crse[2])});
+	const amrex::Real dx_min_fine = std::min({AMREX_D_DECL(dx_fine[0], dx_fine[1], dx_fine[2])});
+	const int ratio = static_cast<int>(std::ceil(dx_min_crse / dx_min_fine - 1.0e-6));
+	return std::clamp(ratio, 1, MaxRefRatio(lev - 1));
+}
+
+template <typename problem_t> void AMRSimulation<problem_t>::refluxLevel(int lev)
+{
+	BL_PROFILE("AMRSimulation::refluxLevel()");
+
+	if (geom[lev].IsCartesian()) {
+		flux_reg_[lev + 1]->Reflux(state_new_cc_[lev]);
+		return;
 	}
+
+	// the area-weighted flux mismatch must be divided by the cell volume
+	amrex::MultiFab dU(grids[lev], dmap[lev], state_new_cc_[lev].nComp(), 0);
+	dU.setVal(0.);
+	flux_reg_[lev + 1]->Reflux(dU);
+	quokka::DivideByCellVolume(dU, quokka::CoordGeometry::fromGeometry(geom[lev]), dU.nComp());
+	amrex::MultiFab::Add(state_new_cc_[lev], dU, 0, 0, dU.nComp(), 0);
 }
 
 template <typename problem_t> auto AMRSimulation<problem_t>::getAmrInterpolaterCellCentered() -> amrex::MFInterpolater *
@@ -1399,6 +2107,10 @@ template <typename problem_t> auto AMRSimulation<problem_t>::getAmrInterpolaterC
 		// 2. should be conservative
 		// 3. preserves linear combinations of variables in each cell
 		mapper = &amrex::mf_linear_slope_minmax_interp;
+	} else if (amrInterpMethod_ == 2) { // limited quartic interpolation
+		// This has the same properties as mf_linear_slope_minmax_interp, but is fourth-order
+		// accurate in smooth regions. It needs 2 coarse cells on each side of the fine region.
+		mapper = &quokka::mf_cell_cons_quartic_interp;
 	} else {
 		amrex::Abort("Invalid AMR interpolation method specified!");
 	}
@@ -1414,6 +2126,104 @@ template <typename problem_t> auto AMRSimulation<problem_t>::getAmrInterpolaterF
 	return mapper; // global object, so this is ok
 }
 
+// Make the DistributionMapping for a new BoxArray on level 'lev'. Overrides the
+// virtual function in AmrMesh. If dmap_locality = 1, each fine box is assigned to
+// the rank that owns most of the coarse data underneath it, as long as this does not
+// make the load on that rank exceed (1 + dmap_max_imbalance) times the average load.
+// This reduces the communication required by FillPatch, AverageDown and refluxing.
+template <typename problem_t> auto AMRSimulation<problem_t>::MakeDistributionMap(int lev, amrex::BoxArray const &ba) -> amrex::DistributionMapping
+{
+	BL_PROFILE("AMRSimulation::MakeDistributionMap()");
+
+	const int nprocs = amrex::ParallelDescriptor::NProcs();
+	if ((dmapLocality_ == 0) || (lev == 0) || (nprocs == 1)) {
+		return amrex::AmrCore::MakeDistributionMap(lev, ba);
+	}
+
+	amrex::BoxArray const &cba = boxArray(lev - 1);
+	amrex::DistributionMapping const &cdm = DistributionMap(lev - 1);
+	const int nboxes = static_cast<int>(ba.size());
+
+	// for each fine box, the number of underlying coarse cells owned by each rank (sorted by decreasing overlap)
+	amrex::Vector<amrex::Vector<std::pair<int, amrex::Long>>> overlap(nboxes);
+	amrex::Vector<amrex::Long> weight(nboxes);
+	amrex::Long totalWeight = 0;
+	amrex::Long maxWeight = 0;
+	for (int i = 0; i < nboxes; ++i) {
+		weight[i] = ba[i].numPts();
+		totalWeight += weight[i];
+		maxWeight = std::max(maxWeight, weight[i]);
+
+		std::map<int, amrex::Long> cellsOnRank;
+		for (auto const &isect : cba.intersections(amrex::coarsen(ba[i], refRatio(lev - 1)))) {
+			cellsOnRank[cdm[isect.first]] += isect.second.numPts();
+		}
+		overlap[i].assign(cellsOnRank.begin(), cellsOnRank.end());
+		std::stable_sort(overlap[i].begin(), overlap[i].end(), [](auto const &a, auto const &b) { return a.second > b.second; });
+	}
+
+	// assign the largest boxes first, to the rank with the most overlap that has room for the box,
+	// or otherwise to the least-loaded rank
+	amrex::Vector<int> order(nboxes);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&weight](int a, int b) { return weight[a] > weight[b]; });
+
+	const amrex::Real maxLoad =
+	    std::max((1.0 + dmapMaxImbalance_) * static_cast<amrex::Real>(totalWeight) / static_cast<amrex::Real>(nprocs), static_cast<amrex::Real>(maxWeight));
+	amrex::Vector<amrex::Long> load(nprocs, 0);
+	amrex::Vector<int> pmap(nboxes, -1);
+	for (const int i : order) {
+		for (auto const &[rank, ncells] : overlap[i]) {
+			if (static_cast<amrex::Real>(load[rank] + weight[i]) <= maxLoad) {
+				pmap[i] = rank;
+				break;
+			}
+		}
+		if (pmap[i] < 0) {
+			pmap[i] = static_cast<int>(std::distance(load.begin(), std::min_element(load.begin(), load.end())));
+		}
+		load[pmap[i]] += weight[i];
+	}
+	amrex::DistributionMapping dm(pmap);
+
+	if (verbose != 0) {
+		// compare with the default distribution map
+		const amrex::DistributionMapping dm_default(ba, nprocs);
+		amrex::Vector<amrex::Long> load_default(nprocs, 0);
+		for (int i = 0; i < nboxes; ++i) {
+			load_default[dm_default[i]] += weight[i];
+		}
+		const amrex::Real avgLoad = static_cast<amrex::Real>(totalWeight) / static_cast<amrex::Real>(nprocs);
+		const amrex::Real imbalance = static_cast<amrex::Real>(*std::max_element(load.begin(), load.end())) / avgLoad;
+		const amrex::Real imbalance_default = static_cast<amrex::Real>(*std::max_element(load_default.begin(), load_default.end())) / avgLoad;
+		amrex::Print() << fmt::format("Level {} locality-preserving distribution map: coarse data is off-rank for {:.1f}% of fine cells "
+					      "(default: {:.1f}%), max/avg load = {:.3f} (default: {:.3f})\n",
+					      lev, 100. * offRankCoarseFraction(lev, ba, dm), 100. * offRankCoarseFraction(lev, ba, dm_default), imbalance,
+					      imbalance_default);
+	}
+	return dm;
+}
+
+// Return the fraction of the (coarsened) fine cells on level 'lev' for which the underlying coarse data
+// is owned by a different rank. This is the fraction of the coarse-fine data that must be communicated.
+template <typename problem_t>
+auto AMRSimulation<problem_t>::offRankCoarseFraction(int lev, amrex::BoxArray const &ba, amrex::DistributionMapping const &dm) const -> amrex::Real
+{
+	amrex::BoxArray const &cba = boxArray(lev - 1);
+	amrex::DistributionMapping const &cdm = DistributionMap(lev - 1);
+	amrex::Long total = 0;
+	amrex::Long offRank = 0;
+	for (int i = 0; i < static_cast<int>(ba.size()); ++i) {
+		for (auto const &isect : cba.intersections(amrex::coarsen(ba[i], refRatio(lev - 1)))) {
+			total += isect.second.numPts();
+			if (cdm[isect.first] != dm[i]) {
+				offRank += isect.second.numPts();
+			}
+		}
+	}
+	return (total > 0) ? static_cast<amrex::Real>(offRank) / static_cast<amrex::Real>(total) : 0.;
+}
+
 // Make a new level using provided BoxArray and DistributionMapping and fill
 // with interpolated coarse level data. Overrides the pure virtual function in
 // AmrCore
@@ -1435,8 +2245,8 @@ void AMRSimulation<problem_t>::MakeNewLevelFromCoarse(int level, amrex::Real tim
 	tOld_[level] = time - 1.e200;
 
 	if (level > 0 && (do_reflux != 0)) {
-		flux_reg_[level] = std::make_unique<amrex::YAFluxRegister>(ba, boxArray(level - 1), dm, DistributionMap(level - 1), Geom(level),
-									   Geom(level - 1), refRatio(level - 1), level, ncomp_cc);
+		flux_reg_[level] = std::make_unique<amrex::YAFluxRegister>(ba, boxArray(level - 1), dm, DistributionMap(level - 1), fluxRegisterGeom(level),
+									   fluxRegisterGeom(level - 1), refRatio(level - 1), level, ncomp_cc);
 	}
 
 	// face-centred
@@ -1480,8 +2290,8 @@ void AMRSimulation<problem_t>::RemakeLevel(int level, amrex::Real time, const am
 	tOld_[level] = time - 1.e200;
 
 	if (level > 0 && (do_reflux != 0)) {
-		flux_reg_[level] = std::make_unique<amrex::YAFluxRegister>(ba, boxArray(level - 1), dm, DistributionMap(level - 1), Geom(level),
-									   Geom(level - 1), refRatio(level - 1), level, ncomp_cc);
+		flux_reg_[level] = std::make_unique<amrex::YAFluxRegister>(ba, boxArray(level - 1), dm, DistributionMap(level - 1), fluxRegisterGeom(level),
+									   fluxRegisterGeom(level - 1), refRatio(level - 1), level, ncomp_cc);
 	}
 
 	// face-centred
@@ -1671,8 +2481,8 @@ void AMRSimulation<problem_t>::MakeNewLevelFromScratch(int level, amrex::Real ti
 	tOld_[level] = time - 1.e200;
 
 	if (level > 0 && (do_reflux != 0)) {
-		flux_reg_[level] = std::make_unique<amrex::YAFluxRegister>(ba, boxArray(level - 1), dm, DistributionMap(level - 1), Geom(level),
-									   Geom(level - 1), refRatio(level - 1), level, ncomp_cc);
+		flux_reg_[level] = std::make_unique<amrex::YAFluxRegister>(ba, boxArray(level - 1), dm, DistributionMap(level - 1), fluxRegisterGeom(level),
+									   fluxRegisterGeom(level - 1), refRatio(level - 1), level, ncomp_cc);
 	}
 
 	// face-centred
@@ -2176,8 +2986,32 @@ template <typename problem_t> void AMRSimulation<problem_t>::doDiagnostics()
 	bool const computeVars =
 	    std::any_of(m_diagnostics.cbegin(), m_diagnostics.cend(), [this](const auto &diag) { return diag->doDiag(tNew_[0], istep[0]); });
 
+	// if all of the requested variables are cell-centred state variables or derived variables, only these are computed,
+	// instead of all of the plotfile variables (this keeps frequent diagnostics, e.g. probes, cheap)
+	auto isCellCentredVar = [this](std::string const &v) {
+		return std::find(componentNames_cc_.begin(), componentNames_cc_.end(), v) != componentNames_cc_.end() ||
+		       std::find(derivedNames_.begin(), derivedNames_.end(), v) != derivedNames_.end();
+	};
+	bool const onlyCellCentredVars = std::all_of(m_diagVars.cbegin(), m_diagVars.cend(), isCellCentredVar);
+
 	amrex::Vector<std::unique_ptr<amrex::MultiFab>> diagMFVec(finestLevel() + 1);
-	if (computeVars) {
+	if (computeVars && onlyCellCentredVars) {
+		for (int lev{0}; lev <= finestLevel(); ++lev) {
+			diagMFVec[lev] = std::make_unique<amrex::MultiFab>(grids[lev], dmap[lev], m_diagVars.size(), 1);
+			fillBoundaryConditions(state_new_cc_[lev], state_new_cc_[lev], lev, tNew_[lev], quokka::centering::cc, quokka::direction::na,
+					       InterpHookNone, InterpHookNone, FillPatchType::fillpatch_function);
+
+			for (int v{0}; v < m_diagVars.size(); ++v) {
+				auto it = std::find(componentNames_cc_.begin(), componentNames_cc_.end(), m_diagVars[v]);
+				if (it != componentNames_cc_.end()) {
+					const int comp = static_cast<int>(std::distance(componentNames_cc_.begin(), it));
+					amrex::MultiFab::Copy(*diagMFVec[lev], state_new_cc_[lev], comp, v, 1, 1);
+				} else {
+					ComputeDerivedVar(lev, m_diagVars[v], *diagMFVec[lev], v);
+				}
+			}
+		}
+	} else if (computeVars) {
 		for (int lev{0}; lev <= finestLevel(); ++lev) {
 			diagMFVec[lev] = std::make_unique<amrex::MultiFab>(grids[lev], dmap[lev], m_diagVars.size(), 1);
 			amrex::MultiFab const mf = PlotFileMFAtLevel(lev, nghost_cc_);
@@ -2319,9 +3153,15 @@ template <typename problem_t> void AMRSimulation<problem_t>::WritePlotFile()
 	// TODO(bwibking): write particles using openPMD
 	quokka::OpenPMDOutput::WriteFile(varnames, finest_level + 1, mf_ptr, Geom(), plot_file, tNew_[0], istep[0]);
 	WriteMetadataFile(plotfilename + ".yaml");
+	if (timestepDiagnostics_ == 1) {
+		WriteTimestepLimiterFile(plotfilename + ".dt_limiting_cells.txt");
+	}
 #else
 	amrex::WriteMultiLevelPlotfile(plotfilename, finest_level + 1, mf_ptr, varnames, Geom(), tNew_[0], istep, refRatio());
 	WriteMetadataFile(plotfilename + "/metadata.yaml");
+	if (timestepDiagnostics_ == 1) {
+		WriteTimestepLimiterFile(plotfilename + "/dt_limiting_cells.txt");
+	}
 #ifdef AMREX_PARTICLES
 	// write particles
 	if (do_tracers != 0) {
@@ -2452,6 +3292,15 @@ template <typename problem_t> void AMRSimulation<problem_t>::WriteProjectionPlot
 	const amrex::ParmParse pp;
 	pp.queryarr("projection.dirs", dirs);
 
+	// output format: AMReX plotfile, PNG images (one per variable), or both
+	std::string format = "plotfile";
+	pp.query("projection.format", format);
+	if (format != "plotfile" && format != "png" && format != "both") {
+		amrex::Abort("invalid projection.format: " + format + " (must be 'plotfile', 'png', or 'both')");
+	}
+	const bool writePlotfile = (format != "png");
+	const bool writeImages = (format != "plotfile");
+
 	auto dir_from_string = [=](const std::string &dir_str) {
 		if (dir_str == "x") {
 			return 0;
@@ -2470,6 +3319,13 @@ template <typename problem_t> void AMRSimulation<problem_t>::WriteProjectionPlot
 		int dir = dir_from_string(dir_str);
 		std::unordered_map<std::string, amrex::BaseFab<amrex::Real>> proj = ComputeProjections(dir);
 
+		if (writeImages) {
+			WriteProjectionImages(proj, dir, dir_str);
+		}
+		if (!writePlotfile) {
+			continue;
+		}
+
 		auto const &firstFab = proj.begin()->second;
 		const amrex::BoxArray ba(firstFab.box());
 		const amrex::DistributionMapping dm(amrex::Vector<int>{0});
@@ -2501,6 +3357,51 @@ template <typename problem_t> void AMRSimulation<problem_t>::WriteProjectionPlot
 	}
 }
 
+template <typename problem_t>
+void AMRSimulation<problem_t>::WriteProjectionImages(std::unordered_map<std::string, amrex::BaseFab<amrex::Real>> const &proj, const int dir,
+						     std::string const &dir_str) const
+{
+	BL_PROFILE("AMRSimulation::WriteProjectionImages()");
+
+	// the projections are only valid on the IO rank
+	if (!amrex::ParallelDescriptor::IOProcessor()) {
+		return;
+	}
+
+	// the horizontal and vertical axes of the image are the remaining axes, in increasing order
+	std::vector<int> axes;
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		if (idim != dir) {
+			axes.push_back(idim);
+		}
+	}
+
+	for (auto const &[varname, fab] : proj) {
+		const amrex::Box &box = fab.box();
+		const int width = axes.empty() ? 1 : box.length(axes[0]);
+		const int height = (axes.size() > 1) ? box.length(axes[1]) : 1;
+		std::vector<amrex::Real> values(static_cast<std::size_t>(width) * height);
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				amrex::IntVect iv = box.smallEnd();
+				if (!axes.empty()) {
+					iv[axes[0]] += x;
+				}
+				if (axes.size() > 1) {
+					iv[axes[1]] += y;
+				}
+				values[x + static_cast<std::size_t>(width) * y] = fab(iv);
+			}
+		}
+
+		ImageRenderer renderer;
+		renderer.init("projection", varname);
+		const std::string filename = amrex::Concatenate("proj_" + dir_str + "_" + varname + "_", istep[0], 5) + ".png";
+		amrex::Print() << "Writing projection image " << filename << "\n";
+		renderer.write(filename, values, width, height);
+	}
+}
+
 template <typename problem_t> void AMRSimulation<problem_t>::WriteStatisticsFile()
 {
 	// append to statistics file
@@ -2509,6 +3410,11 @@ template <typename problem_t> void AMRSimulation<problem_t>::WriteStatisticsFile
 	// compute statistics
 	// IMPORTANT: the user is responsible for performing any necessary MPI reductions inside ComputeStatistics
 	std::map<std::string, amrex::Real> statistics = ComputeStatistics();
+	if (timestepDiagnostics_ == 1) {
+		// record which constraint determined the most recent timestep
+		statistics["dt_limiter"] = static_cast<amrex::Real>(dtLimiter_);
+		statistics["dt_limiting_level"] = static_cast<amrex::Real>(dtLimitingLevel_);
+	}
 
 	// write to file
 	if (amrex::ParallelDescriptor::IOProcessor()) {
@@ -2637,6 +3543,9 @@ template <typename problem_t> void AMRSimulation<problem_t>::WriteCheckpointFile
 	// write Metadata file
 	WriteMetadataFile(checkpointname + "/metadata.yaml");
 
+	// write the time-integrated surface fluxes
+	surfaceFluxes_.writeCheckpoint(checkpointname);
+
 	// write the cell-centred MultiFab data to, e.g., chk00010/Level_0/
 	for (int lev = 0; lev <= finest_level; ++lev) {
 		amrex::VisMF::Write(state_new_cc_[lev], amrex::MultiFabFileFullPrefix(lev, checkpointname, "Level_", "Cell"));
@@ -2757,7 +3666,8 @@ template <typename problem_t> void AMRSimulation<problem_t>::ReadCheckpointFile(
 		}
 
 		// create a distribution mapping
-		amrex::DistributionMapping dm{ba, amrex::ParallelDescriptor::NProcs()};
+		amrex::DistributionMapping dm =
+		    (dmapLocality_ != 0) ? MakeDistributionMap(lev, ba) : amrex::DistributionMapping{ba, amrex::ParallelDescriptor::NProcs()};
 
 		// set BoxArray grids and DistributionMapping dmap in AMReX_AmrMesh.H class
 		SetBoxArray(lev, ba);
@@ -2771,8 +3681,8 @@ template <typename problem_t> void AMRSimulation<problem_t>::ReadCheckpointFile(
 		max_signal_speed_[lev].define(ba, dm, 1, nghost_cc);
 
 		if (lev > 0 && (do_reflux != 0)) {
-			flux_reg_[lev] = std::make_unique<amrex::YAFluxRegister>(ba, boxArray(lev - 1), dm, DistributionMap(lev - 1), Geom(lev), Geom(lev - 1),
-										 refRatio(lev - 1), lev, ncomp_cc);
+			flux_reg_[lev] = std::make_unique<amrex::YAFluxRegister>(ba, boxArray(lev - 1), dm, DistributionMap(lev - 1), fluxRegisterGeom(lev),
+										 fluxRegisterGeom(lev - 1), refRatio(lev - 1), lev, ncomp_cc);
 		}
 
 		const int ncomp_per_dim_fc = Physics_Indices<problem_t>::nvarPerDim_fc;
@@ -2788,6 +3698,8 @@ template <typename problem_t> void AMRSimulation<problem_t>::ReadCheckpointFile(
 	}
 
 	ReadMetadataFile(restart_chkfile);
+	restoreCflController();
+	surfaceFluxes_.readCheckpoint(restart_chkfile);
 
 	// read in the MultiFab data
 	for (int lev = 0; lev <= finest_level; ++lev) {
@@ -0,0 +1,110 @@
+#ifndef COORDGEOMETRY_HPP_ // NOLINT
+#define COORDGEOMETRY_HPP_
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file CoordGeometry.hpp
+/// \brief Face areas and cell volumes for the finite-volume update in curvilinear coordinates.
+///
+
+#include <array>
+
+#include "AMReX_Array.H"
+#include "AMReX_CoordSys.H"
+#include "AMReX_Extension.H"
+#include "AMReX_Geometry.H"
+#include "AMReX_GpuQualifiers.H"
+#include "AMReX_MultiFab.H"
+#include "AMReX_REAL.H"
+
+namespace quokka
+{
+
+// Geometric factors for the coordinate systems supported by AMReX (geometry.coord_sys):
+//   0 == Cartesian,
+//   1 == RZ (2D axisymmetric: x == R, y == z, and the third velocity component is v_phi),
+//   2 == spherical (1D: x == r, and the other two velocity components are v_theta and v_phi).
+// Only the first coordinate direction is curvilinear. The factors are normalised such that they are equal to one
+// in Cartesian coordinates, so the flux divergence in the radial direction is
+//   (A_{i-1/2} F_{i-1/2} - A_{i+1/2} F_{i+1/2}) / (V_i dr),
+// where A = faceArea(i) and V = cellVolume(i). The faces normal to the other directions have area V_i.
+// The factors of 2 pi (RZ) and 4 pi (spherical) are omitted.
+struct CoordGeometry {
+	int coord = amrex::CoordSys::cartesian;
+	amrex::Real r0 = 0.; // radial coordinate of the lower face of cell i == 0
+	amrex::Real dr = 1.; // radial cell width
+
+	static auto fromGeometry(amrex::Geometry const &geom) -> CoordGeometry
+	{
+		const amrex::Real dr = geom.CellSize(0);
+		return CoordGeometry{static_cast<int>(geom.Coord()), geom.ProbLo(0) - geom.Domain().smallEnd(0) * dr, dr};
+	}
+
+	[[nodiscard]] AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE auto isCartesian() const -> bool { return coord == amrex::CoordSys::cartesian; }
+
+	// area of the radial face at the lower edge of cell i
+	[[nodiscard]] AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE auto faceArea(int i) const -> amrex::Real
+	{
+		const amrex::Real r = r0 + i * dr;
+		if (coord == amrex::CoordSys::RZ) {
+			return r;
+		}
+		if (coord == amrex::CoordSys::SPHERICAL) {
+			return r * r;
+		}
+		return 1.0;
+	}
+
+	// volume of cell i, divided by the radial cell width
+	[[nodiscard]] AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE auto cellVolume(int i) const -> amrex::Real
+	{
+		const amrex::Real rm = r0 + i * dr;
+		const amrex::Real rp = rm + dr;
+		if (coord == amrex::CoordSys::RZ) {
+			return 0.5 * (rm + rp);
+		}
+		if (coord == amrex::CoordSys::SPHERICAL) {
+			return (rp * rp * rp - rm * rm * rm) / (3.0 * dr);
+		}
+		return 1.0;
+	}
+
+	// difference of the face areas divided by the cell volume (== 1/R in RZ and ~2/r in spherical coordinates)
+	[[nodiscard]] AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE auto areaDivergence(int i) const -> amrex::Real
+	{
+		return (faceArea(i + 1) - faceArea(i)) / (cellVolume(i) * dr);
+	}
+};
+
+// multiply the fluxes by the face areas, so that the flux divergence of every direction is divided by the cell volume
+// (this is also the form of the fluxes that is needed for the flux registers)
+inline void MultiplyByFaceArea(std::array<amrex::MultiFab, AMREX_SPACEDIM> &flux_mf, CoordGeometry const &cg, const int ncomp)
+{
+	if (cg.isCartesian()) {
+		return;
+	}
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		auto const &flux = flux_mf[idim].arrays();
+		const bool isRadial = (idim == 0);
+		amrex::ParallelFor(flux_mf[idim], amrex::IntVect(0), ncomp, [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k, int n) noexcept {
+			flux[bx](i, j, k, n) *= isRadial ? cg.faceArea(i) : cg.cellVolume(i);
+		});
+	}
+}
+
+// divide a cell-centred quantity by the cell volume
+inline void DivideByCellVolume(amrex::MultiFab &mf, CoordGeometry const &cg, const int ncomp)
+{
+	if (cg.isCartesian()) {
+		return;
+	}
+	auto const &arr = mf.arrays();
+	amrex::ParallelFor(mf, amrex::IntVect(0), ncomp,
+			   [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k, int n) noexcept { arr[bx](i, j, k, n) /= cg.cellVolume(i); });
+}
+
+} // namespace quokka
+
+#endif // COORDGEOMETRY_HPP_
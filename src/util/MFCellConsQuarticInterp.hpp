@@ -0,0 +1,198 @@
+#ifndef MFCELLCONSQUARTICINTERP_HPP_ // NOLINT
+#define MFCELLCONSQUARTICINTERP_HPP_
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file MFCellConsQuarticInterp.hpp
+/// \brief Implements a conservative, limited fourth-order interpolater for cell-centred AMR data.
+///
+
+#include <array>
+
+#include "AMReX_Array.H"
+#include "AMReX_BCRec.H"
+#include "AMReX_Box.H"
+#include "AMReX_FArrayBox.H"
+#include "AMReX_Geometry.H"
+#include "AMReX_GpuQualifiers.H"
+#include "AMReX_IntVect.H"
+#include "AMReX_MFInterpolater.H"
+#include "AMReX_MultiFab.H"
+#include "AMReX_REAL.H"
+#include "AMReX_Vector.H"
+
+namespace quokka
+{
+
+// Conservative cell-centred interpolation using a quartic reconstruction from 5 coarse cells in each direction.
+// The multidimensional interpolant is the tensor product of the 1D reconstructions, so the average of the fine
+// cells always equals the coarse cell value. The interpolant is then limited so that the fine values do not exceed
+// the minimum and maximum of the neighbouring coarse cells. The limiter scales the deviation of the fine values from
+// the coarse cell value, which preserves conservation. As in mf_linear_slope_minmax_interp, the same limiter is
+// applied to all components, so that linear combinations of variables are preserved in each cell.
+class MFCellConsQuarticInterp : public amrex::MFInterpolater
+{
+      public:
+	static constexpr int stencilWidth = 2; // number of coarse cells on each side used for the reconstruction
+	static constexpr int stencilSize = 2 * stencilWidth + 1;
+	static constexpr int maxRatio = 4;
+	using weights_t = amrex::GpuArray<amrex::Real, maxRatio * stencilSize>;
+
+	auto CoarseBox(const amrex::Box &fine, int ratio) -> amrex::Box override { return amrex::grow(amrex::coarsen(fine, ratio), stencilWidth); }
+
+	auto CoarseBox(const amrex::Box &fine, const amrex::IntVect &ratio) -> amrex::Box override
+	{
+		return amrex::grow(amrex::coarsen(fine, ratio), stencilWidth);
+	}
+
+	void interp(const amrex::MultiFab &crsemf, int ccomp, amrex::MultiFab &finemf, int fcomp, int nc, amrex::IntVect const &ng,
+		    amrex::Geometry const &cgeom, amrex::Geometry const &fgeom, amrex::Box const &dest_domain, amrex::IntVect const &ratio,
+		    amrex::Vector<amrex::BCRec> const &bcs, int bcscomp) override;
+
+	// compute the weights of the coarse cells for each of the 'ratio' fine cells along one direction
+	static auto quarticWeights(int ratio) -> weights_t;
+};
+
+inline auto MFCellConsQuarticInterp::quarticWeights(int ratio) -> weights_t
+{
+	// the fine cell averages are obtained by differencing the primitive function of the reconstruction,
+	// which is the degree-5 polynomial through the cumulative sums of the coarse values at the coarse cell faces
+	// (for ratio == 2 this gives the weights [-3/128, 11/64, 1, -11/64, 3/128] for the left fine cell)
+	weights_t w{};
+	std::array<amrex::Real, stencilSize + 1> xface{};
+	for (int e = 0; e <= stencilSize; ++e) {
+		xface[e] = -0.5 * stencilSize + e;
+	}
+	auto lagrange = [&xface](int e, amrex::Real x) {
+		amrex::Real L = 1.0;
+		for (int l = 0; l <= stencilSize; ++l) {
+			if (l != e) {
+				L *= (x - xface[l]) / (xface[e] - xface[l]);
+			}
+		}
+		return L;
+	};
+
+	for (int m = 0; m < ratio; ++m) {
+		const amrex::Real a = -0.5 + static_cast<amrex::Real>(m) / ratio;
+		const amrex::Real b = -0.5 + static_cast<amrex::Real>(m + 1) / ratio;
+		for (int q = 0; q < stencilSize; ++q) {
+			amrex::Real sum = 0.;
+			for (int e = q + 1; e <= stencilSize; ++e) {
+				sum += lagrange(e, b) - lagrange(e, a);
+			}
+			w[m * stencilSize + q] = ratio * sum;
+		}
+	}
+	return w;
+}
+
+inline void MFCellConsQuarticInterp::interp(const amrex::MultiFab &crsemf, int ccomp, amrex::MultiFab &finemf, int fcomp, int nc, amrex::IntVect const &ng,
+					    amrex::Geometry const &cgeom, amrex::Geometry const & /*fgeom*/, amrex::Box const &dest_domain,
+					    amrex::IntVect const &ratio, amrex::Vector<amrex::BCRec> const & /*bcs*/, int /*bcscomp*/)
+{
+	// N.B.: the coarse ghost cells outside the domain have already been filled by the physical boundary functor,
+	// so the boundary conditions are not needed here.
+	BL_PROFILE("MFCellConsQuarticInterp::interp()");
+	AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ratio.allLE(amrex::IntVect(maxRatio)), "MFCellConsQuarticInterp only supports refinement ratios <= 4!");
+	AMREX_ALWAYS_ASSERT_WITH_MESSAGE(cgeom.IsCartesian(), "MFCellConsQuarticInterp only supports Cartesian coordinates!");
+
+	// weights for each direction (directions that are not refined only use the central coarse cell)
+	amrex::GpuArray<weights_t, 3> weights{};
+	amrex::GpuArray<int, 3> rr{1, 1, 1};
+	amrex::GpuArray<int, 3> sw{0, 0, 0};
+	for (int idim = 0; idim < 3; ++idim) {
+		weights[idim][stencilWidth] = 1.0;
+	}
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		rr[idim] = ratio[idim];
+		sw[idim] = stencilWidth;
+		weights[idim] = quarticWeights(ratio[idim]);
+	}
+
+	for (amrex::MFIter mfi(finemf); mfi.isValid(); ++mfi) {
+		const amrex::Box fbx = amrex::grow(mfi.validbox(), ng) & dest_domain;
+		if (!fbx.ok()) {
+			continue;
+		}
+		// temporary fine values for *all* children of the coarse cells that overlap fbx
+		const amrex::Box tbx = amrex::refine(amrex::coarsen(fbx, ratio), ratio);
+		amrex::FArrayBox tmpfab(tbx, nc, amrex::The_Async_Arena());
+
+		auto const &crse = crsemf.const_array(mfi, ccomp);
+		auto const &ho = tmpfab.array();
+		auto const &fine = finemf.array(mfi, fcomp);
+
+		// compute unlimited fourth-order fine values
+		amrex::ParallelFor(tbx, nc, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+			const int ic = amrex::coarsen(i, rr[0]);
+			const int jc = amrex::coarsen(j, rr[1]);
+			const int kc = amrex::coarsen(k, rr[2]);
+			const amrex::Real *wx = &weights[0][(i - ic * rr[0]) * stencilSize + stencilWidth];
+			const amrex::Real *wy = &weights[1][(j - jc * rr[1]) * stencilSize + stencilWidth];
+			const amrex::Real *wz = &weights[2][(k - kc * rr[2]) * stencilSize + stencilWidth];
+
+			amrex::Real sum = 0.;
+			for (int c = -sw[2]; c <= sw[2]; ++c) {
+				for (int b = -sw[1]; b <= sw[1]; ++b) {
+					for (int a = -sw[0]; a <= sw[0]; ++a) {
+						sum += wx[a] * wy[b] * wz[c] * crse(ic + a, jc + b, kc + c, n);
+					}
+				}
+			}
+			ho(i, j, k, n) = sum;
+		});
+
+		// limit the deviation of the fine values from the coarse value so that no new extrema are created
+		amrex::ParallelFor(fbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+			const int ic = amrex::coarsen(i, rr[0]);
+			const int jc = amrex::coarsen(j, rr[1]);
+			const int kc = amrex::coarsen(k, rr[2]);
+			const int nb_x = amrex::min(sw[0], 1);
+			const int nb_y = amrex::min(sw[1], 1);
+			const int nb_z = amrex::min(sw[2], 1);
+
+			amrex::Real theta = 1.0;
+			for (int n = 0; n < nc; ++n) {
+				const amrex::Real u0 = crse(ic, jc, kc, n);
+				amrex::Real umin = u0;
+				amrex::Real umax = u0;
+				for (int c = -nb_z; c <= nb_z; ++c) {
+					for (int b = -nb_y; b <= nb_y; ++b) {
+						for (int a = -nb_x; a <= nb_x; ++a) {
+							umin = amrex::min(umin, crse(ic + a, jc + b, kc + c, n));
+							umax = amrex::max(umax, crse(ic + a, jc + b, kc + c, n));
+						}
+					}
+				}
+				// loop over the children of the coarse cell
+				for (int kk = kc * rr[2]; kk < (kc + 1) * rr[2]; ++kk) {
+					for (int jj = jc * rr[1]; jj < (jc + 1) * rr[1]; ++jj) {
+						for (int ii = ic * rr[0]; ii < (ic + 1) * rr[0]; ++ii) {
+							const amrex::Real du = ho(ii, jj, kk, n) - u0;
+							if ((du > 0.) && (u0 + du > umax)) {
+								theta = amrex::min(theta, (umax - u0) / du);
+							} else if ((du < 0.) && (u0 + du < umin)) {
+								theta = amrex::min(theta, (umin - u0) / du);
+							}
+						}
+					}
+				}
+			}
+
+			for (int n = 0; n < nc; ++n) {
+				const amrex::Real u0 = crse(ic, jc, kc, n);
+				fine(i, j, k, n) = u0 + theta * (ho(i, j, k, n) - u0);
+			}
+		});
+	}
+}
+
+// global object (analogous to amrex::mf_linear_slope_minmax_interp)
+inline MFCellConsQuarticInterp mf_cell_cons_quartic_interp; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+} // namespace quokka
+
+#endif // MFCELLCONSQUARTICINTERP_HPP_
@@ -0,0 +1,243 @@
+#ifndef MULTIPOLEEXPANSION_HPP_ // NOLINT
+#define MULTIPOLEEXPANSION_HPP_
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file MultipoleExpansion.hpp
+/// \brief Computes the boundary values of the gravitational potential from a multipole expansion of the source.
+///
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+#include "AMReX_Algorithm.H"
+#include "AMReX_Array.H"
+#include "AMReX_BLassert.H"
+#include "AMReX_Box.H"
+#include "AMReX_Extension.H"
+#include "AMReX_Geometry.H"
+#include "AMReX_GpuQualifiers.H"
+#include "AMReX_IntVect.H"
+#include "AMReX_MultiFab.H"
+#include "AMReX_MultiFabUtil.H"
+#include "AMReX_ParReduce.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_REAL.H"
+#include "AMReX_Tuple.H"
+#include "AMReX_TypeList.H"
+#include "AMReX_Vector.H"
+#include "AMReX_iMultiFab.H"
+
+namespace quokka
+{
+
+// Multipole expansion of the solution of Laplacian(phi) = rhs with phi -> 0 at infinity:
+//   phi(x) = -1/(4 pi) sum_{l,m} (2 - delta_m0) (l-m)!/(l+m)! [Re R_lm(x) Re M_lm + Im R_lm(x) Im M_lm] / r^(2l+1),
+// where R_lm = r^l P_l^m(cos theta) exp(i m phi) are the regular solid harmonics and M_lm = int rhs R_lm dV are the moments.
+// The solid harmonics are computed from Cartesian coordinates with recurrence relations, so there are no coordinate singularities.
+// The expansion is valid outside of a sphere (centred on the expansion centre) that encloses the source, so it is used
+// to set Dirichlet boundary values for a Poisson solve on the domain. (This is only used in 3D.)
+class MultipoleExpansion
+{
+      public:
+	static constexpr int maxOrder = 12;
+	static constexpr int maxMoments = (maxOrder + 1) * (maxOrder + 2) / 2;
+	using moments_t = amrex::GpuArray<amrex::Real, 2 * maxMoments>; // real parts, followed by imaginary parts
+
+	AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE static auto index(int l, int m) -> int { return l * (l + 1) / 2 + m; }
+
+	// compute R_lm(x, y, z) for 0 <= m <= l <= order
+	AMREX_GPU_HOST_DEVICE static void solidHarmonics(int order, amrex::Real x, amrex::Real y, amrex::Real z, amrex::Real *re, amrex::Real *im);
+
+	// evaluate the potential at (x, y, z) relative to the expansion centre
+	AMREX_GPU_HOST_DEVICE static auto potential(moments_t const &moments, int order, amrex::Real x, amrex::Real y, amrex::Real z) -> amrex::Real;
+
+	// compute the moments of the composite (i.e., not covered by a finer level) rhs, using a single global reduction
+	static auto computeMoments(amrex::Vector<amrex::MultiFab> const &rhs, amrex::Vector<amrex::Geometry> const &geom,
+				   amrex::Vector<amrex::IntVect> const &ref_ratio, int order, amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &center)
+	    -> moments_t;
+
+	// set the ghost cells of phi outside the domain to the potential at the nearest point of the domain boundary
+	// (this is where the linear solver expects the Dirichlet boundary values)
+	static void fillBoundaryValues(amrex::MultiFab &phi, amrex::Geometry const &geom, moments_t const &moments, int order,
+				       amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &center);
+};
+
+AMREX_GPU_HOST_DEVICE inline void MultipoleExpansion::solidHarmonics(int order, amrex::Real x, amrex::Real y, amrex::Real z, amrex::Real *re,
+								     amrex::Real *im)
+{
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	const amrex::Real r2 = x * x + y * y + z * z;
+	re[0] = 1.0;
+	im[0] = 0.0;
+	for (int m = 0; m <= order; ++m) {
+		const int mm = index(m, m);
+		if (m > 0) {
+			// R_mm = (2m - 1) (x + i y) R_{m-1,m-1}
+			const int pm = index(m - 1, m - 1);
+			re[mm] = (2 * m - 1) * (x * re[pm] - y * im[pm]);
+			im[mm] = (2 * m - 1) * (x * im[pm] + y * re[pm]);
+		}
+		if (m < order) {
+			// R_{m+1,m} = (2m + 1) z R_mm
+			const int lm = index(m + 1, m);
+			re[lm] = (2 * m + 1) * z * re[mm];
+			im[lm] = (2 * m + 1) * z * im[mm];
+		}
+		for (int l = m + 2; l <= order; ++l) {
+			// R_lm = ((2l - 1) z R_{l-1,m} - (l + m - 1) r^2 R_{l-2,m}) / (l - m)
+			const int lm = index(l, m);
+			const int l1 = index(l - 1, m);
+			const int l2 = index(l - 2, m);
+			const amrex::Real inv = 1.0 / static_cast<amrex::Real>(l - m);
+			re[lm] = ((2 * l - 1) * z * re[l1] - (l + m - 1) * r2 * re[l2]) * inv;
+			im[lm] = ((2 * l - 1) * z * im[l1] - (l + m - 1) * r2 * im[l2]) * inv;
+		}
+	}
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+AMREX_GPU_HOST_DEVICE inline auto MultipoleExpansion::potential(moments_t const &moments, int order, amrex::Real x, amrex::Real y, amrex::Real z)
+    -> amrex::Real
+{
+	amrex::GpuArray<amrex::Real, maxMoments> re{};
+	amrex::GpuArray<amrex::Real, maxMoments> im{};
+	solidHarmonics(order, x, y, z, re.data(), im.data());
+
+	const amrex::Real r2 = x * x + y * y + z * z;
+	AMREX_ASSERT(r2 > 0.);
+	const amrex::Real inv_r = 1.0 / std::sqrt(r2);
+	amrex::Real inv_r_pow = inv_r; // 1/r^(2l+1)
+	amrex::Real phi = 0.;
+	for (int l = 0; l <= order; ++l) {
+		amrex::Real factorial_ratio = 1.0; // (l-m)!/(l+m)!
+		for (int m = 0; m <= l; ++m) {
+			if (m > 0) {
+				factorial_ratio /= static_cast<amrex::Real>((l + m) * (l - m + 1));
+			}
+			const int lm = index(l, m);
+			const amrex::Real weight = (m == 0) ? 1.0 : 2.0;
+			phi += weight * factorial_ratio * (re[lm] * moments[lm] + im[lm] * moments[maxMoments + lm]) * inv_r_pow;
+		}
+		inv_r_pow *= inv_r * inv_r;
+	}
+	return -phi / (4.0 * M_PI);
+}
+
+namespace detail
+{
+template <std::size_t> using MomentSumOp = amrex::ReduceOpSum;
+template <std::size_t> using MomentReal = amrex::Real;
+
+// sum q R_lm over the uncovered cells of this rank for the moments n0 <= n < min(n0 + sizeof...(Is), nMoments), with one ParReduce
+// (the real parts are the first sizeof...(Is) entries of the tuple, followed by the imaginary parts)
+template <std::size_t... Is>
+void reduceMomentChunk(amrex::MultiFab const &rhs, amrex::iMultiFab const &mask, amrex::Geometry const &geom, int order, int n0, int nMoments,
+		       amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &center, MultipoleExpansion::moments_t &moments,
+		       std::index_sequence<Is...> /*unused*/)
+{
+	constexpr int chunkSize = sizeof...(Is);
+	auto const &rhs_arr = rhs.const_arrays();
+	auto const &mask_arr = mask.const_arrays();
+	const auto dx = geom.CellSizeArray();
+	const auto prob_lo = geom.ProbLoArray();
+	const amrex::Real dV = AMREX_D_TERM(dx[0], *dx[1], *dx[2]);
+
+	auto result = amrex::ParReduce(amrex::TypeList<MomentSumOp<Is>..., MomentSumOp<Is>...>{}, amrex::TypeList<MomentReal<Is>..., MomentReal<Is>...>{},
+				       rhs, amrex::IntVect(0),
+				       [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) noexcept -> amrex::GpuTuple<MomentReal<Is>..., MomentReal<Is>...> {
+					       if (mask_arr[bx](i, j, k) != 0) {
+						       return {MomentReal<Is>(0.)..., MomentReal<Is>(0.)...};
+					       }
+					       const amrex::Real q = rhs_arr[bx](i, j, k) * dV;
+					       const amrex::Real x = prob_lo[0] + (i + 0.5) * dx[0] - center[0];
+					       const amrex::Real y = prob_lo[1] + (j + 0.5) * dx[1] - center[1];
+					       const amrex::Real z = prob_lo[2] + (k + 0.5) * dx[2] - center[2];
+					       amrex::GpuArray<amrex::Real, MultipoleExpansion::maxMoments> re{};
+					       amrex::GpuArray<amrex::Real, MultipoleExpansion::maxMoments> im{};
+					       MultipoleExpansion::solidHarmonics(order, x, y, z, re.data(), im.data());
+					       return {(((n0 + static_cast<int>(Is)) < nMoments) ? q * re[n0 + Is] : amrex::Real(0.))...,
+						       (((n0 + static_cast<int>(Is)) < nMoments) ? q * im[n0 + Is] : amrex::Real(0.))...};
+				       });
+
+	auto accumulate = [&](int n, amrex::Real re_sum, amrex::Real im_sum) {
+		if (n < nMoments) {
+			moments[n] += re_sum;
+			moments[MultipoleExpansion::maxMoments + n] += im_sum;
+		}
+	};
+	(accumulate(n0 + static_cast<int>(Is), amrex::get<Is>(result), amrex::get<chunkSize + Is>(result)), ...);
+}
+} // namespace detail
+
+inline auto MultipoleExpansion::computeMoments(amrex::Vector<amrex::MultiFab> const &rhs, amrex::Vector<amrex::Geometry> const &geom,
+					       amrex::Vector<amrex::IntVect> const &ref_ratio, int order,
+					       amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &center) -> moments_t
+{
+	BL_PROFILE("MultipoleExpansion::computeMoments()");
+	AMREX_ALWAYS_ASSERT_WITH_MESSAGE((order >= 0) && (order <= maxOrder), "The multipole order must be between 0 and 12!");
+
+	// the moments are reduced in chunks of a fixed number of moments, each with a single ParReduce (without atomics),
+	// since a tuple with all of the moments would be too large for a GPU kernel.
+	// each chunk only computes the solid harmonics up to the order of its last moment.
+	constexpr int chunkSize = 8;
+	const int nMoments = index(order, order) + 1;
+
+	moments_t moments{};
+	const int nlevels = static_cast<int>(rhs.size());
+
+	for (int lev = 0; lev < nlevels; ++lev) {
+		// exclude the cells that are covered by the next-finer level
+		amrex::iMultiFab mask;
+		if (lev < nlevels - 1) {
+			mask = amrex::makeFineMask(rhs[lev].boxArray(), rhs[lev].DistributionMap(), rhs[lev + 1].boxArray(), ref_ratio[lev]);
+		} else {
+			mask.define(rhs[lev].boxArray(), rhs[lev].DistributionMap(), 1, 0);
+			mask.setVal(0);
+		}
+
+		for (int n0 = 0; n0 < nMoments; n0 += chunkSize) {
+			const int nLast = std::min(n0 + chunkSize, nMoments) - 1;
+			int chunkOrder = 0;
+			while (index(chunkOrder, chunkOrder) < nLast) {
+				++chunkOrder;
+			}
+			detail::reduceMomentChunk(rhs[lev], mask, geom[lev], chunkOrder, n0, nMoments, center, moments,
+						  std::make_index_sequence<chunkSize>{});
+		}
+	}
+
+	// the moments of each rank are summed with a single global reduction
+	amrex::ParallelDescriptor::ReduceRealSum(moments.data(), 2 * maxMoments);
+	return moments;
+}
+
+inline void MultipoleExpansion::fillBoundaryValues(amrex::MultiFab &phi, amrex::Geometry const &geom, moments_t const &moments, int order,
+						   amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> const &center)
+{
+	BL_PROFILE("MultipoleExpansion::fillBoundaryValues()");
+
+	auto const &phi_arr = phi.arrays();
+	const amrex::Box domain = geom.Domain();
+	const auto dx = geom.CellSizeArray();
+	const auto prob_lo = geom.ProbLoArray();
+	const auto prob_hi = geom.ProbHiArray();
+
+	amrex::ParallelFor(phi, phi.nGrowVect(), [=] AMREX_GPU_DEVICE(int bx, int i, int j, int k) noexcept {
+		if (domain.contains(amrex::IntVect(AMREX_D_DECL(i, j, k)))) {
+			return;
+		}
+		const amrex::Real x = amrex::Clamp(prob_lo[0] + (i + 0.5) * dx[0], prob_lo[0], prob_hi[0]) - center[0];
+		const amrex::Real y = amrex::Clamp(prob_lo[1] + (j + 0.5) * dx[1], prob_lo[1], prob_hi[1]) - center[1];
+		const amrex::Real z = amrex::Clamp(prob_lo[2] + (k + 0.5) * dx[2], prob_lo[2], prob_hi[2]) - center[2];
+		phi_arr[bx](i, j, k) = potential(moments, order, x, y, z);
+	});
+}
+
+} // namespace quokka
+
+#endif // MULTIPOLEEXPANSION_HPP_
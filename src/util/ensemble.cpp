@@ -0,0 +1,258 @@
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file ensemble.cpp
+/// \brief Runs many independent simulations concurrently within a single MPI job.
+///
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "AMReX.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_Print.H"
+
+#include "fmt/format.h"
+#include "util/ensemble.hpp"
+
+namespace quokka
+{
+namespace
+{
+// abort the whole job with an error message
+// (AMReX is not initialized yet when the ensemble configuration is read, so amrex::Abort cannot be used)
+[[noreturn]] void ensembleAbort(std::string const &message)
+{
+	std::cerr << "[ensemble] " << message << "\n";
+#ifdef AMREX_USE_MPI
+	int mpiInitialized = 0;
+	MPI_Initialized(&mpiInitialized);
+	if (mpiInitialized != 0) {
+		MPI_Abort(MPI_COMM_WORLD, 1);
+	}
+#endif
+	std::exit(1); // NOLINT(concurrency-mt-unsafe)
+}
+
+auto trim(std::string const &str) -> std::string
+{
+	const auto first = str.find_first_not_of(" \t\r\n");
+	if (first == std::string::npos) {
+		return {};
+	}
+	const auto last = str.find_last_not_of(" \t\r\n");
+	return str.substr(first, last - first + 1);
+}
+
+// parse a 'key = value' definition (comments start with '#'); returns false if there is none
+auto parseDefinition(std::string const &line, std::string &key, std::string &value) -> bool
+{
+	const std::string stripped = trim(line.substr(0, line.find('#')));
+	const auto eq = stripped.find('=');
+	if (eq == std::string::npos) {
+		return false;
+	}
+	key = trim(stripped.substr(0, eq));
+	value = trim(stripped.substr(eq + 1));
+	return !key.empty();
+}
+
+void setEnsembleParameter(EnsembleConfig &config, std::string const &key, std::string const &value)
+{
+	if (key == "ensemble.num_members") {
+		std::size_t pos = 0;
+		try {
+			config.numMembers = std::stoi(value, &pos);
+		} catch (std::exception const &) {
+			pos = 0;
+		}
+		if ((pos == 0) || (pos != value.size()) || (config.numMembers < 0)) {
+			ensembleAbort("ensemble.num_members must be a non-negative integer (got '" + value + "')!");
+		}
+	} else if (key == "ensemble.overrides_file") {
+		config.overridesFile = value;
+	} else if (key == "ensemble.summary_file") {
+		config.summaryFile = value;
+	} else if (key == "ensemble.member_prefix") {
+		config.memberPrefix = value;
+	}
+}
+
+auto memberDirectory(EnsembleConfig const &config, int member) -> std::string { return fmt::format("{}{:04d}", config.memberPrefix, member); }
+} // namespace
+
+auto readEnsembleConfig(int argc, char **argv) -> EnsembleConfig
+{
+	EnsembleConfig config;
+	std::string key;
+	std::string value;
+
+	// parse the inputs file first...
+	if (argc > 1) {
+		std::ifstream inputs(argv[1]); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		for (std::string line; std::getline(inputs, line);) {
+			if (parseDefinition(line, key, value)) {
+				setEnsembleParameter(config, key, value);
+			}
+		}
+	}
+	// ...then the command line, so that it takes precedence (as for ParmParse)
+	for (int i = 2; i < argc; ++i) {
+		if (parseDefinition(argv[i], key, value)) { // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			setEnsembleParameter(config, key, value);
+		}
+	}
+
+	if ((config.numMembers > 0) && !config.overridesFile.empty()) {
+		// each non-empty line lists the 'key=value' overrides of one member
+		std::ifstream overrides(config.overridesFile);
+		if (!overrides) {
+			ensembleAbort("cannot open the overrides file " + config.overridesFile + "!");
+		}
+		for (std::string line; std::getline(overrides, line);) {
+			std::istringstream tokens(trim(line.substr(0, line.find('#'))));
+			std::vector<std::string> memberArgs;
+			for (std::string token; tokens >> token;) {
+				memberArgs.push_back(token);
+			}
+			if (!memberArgs.empty()) {
+				config.memberOverrides.push_back(memberArgs);
+			}
+		}
+		if (static_cast<int>(config.memberOverrides.size()) != config.numMembers) {
+			ensembleAbort(fmt::format("the overrides file {} has {} non-empty lines, but ensemble.num_members = {}!", config.overridesFile,
+						  config.memberOverrides.size(), config.numMembers));
+		}
+	}
+	return config;
+}
+
+auto runEnsemble(int argc, char **argv, EnsembleConfig const &config, std::function<void()> const &setParmParseDefaults,
+		 std::function<int()> const &memberMain) -> int
+{
+#ifdef AMREX_USE_MPI
+	int mpiInitialized = 0;
+	MPI_Initialized(&mpiInitialized);
+	if (mpiInitialized == 0) {
+		MPI_Init(&argc, &argv);
+	}
+
+	int worldRank = 0;
+	int worldSize = 1;
+	MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+	MPI_Comm_size(MPI_COMM_WORLD, &worldSize);
+
+	if ((config.numMembers > worldSize) || (worldSize % config.numMembers != 0)) {
+		if (worldRank == 0) {
+			std::cerr << "[ensemble] the number of MPI ranks (" << worldSize << ") must be a multiple of ensemble.num_members ("
+				  << config.numMembers << ")!\n";
+		}
+		MPI_Abort(MPI_COMM_WORLD, 1);
+	}
+
+	// assign a contiguous block of ranks to each member
+	const int ranksPerMember = worldSize / config.numMembers;
+	const int member = worldRank / ranksPerMember;
+	MPI_Comm memberComm = MPI_COMM_NULL;
+	MPI_Comm_split(MPI_COMM_WORLD, member, worldRank, &memberComm);
+
+	const std::string outputDir = memberDirectory(config, member);
+	if (worldRank % ranksPerMember == 0) {
+		std::filesystem::create_directories(outputDir);
+	}
+	MPI_Barrier(memberComm);
+
+	// build the command line of this member: the original arguments, followed by
+	// the output prefixes, followed by the member's own overrides (the last definition wins)
+	std::vector<std::string> memberArgs(argv, argv + argc); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	memberArgs.push_back("plotfile_prefix=" + outputDir + "/plt");
+	memberArgs.push_back("checkpoint_prefix=" + outputDir + "/chk");
+	memberArgs.push_back("statistics_file=" + outputDir + "/history.txt");
+	if (ranksPerMember == 1) {
+		// a failing single-rank member can be recorded without aborting the whole job
+		memberArgs.emplace_back("amrex.throw_exception=1");
+	}
+	if (member < static_cast<int>(config.memberOverrides.size())) {
+		for (auto const &arg : config.memberOverrides[member]) {
+			memberArgs.push_back(arg);
+		}
+	}
+	std::vector<char *> memberArgv;
+	memberArgv.reserve(memberArgs.size() + 1);
+	for (auto &arg : memberArgs) {
+		memberArgv.push_back(arg.data());
+	}
+	memberArgv.push_back(nullptr);
+	int memberArgc = static_cast<int>(memberArgs.size());
+	char **memberArgvPtr = memberArgv.data();
+
+	const double startTime = MPI_Wtime();
+	int result = 0;
+
+	// AMReX does not call MPI_Finalize when MPI was already initialized
+	amrex::Initialize(memberArgc, memberArgvPtr, true, memberComm, setParmParseDefaults, std::cout, std::cerr);
+	try {
+		result = memberMain();
+	} catch (std::exception const &e) {
+		std::cerr << "[ensemble] member " << member << " failed: " << e.what() << "\n";
+		result = 1;
+	}
+	amrex::Finalize();
+
+	const double elapsed = MPI_Wtime() - startTime;
+
+	// collect the outcome of every member on world rank 0
+	std::array<double, 2> outcome{static_cast<double>(result), elapsed};
+	std::vector<double> allOutcomes((worldRank == 0) ? 2 * worldSize : 0);
+	MPI_Gather(outcome.data(), 2, MPI_DOUBLE, allOutcomes.data(), 2, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+	int numFailed = 0;
+	if (worldRank == 0) {
+		std::ofstream summary(config.summaryFile);
+		summary << "# member  ranks  status  max_rank_result  elapsed_seconds  output_directory  overrides\n";
+		for (int m = 0; m < config.numMembers; ++m) {
+			int memberResult = 0;
+			double memberElapsed = 0.;
+			for (int r = m * ranksPerMember; r < (m + 1) * ranksPerMember; ++r) {
+				memberResult = std::max(memberResult, static_cast<int>(allOutcomes[2 * r]));
+				memberElapsed = std::max(memberElapsed, allOutcomes[2 * r + 1]);
+			}
+			std::string overrides;
+			if (m < static_cast<int>(config.memberOverrides.size())) {
+				for (auto const &arg : config.memberOverrides[m]) {
+					overrides += arg + " ";
+				}
+			}
+			const std::string status = (memberResult == 0) ? "success" : "FAILED";
+			numFailed += (memberResult == 0) ? 0 : 1;
+			summary << fmt::format("{}  {}  {}  {}  {:.3f}  {}  {}\n", m, ranksPerMember, status, memberResult, memberElapsed,
+					       memberDirectory(config, m), trim(overrides));
+		}
+		std::cout << "[ensemble] " << (config.numMembers - numFailed) << " of " << config.numMembers
+			  << " members succeeded. Summary written to " << config.summaryFile << "\n";
+	}
+	MPI_Bcast(&numFailed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+	MPI_Comm_free(&memberComm);
+	MPI_Finalize();
+	return (numFailed == 0) ? 0 : 1;
+#else
+	amrex::ignore_unused(argc, argv, config, setParmParseDefaults, memberMain);
+	std::cerr << "[ensemble] ensemble mode requires Quokka to be built with MPI!\n";
+	return 1;
+#endif // AMREX_USE_MPI
+}
+
+} // namespace quokka
@@ -0,0 +1,39 @@
+#ifndef ENSEMBLE_HPP_ // NOLINT
+#define ENSEMBLE_HPP_
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file ensemble.hpp
+/// \brief Runs many independent simulations concurrently within a single MPI job.
+///
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace quokka
+{
+
+struct EnsembleConfig {
+	int numMembers = 0;				       // number of ensemble members (0 == ensemble mode disabled)
+	std::string overridesFile{};			       // one line of 'key=value' runtime parameters per member
+	std::string summaryFile{"ensemble_summary.txt"};       // summary of the outcome of every member
+	std::string memberPrefix{"ensemble_member"};	       // output directory prefix for each member
+	std::vector<std::vector<std::string>> memberOverrides; // runtime parameter overrides for each member
+};
+
+// read the ensemble.* runtime parameters from the command line and the inputs file.
+// (this must happen *before* AMReX is initialized, since the communicator depends on them.)
+auto readEnsembleConfig(int argc, char **argv) -> EnsembleConfig;
+
+// split MPI_COMM_WORLD into one sub-communicator per member, initialize AMReX on each
+// sub-communicator with the member's parameter overrides, run memberMain() for each member
+// concurrently, and write a summary of the outcome of all members.
+auto runEnsemble(int argc, char **argv, EnsembleConfig const &config, std::function<void()> const &setParmParseDefaults,
+		 std::function<int()> const &memberMain) -> int;
+
+} // namespace quokka
+
+#endif // ENSEMBLE_HPP_
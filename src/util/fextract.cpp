@@ -1,166 +1,263 @@
-#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <tuple>
 
 #include "AMReX_Geometry.H"
+#include "AMReX_GpuContainers.H"
 #include "AMReX_MultiFab.H"
+#include "AMReX_RealVect.H"
 #include "AMReX_SPACE.H"
+#include "AMReX_iMultiFab.H"
 #include <AMReX.H>
 #include <AMReX_MultiFabUtil.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_PlotFileUtil.H>
 #include <AMReX_Print.H>
 
+#include "util/fextract.hpp"
+
 using namespace amrex; // NOLINT
 
-auto fextract(MultiFab &mf, Geometry &geom, const int idir, const Real slice_coord, const bool center = false)
-    -> std::tuple<Vector<Real>, Vector<Gpu::HostVector<Real>>>
+namespace
+{
+// Extract the cells of all levels that lie in the region where the coordinates
+// along the fixed (i.e., not free) directions equal those of 'point'. Only the finest
+// level covering each position is kept. Each record consists of the cell-center
+// coordinates along the free directions, followed by the values of the components in 'comps'.
+// The records are gathered onto the IO processor (with a single data gather) and
+// sorted by position, with the first free direction varying fastest.
+auto extractFinestRecords(const int nlevels, Vector<const MultiFab *> const &mf, Vector<Geometry> const &geom, Vector<IntVect> const &refRatio,
+			  Vector<int> const &freeDirs, RealVect const &point, Vector<int> const &comps) -> Vector<Real>
 {
-	AMREX_D_TERM(Real xcoord = slice_coord;, Real ycoord = slice_coord;, Real zcoord = slice_coord;)
+	BL_PROFILE("fextract::extractFinestRecords()");
 
-	GpuArray<Real, AMREX_SPACEDIM> problo = geom.ProbLoArray();
-	GpuArray<Real, AMREX_SPACEDIM> dx0 = geom.CellSizeArray();
-	Box probdom0 = geom.Domain();
-	const auto lo0 = amrex::lbound(probdom0);
-	const auto hi0 = amrex::ubound(probdom0);
+	const int nfree = static_cast<int>(freeDirs.size());
+	const int ncomp = static_cast<int>(comps.size());
+	const int recordSize = nfree + ncomp;
+	Vector<Real> records;
 
-	// compute the index of the center or lower left of the domain on the
-	// coarse grid.  These are used to set the position of the slice in
-	// the transverse direction.
+	Gpu::DeviceVector<int> d_comps(ncomp);
+	Gpu::copy(Gpu::hostToDevice, comps.begin(), comps.end(), d_comps.begin());
+	const int *p_comps = d_comps.data();
 
-	AMREX_D_TERM(int iloc = 0;, int jloc = 0;, int kloc = 0;)
-	if (center) {
-		AMREX_D_TERM(iloc = (hi0.x - lo0.x + 1) / 2 + lo0.x;, jloc = (hi0.y - lo0.y + 1) / 2 + lo0.y;, kloc = (hi0.z - lo0.z + 1) / 2 + lo0.z;)
-	}
+	for (int lev = 0; lev < nlevels; ++lev) {
+		const auto problo = geom[lev].ProbLoArray();
+		const auto dx = geom[lev].CellSizeArray();
+		const Box &domain = geom[lev].Domain();
 
-	if (idir == 0) {
-		// we specified the x value to pass through
-		iloc = hi0.x;
-		for (int i = lo0.x; i <= hi0.x; ++i) {
-			amrex::Real xc = problo[0] + (i + 0.5) * dx0[0];
-			if (xc > xcoord) {
-				iloc = i;
-				break;
+		// restrict the region to a single cell along each fixed direction
+		Box region = domain;
+		for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+			if (std::find(freeDirs.begin(), freeDirs.end(), idim) == freeDirs.end()) {
+				int iloc = static_cast<int>(std::floor((point[idim] - problo[idim]) / dx[idim]));
+				iloc = std::clamp(iloc, domain.smallEnd(idim), domain.bigEnd(idim));
+				region.setRange(idim, iloc);
 			}
 		}
-	}
 
-#if AMREX_SPACEDIM >= 2
-	if (idir == 1) {
-		// we specified the y value to pass through
-		jloc = hi0.y;
-		for (int j = lo0.y; j <= hi0.y; ++j) {
-			amrex::Real yc = problo[1] + (j + 0.5) * dx0[1];
-			if (yc > ycoord) {
-				jloc = j;
-				break;
+		// flag cells that are covered by the next finer level
+		const bool hasFinerLevel = (lev < nlevels - 1);
+		iMultiFab fineMask;
+		if (hasFinerLevel) {
+			fineMask = makeFineMask(*mf[lev], mf[lev + 1]->boxArray(), refRatio[lev]);
+		}
+
+		for (MFIter mfi(*mf[lev]); mfi.isValid(); ++mfi) {
+			const Box bx = mfi.validbox() & region;
+			if (!bx.ok()) {
+				continue;
+			}
+			const auto npts = bx.numPts();
+
+			// copy only the cells in the region into a contiguous buffer
+			Gpu::DeviceVector<Real> d_values(npts * ncomp);
+			Gpu::DeviceVector<int> d_covered(npts, 0);
+			Real *p_values = d_values.data();
+			int *p_covered = d_covered.data();
+			auto const &fab = mf[lev]->const_array(mfi);
+			auto const &mask = hasFinerLevel ? fineMask.const_array(mfi) : Array4<int const>{};
+
+			ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
+				const auto n = bx.index(IntVect(AMREX_D_DECL(i, j, k)));
+				for (int c = 0; c < ncomp; ++c) {
+					p_values[n * ncomp + c] = fab(i, j, k, p_comps[c]); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				}
+				if (hasFinerLevel) {
+					p_covered[n] = mask(i, j, k); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+				}
+			});
+
+			Vector<Real> values(npts * ncomp);
+			Vector<int> covered(npts);
+			Gpu::copy(Gpu::deviceToHost, d_values.begin(), d_values.end(), values.begin());
+			Gpu::copy(Gpu::deviceToHost, d_covered.begin(), d_covered.end(), covered.begin());
+
+			for (Long n = 0; n < npts; ++n) {
+				if (covered[n] != 0) {
+					continue;
+				}
+				const IntVect iv = bx.atOffset(n);
+				for (int idir : freeDirs) {
+					records.push_back(problo[idir] + (iv[idir] + 0.5) * dx[idir]);
+				}
+				for (int c = 0; c < ncomp; ++c) {
+					records.push_back(values[n * ncomp + c]);
+				}
 			}
 		}
 	}
-#endif
-
-#if AMREX_SPACEDIM == 3
-	if (idir == 2) {
-		// we specified the z value to pass through
-		kloc = hi0.z;
-		for (int k = lo0.z; k <= hi0.z; ++k) {
-			amrex::Real zc = problo[2] + (k + 0.5) * dx0[2];
-			if (zc > zcoord) {
-				kloc = k;
-				break;
+
+#ifdef AMREX_USE_MPI
+	{
+		const int nlocal = static_cast<int>(records.size());
+		const int ioproc = ParallelDescriptor::IOProcessorNumber();
+		auto nlocal_vec = ParallelDescriptor::Gather(nlocal, ioproc);
+		Vector<int> recvcnt(1, 0);
+		Vector<int> disp(1, 0);
+		Vector<Real> allrecords(1);
+		if (ParallelDescriptor::IOProcessor()) {
+			const int nprocs = static_cast<int>(nlocal_vec.size());
+			recvcnt = nlocal_vec;
+			disp.resize(nprocs);
+			std::exclusive_scan(recvcnt.begin(), recvcnt.end(), disp.begin(), 0);
+			allrecords.resize(std::accumulate(recvcnt.begin(), recvcnt.end(), 0));
+		}
+		ParallelDescriptor::Gatherv(records.data(), nlocal, allrecords.data(), recvcnt, disp, ioproc);
+		if (ParallelDescriptor::IOProcessor()) {
+			records = std::move(allrecords);
+		} else {
+			records.clear();
+		}
+	}
+#endif // AMREX_USE_MPI
+
+	// sort records by position (the last free direction is the slowest-varying)
+	const Long nrecords = static_cast<Long>(records.size()) / recordSize;
+	Vector<Long> order(nrecords);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](Long a, Long b) {
+		for (int d = nfree - 1; d >= 0; --d) {
+			const Real xa = records[a * recordSize + d];
+			const Real xb = records[b * recordSize + d];
+			if (xa != xb) {
+				return xa < xb;
 			}
 		}
+		return false;
+	});
+
+	Vector<Real> sorted(records.size());
+	for (Long r = 0; r < nrecords; ++r) {
+		std::copy_n(records.begin() + order[r] * recordSize, recordSize, sorted.begin() + r * recordSize);
+	}
+	return sorted;
+}
+
+auto allComponentsIfEmpty(Vector<int> const &comps, const int ncomp) -> Vector<int>
+{
+	if (!comps.empty()) {
+		return comps;
 	}
-#endif
+	Vector<int> allcomps(ncomp);
+	std::iota(allcomps.begin(), allcomps.end(), 0);
+	return allcomps;
+}
+} // namespace
 
+auto fextract(const int nlevels, Vector<const MultiFab *> const &mf, Vector<Geometry> const &geom, Vector<IntVect> const &refRatio, const int idir,
+	      RealVect const &point, Vector<int> const &comps) -> std::tuple<Vector<Real>, Vector<Gpu::HostVector<Real>>>
+{
 	if (idir < 0 || idir >= AMREX_SPACEDIM) {
 		amrex::Abort("invalid direction!");
 	}
+	AMREX_ALWAYS_ASSERT(nlevels >= 1 && nlevels <= static_cast<int>(mf.size()));
 
-	const IntVect ivloc{AMREX_D_DECL(iloc, jloc, kloc)};
-
-	Vector<Real> pos;
-	Vector<Gpu::HostVector<Real>> data(mf.nComp());
+	const Vector<int> extractComps = allComponentsIfEmpty(comps, mf[0]->nComp());
+	const int ncomp = static_cast<int>(extractComps.size());
+	const int recordSize = 1 + ncomp;
 
-	IntVect rr{1};
-	Box slice_box(ivloc * rr, ivloc * rr);
-	slice_box.setSmall(idir, std::numeric_limits<int>::lowest());
-	slice_box.setBig(idir, std::numeric_limits<int>::max());
+	const Vector<Real> records = extractFinestRecords(nlevels, mf, geom, refRatio, {idir}, point, extractComps);
+	const Long nrecords = static_cast<Long>(records.size()) / recordSize;
 
-	GpuArray<Real, AMREX_SPACEDIM> dx = dx0;
-
-	// compute position coordinates
-	for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-		const Box &bx = mfi.validbox() & slice_box;
-		if (bx.ok()) {
-			amrex::LoopOnCpu(bx, [problo, dx, idir, &pos](int i, int j, int k) {
-				Array<Real, AMREX_SPACEDIM> p = {AMREX_D_DECL(problo[0] + static_cast<Real>(i + 0.5) * dx[0],
-									      problo[1] + static_cast<Real>(j + 0.5) * dx[1],
-									      problo[2] + static_cast<Real>(k + 0.5) * dx[2])};
-				pos.push_back(p[idir]);
-			});
+	Vector<Real> pos(nrecords);
+	Vector<Gpu::HostVector<Real>> data(ncomp);
+	for (auto &v : data) {
+		v.resize(nrecords);
+	}
+	for (Long r = 0; r < nrecords; ++r) {
+		pos[r] = records[r * recordSize];
+		for (int c = 0; c < ncomp; ++c) {
+			data[c][r] = records[r * recordSize + 1 + c];
 		}
 	}
+	return std::make_tuple(pos, data);
+}
 
-	for (int ivar = 0; ivar < mf.nComp(); ++ivar) {
-		// allocate HostVector storage
-		data[ivar].resize(pos.size());
-		const auto &dataptr = data[ivar].data();
-		for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-			const Box &bx = mfi.validbox() & slice_box;
-			if (bx.ok()) {
-				const auto &fab = mf.array(mfi);
-				ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) {
-					GpuArray<int, 3> idx_vec({i - lo0.x, j - lo0.y, k - lo0.z});
-					int idx = idx_vec[idir];
-					dataptr[idx] = fab(i, j, k, ivar); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-				});
-			}
+auto fextract_slice(const int nlevels, Vector<const MultiFab *> const &mf, Vector<Geometry> const &geom, Vector<IntVect> const &refRatio,
+		    const int normal_dir, const Real slice_coord, Vector<int> const &comps)
+    -> std::tuple<Vector<Real>, Vector<Real>, Vector<Gpu::HostVector<Real>>>
+{
+	if (normal_dir < 0 || normal_dir >= AMREX_SPACEDIM) {
+		amrex::Abort("invalid direction!");
+	}
+	AMREX_ALWAYS_ASSERT(nlevels >= 1 && nlevels <= static_cast<int>(mf.size()));
+
+	Vector<int> freeDirs;
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		if (idim != normal_dir) {
+			freeDirs.push_back(idim);
 		}
 	}
+	RealVect point(AMREX_D_DECL(0., 0., 0.));
+	point[normal_dir] = slice_coord;
 
-#ifdef AMREX_USE_MPI
-	{
-		const int numpts = static_cast<int>(pos.size());
-		auto numpts_vec = ParallelDescriptor::Gather(numpts, ParallelDescriptor::IOProcessorNumber());
-		Vector<int> recvcnt;
-		Vector<int> disp;
-		Vector<Real> allpos;
-		Vector<Gpu::HostVector<Real>> alldata(data.size());
-		if (ParallelDescriptor::IOProcessor()) {
-			recvcnt.resize(numpts_vec.size());
-			disp.resize(numpts_vec.size());
-			int ntot = 0;
-			disp[0] = 0;
-			for (int i = 0, N = static_cast<int>(numpts_vec.size()); i < N; ++i) {
-				ntot += numpts_vec[i];
-				recvcnt[i] = numpts_vec[i];
-				if (i + 1 < N) {
-					disp[i + 1] = disp[i] + numpts_vec[i];
-				}
-			}
-			allpos.resize(ntot);
-			alldata.resize(data.size());
-			for (auto &v : alldata) {
-				v.resize(ntot);
-			}
-		} else {
-			recvcnt.resize(1);
-			disp.resize(1);
-			allpos.resize(1);
-			for (auto &v : alldata) {
-				v.resize(1);
-			}
+	const Vector<int> extractComps = allComponentsIfEmpty(comps, mf[0]->nComp());
+	const int nfree = static_cast<int>(freeDirs.size());
+	const int ncomp = static_cast<int>(extractComps.size());
+	const int recordSize = nfree + ncomp;
+
+	const Vector<Real> records = extractFinestRecords(nlevels, mf, geom, refRatio, freeDirs, point, extractComps);
+	const Long nrecords = static_cast<Long>(records.size()) / recordSize;
+
+	// in 2D, the 'plane' is a line and the second coordinate is left empty
+	Vector<Real> pos0(nrecords);
+	Vector<Real> pos1((nfree > 1) ? nrecords : 0);
+	Vector<Gpu::HostVector<Real>> data(ncomp);
+	for (auto &v : data) {
+		v.resize(nrecords);
+	}
+	for (Long r = 0; r < nrecords; ++r) {
+		pos0[r] = records[r * recordSize];
+		if (nfree > 1) {
+			pos1[r] = records[r * recordSize + 1];
 		}
-		ParallelDescriptor::Gatherv(pos.data(), numpts, allpos.data(), recvcnt, disp, ParallelDescriptor::IOProcessorNumber());
-		for (int i = 0; i < data.size(); ++i) {
-			ParallelDescriptor::Gatherv(data[i].data(), numpts, alldata[i].data(), recvcnt, disp, ParallelDescriptor::IOProcessorNumber());
+		for (int c = 0; c < ncomp; ++c) {
+			data[c][r] = records[r * recordSize + nfree + c];
 		}
-		if (ParallelDescriptor::IOProcessor()) {
-			pos = std::move(allpos);
-			data = std::move(alldata);
+	}
+	return std::make_tuple(pos0, pos1, data);
+}
+
+auto fextract(MultiFab &mf, Geometry &geom, const int idir, const Real slice_coord, const bool center)
+    -> std::tuple<Vector<Real>, Vector<Gpu::HostVector<Real>>>
+{
+	// the line is placed along the lower-left cells of the domain (or through the center cell if center == true);
+	// slice_coord only selects a position along idir and therefore does not affect the result
+	amrex::ignore_unused(slice_coord);
+
+	const auto problo = geom.ProbLoArray();
+	const auto dx = geom.CellSizeArray();
+	const Box &domain = geom.Domain();
+
+	RealVect point(AMREX_D_DECL(0., 0., 0.));
+	for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+		int iloc = domain.smallEnd(idim);
+		if (center) {
+			iloc = (domain.bigEnd(idim) - domain.smallEnd(idim) + 1) / 2 + domain.smallEnd(idim);
 		}
+		point[idim] = problo[idim] + (iloc + 0.5) * dx[idim];
 	}
-#endif // AMREX_USE_MPI
 
-	return std::make_tuple(pos, data);
+	return fextract(1, {&mf}, {geom}, {}, idir, point);
 }
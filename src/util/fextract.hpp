@@ -3,13 +3,32 @@
 
 #include "AMReX_Geometry.H"
 #include "AMReX_MultiFab.H"
+#include "AMReX_RealVect.H"
 #include <AMReX.H>
 #include <AMReX_MultiFabUtil.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_PlotFileUtil.H>
 #include <AMReX_Print.H>
 
+// extract a line of cells parallel to direction idir from a single level
+// (passing through the lower-left corner of the domain, or its center if center == true)
 auto fextract(amrex::MultiFab &mf, amrex::Geometry &geom, int idir, amrex::Real slice_coord, bool center = false)
     -> std::tuple<amrex::Vector<amrex::Real>, amrex::Vector<amrex::Gpu::HostVector<amrex::Real>>>;
 
-#endif // FEXTRACT_HPP_
\ No newline at end of file
+// extract a line of cells parallel to direction idir that passes through 'point',
+// using the finest available AMR data at each position along the line.
+// the components in 'comps' are extracted (all components if empty).
+// the result is gathered onto the IO processor and sorted by position.
+auto fextract(int nlevels, amrex::Vector<const amrex::MultiFab *> const &mf, amrex::Vector<amrex::Geometry> const &geom,
+	      amrex::Vector<amrex::IntVect> const &refRatio, int idir, amrex::RealVect const &point, amrex::Vector<int> const &comps = {})
+    -> std::tuple<amrex::Vector<amrex::Real>, amrex::Vector<amrex::Gpu::HostVector<amrex::Real>>>;
+
+// extract a plane of cells normal to direction normal_dir at the coordinate slice_coord,
+// using the finest available AMR data at each position in the plane.
+// returns the two in-plane coordinates of each cell (in increasing order of direction index)
+// and the extracted components, gathered onto the IO processor and sorted by position.
+auto fextract_slice(int nlevels, amrex::Vector<const amrex::MultiFab *> const &mf, amrex::Vector<amrex::Geometry> const &geom,
+		    amrex::Vector<amrex::IntVect> const &refRatio, int normal_dir, amrex::Real slice_coord, amrex::Vector<int> const &comps = {})
+    -> std::tuple<amrex::Vector<amrex::Real>, amrex::Vector<amrex::Real>, amrex::Vector<amrex::Gpu::HostVector<amrex::Real>>>;
+
+#endif // FEXTRACT_HPP_
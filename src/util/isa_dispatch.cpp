@@ -0,0 +1,195 @@
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file isa_dispatch.cpp
+/// \brief Selects the executable built for the best instruction set supported by the CPU at runtime.
+///
+
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+#if defined(__linux__) && defined(__aarch64__)
+#include <sys/auxv.h>
+#endif
+
+#include "AMReX_Print.H"
+
+#include "fmt/format.h"
+#include "util/isa_dispatch.hpp"
+
+namespace quokka
+{
+namespace
+{
+// environment variable that is set before re-executing, so that the variant does not dispatch again
+constexpr const char *dispatchedEnvVar = "QUOKKA_ISA_DISPATCHED";
+
+auto splitVariants(std::string const &list) -> std::vector<std::string>
+{
+	std::vector<std::string> variants;
+	std::istringstream stream(list);
+	std::string variant;
+	while (std::getline(stream, variant, ',')) {
+		if (!variant.empty()) {
+			variants.push_back(variant);
+		}
+	}
+	return variants;
+}
+
+// the rank of each variant: a variant is more capable than all variants of the same architecture with a lower rank
+// (the variants are chosen by this ranking, not by their order in QUOKKA_ISA_VARIANTS)
+auto isaRank(std::string const &isa) -> int
+{
+	if (isa == "x86-64-v2" || isa == "sve") {
+		return 1;
+	}
+	if (isa == "x86-64-v3" || isa == "sve2") {
+		return 2;
+	}
+	if (isa == "x86-64-v4") {
+		return 3;
+	}
+	return 0;
+}
+
+auto configuredVariants() -> std::vector<std::string>
+{
+#ifdef QUOKKA_ISA_VARIANTS
+	return splitVariants(QUOKKA_ISA_VARIANTS);
+#else
+	return {};
+#endif
+}
+} // namespace
+
+auto cpuSupportsIsa(std::string const &isa) -> bool
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+	__builtin_cpu_init();
+	const bool v2 = __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+	const bool v3 = v2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("bmi2");
+	const bool v4 = v3 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512cd") &&
+			__builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl");
+	if (isa == "x86-64-v2") {
+		return v2;
+	}
+	if (isa == "x86-64-v3") {
+		return v3;
+	}
+	if (isa == "x86-64-v4") {
+		return v4;
+	}
+#elif defined(__linux__) && defined(__aarch64__)
+	const unsigned long hwcap = getauxval(AT_HWCAP);
+#ifdef HWCAP_SVE
+	const bool sve = (hwcap & HWCAP_SVE) != 0;
+#else
+	const bool sve = false;
+	(void)hwcap;
+#endif
+#ifdef HWCAP2_SVE2
+	const bool sve2 = sve && ((getauxval(AT_HWCAP2) & HWCAP2_SVE2) != 0);
+#else
+	const bool sve2 = false;
+#endif
+	if (isa == "sve") {
+		return sve;
+	}
+	if (isa == "sve2") {
+		return sve2;
+	}
+#endif
+	(void)isa;
+	return false;
+}
+
+void dispatchToBestIsa(int argc, char **argv)
+{
+	const std::vector<std::string> variants = configuredVariants();
+	if (variants.empty() || (std::getenv(dispatchedEnvVar) != nullptr) || (argc < 1)) { // NOLINT(concurrency-mt-unsafe)
+		return;
+	}
+
+	// choose the variant: the most capable variant supported by the CPU, unless overridden
+	std::string chosen = "baseline";
+	const char *isa_env = std::getenv("QUOKKA_ISA"); // NOLINT(concurrency-mt-unsafe)
+	if (isa_env != nullptr) {
+		chosen = isa_env;
+		if (chosen != "baseline" && !cpuSupportsIsa(chosen)) {
+			std::cerr << fmt::format("[quokka] QUOKKA_ISA={} is not supported by this CPU! Using the baseline executable.\n", chosen);
+			chosen = "baseline";
+		}
+	} else {
+		int chosenRank = 0;
+		for (auto const &variant : variants) {
+			if ((isaRank(variant) > chosenRank) && cpuSupportsIsa(variant)) {
+				chosen = variant;
+				chosenRank = isaRank(variant);
+			}
+		}
+	}
+	if (chosen == "baseline") {
+		return;
+	}
+
+#if defined(__linux__) && defined(QUOKKA_BINARY_DIR)
+	// the variant executable has the same path relative to <build dir>/isa/<variant> as this executable has relative to the build dir
+	std::error_code ec;
+	const std::filesystem::path self = std::filesystem::canonical("/proc/self/exe", ec);
+	if (ec) {
+		return;
+	}
+	const std::filesystem::path binary_dir = std::filesystem::weakly_canonical(QUOKKA_BINARY_DIR, ec);
+	if (ec) {
+		return;
+	}
+	const std::filesystem::path relative = self.lexically_relative(binary_dir);
+	if (relative.empty() || (*relative.begin() == "..")) {
+		return; // not inside the build directory (e.g., the executable has been copied elsewhere)
+	}
+	const std::filesystem::path target = binary_dir / "isa" / chosen / relative;
+	if (!std::filesystem::exists(target, ec)) {
+		std::cerr << fmt::format("[quokka] the {} variant of this executable ({}) has not been built! Using the baseline executable.\n", chosen,
+					 target.string());
+		return;
+	}
+
+	setenv(dispatchedEnvVar, chosen.c_str(), 1); // NOLINT(concurrency-mt-unsafe)
+	execv(target.c_str(), argv);		     // NOLINT(cppcoreguidelines-pro-type-vararg)
+	// execv only returns if it fails
+	std::cerr << fmt::format("[quokka] failed to execute {}! Using the baseline executable.\n", target.string());
+	unsetenv(dispatchedEnvVar); // NOLINT(concurrency-mt-unsafe)
+#endif
+}
+
+auto isaVariantName() -> std::string
+{
+#ifdef QUOKKA_ISA_NAME
+	return QUOKKA_ISA_NAME;
+#else
+	return "baseline";
+#endif
+}
+
+void reportIsaVariant()
+{
+	const std::vector<std::string> variants = configuredVariants();
+	if (variants.empty() && isaVariantName() == "baseline") {
+		return; // dispatch is not enabled
+	}
+	// all of the compute kernels (hydro, radiation, chemistry, cooling, ...) are compiled into this executable, so they use the same ISA
+	amrex::Print() << fmt::format("Runtime ISA dispatch: all compute kernels use the {} instruction set.\n", isaVariantName());
+}
+
+} // namespace quokka
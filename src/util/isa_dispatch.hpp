@@ -0,0 +1,34 @@
+#ifndef ISA_DISPATCH_HPP_ // NOLINT
+#define ISA_DISPATCH_HPP_
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file isa_dispatch.hpp
+/// \brief Selects the executable built for the best instruction set supported by the CPU at runtime.
+///
+
+#include <string>
+
+namespace quokka
+{
+
+// returns true if the CPU we are running on supports the given ISA variant (x86-64-v2, x86-64-v3, x86-64-v4, sve, sve2)
+auto cpuSupportsIsa(std::string const &isa) -> bool;
+
+// if this executable was configured with QUOKKA_ISA_VARIANTS, re-execute the variant of this executable built for the
+// best instruction set that the CPU supports. the choice can be overridden with the environment variable QUOKKA_ISA.
+// (this must be called at the start of main(), before MPI and AMReX are initialized. it only returns if this executable
+// is the best choice or if the variant cannot be executed.)
+void dispatchToBestIsa(int argc, char **argv);
+
+// returns the name of the instruction set this executable was compiled for ('baseline' for the default build)
+auto isaVariantName() -> std::string;
+
+// print the instruction set used by all of the compute kernels (must be called after AMReX is initialized)
+void reportIsaVariant();
+
+} // namespace quokka
+
+#endif // ISA_DISPATCH_HPP_
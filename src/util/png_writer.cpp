@@ -0,0 +1,278 @@
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file png_writer.cpp
+/// \brief A minimal, dependency-free PNG encoder (8-bit RGB, fixed-Huffman deflate).
+///
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "util/png_writer.hpp"
+
+namespace quokka
+{
+namespace
+{
+
+// the deflate stream is compressed with greedy LZ77 matching and the fixed Huffman codes (RFC 1951, Sec. 3.2.6).
+// this is much simpler than a full deflate implementation, and it compresses colormapped images (which have large
+// regions of identical or slowly-varying pixels) nearly as well.
+constexpr int windowSize = 32768;
+constexpr int minMatch = 3;
+constexpr int maxMatch = 258;
+constexpr int maxChainLength = 32; // maximum number of earlier positions searched for a match
+constexpr int hashBits = 15;
+
+constexpr std::array<int, 29> lengthBase{3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<int, 29> lengthExtraBits{0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr std::array<int, 30> distBase{1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+				       193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr std::array<int, 30> distExtraBits{0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+class BitWriter
+{
+      public:
+	explicit BitWriter(std::vector<std::uint8_t> &out) : out_(out) {}
+
+	// write the lowest 'nbits' bits of 'value', least-significant bit first
+	void writeBits(std::uint32_t value, int nbits)
+	{
+		buffer_ |= static_cast<std::uint64_t>(value) << count_;
+		count_ += nbits;
+		while (count_ >= 8) {
+			out_.push_back(static_cast<std::uint8_t>(buffer_ & 0xFFU));
+			buffer_ >>= 8;
+			count_ -= 8;
+		}
+	}
+
+	// write a Huffman code, most-significant bit first
+	void writeCode(std::uint32_t code, int nbits)
+	{
+		std::uint32_t reversed = 0;
+		for (int i = 0; i < nbits; ++i) {
+			reversed = (reversed << 1U) | ((code >> i) & 1U);
+		}
+		writeBits(reversed, nbits);
+	}
+
+	void flush()
+	{
+		if (count_ > 0) {
+			out_.push_back(static_cast<std::uint8_t>(buffer_ & 0xFFU));
+		}
+		buffer_ = 0;
+		count_ = 0;
+	}
+
+      private:
+	std::vector<std::uint8_t> &out_;
+	std::uint64_t buffer_{0};
+	int count_{0};
+};
+
+void writeLiteralOrLength(BitWriter &bits, int symbol)
+{
+	if (symbol < 144) {
+		bits.writeCode(0x30 + symbol, 8);
+	} else if (symbol < 256) {
+		bits.writeCode(0x190 + (symbol - 144), 9);
+	} else if (symbol < 280) {
+		bits.writeCode(symbol - 256, 7);
+	} else {
+		bits.writeCode(0xC0 + (symbol - 280), 8);
+	}
+}
+
+void writeMatch(BitWriter &bits, int length, int distance)
+{
+	int lcode = 0;
+	while (lcode + 1 < static_cast<int>(lengthBase.size()) && lengthBase[lcode + 1] <= length) {
+		++lcode;
+	}
+	writeLiteralOrLength(bits, 257 + lcode);
+	bits.writeBits(length - lengthBase[lcode], lengthExtraBits[lcode]);
+
+	int dcode = 0;
+	while (dcode + 1 < static_cast<int>(distBase.size()) && distBase[dcode + 1] <= distance) {
+		++dcode;
+	}
+	bits.writeCode(dcode, 5);
+	bits.writeBits(distance - distBase[dcode], distExtraBits[dcode]);
+}
+
+auto hash3(std::uint8_t const *p) -> std::uint32_t
+{
+	const std::uint32_t v = (static_cast<std::uint32_t>(p[0]) << 16U) | (static_cast<std::uint32_t>(p[1]) << 8U) | p[2]; // NOLINT
+	return (v * 2654435761U) >> (32 - hashBits);
+}
+
+// returns a zlib stream (RFC 1950) containing the data compressed as a single fixed-Huffman deflate block
+auto zlibCompress(std::vector<std::uint8_t> const &data) -> std::vector<std::uint8_t>
+{
+	std::vector<std::uint8_t> out;
+	out.reserve(data.size() / 4 + 64);
+	out.push_back(0x78); // deflate with a 32 kB window
+	out.push_back(0x01); // no preset dictionary, fastest compression level
+
+	BitWriter bits(out);
+	bits.writeBits(1, 1); // final block
+	bits.writeBits(1, 2); // fixed Huffman codes
+
+	const int n = static_cast<int>(data.size());
+	std::vector<int> head(std::size_t{1} << hashBits, -1);
+	std::vector<int> prev(windowSize, -1);
+	auto insert = [&](int pos) {
+		if (pos + minMatch <= n) {
+			const std::uint32_t h = hash3(&data[pos]);
+			prev[pos % windowSize] = head[h];
+			head[h] = pos;
+		}
+	};
+
+	int pos = 0;
+	while (pos < n) {
+		int bestLength = 0;
+		int bestDistance = 0;
+		if (pos + minMatch <= n) {
+			const int maxLength = std::min(maxMatch, n - pos);
+			int candidate = head[hash3(&data[pos])];
+			for (int chain = 0; chain < maxChainLength && candidate >= 0 && pos - candidate <= windowSize; ++chain) {
+				int length = 0;
+				while (length < maxLength && data[candidate + length] == data[pos + length]) {
+					++length;
+				}
+				if (length > bestLength) {
+					bestLength = length;
+					bestDistance = pos - candidate;
+					if (length == maxLength) {
+						break;
+					}
+				}
+				const int next = prev[candidate % windowSize];
+				if (next >= candidate) {
+					break; // the slot has been overwritten by a newer position
+				}
+				candidate = next;
+			}
+		}
+
+		if (bestLength >= minMatch) {
+			writeMatch(bits, bestLength, bestDistance);
+			for (int i = 0; i < bestLength; ++i) {
+				insert(pos + i);
+			}
+			pos += bestLength;
+		} else {
+			writeLiteralOrLength(bits, data[pos]);
+			insert(pos);
+			++pos;
+		}
+	}
+	writeLiteralOrLength(bits, 256); // end of block
+	bits.flush();
+
+	// Adler-32 checksum of the uncompressed data
+	std::uint32_t a = 1;
+	std::uint32_t b = 0;
+	for (const std::uint8_t byte : data) {
+		a = (a + byte) % 65521U;
+		b = (b + a) % 65521U;
+	}
+	const std::uint32_t adler = (b << 16U) | a;
+	for (int shift = 24; shift >= 0; shift -= 8) {
+		out.push_back(static_cast<std::uint8_t>((adler >> shift) & 0xFFU));
+	}
+	return out;
+}
+
+auto crc32(std::uint8_t const *data, std::size_t size, std::uint32_t crc = 0xFFFFFFFFU) -> std::uint32_t
+{
+	static const std::array<std::uint32_t, 256> table = [] {
+		std::array<std::uint32_t, 256> t{};
+		for (std::uint32_t i = 0; i < 256; ++i) {
+			std::uint32_t c = i;
+			for (int k = 0; k < 8; ++k) {
+				c = ((c & 1U) != 0U) ? (0xEDB88320U ^ (c >> 1U)) : (c >> 1U);
+			}
+			t[i] = c;
+		}
+		return t;
+	}();
+	for (std::size_t i = 0; i < size; ++i) {
+		crc = table[(crc ^ data[i]) & 0xFFU] ^ (crc >> 8U); // NOLINT
+	}
+	return crc;
+}
+
+void appendU32(std::vector<std::uint8_t> &out, std::uint32_t value)
+{
+	for (int shift = 24; shift >= 0; shift -= 8) {
+		out.push_back(static_cast<std::uint8_t>((value >> shift) & 0xFFU));
+	}
+}
+
+void appendChunk(std::vector<std::uint8_t> &out, std::string const &type, std::vector<std::uint8_t> const &data)
+{
+	appendU32(out, static_cast<std::uint32_t>(data.size()));
+	const std::size_t start = out.size();
+	out.insert(out.end(), type.begin(), type.end());
+	out.insert(out.end(), data.begin(), data.end());
+	const std::uint32_t crc = crc32(&out[start], out.size() - start) ^ 0xFFFFFFFFU;
+	appendU32(out, crc);
+}
+
+} // namespace
+
+auto encodePNG(std::vector<std::uint8_t> const &rgb, const int width, const int height) -> std::vector<std::uint8_t>
+{
+	// filter each row with the 'Sub' filter (the difference from the pixel to the left),
+	// which turns smooth colour gradients into runs that compress well
+	const std::size_t rowBytes = 3 * static_cast<std::size_t>(width);
+	std::vector<std::uint8_t> filtered;
+	filtered.reserve((rowBytes + 1) * height);
+	for (int j = 0; j < height; ++j) {
+		std::uint8_t const *row = &rgb[rowBytes * j];
+		filtered.push_back(1);
+		for (std::size_t i = 0; i < rowBytes; ++i) {
+			const std::uint8_t left = (i >= 3) ? row[i - 3] : 0; // NOLINT
+			filtered.push_back(static_cast<std::uint8_t>(row[i] - left)); // NOLINT
+		}
+	}
+
+	std::vector<std::uint8_t> png{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+	std::vector<std::uint8_t> header;
+	appendU32(header, static_cast<std::uint32_t>(width));
+	appendU32(header, static_cast<std::uint32_t>(height));
+	header.push_back(8); // bit depth
+	header.push_back(2); // colour type: RGB
+	header.push_back(0); // compression method: deflate
+	header.push_back(0); // filter method: adaptive
+	header.push_back(0); // no interlacing
+	appendChunk(png, "IHDR", header);
+	appendChunk(png, "IDAT", zlibCompress(filtered));
+	appendChunk(png, "IEND", {});
+	return png;
+}
+
+auto writePNG(std::string const &filename, std::vector<std::uint8_t> const &rgb, const int width, const int height) -> bool
+{
+	const std::vector<std::uint8_t> png = encodePNG(rgb, width, height);
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if (!file.good()) {
+		return false;
+	}
+	file.write(reinterpret_cast<char const *>(png.data()), static_cast<std::streamsize>(png.size())); // NOLINT
+	return file.good();
+}
+
+} // namespace quokka
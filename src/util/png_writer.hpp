@@ -0,0 +1,28 @@
+#ifndef PNG_WRITER_HPP_ // NOLINT
+#define PNG_WRITER_HPP_
+//==============================================================================
+// TwoMomentRad - a radiation transport library for patch-based AMR codes
+// Copyright 2020 Benjamin Wibking.
+// Released under the MIT license. See LICENSE file included in the GitHub repo.
+//==============================================================================
+/// \file png_writer.hpp
+/// \brief A minimal, dependency-free PNG encoder (8-bit RGB, fixed-Huffman deflate).
+///
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace quokka
+{
+
+// encode an 8-bit RGB image as a PNG file in memory.
+// 'rgb' has 3 * width * height bytes, stored row by row starting with the top row of the image.
+auto encodePNG(std::vector<std::uint8_t> const &rgb, int width, int height) -> std::vector<std::uint8_t>;
+
+// encode an 8-bit RGB image and write it to 'filename' (returns false if the file cannot be written)
+auto writePNG(std::string const &filename, std::vector<std::uint8_t> const &rgb, int width, int height) -> bool;
+
+} // namespace quokka
+
+#endif // PNG_WRITER_HPP_